@@ -30,8 +30,17 @@ public class NanoBananaBridge : ModuleRules
         {
             "ViewportCapture",
             "ImageComposer",
-            "Projects"
+            "ImageCore",
+            "Projects",
+            "Sockets",
+            "HTTPServer"
         });
+
+        // DerivedDataCache is a developer module: the team-wide result cache is editor only.
+        if (Target.bBuildEditor)
+        {
+            PrivateDependencyModuleNames.Add("DerivedDataCache");
+        }
     }
 }
 
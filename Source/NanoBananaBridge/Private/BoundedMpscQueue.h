@@ -0,0 +1,98 @@
+// Fixed-capacity, lock-free multi-producer / single-consumer queue. Enqueue never allocates:
+// items are moved into preallocated slots, and a full queue reports failure instead of
+// growing, so the caller decides what to do with the overflow.
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <atomic>
+
+namespace NanoBanana
+{
+    /**
+     * Bounded ring after D. Vyukov's sequence-numbered MPMC queue, with the consumer side
+     * reduced to a single thread. Each slot's sequence says whose turn it is: equal to the
+     * enqueue position when free, position + 1 once published. Items from one producer come
+     * out in the order that producer enqueued them.
+     */
+    template<typename T, uint32 Capacity>
+    class TBoundedMpscQueue
+    {
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    public:
+        TBoundedMpscQueue()
+        {
+            for (uint32 i = 0; i < Capacity; ++i)
+            {
+                Slots[i].Sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        TBoundedMpscQueue(const TBoundedMpscQueue&) = delete;
+        TBoundedMpscQueue& operator=(const TBoundedMpscQueue&) = delete;
+
+        /** Any thread. Returns false (leaving Item untouched) when the queue is full. */
+        bool TryEnqueue(T&& Item)
+        {
+            uint32 Pos = EnqueuePos.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                FSlot& Slot = Slots[Pos & (Capacity - 1)];
+                const uint32 Seq = Slot.Sequence.load(std::memory_order_acquire);
+                const int32 Diff = (int32)(Seq - Pos);
+                if (Diff == 0)
+                {
+                    if (EnqueuePos.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed))
+                    {
+                        Slot.Value = MoveTemp(Item);
+                        Slot.Sequence.store(Pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (Diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    Pos = EnqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /** Consumer thread only. False when empty, or when the next slot is claimed but not yet published. */
+        bool TryDequeue(T& Out)
+        {
+            FSlot& Slot = Slots[DequeuePos & (Capacity - 1)];
+            const uint32 Seq = Slot.Sequence.load(std::memory_order_acquire);
+            if ((int32)(Seq - (DequeuePos + 1)) < 0)
+            {
+                return false;
+            }
+            Out = MoveTemp(Slot.Value);
+            Slot.Value = T();
+            Slot.Sequence.store(DequeuePos + Capacity, std::memory_order_release);
+            ++DequeuePos;
+            return true;
+        }
+
+        /** Consumer thread only; a hint, since producers may be mid-publish. */
+        bool IsEmpty() const
+        {
+            const FSlot& Slot = Slots[DequeuePos & (Capacity - 1)];
+            return (int32)(Slot.Sequence.load(std::memory_order_acquire) - (DequeuePos + 1)) < 0;
+        }
+
+    private:
+        struct FSlot
+        {
+            std::atomic<uint32> Sequence { 0 };
+            T Value;
+        };
+
+        FSlot Slots[Capacity];
+        alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint32> EnqueuePos { 0 };
+        alignas(PLATFORM_CACHE_LINE_SIZE) uint32 DequeuePos = 0;
+    };
+}
@@ -0,0 +1,215 @@
+#include "DerivedDataResultCache.h"
+#include "NanoBananaSettings.h"
+#include "NanoBananaLog.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+
+#if WITH_EDITOR
+#include "DerivedDataCache.h"
+#include "DerivedDataCacheKey.h"
+#include "DerivedDataCacheRecord.h"
+#include "DerivedDataRequestOwner.h"
+#include "DerivedDataValue.h"
+#include "DerivedDataValueId.h"
+#include "Compression/CompressedBuffer.h"
+#include "IO/IoHash.h"
+#include "Memory/SharedBuffer.h"
+#include "Serialization/CompactBinary.h"
+#include "Serialization/CompactBinaryWriter.h"
+#endif
+
+namespace NanoBanana
+{
+    namespace
+    {
+        FAutoConsoleCommand DumpStatsCommand(
+            TEXT("NanoBanana.SharedResultCache.Stats"),
+            TEXT("Logs hits, misses and stores of the DerivedDataCache-backed result cache."),
+            FConsoleCommandDelegate::CreateLambda([]()
+            {
+                const FDerivedDataResultCacheStats S = FDerivedDataResultCache::Get().GetStats();
+                UE_LOG(LogNanoBanana, Display, TEXT("Shared result cache: %lld hits, %lld misses, %lld stored"), S.Hits, S.Misses, S.Stores);
+            }));
+
+#if WITH_EDITOR
+        using namespace UE::DerivedData;
+
+        FCacheKey MakeKey(uint64 Fingerprint)
+        {
+            static const FCacheBucket Bucket(ANSITEXTVIEW("NanoBananaResult"));
+            const uint64 Parts[2] = { (uint64)FDerivedDataResultCache::FormatVersion, Fingerprint };
+            return FCacheKey{ Bucket, FIoHash::HashBuffer(Parts, sizeof(Parts)) };
+        }
+
+        FValueId MakeValueId(int32 Index)
+        {
+            return FValueId::FromName(WriteToUtf8String<16>("Result_", Index));
+        }
+
+        FSharedString MakeDebugName(uint64 Fingerprint)
+        {
+            return FSharedString(FString::Printf(TEXT("NanoBananaResult/%016llx"), Fingerprint));
+        }
+
+        ECachePolicy MakePolicy(bool bLocalOnly)
+        {
+            return bLocalOnly ? ECachePolicy::Local : ECachePolicy::Default;
+        }
+
+        bool ReadRecord(const FCacheRecord& Record, TArray<TArray<uint8>>& OutImages, FResultMetadata& OutMetadata)
+        {
+            const FCbObject& Meta = Record.GetMeta();
+            if (Meta[UTF8TEXTVIEW("Version")].AsInt32() != FDerivedDataResultCache::FormatVersion) return false;
+            const int32 Count = Meta[UTF8TEXTVIEW("Count")].AsInt32();
+            if (Count <= 0) return false;
+
+            OutImages.SetNum(Count);
+            for (int32 i = 0; i < Count; ++i)
+            {
+                const FValueWithId& Value = Record.GetValue(MakeValueId(i));
+                if (!Value.IsValid() || !Value.HasData()) return false;
+                const FSharedBuffer Raw = Value.GetData().Decompress();
+                if (Raw.IsNull() || Raw.GetSize() == 0) return false;
+                OutImages[i].Append(static_cast<const uint8*>(Raw.GetData()), (int64)Raw.GetSize());
+            }
+
+            OutMetadata.Ext = FString(Meta[UTF8TEXTVIEW("Ext")].AsString());
+            OutMetadata.Vendor = FString(Meta[UTF8TEXTVIEW("Vendor")].AsString());
+            OutMetadata.Model = FString(Meta[UTF8TEXTVIEW("Model")].AsString());
+            OutMetadata.Prompt = FString(Meta[UTF8TEXTVIEW("Prompt")].AsString());
+            OutMetadata.Seed = Meta[UTF8TEXTVIEW("Seed")].AsInt32();
+            OutMetadata.CreatedUtc = Meta[UTF8TEXTVIEW("Created")].AsDateTime();
+            OutMetadata.CreatedBy = FString(Meta[UTF8TEXTVIEW("CreatedBy")].AsString());
+            return true;
+        }
+#endif
+    }
+
+    FResultMetadata FResultMetadata::Describe(const FNanoBananaRequest& Request)
+    {
+        FResultMetadata Out;
+        Out.Ext = FNanoBananaTypeUtils::OutputFormatToExt(Request.OutputFormat);
+        Out.Vendor = FNanoBananaTypeUtils::VendorToString(Request.Vendor);
+        Out.Model = FNanoBananaTypeUtils::ModelToDisplayString(Request.Model);
+        Out.Prompt = Request.Prompt;
+        Out.Seed = Request.Seed;
+        Out.CreatedUtc = FDateTime::UtcNow();
+        Out.CreatedBy = FPlatformProcess::UserName();
+        return Out;
+    }
+
+    FDerivedDataResultCache::FDerivedDataResultCache(bool bInLocalOnly)
+        : bLocalOnly(bInLocalOnly)
+    {
+    }
+
+    FDerivedDataResultCache& FDerivedDataResultCache::Get()
+    {
+        static FDerivedDataResultCache Instance(/*bLocalOnly*/ false);
+        return Instance;
+    }
+
+    bool FDerivedDataResultCache::IsEnabledFor(const FNanoBananaRequest& Request)
+    {
+#if WITH_EDITOR
+        const UNanoBananaSettings& S = UNanoBananaSettings::Get();
+        return S.bShareResultsThroughDerivedDataCache && (Request.Seed != 0 || S.bCacheUnseededResults);
+#else
+        return false;
+#endif
+    }
+
+    void FDerivedDataResultCache::Load(uint64 Fingerprint, FOnLoaded&& OnLoaded)
+    {
+#if WITH_EDITOR
+        const FCacheGetRequest Request{ MakeDebugName(Fingerprint), MakeKey(Fingerprint), MakePolicy(bLocalOnly) };
+
+        FRequestOwner Owner(EPriority::Normal);
+        GetCache().Get({ Request }, Owner, [this, OnLoaded = MoveTemp(OnLoaded)](FCacheGetResponse&& Response) mutable
+        {
+            TArray<TArray<uint8>> Images;
+            FResultMetadata Metadata;
+            const bool bFound = Response.Status == EStatus::Ok && ReadRecord(Response.Record, Images, Metadata);
+            if (bFound)
+            {
+                ++Hits;
+            }
+            else
+            {
+                ++Misses;
+                Images.Reset();
+            }
+            OnLoaded(bFound, MoveTemp(Images), MoveTemp(Metadata));
+        });
+        // The callback owns everything it needs; let the lookup finish after Owner goes away.
+        Owner.KeepAlive();
+#else
+        ++Misses;
+        OnLoaded(false, {}, {});
+#endif
+    }
+
+    void FDerivedDataResultCache::Store(uint64 Fingerprint, const TArray<FNanoBananaImageResult>& Results, const FResultMetadata& Metadata, FOnStored&& OnStored)
+    {
+#if WITH_EDITOR
+        if (Results.Num() == 0)
+        {
+            if (OnStored) OnStored(false);
+            return;
+        }
+
+        FCacheRecordBuilder Builder(MakeKey(Fingerprint));
+        for (int32 i = 0; i < Results.Num(); ++i)
+        {
+            const TArray<uint8>& Bytes = Results[i].PngBytes;
+            const FCompressedBuffer Stored = FCompressedBuffer::Compress(FSharedBuffer::Clone(Bytes.GetData(), Bytes.Num()),
+                ECompressedBufferCompressor::NotSet, ECompressedBufferCompressionLevel::None);
+            Builder.AddValue(MakeValueId(i), FValue(Stored));
+        }
+
+        TCbWriter<512> Writer;
+        Writer.BeginObject();
+        Writer.AddInteger(UTF8TEXTVIEW("Version"), FormatVersion);
+        Writer.AddInteger(UTF8TEXTVIEW("Count"), Results.Num());
+        Writer.AddString(UTF8TEXTVIEW("Ext"), Metadata.Ext);
+        Writer.AddString(UTF8TEXTVIEW("Vendor"), Metadata.Vendor);
+        Writer.AddString(UTF8TEXTVIEW("Model"), Metadata.Model);
+        Writer.AddString(UTF8TEXTVIEW("Prompt"), Metadata.Prompt);
+        Writer.AddInteger(UTF8TEXTVIEW("Seed"), Metadata.Seed);
+        Writer.AddDateTime(UTF8TEXTVIEW("Created"), Metadata.CreatedUtc);
+        Writer.AddString(UTF8TEXTVIEW("CreatedBy"), Metadata.CreatedBy);
+        Writer.EndObject();
+        Builder.SetMeta(Writer.Save().AsObject());
+
+        const FCachePutRequest Request{ MakeDebugName(Fingerprint), Builder.Build(), MakePolicy(bLocalOnly) };
+
+        // Writes to a shared store can be slow; nobody waits on them.
+        FRequestOwner Owner(EPriority::Low);
+        GetCache().Put({ Request }, Owner, [this, Fingerprint, OnStored = MoveTemp(OnStored)](FCachePutResponse&& Response) mutable
+        {
+            const bool bStored = Response.Status == EStatus::Ok;
+            if (bStored)
+            {
+                ++Stores;
+            }
+            else
+            {
+                UE_LOG(LogNanoBanana, Verbose, TEXT("Could not store result %016llx in the DerivedDataCache."), Fingerprint);
+            }
+            if (OnStored) OnStored(bStored);
+        });
+        Owner.KeepAlive();
+#else
+        if (OnStored) OnStored(false);
+#endif
+    }
+
+    FDerivedDataResultCacheStats FDerivedDataResultCache::GetStats() const
+    {
+        FDerivedDataResultCacheStats Out;
+        Out.Hits = Hits.load();
+        Out.Misses = Misses.load();
+        Out.Stores = Stores.load();
+        return Out;
+    }
+}
@@ -0,0 +1,76 @@
+// Team-wide result cache on Unreal's DerivedDataCache: results generated on one machine are
+// hits on every machine that shares its DDC (local or shared filesystem, cloud). Editor only.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+#include "NanoBananaTypes.h"
+#include <atomic>
+
+namespace NanoBanana
+{
+    /** What a shared entry records besides its images. */
+    struct FResultMetadata
+    {
+        /** Result file extension, with the dot. */
+        FString Ext;
+        FString Vendor;
+        FString Model;
+        FString Prompt;
+        int32 Seed = 0;
+        FDateTime CreatedUtc;
+        /** Who generated it, for tracing where a shared result came from. */
+        FString CreatedBy;
+
+        static FResultMetadata Describe(const FNanoBananaRequest& Request);
+    };
+
+    struct FDerivedDataResultCacheStats
+    {
+        int64 Hits = 0;
+        int64 Misses = 0;
+        int64 Stores = 0;
+    };
+
+    /**
+     * One DDC cache record per request fingerprint in the "NanoBananaResult" bucket: a value
+     * per result image plus FResultMetadata as the record's metadata. Lookups and stores are
+     * asynchronous and their callbacks run on any thread. Images are stored uncompressed: they
+     * are PNG or JPEG already, so another pass only costs CPU on every put and get. Without
+     * the DerivedDataCache module (non-editor builds) every lookup misses and nothing is stored.
+     */
+    class FDerivedDataResultCache
+    {
+    public:
+        /** Bumped when the record layout changes; it is part of every key. */
+        static constexpr int32 FormatVersion = 1;
+
+        using FOnLoaded = TUniqueFunction<void(bool bFound, TArray<TArray<uint8>> Images, FResultMetadata Metadata)>;
+        using FOnStored = TUniqueFunction<void(bool bStored)>;
+
+        /** bLocalOnly restricts reads and writes to the machine's own DDC stores. */
+        explicit FDerivedDataResultCache(bool bInLocalOnly);
+
+        /** Process-wide instance that reads and writes every configured DDC store. */
+        static FDerivedDataResultCache& Get();
+
+        /** Restricts (or stops restricting) later reads and writes to the machine's own DDC stores. */
+        void SetLocalOnly(bool bInLocalOnly) { bLocalOnly = bInLocalOnly; }
+        bool IsLocalOnly() const { return bLocalOnly; }
+
+        /** Settings allow sharing Request's results (and this build has a DDC). */
+        static bool IsEnabledFor(const FNanoBananaRequest& Request);
+
+        void Load(uint64 Fingerprint, FOnLoaded&& OnLoaded);
+
+        void Store(uint64 Fingerprint, const TArray<FNanoBananaImageResult>& Results, const FResultMetadata& Metadata, FOnStored&& OnStored = nullptr);
+
+        FDerivedDataResultCacheStats GetStats() const;
+
+    private:
+        std::atomic<bool> bLocalOnly;
+        std::atomic<int64> Hits { 0 };
+        std::atomic<int64> Misses { 0 };
+        std::atomic<int64> Stores { 0 };
+    };
+}
@@ -0,0 +1,621 @@
+#include "Base64Codec.h"
+
+#if PLATFORM_CPU_X86_FAMILY && PLATFORM_64BITS
+    #define NB_BASE64_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+    // Kernels are compiled for their ISA regardless of the module's baseline and only
+    // called after a CPUID check. MSVC needs no attribute to emit these intrinsics.
+    #if defined(__clang__) || defined(__GNUC__)
+        #define NB_BASE64_TARGET(Features) __attribute__((target(Features)))
+    #else
+        #define NB_BASE64_TARGET(Features)
+    #endif
+#else
+    #define NB_BASE64_X86 0
+#endif
+
+#if PLATFORM_CPU_ARM_FAMILY && PLATFORM_64BITS
+    #define NB_BASE64_NEON 1
+    #include <arm_neon.h>
+#else
+    #define NB_BASE64_NEON 0
+#endif
+
+namespace NanoBanana::Base64
+{
+    namespace
+    {
+        const uint8 EncodeTable[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+        constexpr uint8 InvalidChar = 0xFF;
+
+        struct FDecodeTable
+        {
+            uint8 Values[256];
+
+            FDecodeTable()
+            {
+                FMemory::Memset(Values, InvalidChar, sizeof(Values));
+                for (uint8 i = 0; i < 64; ++i)
+                {
+                    Values[EncodeTable[i]] = i;
+                }
+            }
+        };
+
+        const FDecodeTable& GetDecodeTable()
+        {
+            static const FDecodeTable Table;
+            return Table;
+        }
+
+        /** Bytes produced by NumChars unpadded characters (NumChars % 4 != 1). */
+        int64 GetDataDecodedSize(int64 NumChars)
+        {
+            const int64 Rem = NumChars % 4;
+            return (NumChars / 4) * 3 + (Rem ? Rem - 1 : 0);
+        }
+
+        // ---------------------------------------------------------------------------------
+        // Scalar reference. Also finishes whatever tail the vector kernels leave behind.
+        // ---------------------------------------------------------------------------------
+
+        void EncodeScalar(const uint8* Src, int64 NumBytes, uint8* Dst)
+        {
+            int64 i = 0;
+            for (; i + 3 <= NumBytes; i += 3)
+            {
+                const uint32 V = ((uint32)Src[i] << 16) | ((uint32)Src[i + 1] << 8) | Src[i + 2];
+                Dst[0] = EncodeTable[(V >> 18) & 0x3F];
+                Dst[1] = EncodeTable[(V >> 12) & 0x3F];
+                Dst[2] = EncodeTable[(V >> 6) & 0x3F];
+                Dst[3] = EncodeTable[V & 0x3F];
+                Dst += 4;
+            }
+
+            const int64 Rem = NumBytes - i;
+            if (Rem == 1)
+            {
+                const uint32 V = (uint32)Src[i] << 16;
+                Dst[0] = EncodeTable[(V >> 18) & 0x3F];
+                Dst[1] = EncodeTable[(V >> 12) & 0x3F];
+                Dst[2] = '=';
+                Dst[3] = '=';
+            }
+            else if (Rem == 2)
+            {
+                const uint32 V = ((uint32)Src[i] << 16) | ((uint32)Src[i + 1] << 8);
+                Dst[0] = EncodeTable[(V >> 18) & 0x3F];
+                Dst[1] = EncodeTable[(V >> 12) & 0x3F];
+                Dst[2] = EncodeTable[(V >> 6) & 0x3F];
+                Dst[3] = '=';
+            }
+        }
+
+        /** Decodes unpadded characters; NumChars % 4 != 1. Returns false on any invalid character. */
+        bool DecodeScalar(const uint8* Src, int64 NumChars, uint8* Dst)
+        {
+            const uint8* T = GetDecodeTable().Values;
+            uint32 Bad = 0;
+            for (; NumChars >= 4; NumChars -= 4, Src += 4, Dst += 3)
+            {
+                const uint32 A = T[Src[0]], B = T[Src[1]], C = T[Src[2]], D = T[Src[3]];
+                Bad |= A | B | C | D;
+                const uint32 V = (A << 18) | (B << 12) | (C << 6) | D;
+                Dst[0] = (uint8)(V >> 16);
+                Dst[1] = (uint8)(V >> 8);
+                Dst[2] = (uint8)V;
+            }
+            if (NumChars >= 2)
+            {
+                const uint32 A = T[Src[0]], B = T[Src[1]];
+                Bad |= A | B;
+                Dst[0] = (uint8)((A << 2) | (B >> 4));
+                if (NumChars == 3)
+                {
+                    const uint32 C = T[Src[2]];
+                    Bad |= C;
+                    Dst[1] = (uint8)((B << 4) | (C >> 2));
+                }
+            }
+            return (Bad & 0x80) == 0;
+        }
+
+#if NB_BASE64_X86
+        // ---------------------------------------------------------------------------------
+        // x86: SSSE3/SSE4.1 (16 chars per step) and AVX2 (32 chars per step).
+        // Encode: shuffle 3-byte groups into 32-bit lanes, split sextets with mulhi/mullo,
+        // then map sextets to ASCII with one pshufb offset lookup.
+        // Decode: classify characters by range, add the per-range offset, then merge
+        // sextets with maddubs/madd and compact the 3-byte groups with pshufb.
+        // ---------------------------------------------------------------------------------
+
+        void Cpuid(int32 Leaf, int32 SubLeaf, uint32 Regs[4])
+        {
+#if defined(_MSC_VER)
+            int32 R[4];
+            __cpuidex(R, Leaf, SubLeaf);
+            for (int32 i = 0; i < 4; ++i) Regs[i] = (uint32)R[i];
+#else
+            __cpuid_count(Leaf, SubLeaf, Regs[0], Regs[1], Regs[2], Regs[3]);
+#endif
+        }
+
+        uint64 ReadXcr0()
+        {
+#if defined(_MSC_VER)
+            return _xgetbv(0);
+#else
+            uint32 Eax = 0, Edx = 0;
+            __asm__ volatile("xgetbv" : "=a"(Eax), "=d"(Edx) : "c"(0));
+            return ((uint64)Edx << 32) | Eax;
+#endif
+        }
+
+        bool CpuHasSse41()
+        {
+            uint32 R[4];
+            Cpuid(1, 0, R);
+            const bool bSsse3 = (R[2] & (1u << 9)) != 0;
+            const bool bSse41 = (R[2] & (1u << 19)) != 0;
+            return bSsse3 && bSse41;
+        }
+
+        bool CpuHasAvx2()
+        {
+            uint32 R[4];
+            Cpuid(0, 0, R);
+            if (R[0] < 7)
+            {
+                return false;
+            }
+            Cpuid(1, 0, R);
+            const bool bOsXsave = (R[2] & (1u << 27)) != 0;
+            const bool bAvx = (R[2] & (1u << 28)) != 0;
+            if (!bOsXsave || !bAvx || (ReadXcr0() & 0x6) != 0x6)
+            {
+                return false; // OS does not preserve YMM state
+            }
+            Cpuid(7, 0, R);
+            return (R[1] & (1u << 5)) != 0;
+        }
+
+        NB_BASE64_TARGET("ssse3,sse4.1")
+        inline __m128i SextetsToAsciiSse(__m128i Indices)
+        {
+            const __m128i ShiftLut = _mm_setr_epi8(
+                'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+            // 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12
+            __m128i Slot = _mm_subs_epu8(Indices, _mm_set1_epi8(51));
+            const __m128i Less = _mm_cmpgt_epi8(_mm_set1_epi8(26), Indices);
+            Slot = _mm_or_si128(Slot, _mm_and_si128(Less, _mm_set1_epi8(13)));
+            return _mm_add_epi8(_mm_shuffle_epi8(ShiftLut, Slot), Indices);
+        }
+
+        NB_BASE64_TARGET("ssse3,sse4.1")
+        inline __m128i SplitSextetsSse(__m128i In)
+        {
+            // Each 32-bit lane gets bytes [b1 b0 b2 b1] so the four sextets can be isolated in place.
+            In = _mm_shuffle_epi8(In, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+            const __m128i T0 = _mm_and_si128(In, _mm_set1_epi32(0x0FC0FC00));
+            const __m128i T1 = _mm_mulhi_epu16(T0, _mm_set1_epi32(0x04000040));
+            const __m128i T2 = _mm_and_si128(In, _mm_set1_epi32(0x003F03F0));
+            const __m128i T3 = _mm_mullo_epi16(T2, _mm_set1_epi32(0x01000010));
+            return _mm_or_si128(T1, T3);
+        }
+
+        NB_BASE64_TARGET("ssse3,sse4.1")
+        void EncodeSse(const uint8* Src, int64 NumBytes, uint8* Dst, int64& InPos, int64& OutPos)
+        {
+            // Each step reads 16 bytes but consumes 12.
+            while (NumBytes - InPos >= 16)
+            {
+                const __m128i In = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Src + InPos));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + OutPos), SextetsToAsciiSse(SplitSextetsSse(In)));
+                InPos += 12;
+                OutPos += 16;
+            }
+        }
+
+        NB_BASE64_TARGET("ssse3,sse4.1")
+        inline __m128i AsciiToSextetsSse(__m128i In, __m128i& Error)
+        {
+            const __m128i AZ = _mm_and_si128(_mm_cmpgt_epi8(In, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(In, _mm_set1_epi8('Z' + 1)));
+            const __m128i Az = _mm_and_si128(_mm_cmpgt_epi8(In, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(In, _mm_set1_epi8('z' + 1)));
+            const __m128i Digit = _mm_and_si128(_mm_cmpgt_epi8(In, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(In, _mm_set1_epi8('9' + 1)));
+            const __m128i Plus = _mm_cmpeq_epi8(In, _mm_set1_epi8('+'));
+            const __m128i Slash = _mm_cmpeq_epi8(In, _mm_set1_epi8('/'));
+
+            __m128i Shift = _mm_and_si128(AZ, _mm_set1_epi8(-65));
+            Shift = _mm_or_si128(Shift, _mm_and_si128(Az, _mm_set1_epi8(-71)));
+            Shift = _mm_or_si128(Shift, _mm_and_si128(Digit, _mm_set1_epi8(4)));
+            Shift = _mm_or_si128(Shift, _mm_and_si128(Plus, _mm_set1_epi8(19)));
+            Shift = _mm_or_si128(Shift, _mm_and_si128(Slash, _mm_set1_epi8(16)));
+
+            const __m128i Valid = _mm_or_si128(_mm_or_si128(_mm_or_si128(AZ, Az), _mm_or_si128(Digit, Plus)), Slash);
+            Error = _mm_or_si128(Error, _mm_andnot_si128(Valid, _mm_set1_epi8(-1)));
+            return _mm_add_epi8(In, Shift);
+        }
+
+        NB_BASE64_TARGET("ssse3,sse4.1")
+        inline __m128i PackSextetsSse(__m128i Values)
+        {
+            // [00aaaaaa 00bbbbbb 00cccccc 00dddddd] -> 24-bit little-endian lane -> 3 big-endian bytes.
+            const __m128i AB = _mm_maddubs_epi16(Values, _mm_set1_epi32(0x01400140));
+            const __m128i ABCD = _mm_madd_epi16(AB, _mm_set1_epi32(0x00011000));
+            return _mm_shuffle_epi8(ABCD, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        }
+
+        NB_BASE64_TARGET("ssse3,sse4.1")
+        bool DecodeSse(const uint8* Src, int64 NumChars, uint8* Dst, int64& InPos, int64& OutPos)
+        {
+            // Each step stores 16 bytes but produces 12; keeping 24 chars in hand guarantees
+            // the 4 scratch bytes land inside the output the tail will overwrite.
+            __m128i Error = _mm_setzero_si128();
+            while (NumChars - InPos >= 24)
+            {
+                const __m128i In = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Src + InPos));
+                const __m128i Values = AsciiToSextetsSse(In, Error);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + OutPos), PackSextetsSse(Values));
+                InPos += 16;
+                OutPos += 12;
+            }
+            return _mm_movemask_epi8(Error) == 0;
+        }
+
+        NB_BASE64_TARGET("avx2")
+        void EncodeAvx2(const uint8* Src, int64 NumBytes, uint8* Dst, int64& InPos, int64& OutPos)
+        {
+            const __m256i Shuffle = _mm256_setr_epi8(
+                1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+            const __m256i ShiftLut = _mm256_setr_epi8(
+                'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+                'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+
+            // Each step reads 28 bytes (two 16-byte loads 12 apart) but consumes 24.
+            while (NumBytes - InPos >= 28)
+            {
+                const __m128i Lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Src + InPos));
+                const __m128i Hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Src + InPos + 12));
+                __m256i In = _mm256_inserti128_si256(_mm256_castsi128_si256(Lo), Hi, 1);
+
+                In = _mm256_shuffle_epi8(In, Shuffle);
+                const __m256i T0 = _mm256_and_si256(In, _mm256_set1_epi32(0x0FC0FC00));
+                const __m256i T1 = _mm256_mulhi_epu16(T0, _mm256_set1_epi32(0x04000040));
+                const __m256i T2 = _mm256_and_si256(In, _mm256_set1_epi32(0x003F03F0));
+                const __m256i T3 = _mm256_mullo_epi16(T2, _mm256_set1_epi32(0x01000010));
+                const __m256i Indices = _mm256_or_si256(T1, T3);
+
+                __m256i Slot = _mm256_subs_epu8(Indices, _mm256_set1_epi8(51));
+                const __m256i Less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), Indices);
+                Slot = _mm256_or_si256(Slot, _mm256_and_si256(Less, _mm256_set1_epi8(13)));
+                const __m256i Ascii = _mm256_add_epi8(_mm256_shuffle_epi8(ShiftLut, Slot), Indices);
+
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(Dst + OutPos), Ascii);
+                InPos += 24;
+                OutPos += 32;
+            }
+        }
+
+        NB_BASE64_TARGET("avx2")
+        bool DecodeAvx2(const uint8* Src, int64 NumChars, uint8* Dst, int64& InPos, int64& OutPos)
+        {
+            const __m256i Compact = _mm256_setr_epi8(
+                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+            const __m256i LanePack = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+
+            // Each step stores 32 bytes but produces 24; see DecodeSse for the slack rule.
+            __m256i Error = _mm256_setzero_si256();
+            while (NumChars - InPos >= 48)
+            {
+                const __m256i In = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Src + InPos));
+
+                const __m256i AZ = _mm256_and_si256(_mm256_cmpgt_epi8(In, _mm256_set1_epi8('A' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), In));
+                const __m256i Az = _mm256_and_si256(_mm256_cmpgt_epi8(In, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), In));
+                const __m256i Digit = _mm256_and_si256(_mm256_cmpgt_epi8(In, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), In));
+                const __m256i Plus = _mm256_cmpeq_epi8(In, _mm256_set1_epi8('+'));
+                const __m256i Slash = _mm256_cmpeq_epi8(In, _mm256_set1_epi8('/'));
+
+                __m256i Shift = _mm256_and_si256(AZ, _mm256_set1_epi8(-65));
+                Shift = _mm256_or_si256(Shift, _mm256_and_si256(Az, _mm256_set1_epi8(-71)));
+                Shift = _mm256_or_si256(Shift, _mm256_and_si256(Digit, _mm256_set1_epi8(4)));
+                Shift = _mm256_or_si256(Shift, _mm256_and_si256(Plus, _mm256_set1_epi8(19)));
+                Shift = _mm256_or_si256(Shift, _mm256_and_si256(Slash, _mm256_set1_epi8(16)));
+
+                const __m256i Valid = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(AZ, Az), _mm256_or_si256(Digit, Plus)), Slash);
+                Error = _mm256_or_si256(Error, _mm256_andnot_si256(Valid, _mm256_set1_epi8(-1)));
+                const __m256i Values = _mm256_add_epi8(In, Shift);
+
+                const __m256i AB = _mm256_maddubs_epi16(Values, _mm256_set1_epi32(0x01400140));
+                const __m256i ABCD = _mm256_madd_epi16(AB, _mm256_set1_epi32(0x00011000));
+                const __m256i Packed = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(ABCD, Compact), LanePack);
+
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(Dst + OutPos), Packed);
+                InPos += 32;
+                OutPos += 24;
+            }
+            return _mm256_movemask_epi8(Error) == 0;
+        }
+#endif // NB_BASE64_X86
+
+#if NB_BASE64_NEON
+        // ---------------------------------------------------------------------------------
+        // arm64 NEON: vld3/vst4 de-interleave 48 bytes <-> 64 chars, 64-entry table lookup
+        // for encode, range classification for decode.
+        // ---------------------------------------------------------------------------------
+
+        void EncodeNeon(const uint8* Src, int64 NumBytes, uint8* Dst, int64& InPos, int64& OutPos)
+        {
+            uint8x16x4_t Table;
+            Table.val[0] = vld1q_u8(EncodeTable);
+            Table.val[1] = vld1q_u8(EncodeTable + 16);
+            Table.val[2] = vld1q_u8(EncodeTable + 32);
+            Table.val[3] = vld1q_u8(EncodeTable + 48);
+            const uint8x16_t Mask = vdupq_n_u8(0x3F);
+
+            while (NumBytes - InPos >= 48)
+            {
+                const uint8x16x3_t In = vld3q_u8(Src + InPos);
+                uint8x16x4_t Out;
+                Out.val[0] = vshrq_n_u8(In.val[0], 2);
+                Out.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(In.val[0], 4), vshrq_n_u8(In.val[1], 4)), Mask);
+                Out.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(In.val[1], 2), vshrq_n_u8(In.val[2], 6)), Mask);
+                Out.val[3] = vandq_u8(In.val[2], Mask);
+                for (int32 k = 0; k < 4; ++k)
+                {
+                    Out.val[k] = vqtbl4q_u8(Table, Out.val[k]);
+                }
+                vst4q_u8(Dst + OutPos, Out);
+                InPos += 48;
+                OutPos += 64;
+            }
+        }
+
+        inline uint8x16_t AsciiToSextetsNeon(uint8x16_t In, uint8x16_t& Error)
+        {
+            const uint8x16_t AZ = vandq_u8(vcgeq_u8(In, vdupq_n_u8('A')), vcleq_u8(In, vdupq_n_u8('Z')));
+            const uint8x16_t Az = vandq_u8(vcgeq_u8(In, vdupq_n_u8('a')), vcleq_u8(In, vdupq_n_u8('z')));
+            const uint8x16_t Digit = vandq_u8(vcgeq_u8(In, vdupq_n_u8('0')), vcleq_u8(In, vdupq_n_u8('9')));
+            const uint8x16_t Plus = vceqq_u8(In, vdupq_n_u8('+'));
+            const uint8x16_t Slash = vceqq_u8(In, vdupq_n_u8('/'));
+
+            uint8x16_t Shift = vandq_u8(AZ, vdupq_n_u8((uint8)-65));
+            Shift = vorrq_u8(Shift, vandq_u8(Az, vdupq_n_u8((uint8)-71)));
+            Shift = vorrq_u8(Shift, vandq_u8(Digit, vdupq_n_u8(4)));
+            Shift = vorrq_u8(Shift, vandq_u8(Plus, vdupq_n_u8(19)));
+            Shift = vorrq_u8(Shift, vandq_u8(Slash, vdupq_n_u8(16)));
+
+            const uint8x16_t Valid = vorrq_u8(vorrq_u8(vorrq_u8(AZ, Az), vorrq_u8(Digit, Plus)), Slash);
+            Error = vorrq_u8(Error, vmvnq_u8(Valid));
+            return vaddq_u8(In, Shift);
+        }
+
+        bool DecodeNeon(const uint8* Src, int64 NumChars, uint8* Dst, int64& InPos, int64& OutPos)
+        {
+            uint8x16_t Error = vdupq_n_u8(0);
+            while (NumChars - InPos >= 64)
+            {
+                const uint8x16x4_t In = vld4q_u8(Src + InPos);
+                const uint8x16_t A = AsciiToSextetsNeon(In.val[0], Error);
+                const uint8x16_t B = AsciiToSextetsNeon(In.val[1], Error);
+                const uint8x16_t C = AsciiToSextetsNeon(In.val[2], Error);
+                const uint8x16_t D = AsciiToSextetsNeon(In.val[3], Error);
+
+                uint8x16x3_t Out;
+                Out.val[0] = vorrq_u8(vshlq_n_u8(A, 2), vshrq_n_u8(B, 4));
+                Out.val[1] = vorrq_u8(vshlq_n_u8(B, 4), vshrq_n_u8(C, 2));
+                Out.val[2] = vorrq_u8(vshlq_n_u8(C, 6), D);
+                vst3q_u8(Dst + OutPos, Out);
+                InPos += 64;
+                OutPos += 48;
+            }
+            return vmaxvq_u8(Error) == 0;
+        }
+#endif // NB_BASE64_NEON
+
+        EKernel DetectKernel()
+        {
+#if NB_BASE64_X86
+            if (CpuHasAvx2())
+            {
+                return EKernel::AVX2;
+            }
+            if (CpuHasSse41())
+            {
+                return EKernel::SSE;
+            }
+#elif NB_BASE64_NEON
+            return EKernel::NEON;
+#endif
+            return EKernel::Scalar;
+        }
+
+        EKernel ResolveKernel(EKernel Requested)
+        {
+            return IsKernelSupported(Requested) ? Requested : EKernel::Scalar;
+        }
+
+        /** Unpadded characters only; NumChars % 4 != 1. Writes exactly GetDataDecodedSize(NumChars) bytes. */
+        bool DecodeData(const uint8* Src, int64 NumChars, uint8* Dst, EKernel Kernel)
+        {
+            int64 InPos = 0;
+            int64 OutPos = 0;
+            bool bOk = true;
+            switch (Kernel)
+            {
+#if NB_BASE64_X86
+            case EKernel::AVX2: bOk = DecodeAvx2(Src, NumChars, Dst, InPos, OutPos); break;
+            case EKernel::SSE:  bOk = DecodeSse(Src, NumChars, Dst, InPos, OutPos); break;
+#endif
+#if NB_BASE64_NEON
+            case EKernel::NEON: bOk = DecodeNeon(Src, NumChars, Dst, InPos, OutPos); break;
+#endif
+            default: break;
+            }
+            return bOk && DecodeScalar(Src + InPos, NumChars - InPos, Dst + OutPos);
+        }
+
+        /** Strips '=' padding and validates the length. Returns the data length, or INDEX_NONE. */
+        template <typename CharType>
+        int64 GetUnpaddedLength(const CharType* Src, int64 NumChars)
+        {
+            int64 Len = NumChars;
+            if (Len > 0 && Src[Len - 1] == '=')
+            {
+                --Len;
+                if (Len > 0 && Src[Len - 1] == '=')
+                {
+                    --Len;
+                }
+                if (NumChars % 4 != 0)
+                {
+                    return INDEX_NONE;
+                }
+            }
+            return (Len % 4 == 1) ? INDEX_NONE : Len;
+        }
+    }
+
+    EKernel GetActiveKernel()
+    {
+        static const EKernel Active = DetectKernel();
+        return Active;
+    }
+
+    bool IsKernelSupported(EKernel Kernel)
+    {
+        switch (Kernel)
+        {
+        case EKernel::Scalar: return true;
+#if NB_BASE64_X86
+        case EKernel::SSE:    return CpuHasSse41();
+        case EKernel::AVX2:   return CpuHasAvx2();
+#endif
+#if NB_BASE64_NEON
+        case EKernel::NEON:   return true;
+#endif
+        default:              return false;
+        }
+    }
+
+    const TCHAR* LexToString(EKernel Kernel)
+    {
+        switch (Kernel)
+        {
+        case EKernel::SSE:  return TEXT("SSE4.1");
+        case EKernel::AVX2: return TEXT("AVX2");
+        case EKernel::NEON: return TEXT("NEON");
+        default:            return TEXT("Scalar");
+        }
+    }
+
+    void Encode(const uint8* Src, int64 NumBytes, ANSICHAR* Dest)
+    {
+        Encode(Src, NumBytes, Dest, GetActiveKernel());
+    }
+
+    void Encode(const uint8* Src, int64 NumBytes, ANSICHAR* Dest, EKernel Kernel)
+    {
+        uint8* Dst = reinterpret_cast<uint8*>(Dest);
+        int64 InPos = 0;
+        int64 OutPos = 0;
+        switch (ResolveKernel(Kernel))
+        {
+#if NB_BASE64_X86
+        case EKernel::AVX2: EncodeAvx2(Src, NumBytes, Dst, InPos, OutPos); break;
+        case EKernel::SSE:  EncodeSse(Src, NumBytes, Dst, InPos, OutPos); break;
+#endif
+#if NB_BASE64_NEON
+        case EKernel::NEON: EncodeNeon(Src, NumBytes, Dst, InPos, OutPos); break;
+#endif
+        default: break;
+        }
+        EncodeScalar(Src + InPos, NumBytes - InPos, Dst + OutPos);
+    }
+
+    int64 Decode(const ANSICHAR* Src, int64 NumChars, uint8* Dest)
+    {
+        return Decode(Src, NumChars, Dest, GetActiveKernel());
+    }
+
+    int64 Decode(const ANSICHAR* Src, int64 NumChars, uint8* Dest, EKernel Kernel)
+    {
+        const int64 Len = GetUnpaddedLength(Src, NumChars);
+        if (Len == INDEX_NONE)
+        {
+            return INDEX_NONE;
+        }
+        if (!DecodeData(reinterpret_cast<const uint8*>(Src), Len, Dest, ResolveKernel(Kernel)))
+        {
+            return INDEX_NONE;
+        }
+        return GetDataDecodedSize(Len);
+    }
+
+    FString Encode(TConstArrayView<uint8> Bytes)
+    {
+        TArray<ANSICHAR> Ascii;
+        Ascii.SetNumUninitialized(GetEncodedSize(Bytes.Num()));
+        Encode(Bytes.GetData(), Bytes.Num(), Ascii.GetData());
+        return FString(Ascii.Num(), Ascii.GetData());
+    }
+
+    bool Decode(FAnsiStringView Encoded, TArray<uint8>& Out)
+    {
+        Out.SetNumUninitialized(GetMaxDecodedSize(Encoded.Len()));
+        const int64 Written = Decode(Encoded.GetData(), Encoded.Len(), Out.GetData());
+        if (Written == INDEX_NONE)
+        {
+            Out.Reset();
+            return false;
+        }
+        Out.SetNum(Written, EAllowShrinking::No);
+        return true;
+    }
+
+    bool Decode(FStringView Encoded, TArray<uint8>& Out)
+    {
+        const int64 Len = GetUnpaddedLength(Encoded.GetData(), Encoded.Len());
+        if (Len == INDEX_NONE)
+        {
+            Out.Reset();
+            return false;
+        }
+
+        // Narrow to ASCII in cache-sized chunks instead of materializing a second copy of
+        // the whole payload. Chunks are whole quads, so only the last one can be partial.
+        constexpr int64 ChunkChars = 4 * 1024;
+        uint8 Narrow[ChunkChars];
+        const EKernel Kernel = GetActiveKernel();
+
+        Out.SetNumUninitialized(GetDataDecodedSize(Len));
+        const TCHAR* Src = Encoded.GetData();
+        int64 OutPos = 0;
+        for (int64 Pos = 0; Pos < Len; Pos += ChunkChars)
+        {
+            const int64 Count = FMath::Min(ChunkChars, Len - Pos);
+            for (int64 i = 0; i < Count; ++i)
+            {
+                const TCHAR C = Src[Pos + i];
+                Narrow[i] = ((uint32)C < 0x80) ? (uint8)C : 0x80; // non-ASCII never decodes
+            }
+            if (!DecodeData(Narrow, Count, Out.GetData() + OutPos, Kernel))
+            {
+                Out.Reset();
+                return false;
+            }
+            OutPos += GetDataDecodedSize(Count);
+        }
+        return true;
+    }
+}
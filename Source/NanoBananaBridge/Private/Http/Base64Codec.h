@@ -0,0 +1,47 @@
+// Vectorized base64 codec (standard alphabet, '=' padding) for image payloads.
+// AVX2 / SSE4.1 on x86-64 (picked at runtime via CPUID), NEON on arm64, with a scalar
+// reference path that also handles block tails. Output is identical to FBase64.
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace NanoBanana::Base64
+{
+    enum class EKernel : uint8
+    {
+        Scalar,
+        SSE,
+        AVX2,
+        NEON,
+    };
+
+    /** Fastest kernel supported by the running CPU. Used by the overloads without an EKernel argument. */
+    EKernel GetActiveKernel();
+
+    bool IsKernelSupported(EKernel Kernel);
+
+    const TCHAR* LexToString(EKernel Kernel);
+
+    /** Padded output length for NumBytes input bytes. */
+    inline int64 GetEncodedSize(int64 NumBytes) { return ((NumBytes + 2) / 3) * 4; }
+
+    /** Upper bound on decoded bytes for NumChars input characters. */
+    inline int64 GetMaxDecodedSize(int64 NumChars) { return (NumChars / 4) * 3 + 2; }
+
+    /** Writes exactly GetEncodedSize(NumBytes) characters to Dest (no terminator). */
+    void Encode(const uint8* Src, int64 NumBytes, ANSICHAR* Dest);
+    void Encode(const uint8* Src, int64 NumBytes, ANSICHAR* Dest, EKernel Kernel);
+
+    /**
+     * Decodes NumChars characters into Dest, which must hold GetMaxDecodedSize(NumChars) bytes.
+     * Accepts padded or unpadded input; whitespace and other characters are rejected.
+     * Returns the number of bytes written, or INDEX_NONE on malformed input.
+     */
+    int64 Decode(const ANSICHAR* Src, int64 NumChars, uint8* Dest);
+    int64 Decode(const ANSICHAR* Src, int64 NumChars, uint8* Dest, EKernel Kernel);
+
+    /** Convenience wrappers. Out is resized to the exact result; false (and Out emptied) on malformed input. */
+    FString Encode(TConstArrayView<uint8> Bytes);
+    bool Decode(FAnsiStringView Encoded, TArray<uint8>& Out);
+    bool Decode(FStringView Encoded, TArray<uint8>& Out);
+}
@@ -1,4 +1,6 @@
 #include "Base64Image.h"
+#include "Base64Codec.h"
+#include "UploadEncoder.h"
 #include "ViewportCaptureLibrary.h"
 #include "IImageWrapper.h"
 #include "IImageWrapperModule.h"
@@ -6,7 +8,6 @@
 #include "PixelFormat.h"
 #include "RenderingThread.h"
 #include "TextureResource.h"
-#include "Misc/Base64.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
 
@@ -46,7 +47,7 @@ namespace NanoBanana::Image
         TSharedPtr<IImageWrapper> Wrapper = Mod.CreateImageWrapper(EImageFormat::PNG);
         const ERGBFormat RGBFmt = (Fmt == PF_B8G8R8A8) ? ERGBFormat::BGRA : ERGBFormat::RGBA;
         Wrapper->SetRaw(Data, (int64)W * (int64)H * 4, W, H, RGBFmt, 8);
-        OutPng = Wrapper->GetCompressed(100);
+        OutPng = Wrapper->GetCompressed(PngFastQuality);
 
         Mip.BulkData.Unlock();
         return OutPng.Num() > 0;
@@ -80,17 +81,23 @@ namespace NanoBanana::Image
         return false;
     }
 
-    void ResolveAllReferences(const FNanoBananaRequest& Req, TArray<TArray<uint8>>& OutPngs)
+    FEncodedReferenceRef MakeEncodedReference(TArray<uint8> Bytes)
     {
-        OutPngs.Reset();
-        for (const FNanoBananaReferenceImage& Ref : Req.ReferenceImages)
+        TSharedRef<FEncodedReference, ESPMode::ThreadSafe> Ref = MakeShared<FEncodedReference, ESPMode::ThreadSafe>();
+        Ref->MimeType = SniffImageMimeType(Bytes);
+
+        const FString Prefix = FString::Printf(TEXT("data:%s;base64,"), *Ref->MimeType);
+        const int64 EncodedLen = NanoBanana::Base64::GetEncodedSize(Bytes.Num());
+        Ref->Base64Offset = Prefix.Len();
+        Ref->DataUri.SetNumUninitialized(Prefix.Len() + EncodedLen);
+        for (int32 i = 0; i < Prefix.Len(); ++i)
         {
-            TArray<uint8> Png;
-            if (ResolveReferenceToPng(Ref, Png) && Png.Num() > 0)
-            {
-                OutPngs.Add(MoveTemp(Png));
-            }
+            Ref->DataUri[i] = (ANSICHAR)Prefix[i];
         }
+        NanoBanana::Base64::Encode(Bytes.GetData(), Bytes.Num(), Ref->DataUri.GetData() + Prefix.Len());
+
+        Ref->Bytes = MoveTemp(Bytes);
+        return Ref;
     }
 
     FString PngBytesToDataUri(const TArray<uint8>& Png, const FString& MimeType)
@@ -99,8 +106,8 @@ namespace NanoBanana::Image
         {
             return FString();
         }
-        const FString B64 = FBase64::Encode(Png);
-        return FString::Printf(TEXT("data:%s;base64,%s"), *MimeType, *B64);
+        const FString B64 = NanoBanana::Base64::Encode(Png);
+        return FString::Printf(TEXT("data:%s;base64,%s"), MimeType.IsEmpty() ? *SniffImageMimeType(Png) : *MimeType, *B64);
     }
 
     FString SniffImageMimeType(const TArray<uint8>& Bytes)
@@ -7,6 +7,34 @@
 
 namespace NanoBanana::Image
 {
+    /** One reference image, encoded and ready to embed in a vendor payload. Immutable once published. */
+    struct FEncodedReference
+    {
+        /** Encoded image bytes (PNG/JPEG/WebP). */
+        TArray<uint8> Bytes;
+
+        /** MIME type matching Bytes, e.g. "image/png". */
+        FString MimeType;
+
+        /** ASCII "data:<mime>;base64,<payload>", built once so payload builders never re-encode. */
+        TArray<ANSICHAR> DataUri;
+
+        /** Offset of the base64 payload inside DataUri. */
+        int32 Base64Offset = 0;
+
+        /** Content hash this reference is cached under (see FReferenceCache); 0 when uncached. */
+        uint64 ContentHash = 0;
+
+        FAnsiStringView GetDataUri() const { return FAnsiStringView(DataUri.GetData(), DataUri.Num()); }
+        FAnsiStringView GetBase64() const { return GetDataUri().RightChop(Base64Offset); }
+        SIZE_T GetAllocatedSize() const { return Bytes.GetAllocatedSize() + DataUri.GetAllocatedSize() + MimeType.GetAllocatedSize(); }
+    };
+
+    using FEncodedReferenceRef = TSharedRef<const FEncodedReference, ESPMode::ThreadSafe>;
+
+    /** Wrap already-encoded image bytes, sniffing the MIME type and building the base64 data URI. */
+    FEncodedReferenceRef MakeEncodedReference(TArray<uint8> Bytes);
+
     /** Encode any UTexture2D (CPU-readable or GPU) to PNG bytes. Returns true on success. */
     bool TextureToPng(const UTexture2D* Texture, TArray<uint8>& OutPng);
 
@@ -16,11 +44,8 @@ namespace NanoBanana::Image
     /** Resolve a single FNanoBananaReferenceImage to PNG bytes (texture > render target > file path). */
     bool ResolveReferenceToPng(const FNanoBananaReferenceImage& Ref, TArray<uint8>& OutPng);
 
-    /** Resolve every reference in a request to PNG bytes. Skips entries that fail. */
-    void ResolveAllReferences(const FNanoBananaRequest& Req, TArray<TArray<uint8>>& OutPngs);
-
-    /** Build a "data:image/png;base64,..." URI from raw PNG bytes. */
-    FString PngBytesToDataUri(const TArray<uint8>& Png, const FString& MimeType = TEXT("image/png"));
+    /** Build a "data:<mime>;base64,..." URI from encoded image bytes. An empty MimeType sniffs it from the bytes. */
+    FString PngBytesToDataUri(const TArray<uint8>& Png, const FString& MimeType = FString());
 
     /** Sniff bytes (PNG/JPEG/WebP magic) and return MIME type, defaulting to image/png. */
     FString SniffImageMimeType(const TArray<uint8>& Bytes);
@@ -0,0 +1,108 @@
+#include "HedgePolicy.h"
+#include "NanoBananaLog.h"
+#include "HAL/IConsoleManager.h"
+
+namespace NanoBanana::Http
+{
+    namespace
+    {
+        FAutoConsoleCommand DumpStatsCommand(
+            TEXT("NanoBanana.Hedge.Stats"),
+            TEXT("Logs hedge rate, which request won hedged jobs, time-to-result percentiles and the recent primary latencies per model."),
+            FConsoleCommandDelegate::CreateLambda([]()
+            {
+                const FHedgePolicy& Policy = FHedgePolicy::Get();
+                const FHedgeStats S = Policy.GetStats();
+                UE_LOG(LogNanoBanana, Display, TEXT("Hedging: %lld jobs, %lld hedged (%.0f%%), backup won %lld, primary won %lld, saved up to %.1f s; time to result p50 %.1f s, p90 %.1f s, p99 %.1f s"),
+                    S.Jobs, S.Hedged, 100.0f * S.HedgeRate(), S.BackupWins, S.PrimaryWins, S.SavedUpToSeconds, S.P50Seconds, S.P90Seconds, S.P99Seconds);
+                for (const TPair<FString, TArray<float>>& Pair : Policy.GetWindows())
+                {
+                    UE_LOG(LogNanoBanana, Display, TEXT("  %s: primary p50 %.1f s, p90 %.1f s (%d samples)"),
+                        *Pair.Key, FHedgePolicy::Percentile(Pair.Value, 0.5f), FHedgePolicy::Percentile(Pair.Value, 0.9f), Pair.Value.Num());
+                }
+            }));
+    }
+
+    FHedgePolicy& FHedgePolicy::Get()
+    {
+        static FHedgePolicy Instance;
+        return Instance;
+    }
+
+    float FHedgePolicy::Percentile(TArray<float> Samples, float Fraction)
+    {
+        if (Samples.Num() == 0) return 0.0f;
+        Samples.Sort();
+        const int32 Rank = FMath::CeilToInt(FMath::Clamp(Fraction, 0.0f, 1.0f) * Samples.Num());
+        return Samples[FMath::Clamp(Rank - 1, 0, Samples.Num() - 1)];
+    }
+
+    void FHedgePolicy::RecordPrimaryLatency(const FString& Key, float Seconds)
+    {
+        if (Key.IsEmpty()) return;
+        TArray<float>& Window = Windows.FindOrAdd(Key);
+        if (Window.Num() >= WindowSize)
+        {
+            Window.RemoveAt(0, Window.Num() - WindowSize + 1, EAllowShrinking::No);
+        }
+        Window.Add(FMath::Max(0.0f, Seconds));
+    }
+
+    float FHedgePolicy::GetHedgeDelay(const FString& Key, float Fraction, float FallbackDelay, float MaxDelay) const
+    {
+        const TArray<float>* Window = Windows.Find(Key);
+        const float Delay = (Window && Window->Num() >= MinSamples) ? Percentile(*Window, Fraction) : FallbackDelay;
+        return FMath::Clamp(Delay, MinHedgeDelaySeconds, FMath::Max(MinHedgeDelaySeconds, MaxDelay));
+    }
+
+    void FHedgePolicy::RecordOutcome(float CompletedAt, float HedgedAt, bool bBackupWon, float PrimaryTimeout)
+    {
+        ++Stats.Jobs;
+        if (HedgedAt >= 0.0f)
+        {
+            ++Stats.Hedged;
+            if (bBackupWon)
+            {
+                ++Stats.BackupWins;
+                Stats.SavedUpToSeconds += FMath::Max(0.0f, PrimaryTimeout - HedgedAt);
+            }
+            else
+            {
+                ++Stats.PrimaryWins;
+            }
+        }
+
+        if (Completions.Num() < WindowSize * 4)
+        {
+            Completions.Add(CompletedAt);
+        }
+        else
+        {
+            Completions[NextCompletion] = CompletedAt;
+            NextCompletion = (NextCompletion + 1) % Completions.Num();
+        }
+    }
+
+    int32 FHedgePolicy::NumSamples(const FString& Key) const
+    {
+        const TArray<float>* Window = Windows.Find(Key);
+        return Window ? Window->Num() : 0;
+    }
+
+    FHedgeStats FHedgePolicy::GetStats() const
+    {
+        FHedgeStats S = Stats;
+        S.P50Seconds = Percentile(Completions, 0.5f);
+        S.P90Seconds = Percentile(Completions, 0.9f);
+        S.P99Seconds = Percentile(Completions, 0.99f);
+        return S;
+    }
+
+    void FHedgePolicy::Reset()
+    {
+        Windows.Reset();
+        Completions.Reset();
+        NextCompletion = 0;
+        Stats = FHedgeStats();
+    }
+}
@@ -0,0 +1,82 @@
+// When to hedge a slow primary request with a backup one. Keeps a short window of recent
+// primary latencies per key (vendor/model/resolution) and answers with a high percentile of
+// it: a request still unanswered past that point is in the tail and gets a backup. Also
+// counts how often that happened and who won, for NanoBanana.Hedge.Stats.
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace NanoBanana::Http
+{
+    struct FHedgeStats
+    {
+        /** Jobs that could have hedged (the mode was on). */
+        int64 Jobs = 0;
+        /** Jobs whose backup request was actually sent. */
+        int64 Hedged = 0;
+        /** Hedged jobs the backup finished first. */
+        int64 BackupWins = 0;
+        /** Hedged jobs the primary still finished first. */
+        int64 PrimaryWins = 0;
+        /**
+         * Sum over backup wins of (primary timeout - hedge time): what the serial fallback
+         * would have cost had those primaries timed out. An upper bound on the time saved.
+         */
+        double SavedUpToSeconds = 0.0;
+        /** Time to result over the recent window, all jobs. */
+        float P50Seconds = 0.0f;
+        float P90Seconds = 0.0f;
+        float P99Seconds = 0.0f;
+
+        float HedgeRate() const { return Jobs > 0 ? (float)Hedged / (float)Jobs : 0.0f; }
+    };
+
+    /** Game thread only. */
+    class FHedgePolicy
+    {
+    public:
+        /** Latencies kept per key; older ones fall out. */
+        static constexpr int32 WindowSize = 64;
+        /** Below this many samples the caller's fallback delay is used. */
+        static constexpr int32 MinSamples = 5;
+        /** Never hedge sooner than this, however fast recent requests were. */
+        static constexpr float MinHedgeDelaySeconds = 0.25f;
+
+        static FHedgePolicy& Get();
+
+        /** Nearest-rank percentile (0..1) of Samples; 0 when empty. */
+        static float Percentile(TArray<float> Samples, float Fraction);
+
+        /**
+         * Records how long a primary request ran: until it answered, or until it was abandoned
+         * because the backup won (a lower bound, which keeps the window from only ever seeing
+         * the fast requests).
+         */
+        void RecordPrimaryLatency(const FString& Key, float Seconds);
+
+        /**
+         * Hedge delay for Key: the Fraction percentile of its window, clamped to
+         * [MinHedgeDelaySeconds, MaxDelay]. Falls back to FallbackDelay (same clamp) until the
+         * window holds MinSamples.
+         */
+        float GetHedgeDelay(const FString& Key, float Fraction, float FallbackDelay, float MaxDelay) const;
+
+        /**
+         * One finished job. HedgedAt < 0 means the backup was never sent; PrimaryTimeout feeds
+         * the SavedUpToSeconds bound.
+         */
+        void RecordOutcome(float CompletedAt, float HedgedAt, bool bBackupWon, float PrimaryTimeout);
+
+        int32 NumSamples(const FString& Key) const;
+        FHedgeStats GetStats() const;
+        const TMap<FString, TArray<float>>& GetWindows() const { return Windows; }
+        void Reset();
+
+    private:
+        TMap<FString, TArray<float>> Windows;
+        /** Ring of recent times to result, for the percentiles in FHedgeStats. */
+        TArray<float> Completions;
+        int32 NextCompletion = 0;
+        FHedgeStats Stats;
+    };
+}
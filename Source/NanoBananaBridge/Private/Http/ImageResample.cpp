@@ -0,0 +1,149 @@
+#include "ImageResample.h"
+#include "Math/VectorRegister.h"
+
+namespace NanoBanana::Image
+{
+    namespace
+    {
+        /** Per-output-sample filter taps along one axis, stored with a fixed stride. */
+        struct FFilterTaps
+        {
+            TArray<int32> First;
+            TArray<int32> Count;
+            TArray<float> Weights;
+            int32 Stride = 0;
+
+            const float* GetWeights(int32 Dst) const { return Weights.GetData() + (int64)Dst * Stride; }
+        };
+
+        void BuildTaps(int32 SrcLen, int32 DstLen, FFilterTaps& Out)
+        {
+            // Triangle filter stretched by the scale factor: every source pixel contributes
+            // to the output samples within one output pixel, weighted by distance.
+            const float Scale = (float)SrcLen / (float)DstLen;
+            const float Support = FMath::Max(1.0f, Scale);
+            Out.Stride = FMath::CeilToInt(Support * 2.0f) + 1;
+            Out.First.SetNumUninitialized(DstLen);
+            Out.Count.SetNumUninitialized(DstLen);
+            Out.Weights.SetNumZeroed((int64)DstLen * Out.Stride);
+
+            for (int32 Dst = 0; Dst < DstLen; ++Dst)
+            {
+                const float Center = ((float)Dst + 0.5f) * Scale - 0.5f;
+                const int32 Lo = FMath::Max(0, FMath::CeilToInt(Center - Support));
+                const int32 Hi = FMath::Min(SrcLen - 1, FMath::FloorToInt(Center + Support));
+
+                float* W = Out.Weights.GetData() + (int64)Dst * Out.Stride;
+                int32 N = 0;
+                float Sum = 0.0f;
+                for (int32 Src = Lo; Src <= Hi && N < Out.Stride; ++Src)
+                {
+                    const float Weight = 1.0f - FMath::Abs((float)Src - Center) / Support;
+                    W[N++] = FMath::Max(0.0f, Weight);
+                    Sum += W[N - 1];
+                }
+
+                if (N == 0 || Sum <= UE_SMALL_NUMBER)
+                {
+                    // Degenerate window (can only happen at extreme ratios): nearest sample.
+                    Out.First[Dst] = FMath::Clamp(FMath::RoundToInt(Center), 0, SrcLen - 1);
+                    Out.Count[Dst] = 1;
+                    W[0] = 1.0f;
+                    continue;
+                }
+
+                const float Inv = 1.0f / Sum;
+                for (int32 i = 0; i < N; ++i)
+                {
+                    W[i] *= Inv;
+                }
+                Out.First[Dst] = Lo;
+                Out.Count[Dst] = N;
+            }
+        }
+    }
+
+    FIntPoint ComputeFitSize(FIntPoint SrcSize, int32 MaxDimension)
+    {
+        const int32 Longest = FMath::Max(SrcSize.X, SrcSize.Y);
+        if (MaxDimension <= 0 || Longest <= MaxDimension)
+        {
+            return SrcSize;
+        }
+        const double Scale = (double)MaxDimension / (double)Longest;
+        return FIntPoint(
+            FMath::Clamp((int32)FMath::RoundToDouble(SrcSize.X * Scale), 1, MaxDimension),
+            FMath::Clamp((int32)FMath::RoundToDouble(SrcSize.Y * Scale), 1, MaxDimension));
+    }
+
+    void ResamplePixels(TConstArrayView<FColor> Src, FIntPoint SrcSize, FIntPoint DstSize, TArray<FColor>& OutPixels)
+    {
+        check(Src.Num() == (int64)SrcSize.X * SrcSize.Y);
+        check(DstSize.X > 0 && DstSize.Y > 0 && DstSize.X <= SrcSize.X && DstSize.Y <= SrcSize.Y);
+
+        FFilterTaps Horizontal;
+        FFilterTaps Vertical;
+        BuildTaps(SrcSize.X, DstSize.X, Horizontal);
+        BuildTaps(SrcSize.Y, DstSize.Y, Vertical);
+
+        OutPixels.SetNumUninitialized((int64)DstSize.X * DstSize.Y);
+
+        // One source-width row of premultiplied-by-weight float4 accumulators.
+        TArray<VectorRegister4Float, TAlignedHeapAllocator<16>> Row;
+        Row.SetNumUninitialized(SrcSize.X);
+        const VectorRegister4Float Half = VectorSetFloat1(0.5f);
+
+        for (int32 Dy = 0; Dy < DstSize.Y; ++Dy)
+        {
+            // Vertical pass: blend the contributing source rows into Row.
+            const int32 FirstRow = Vertical.First[Dy];
+            const int32 NumRows = Vertical.Count[Dy];
+            const float* RowWeights = Vertical.GetWeights(Dy);
+            {
+                const FColor* SrcRow = Src.GetData() + (int64)FirstRow * SrcSize.X;
+                const VectorRegister4Float W = VectorSetFloat1(RowWeights[0]);
+                for (int32 X = 0; X < SrcSize.X; ++X)
+                {
+                    Row[X] = VectorMultiply(VectorLoadByte4(&SrcRow[X]), W);
+                }
+            }
+            for (int32 Tap = 1; Tap < NumRows; ++Tap)
+            {
+                const FColor* SrcRow = Src.GetData() + (int64)(FirstRow + Tap) * SrcSize.X;
+                const VectorRegister4Float W = VectorSetFloat1(RowWeights[Tap]);
+                for (int32 X = 0; X < SrcSize.X; ++X)
+                {
+                    Row[X] = VectorMultiplyAdd(VectorLoadByte4(&SrcRow[X]), W, Row[X]);
+                }
+            }
+
+            // Horizontal pass: filter Row down to DstSize.X output pixels.
+            FColor* DstRow = OutPixels.GetData() + (int64)Dy * DstSize.X;
+            for (int32 Dx = 0; Dx < DstSize.X; ++Dx)
+            {
+                const int32 First = Horizontal.First[Dx];
+                const int32 Count = Horizontal.Count[Dx];
+                const float* Weights = Horizontal.GetWeights(Dx);
+                VectorRegister4Float Acc = VectorMultiply(Row[First], VectorSetFloat1(Weights[0]));
+                for (int32 Tap = 1; Tap < Count; ++Tap)
+                {
+                    Acc = VectorMultiplyAdd(Row[First + Tap], VectorSetFloat1(Weights[Tap]), Acc);
+                }
+                // Weights are normalized and non-negative, so Acc stays in [0, 255]; +0.5 rounds.
+                VectorStoreByte4(VectorAdd(Acc, Half), &DstRow[Dx]);
+            }
+        }
+    }
+
+    bool DownscaleToFit(TConstArrayView<FColor> Src, FIntPoint SrcSize, int32 MaxDimension, TArray<FColor>& OutPixels, FIntPoint& OutSize)
+    {
+        const FIntPoint Fit = ComputeFitSize(SrcSize, MaxDimension);
+        if (Fit == SrcSize)
+        {
+            return false;
+        }
+        ResamplePixels(Src, SrcSize, Fit, OutPixels);
+        OutSize = Fit;
+        return true;
+    }
+}
@@ -0,0 +1,24 @@
+// Fast downscaling of BGRA8 reference pixels before encoding. Separable triangle
+// (area-weighted) filter evaluated with VectorRegister4Float, one pixel per vector.
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace NanoBanana::Image
+{
+    /** Size that fits SrcSize inside MaxDimension x MaxDimension with the same aspect ratio (never upscales). */
+    FIntPoint ComputeFitSize(FIntPoint SrcSize, int32 MaxDimension);
+
+    /**
+     * Resample Src (SrcSize.X * SrcSize.Y BGRA8 pixels) to DstSize, which must not exceed SrcSize
+     * on either axis. Pass-order is vertical then horizontal over one row buffer, so scratch
+     * memory is a single source row regardless of image size.
+     */
+    void ResamplePixels(TConstArrayView<FColor> Src, FIntPoint SrcSize, FIntPoint DstSize, TArray<FColor>& OutPixels);
+
+    /**
+     * Downscale so neither side exceeds MaxDimension. Returns false (and leaves the outputs
+     * untouched) when MaxDimension <= 0 or the image already fits.
+     */
+    bool DownscaleToFit(TConstArrayView<FColor> Src, FIntPoint SrcSize, int32 MaxDimension, TArray<FColor>& OutPixels, FIntPoint& OutSize);
+}
@@ -0,0 +1,208 @@
+#include "JsonBodyWriter.h"
+#include "Containers/StringConv.h"
+
+namespace NanoBanana::Json
+{
+    FJsonBodyWriter::FJsonBodyWriter(int64 ReserveBytes)
+    {
+        if (ReserveBytes > 0)
+        {
+            Buffer.Reserve(ReserveBytes);
+        }
+    }
+
+    void FJsonBodyWriter::BeginValue()
+    {
+        if (bAfterKey)
+        {
+            bAfterKey = false;
+            return;
+        }
+        if (Scopes.Num() > 0)
+        {
+            if (Scopes.Last())
+            {
+                AppendByte(',');
+            }
+            Scopes.Last() = true;
+        }
+    }
+
+    void FJsonBodyWriter::WriteKey(FAnsiStringView Key)
+    {
+        BeginValue();
+        AppendByte('"');
+        AppendAscii(Key);
+        AppendByte('"');
+        AppendByte(':');
+        bAfterKey = true;
+    }
+
+    void FJsonBodyWriter::BeginObject()
+    {
+        BeginValue();
+        AppendByte('{');
+        Scopes.Add(false);
+    }
+
+    void FJsonBodyWriter::BeginObject(FAnsiStringView Key)
+    {
+        WriteKey(Key);
+        BeginObject();
+    }
+
+    void FJsonBodyWriter::EndObject()
+    {
+        check(Scopes.Num() > 0);
+        Scopes.Pop(EAllowShrinking::No);
+        AppendByte('}');
+    }
+
+    void FJsonBodyWriter::BeginArray()
+    {
+        BeginValue();
+        AppendByte('[');
+        Scopes.Add(false);
+    }
+
+    void FJsonBodyWriter::BeginArray(FAnsiStringView Key)
+    {
+        WriteKey(Key);
+        BeginArray();
+    }
+
+    void FJsonBodyWriter::EndArray()
+    {
+        check(Scopes.Num() > 0);
+        Scopes.Pop(EAllowShrinking::No);
+        AppendByte(']');
+    }
+
+    void FJsonBodyWriter::WriteString(FStringView Value)
+    {
+        BeginValue();
+        AppendByte('"');
+        AppendEscaped(Value);
+        AppendByte('"');
+    }
+
+    void FJsonBodyWriter::WriteString(FAnsiStringView Key, FStringView Value)
+    {
+        WriteKey(Key);
+        WriteString(Value);
+    }
+
+    void FJsonBodyWriter::WriteAsciiString(FAnsiStringView Value)
+    {
+        BeginValue();
+        AppendByte('"');
+        AppendAscii(Value);
+        AppendByte('"');
+    }
+
+    void FJsonBodyWriter::WriteAsciiString(FAnsiStringView Key, FAnsiStringView Value)
+    {
+        WriteKey(Key);
+        WriteAsciiString(Value);
+    }
+
+    void FJsonBodyWriter::WriteInt(int64 Value)
+    {
+        BeginValue();
+        ANSICHAR Digits[24];
+        const int32 Len = FCStringAnsi::Snprintf(Digits, UE_ARRAY_COUNT(Digits), "%lld", (long long)Value);
+        AppendAscii(FAnsiStringView(Digits, Len));
+    }
+
+    void FJsonBodyWriter::WriteInt(FAnsiStringView Key, int64 Value)
+    {
+        WriteKey(Key);
+        WriteInt(Value);
+    }
+
+    void FJsonBodyWriter::WriteBool(FAnsiStringView Key, bool bValue)
+    {
+        WriteKey(Key);
+        BeginValue();
+        AppendAscii(bValue ? FAnsiStringView("true") : FAnsiStringView("false"));
+    }
+
+    TArray<uint8> FJsonBodyWriter::Finish()
+    {
+        check(Scopes.Num() == 0);
+        return MoveTemp(Buffer);
+    }
+
+    FString FJsonBodyWriter::ToString(const TArray<uint8>& Utf8Body)
+    {
+        const FUTF8ToTCHAR Conv(reinterpret_cast<const UTF8CHAR*>(Utf8Body.GetData()), Utf8Body.Num());
+        return FString(Conv.Length(), Conv.Get());
+    }
+
+    void FJsonBodyWriter::AppendAscii(FAnsiStringView Text)
+    {
+        Buffer.Append(reinterpret_cast<const uint8*>(Text.GetData()), Text.Len());
+    }
+
+    void FJsonBodyWriter::AppendEscaped(FStringView Text)
+    {
+        static const ANSICHAR Hex[] = "0123456789abcdef";
+
+        const TCHAR* It = Text.GetData();
+        const TCHAR* End = It + Text.Len();
+        while (It < End)
+        {
+            uint32 Code = (uint32)*It++;
+
+            // Recombine UTF-16 surrogate pairs (no-op on platforms with 32-bit TCHAR).
+            if (Code >= 0xD800 && Code <= 0xDBFF && It < End && (uint32)*It >= 0xDC00 && (uint32)*It <= 0xDFFF)
+            {
+                Code = 0x10000 + ((Code - 0xD800) << 10) + ((uint32)*It++ - 0xDC00);
+            }
+            else if (Code >= 0xD800 && Code <= 0xDFFF)
+            {
+                Code = 0xFFFD; // lone surrogate
+            }
+
+            switch (Code)
+            {
+            case '"':  AppendByte('\\'); AppendByte('"');  continue;
+            case '\\': AppendByte('\\'); AppendByte('\\'); continue;
+            case '\b': AppendByte('\\'); AppendByte('b');  continue;
+            case '\f': AppendByte('\\'); AppendByte('f');  continue;
+            case '\n': AppendByte('\\'); AppendByte('n');  continue;
+            case '\r': AppendByte('\\'); AppendByte('r');  continue;
+            case '\t': AppendByte('\\'); AppendByte('t');  continue;
+            default: break;
+            }
+
+            if (Code < 0x20)
+            {
+                const uint8 Escape[] = {'\\', 'u', '0', '0', (uint8)Hex[(Code >> 4) & 0xF], (uint8)Hex[Code & 0xF]};
+                Buffer.Append(Escape, UE_ARRAY_COUNT(Escape));
+            }
+            else if (Code < 0x80)
+            {
+                AppendByte((uint8)Code);
+            }
+            else if (Code < 0x800)
+            {
+                AppendByte((uint8)(0xC0 | (Code >> 6)));
+                AppendByte((uint8)(0x80 | (Code & 0x3F)));
+            }
+            else if (Code < 0x10000)
+            {
+                AppendByte((uint8)(0xE0 | (Code >> 12)));
+                AppendByte((uint8)(0x80 | ((Code >> 6) & 0x3F)));
+                AppendByte((uint8)(0x80 | (Code & 0x3F)));
+            }
+            else
+            {
+                AppendByte((uint8)(0xF0 | (Code >> 18)));
+                AppendByte((uint8)(0x80 | ((Code >> 12) & 0x3F)));
+                AppendByte((uint8)(0x80 | ((Code >> 6) & 0x3F)));
+                AppendByte((uint8)(0x80 | (Code & 0x3F)));
+            }
+        }
+    }
+}
@@ -0,0 +1,71 @@
+// Streaming UTF-8 JSON writer for request bodies. Appends straight into one pre-sized
+// byte buffer that can be handed to IHttpRequest::SetContent, so multi-megabyte base64
+// payloads are copied exactly once (no FJsonObject DOM, no UTF-16 intermediate).
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace NanoBanana::Json
+{
+    /**
+     * Minimal compact JSON writer. Keys are ASCII string literals; string values are
+     * escaped and UTF-8 encoded, except the *Ascii variants which copy pre-validated
+     * ASCII (base64, data URIs) verbatim. Commas are inserted automatically.
+     *
+     *   FJsonBodyWriter W(EstimatedBytes);
+     *   W.BeginObject();
+     *   W.WriteString("prompt", Request.Prompt);
+     *   W.BeginArray("image_urls");
+     *   W.WriteAsciiString(Ref->GetDataUri());
+     *   W.EndArray();
+     *   W.EndObject();
+     *   TArray<uint8> Body = W.Finish();
+     */
+    class FJsonBodyWriter
+    {
+    public:
+        explicit FJsonBodyWriter(int64 ReserveBytes = 0);
+
+        void BeginObject();
+        void BeginObject(FAnsiStringView Key);
+        void EndObject();
+
+        void BeginArray();
+        void BeginArray(FAnsiStringView Key);
+        void EndArray();
+
+        void WriteString(FStringView Value);
+        void WriteString(FAnsiStringView Key, FStringView Value);
+
+        /** Value must be plain ASCII with nothing that needs JSON escaping (e.g. base64). */
+        void WriteAsciiString(FAnsiStringView Value);
+        void WriteAsciiString(FAnsiStringView Key, FAnsiStringView Value);
+
+        void WriteInt(int64 Value);
+        void WriteInt(FAnsiStringView Key, int64 Value);
+
+        void WriteBool(FAnsiStringView Key, bool bValue);
+
+        /** Bytes written so far. */
+        int64 Num() const { return Buffer.Num(); }
+
+        /** Moves the finished body out. The writer is empty afterwards. */
+        TArray<uint8> Finish();
+
+        /** Decode a UTF-8 body for display or tests. */
+        static FString ToString(const TArray<uint8>& Utf8Body);
+
+    private:
+        void BeginValue();
+        void WriteKey(FAnsiStringView Key);
+        void AppendAscii(FAnsiStringView Text);
+        void AppendEscaped(FStringView Text);
+        void AppendByte(uint8 Byte) { Buffer.Add(Byte); }
+
+        TArray<uint8> Buffer;
+
+        /** One entry per open object/array: true once it holds at least one value. */
+        TArray<bool, TInlineAllocator<8>> Scopes;
+        bool bAfterKey = false;
+    };
+}
@@ -1,7 +1,9 @@
 #include "JsonResponseScanner.h"
 #include "Serialization/JsonReader.h"
 #include "Serialization/JsonSerializer.h"
-#include "Misc/Base64.h"
+#include "Base64Codec.h"
+
+#include <cstring>
 
 namespace NanoBanana::Json
 {
@@ -17,7 +19,7 @@ namespace NanoBanana::Json
             if (Mime.IsEmpty() || Mime.StartsWith(TEXT("image/")))
             {
                 TArray<uint8> Img;
-                if (FBase64::Decode(DataB64, Img) && Img.Num() > 0)
+                if (NanoBanana::Base64::Decode(DataB64, Img) && Img.Num() > 0)
                 {
                     Out.Add(MoveTemp(Img));
                 }
@@ -38,7 +40,7 @@ namespace NanoBanana::Json
         if (Obj->TryGetStringField(TEXT("b64_json"), B64) || Obj->TryGetStringField(TEXT("bytesBase64"), B64))
         {
             TArray<uint8> Img;
-            if (FBase64::Decode(B64, Img) && Img.Num() > 0)
+            if (NanoBanana::Base64::Decode(B64, Img) && Img.Num() > 0)
             {
                 Out.Add(MoveTemp(Img));
             }
@@ -66,13 +68,301 @@ namespace NanoBanana::Json
         }
     }
 
-    void CollectInlineImagesFromResponseBody(const FString& Body, TArray<TArray<uint8>>& Out)
+    namespace
     {
-        TSharedPtr<FJsonObject> Json;
-        TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Body);
-        if (FJsonSerializer::Deserialize(Reader, Json) && Json.IsValid())
+        enum class EFieldKey : uint8
+        {
+            Other,
+            InlineData,     // inline_data / inlineData
+            Base64,         // b64_json / bytesBase64
+            Data,           // "data" (only meaningful inside an inline-data object)
+            MimeType,       // mime_type / mimeType
+        };
+
+        EFieldKey ClassifyKey(FAnsiStringView Key)
         {
-            CollectInlineImages(Json, Out);
+            auto Is = [Key](const ANSICHAR* Name) { return Key.Equals(Name, ESearchCase::CaseSensitive); };
+            if (Is("inlineData") || Is("inline_data")) return EFieldKey::InlineData;
+            if (Is("b64_json") || Is("bytesBase64"))   return EFieldKey::Base64;
+            if (Is("data"))                            return EFieldKey::Data;
+            if (Is("mimeType") || Is("mime_type"))     return EFieldKey::MimeType;
+            return EFieldKey::Other;
         }
+
+        /** Tokenizer over UTF-8 bytes with an explicit container stack (no recursion). */
+        class FInlineImageScanner
+        {
+        public:
+            FInlineImageScanner(TConstArrayView<uint8> InUtf8, TArray<TArray<uint8>>& InOut)
+                : Cur(InUtf8.GetData())
+                , End(InUtf8.GetData() + InUtf8.Num())
+                , Out(InOut)
+            {
+            }
+
+            bool Run()
+            {
+                // Tolerate a UTF-8 BOM.
+                if (End - Cur >= 3 && Cur[0] == 0xEF && Cur[1] == 0xBB && Cur[2] == 0xBF) Cur += 3;
+
+                enum class EState : uint8 { Value, FirstKey, Key, Colon, FirstElement, CommaOrEnd };
+                EState State = EState::Value;
+                for (;;)
+                {
+                    SkipWhitespace();
+                    if (Cur == End)
+                    {
+                        return Stack.Num() == 0 && State == EState::CommaOrEnd;
+                    }
+
+                    const uint8 C = *Cur;
+                    switch (State)
+                    {
+                    case EState::FirstElement:
+                        if (C == ']') { ++Cur; PopContainer(); State = EState::CommaOrEnd; break; }
+                        [[fallthrough]]; // the first element is an ordinary value
+                    case EState::Value:
+                        if (C == '{')
+                        {
+                            ++Cur;
+                            FFrame Frame;
+                            Frame.bObject = true;
+                            Frame.bInlineData = CurrentKey() == EFieldKey::InlineData;
+                            Stack.Add(Frame);
+                            State = EState::FirstKey;
+                        }
+                        else if (C == '[')
+                        {
+                            ++Cur;
+                            Stack.AddDefaulted();
+                            State = EState::FirstElement;
+                        }
+                        else if (C == '"')
+                        {
+                            if (!ScanStringValue()) return false;
+                            State = EState::CommaOrEnd;
+                        }
+                        else
+                        {
+                            if (!SkipLiteral()) return false;
+                            State = EState::CommaOrEnd;
+                        }
+                        break;
+
+                    case EState::FirstKey:
+                        if (C == '}') { ++Cur; PopContainer(); State = EState::CommaOrEnd; break; }
+                        [[fallthrough]];
+                    case EState::Key:
+                    {
+                        const uint8* Start = nullptr;
+                        const uint8* Stop = nullptr;
+                        bool bEscaped = false;
+                        if (C != '"' || !FindStringEnd(Start, Stop, bEscaped)) return false;
+                        // Keys we look for never need escaping; an escaped key is just "other".
+                        Stack.Last().PendingKey = bEscaped ? EFieldKey::Other
+                            : ClassifyKey(FAnsiStringView(reinterpret_cast<const ANSICHAR*>(Start), (int32)(Stop - Start)));
+                        State = EState::Colon;
+                        break;
+                    }
+
+                    case EState::Colon:
+                        if (C != ':') return false;
+                        ++Cur;
+                        State = EState::Value;
+                        break;
+
+                    case EState::CommaOrEnd:
+                        if (Stack.Num() == 0) return false; // trailing garbage after the root value
+                        ++Cur;
+                        if (C == ',')
+                        {
+                            State = Stack.Last().bObject ? EState::Key : EState::Value;
+                        }
+                        else if (C == (Stack.Last().bObject ? '}' : ']'))
+                        {
+                            PopContainer();
+                        }
+                        else
+                        {
+                            return false;
+                        }
+                        break;
+                    }
+                }
+            }
+
+            /** Indices into Out of images whose inline-data object declared a non-image MIME type. */
+            TArray<int32> Rejected;
+
+        private:
+            struct FFrame
+            {
+                bool bObject = false;
+                /** This object is the value of an inline_data / inlineData key. */
+                bool bInlineData = false;
+                bool bNonImageMime = false;
+                EFieldKey PendingKey = EFieldKey::Other;
+                int32 DataImage = INDEX_NONE;
+            };
+
+            EFieldKey CurrentKey() const
+            {
+                return (Stack.Num() > 0 && Stack.Last().bObject) ? Stack.Last().PendingKey : EFieldKey::Other;
+            }
+
+            void PopContainer()
+            {
+                const FFrame Frame = Stack.Pop(EAllowShrinking::No);
+                // "mimeType" may come after "data", so the decision can only be made here.
+                if (Frame.bInlineData && Frame.bNonImageMime && Frame.DataImage != INDEX_NONE)
+                {
+                    Rejected.Add(Frame.DataImage);
+                }
+            }
+
+            void SkipWhitespace()
+            {
+                while (Cur < End && (*Cur == ' ' || *Cur == '\n' || *Cur == '\r' || *Cur == '\t')) ++Cur;
+            }
+
+            /** Cur is on the opening quote. On success Cur is past the closing quote and [OutStart, OutStop) is the raw body. */
+            bool FindStringEnd(const uint8*& OutStart, const uint8*& OutStop, bool& bOutEscaped)
+            {
+                const uint8* Start = Cur + 1;
+                const uint8* P = Start;
+                bOutEscaped = false;
+                for (;;)
+                {
+                    const uint8* Quote = static_cast<const uint8*>(memchr(P, '"', End - P));
+                    if (!Quote) return false;
+                    // A quote preceded by an odd run of backslashes is escaped.
+                    int64 Backslashes = 0;
+                    for (const uint8* B = Quote; B > Start && B[-1] == '\\'; --B) ++Backslashes;
+                    if ((Backslashes & 1) == 0)
+                    {
+                        bOutEscaped = bOutEscaped || memchr(Start, '\\', Quote - Start) != nullptr;
+                        OutStart = Start;
+                        OutStop = Quote;
+                        Cur = Quote + 1;
+                        return true;
+                    }
+                    bOutEscaped = true;
+                    P = Quote + 1;
+                }
+            }
+
+            bool ScanStringValue()
+            {
+                const EFieldKey Key = CurrentKey();
+                const bool bInInline = Stack.Num() > 0 && Stack.Last().bInlineData;
+                const uint8* Start = nullptr;
+                const uint8* Stop = nullptr;
+                bool bEscaped = false;
+                if (!FindStringEnd(Start, Stop, bEscaped)) return false;
+
+                if (Key == EFieldKey::Base64 || (Key == EFieldKey::Data && bInInline))
+                {
+                    const int32 Index = DecodeImage(Start, Stop, bEscaped);
+                    if (Key == EFieldKey::Data && Index != INDEX_NONE)
+                    {
+                        Stack.Last().DataImage = Index;
+                    }
+                }
+                else if (Key == EFieldKey::MimeType && bInInline)
+                {
+                    const FAnsiStringView Mime(reinterpret_cast<const ANSICHAR*>(Start), (int32)(Stop - Start));
+                    Stack.Last().bNonImageMime = Mime.Len() > 0 && !Mime.StartsWith("image/", ESearchCase::IgnoreCase);
+                }
+                return true;
+            }
+
+            /** Decode a base64 string body into a new output image. Returns its index, or INDEX_NONE. */
+            int32 DecodeImage(const uint8* Start, const uint8* Stop, bool bEscaped)
+            {
+                TArray<uint8> Image;
+                bool bDecoded = false;
+                if (!bEscaped)
+                {
+                    // Common case: decode straight out of the response bytes.
+                    bDecoded = NanoBanana::Base64::Decode(FAnsiStringView(reinterpret_cast<const ANSICHAR*>(Start), (int32)(Stop - Start)), Image);
+                }
+                else
+                {
+                    // Some encoders write "\/" or wrap lines with "\n"; unescape into scratch first.
+                    Scratch.Reset();
+                    for (const uint8* P = Start; P < Stop; ++P)
+                    {
+                        if (*P != '\\') { Scratch.Add((ANSICHAR)*P); continue; }
+                        if (++P == Stop) return INDEX_NONE;
+                        switch (*P)
+                        {
+                        case '/':  Scratch.Add('/'); break;
+                        case '\\': Scratch.Add('\\'); break;
+                        case '"':  Scratch.Add('"'); break;
+                        case 'n': case 'r': case 't': break; // line wrapping inside base64
+                        default:   return INDEX_NONE;        // \uXXXX etc. never appear in valid base64
+                        }
+                    }
+                    bDecoded = NanoBanana::Base64::Decode(FAnsiStringView(Scratch.GetData(), Scratch.Num()), Image);
+                }
+
+                if (!bDecoded || Image.Num() == 0)
+                {
+                    return INDEX_NONE;
+                }
+                return Out.Add(MoveTemp(Image));
+            }
+
+            bool SkipLiteral()
+            {
+                // true / false / null must match exactly; numbers only need to use number bytes.
+                for (const FAnsiStringView Word : { FAnsiStringView("true"), FAnsiStringView("false"), FAnsiStringView("null") })
+                {
+                    if (*Cur == (uint8)Word[0])
+                    {
+                        if (End - Cur < Word.Len() || FMemory::Memcmp(Cur, Word.GetData(), Word.Len()) != 0) return false;
+                        Cur += Word.Len();
+                        return true;
+                    }
+                }
+                const uint8* Start = Cur;
+                while (Cur < End && ((*Cur >= '0' && *Cur <= '9') || *Cur == '-' || *Cur == '+' || *Cur == '.' || *Cur == 'e' || *Cur == 'E'))
+                {
+                    ++Cur;
+                }
+                return Cur > Start;
+            }
+
+            const uint8* Cur;
+            const uint8* End;
+            TArray<TArray<uint8>>& Out;
+            TArray<FFrame, TInlineAllocator<16>> Stack;
+            TArray<ANSICHAR> Scratch;
+        };
+    }
+
+    bool CollectInlineImagesFromUtf8(TConstArrayView<uint8> Utf8, TArray<TArray<uint8>>& Out)
+    {
+        const int32 FirstNew = Out.Num();
+        FInlineImageScanner Scanner(Utf8, Out);
+        if (!Scanner.Run())
+        {
+            Out.SetNum(FirstNew);
+            return false;
+        }
+
+        // Drop payloads whose MIME type turned out not to be an image (highest index first).
+        Scanner.Rejected.Sort([](int32 A, int32 B) { return A > B; });
+        for (const int32 Index : Scanner.Rejected)
+        {
+            Out.RemoveAt(Index);
+        }
+        return true;
+    }
+
+    void CollectInlineImagesFromResponseBody(const FString& Body, TArray<TArray<uint8>>& Out)
+    {
+        const FTCHARToUTF8 Utf8(*Body, Body.Len());
+        CollectInlineImagesFromUtf8(TConstArrayView<uint8>(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length()), Out);
     }
 }
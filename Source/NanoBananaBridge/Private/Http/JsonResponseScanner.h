@@ -1,5 +1,6 @@
-// Recursive JSON scanner that extracts inline base64 image payloads from arbitrary
-// vendor response shapes (Gemini "inline_data", OpenAI-style "b64_json", etc.).
+// JSON scanners that extract inline base64 image payloads from arbitrary vendor response
+// shapes (Gemini "inline_data", OpenAI-style "b64_json", etc.). The UTF-8 scanner is the
+// one providers use; the FJsonObject walker remains for callers that already hold a DOM.
 #pragma once
 
 #include "CoreMinimal.h"
@@ -10,6 +11,15 @@ namespace NanoBanana::Json
     /** Walk an arbitrary JSON object tree, decoding any base64 image fields found. */
     void CollectInlineImages(const TSharedPtr<FJsonObject>& Root, TArray<TArray<uint8>>& OutImages);
 
-    /** Convenience: parse a response body string and collect images in one call. */
+    /**
+     * Single pass over raw UTF-8 response bytes: no DOM and no UTF-16 copy. Each matching
+     * base64 string is decoded straight from the response into its output buffer, so peak
+     * memory is the response plus the decoded images. Finds the same fields as
+     * CollectInlineImages, in document order. Returns false (OutImages untouched) when the
+     * body is not well-formed JSON.
+     */
+    bool CollectInlineImagesFromUtf8(TConstArrayView<uint8> Utf8, TArray<TArray<uint8>>& OutImages);
+
+    /** Convenience for text bodies: converts to UTF-8 and runs CollectInlineImagesFromUtf8. */
     void CollectInlineImagesFromResponseBody(const FString& Body, TArray<TArray<uint8>>& OutImages);
 }
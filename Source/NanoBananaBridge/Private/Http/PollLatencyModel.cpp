@@ -0,0 +1,217 @@
+#include "PollLatencyModel.h"
+#include "NanoBananaLog.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+namespace NanoBanana::Http
+{
+    namespace
+    {
+        constexpr int32 StoreVersion = 1;
+
+        FAutoConsoleCommand DumpStatsCommand(
+            TEXT("NanoBanana.PollLatency.Stats"),
+            TEXT("Logs learned job completion times and the poll requests / latency saved against the fixed poll schedule."),
+            FConsoleCommandDelegate::CreateLambda([]()
+            {
+                const FPollLatencyModel& Model = FPollLatencyModel::Get();
+                const FPollLatencyStats& S = Model.GetStats();
+                UE_LOG(LogNanoBanana, Display, TEXT("Poll latency: %lld jobs, %lld polls (fixed schedule: %lld, saved %lld), detection delay %.1f s (fixed schedule: %.1f s, saved %.1f s)"),
+                    S.Jobs, S.Polls, S.BaselinePolls, S.SavedPolls(), S.DetectionDelaySeconds, S.BaselineDetectionDelaySeconds, S.SavedSeconds());
+                for (const TPair<FString, FPollLatencyEstimate>& Pair : Model.GetEstimates())
+                {
+                    UE_LOG(LogNanoBanana, Display, TEXT("  %s: %.1f s +/- %.1f s (%d samples)"),
+                        *Pair.Key, Pair.Value.Mean, Pair.Value.Deviation, Pair.Value.Samples);
+                }
+            }));
+
+        FAutoConsoleCommand ResetCommand(
+            TEXT("NanoBanana.PollLatency.Reset"),
+            TEXT("Forgets all learned job completion times."),
+            FConsoleCommandDelegate::CreateLambda([]()
+            {
+                FPollLatencyModel::Get().Reset();
+            }));
+    }
+
+    void FPollLatencyEstimate::Observe(double Seconds)
+    {
+        Seconds = FMath::Max(0.0, Seconds);
+        if (Samples == 0)
+        {
+            Mean = Seconds;
+            Deviation = Seconds * 0.5;
+        }
+        else
+        {
+            Deviation = 0.75 * Deviation + 0.25 * FMath::Abs(Mean - Seconds);
+            Mean = 0.875 * Mean + 0.125 * Seconds;
+        }
+        ++Samples;
+    }
+
+    FPollLatencyModel::FPollLatencyModel(const FString& InStorePath)
+        : StorePath(InStorePath)
+    {
+    }
+
+    FPollLatencyModel& FPollLatencyModel::Get()
+    {
+        static FPollLatencyModel Instance = []()
+        {
+            FPollLatencyModel Model(FPaths::ProjectSavedDir() / TEXT("NanoBanana") / TEXT("PollLatency.json"));
+            Model.Load();
+            return Model;
+        }();
+        return Instance;
+    }
+
+    FString FPollLatencyModel::MakeKey(ENanoBananaVendor Vendor, const FString& Model, ENanoBananaResolution Resolution)
+    {
+        return FString::Printf(TEXT("%s/%s/%s"), *FNanoBananaTypeUtils::VendorToString(Vendor), *Model,
+            *FNanoBananaTypeUtils::ResolutionToString(Resolution));
+    }
+
+    float FPollLatencyModel::PlanDelay(const FPollLatencyEstimate& Estimate, double Elapsed, float MaxDelay)
+    {
+        MaxDelay = FMath::Max(MaxDelay, MinPollDelaySeconds);
+        // A near-zero deviation would make the window a point; keep it at least a poll wide.
+        const double Spread = FMath::Max3(Estimate.Deviation, Estimate.Mean * 0.1, (double)MinPollDelaySeconds);
+        const double Open = Estimate.Mean - 2.0 * Spread;
+
+        if (Elapsed + MinPollDelaySeconds < Open)
+        {
+            // Before the window the job is almost never done: one wait, however long.
+            return (float)(Open - Elapsed);
+        }
+        // Inside the window, poll no denser than a quarter of the spread: a tight estimate earns
+        // fine-grained polls, a loose one would only burn requests on them.
+        const float Floor = FMath::Clamp((float)(Spread * 0.25), MinPollDelaySeconds, MaxDelay);
+        if (Elapsed < Estimate.Mean)
+        {
+            return FMath::Clamp((float)((Estimate.Mean - Elapsed) * 0.5), Floor, MaxDelay);
+        }
+        return FMath::Clamp(Floor + (float)((Elapsed - Estimate.Mean) * 0.25), Floor, MaxDelay);
+    }
+
+    bool FPollLatencyModel::TryPlanDelay(const FString& Key, double Elapsed, float MaxDelay, float& OutDelay) const
+    {
+        const FPollLatencyEstimate* Estimate = Estimates.Find(Key);
+        if (!Estimate || Estimate->Samples < MinSamples) return false;
+        OutDelay = PlanDelay(*Estimate, Elapsed, MaxDelay);
+        return true;
+    }
+
+    int32 FPollLatencyModel::ReplayFixedSchedule(double CompletedAt, float InitialDelay, float MaxDelay, float Multiplier, double& OutDetectedAt)
+    {
+        // Mirrors FPollLoop without a model: first poll at once, then Initial, x Multiplier, capped.
+        double At = 0.0;
+        float Delay = FMath::Max(0.1f, InitialDelay);
+        int32 Polls = 1;
+        while (At < CompletedAt)
+        {
+            At += Delay;
+            Delay = FMath::Min(MaxDelay, Delay * Multiplier);
+            ++Polls;
+        }
+        OutDetectedAt = At;
+        return Polls;
+    }
+
+    void FPollLatencyModel::Observe(const FString& Key, double CompletedAt)
+    {
+        if (Key.IsEmpty()) return;
+        Estimates.FindOrAdd(Key).Observe(CompletedAt);
+        bDirty = true;
+    }
+
+    void FPollLatencyModel::RecordCompletion(const FString& Key, double CompletedAt, double DetectedAt, int32 NumPolls,
+        float InitialDelay, float MaxDelay, float Multiplier)
+    {
+        if (Key.IsEmpty()) return;
+        Observe(Key, CompletedAt);
+
+        double BaselineDetectedAt = 0.0;
+        ++Stats.Jobs;
+        Stats.Polls += NumPolls;
+        Stats.BaselinePolls += ReplayFixedSchedule(CompletedAt, InitialDelay, MaxDelay, Multiplier, BaselineDetectedAt);
+        Stats.DetectionDelaySeconds += FMath::Max(0.0, DetectedAt - CompletedAt);
+        Stats.BaselineDetectionDelaySeconds += FMath::Max(0.0, BaselineDetectedAt - CompletedAt);
+    }
+
+    bool FPollLatencyModel::Load()
+    {
+        if (StorePath.IsEmpty()) return false;
+
+        FString Text;
+        if (!FFileHelper::LoadFileToString(Text, *StorePath)) return false;
+
+        TSharedPtr<FJsonObject> Root;
+        const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Text);
+        if (!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid()
+            || Root->GetIntegerField(TEXT("version")) != StoreVersion)
+        {
+            UE_LOG(LogNanoBanana, Warning, TEXT("Ignoring unreadable poll latency store %s"), *StorePath);
+            return false;
+        }
+
+        const TSharedPtr<FJsonObject>* Entries = nullptr;
+        if (!Root->TryGetObjectField(TEXT("estimates"), Entries)) return false;
+        for (const TPair<FString, TSharedPtr<FJsonValue>>& Pair : (*Entries)->Values)
+        {
+            const TSharedPtr<FJsonObject>* Entry = nullptr;
+            if (!Pair.Value.IsValid() || !Pair.Value->TryGetObject(Entry)) continue;
+
+            FPollLatencyEstimate Estimate;
+            Estimate.Mean = (*Entry)->GetNumberField(TEXT("mean"));
+            Estimate.Deviation = (*Entry)->GetNumberField(TEXT("deviation"));
+            Estimate.Samples = (int32)(*Entry)->GetNumberField(TEXT("samples"));
+            if (Estimate.Samples > 0 && Estimate.Mean >= 0.0)
+            {
+                Estimates.Add(Pair.Key, Estimate);
+            }
+        }
+        bDirty = false;
+        return true;
+    }
+
+    bool FPollLatencyModel::Save()
+    {
+        if (StorePath.IsEmpty() || !bDirty) return false;
+
+        TSharedRef<FJsonObject> Entries = MakeShared<FJsonObject>();
+        for (const TPair<FString, FPollLatencyEstimate>& Pair : Estimates)
+        {
+            TSharedRef<FJsonObject> Entry = MakeShared<FJsonObject>();
+            Entry->SetNumberField(TEXT("mean"), Pair.Value.Mean);
+            Entry->SetNumberField(TEXT("deviation"), Pair.Value.Deviation);
+            Entry->SetNumberField(TEXT("samples"), Pair.Value.Samples);
+            Entries->SetObjectField(Pair.Key, Entry);
+        }
+        TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+        Root->SetNumberField(TEXT("version"), StoreVersion);
+        Root->SetObjectField(TEXT("estimates"), Entries);
+
+        FString Text;
+        const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Text);
+        if (!FJsonSerializer::Serialize(Root, Writer)) return false;
+
+        IFileManager::Get().MakeDirectory(*FPaths::GetPath(StorePath), /*Tree*/ true);
+        if (!FFileHelper::SaveStringToFile(Text, *StorePath)) return false;
+        bDirty = false;
+        return true;
+    }
+
+    void FPollLatencyModel::Reset()
+    {
+        Estimates.Reset();
+        Stats = FPollLatencyStats();
+        bDirty = true;
+    }
+}
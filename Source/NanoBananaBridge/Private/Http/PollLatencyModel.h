@@ -0,0 +1,99 @@
+// Learned completion times for queued jobs, keyed by (vendor, model, resolution). FPollLoop
+// uses them to sleep through the part of a job that is almost never finished and to poll
+// densely around the predicted completion; the estimates persist across editor sessions.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NanoBananaTypes.h"
+
+namespace NanoBanana::Http
+{
+    /** Smoothed completion time and its mean deviation, in seconds since polling started. */
+    struct FPollLatencyEstimate
+    {
+        double Mean = 0.0;
+        double Deviation = 0.0;
+        int32 Samples = 0;
+
+        /**
+         * Folds one observed completion time in, the way TCP smooths round-trip times
+         * (RFC 6298): the first sample seeds the mean, later ones move it by 1/8 and the
+         * deviation by 1/4.
+         */
+        void Observe(double Seconds);
+    };
+
+    struct FPollLatencyStats
+    {
+        /** Jobs whose completion was observed this session. */
+        int64 Jobs = 0;
+        /** Status requests those jobs actually used. */
+        int64 Polls = 0;
+        /** Status requests the fixed 1 s x 1.5 up to 5 s schedule would have used. */
+        int64 BaselinePolls = 0;
+        /** Total time between a job finishing and its poll noticing, actual vs fixed schedule. */
+        double DetectionDelaySeconds = 0.0;
+        double BaselineDetectionDelaySeconds = 0.0;
+
+        int64 SavedPolls() const { return BaselinePolls - Polls; }
+        double SavedSeconds() const { return BaselineDetectionDelaySeconds - DetectionDelaySeconds; }
+    };
+
+    /** Game thread only. */
+    class FPollLatencyModel
+    {
+    public:
+        /** Polls never come closer together than this, however tight the estimate. */
+        static constexpr float MinPollDelaySeconds = 0.25f;
+        /** Estimates with fewer samples are not trusted; loops keep the fixed backoff. */
+        static constexpr int32 MinSamples = 3;
+
+        /** StorePath empty = in memory only. */
+        explicit FPollLatencyModel(const FString& InStorePath);
+
+        /** Process-wide model, loaded from Saved/NanoBanana/PollLatency.json on first use. */
+        static FPollLatencyModel& Get();
+
+        static FString MakeKey(ENanoBananaVendor Vendor, const FString& Model, ENanoBananaResolution Resolution);
+
+        /**
+         * Delay before the next poll of a job Elapsed seconds in: one long wait until the job
+         * could plausibly be done (Mean - 2 x Deviation), then half the remaining time to
+         * the mean, then a slow backoff once the job is overdue. After the initial wait, delays
+         * stay within [max(MinPollDelaySeconds, Deviation / 4), MaxDelay].
+         */
+        static float PlanDelay(const FPollLatencyEstimate& Estimate, double Elapsed, float MaxDelay);
+
+        /** Delay planned from Key's estimate, or false while the estimate is not trusted. */
+        bool TryPlanDelay(const FString& Key, double Elapsed, float MaxDelay, float& OutDelay) const;
+
+        /** Folds an exactly known completion time into Key's estimate (no poll stats). */
+        void Observe(const FString& Key, double CompletedAt);
+
+        /**
+         * Records a finished job: CompletedAt is the estimated completion time, DetectedAt when
+         * the successful poll returned, NumPolls the requests issued. The fixed schedule
+         * (InitialDelay x Multiplier up to MaxDelay) is replayed for the saved-work stats.
+         */
+        void RecordCompletion(const FString& Key, double CompletedAt, double DetectedAt, int32 NumPolls,
+            float InitialDelay, float MaxDelay, float Multiplier);
+
+        /** Polls the fixed schedule needs to see a job that completes at CompletedAt, and when it would. */
+        static int32 ReplayFixedSchedule(double CompletedAt, float InitialDelay, float MaxDelay, float Multiplier, double& OutDetectedAt);
+
+        const FPollLatencyEstimate* Find(const FString& Key) const { return Estimates.Find(Key); }
+        const TMap<FString, FPollLatencyEstimate>& GetEstimates() const { return Estimates; }
+        const FPollLatencyStats& GetStats() const { return Stats; }
+
+        bool Load();
+        /** Writes the estimates if anything changed since the last Load/Save. */
+        bool Save();
+        void Reset();
+
+    private:
+        FString StorePath;
+        TMap<FString, FPollLatencyEstimate> Estimates;
+        FPollLatencyStats Stats;
+        bool bDirty = false;
+    };
+}
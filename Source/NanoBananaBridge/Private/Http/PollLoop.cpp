@@ -1,4 +1,7 @@
 #include "PollLoop.h"
+#include "PollScheduler.h"
+#include "PollLatencyModel.h"
+#include "NanoBananaSettings.h"
 #include "HttpModule.h"
 #include "Interfaces/IHttpResponse.h"
 
@@ -15,24 +18,37 @@ namespace NanoBanana::Http
     {
         StartTime = FPlatformTime::Seconds();
         NextDelay = FMath::Max(0.1f, InitialDelaySeconds);
-        // Issue first request immediately, then back off between subsequent polls.
-        IssueRequest();
+        NumPolls = 0;
+        LastPendingAt = -1.0;
+        // Without a trusted estimate the first request goes out as soon as the vendor has a
+        // free slot (immediately unless the cap is reached, or after StartDelaySeconds when the
+        // caller has a faster signal), then backs off between polls.
+        float FirstDelay = FMath::Max(0.0f, StartDelaySeconds);
+        if (TryPlanDelay(0.0, FirstDelay))
+        {
+            FirstDelay = FMath::Min(FirstDelay, MaxTotalSeconds);
+        }
+        FPollScheduler::Get().Schedule(AsShared(), FirstDelay);
     }
 
     void FPollLoop::Cancel()
     {
         bCanceled = true;
         bDone = true;
-        if (TickerHandle.IsValid())
-        {
-            FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
-            TickerHandle.Reset();
-        }
+        // A pending scheduler entry is dropped when it comes due; only the slot needs handing back.
         if (InFlight.IsValid())
         {
             InFlight->CancelRequest();
             InFlight.Reset();
         }
+        ReleaseSlot();
+    }
+
+    void FPollLoop::ReleaseSlot()
+    {
+        if (!bHoldingSlot) return;
+        bHoldingSlot = false;
+        FPollScheduler::Get().Release(Vendor);
     }
 
     void FPollLoop::ScheduleNext()
@@ -52,28 +68,43 @@ namespace NanoBanana::Http
             OnProgress(FMath::Clamp((float)(Elapsed / FMath::Max(1.0f, MaxTotalSeconds)), 0.0f, 1.0f));
         }
 
-        TWeakPtr<FPollLoop, ESPMode::ThreadSafe> WeakThis = AsShared();
-        const float Delay = NextDelay;
-        NextDelay = FMath::Min(MaxDelaySeconds, NextDelay * BackoffMultiplier);
+        float Delay = NextDelay;
+        if (!TryPlanDelay(Elapsed, Delay))
+        {
+            NextDelay = FMath::Min(MaxDelaySeconds, NextDelay * BackoffMultiplier);
+        }
+        // Never plan past the deadline; the last poll lands on it.
+        Delay = FMath::Min(Delay, FMath::Max(0.1f, MaxTotalSeconds - (float)Elapsed));
+        FPollScheduler::Get().Schedule(AsShared(), Delay);
+    }
 
-        TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda(
-            [WeakThis](float /*Dt*/) -> bool
-            {
-                if (TSharedPtr<FPollLoop, ESPMode::ThreadSafe> Pinned = WeakThis.Pin())
-                {
-                    Pinned->TickerHandle.Reset();
-                    Pinned->IssueRequest();
-                }
-                return false; // one-shot
-            }), Delay);
+    bool FPollLoop::TryPlanDelay(double Elapsed, float& OutDelay) const
+    {
+        if (LatencyKey.IsEmpty() || !GetDefault<UNanoBananaSettings>()->bAdaptivePollIntervals) return false;
+        return FPollLatencyModel::Get().TryPlanDelay(LatencyKey, Elapsed, MaxDelaySeconds, OutDelay);
+    }
+
+    void FPollLoop::RecordCompletion()
+    {
+        if (LatencyKey.IsEmpty()) return;
+        // The job finished somewhere between the last "not done" answer and this one.
+        const double DetectedAt = FPlatformTime::Seconds() - StartTime;
+        const double CompletedAt = LastPendingAt >= 0.0 ? 0.5 * (LastPendingAt + DetectedAt) : DetectedAt;
+        FPollLatencyModel::Get().RecordCompletion(LatencyKey, CompletedAt, DetectedAt, NumPolls,
+            InitialDelaySeconds, MaxDelaySeconds, BackoffMultiplier);
     }
 
     void FPollLoop::IssueRequest()
     {
-        if (bDone || bCanceled || !RequestFactory) return;
+        if (bDone || bCanceled || !RequestFactory)
+        {
+            ReleaseSlot();
+            return;
+        }
 
         TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Req = RequestFactory();
         InFlight = Req;
+        ++NumPolls;
 
         TWeakPtr<FPollLoop, ESPMode::ThreadSafe> WeakThis = AsShared();
         Req->OnProcessRequestComplete().BindLambda(
@@ -83,6 +114,7 @@ namespace NanoBanana::Http
                 if (!Pinned.IsValid() || Pinned->bDone || Pinned->bCanceled) return;
 
                 Pinned->InFlight.Reset();
+                Pinned->ReleaseSlot();
 
                 if (!bSucceeded || !Resp.IsValid())
                 {
@@ -92,19 +124,20 @@ namespace NanoBanana::Http
                 }
 
                 const int32 Code = Resp->GetResponseCode();
-                const FString Body = Resp->GetContentAsString();
+                const FSharedText Body = MakeSharedText(Resp->GetContentAsString());
 
                 FString Err;
                 EPollDecision Decision = EPollDecision::Continue;
                 if (Pinned->DecideFn)
                 {
-                    Decision = Pinned->DecideFn(Code, Body, Err);
+                    Decision = Pinned->DecideFn(Code, *Body, Err);
                 }
 
                 switch (Decision)
                 {
                 case EPollDecision::Succeeded:
                     Pinned->bDone = true;
+                    Pinned->RecordCompletion();
                     if (Pinned->OnSucceeded) Pinned->OnSucceeded(Body);
                     break;
                 case EPollDecision::Failed:
@@ -113,6 +146,7 @@ namespace NanoBanana::Http
                     break;
                 case EPollDecision::Continue:
                 default:
+                    Pinned->LastPendingAt = FPlatformTime::Seconds() - Pinned->StartTime;
                     Pinned->ScheduleNext();
                     break;
                 }
@@ -120,9 +154,4 @@ namespace NanoBanana::Http
 
         Req->ProcessRequest();
     }
-
-    bool FPollLoop::TickPoll(float /*Dt*/)
-    {
-        return false;
-    }
 }
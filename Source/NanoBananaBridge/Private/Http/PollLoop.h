@@ -1,12 +1,13 @@
 // Generic exponential-backoff HTTP GET poll loop used by FAL queue polling and
-// Replicate prediction polling. Lifetime is owned by the caller's TSharedPtr.
+// Replicate prediction polling. Lifetime is owned by the caller's TSharedPtr; the waits
+// between polls are run by the shared FPollScheduler.
 #pragma once
 
 #include "CoreMinimal.h"
 #include "Templates/SharedPointer.h"
 #include "Templates/Function.h"
-#include "Containers/Ticker.h"
 #include "Interfaces/IHttpRequest.h"
+#include "SharedPayload.h"
 
 namespace NanoBanana::Http
 {
@@ -20,7 +21,8 @@ namespace NanoBanana::Http
 
     /**
      * Polls a URL until the user-supplied DecideFn returns Succeeded/Failed
-     * or MaxSeconds elapses. Backs off exponentially from InitialDelay to MaxDelay.
+     * or MaxSeconds elapses. Backs off exponentially from InitialDelay to MaxDelay
+     * (jittered by the scheduler), and waits for a free per-vendor slot before each poll.
      */
     class FPollLoop : public TSharedFromThis<FPollLoop, ESPMode::ThreadSafe>
     {
@@ -34,10 +36,22 @@ namespace NanoBanana::Http
         /** Inspect a response body + status code; decide whether to continue or stop. */
         TFunction<EPollDecision(int32 /*HttpStatus*/, const FString& /*Body*/, FString& /*OutError*/)> DecideFn;
 
-        TFunction<void(const FString& /*FinalBody*/)> OnSucceeded;
+        /** The final body is shared, so handlers can hand it to a worker without copying. */
+        TFunction<void(const FSharedText& /*FinalBody*/)> OnSucceeded;
         TFunction<void(const FString& /*Error*/)> OnFailed;
         TFunction<void(float /*FractionElapsed*/)> OnProgress;
 
+        /** Groups loops for FPollScheduler's per-vendor concurrency cap. */
+        FName Vendor;
+
+        /**
+         * FPollLatencyModel key (vendor/model/resolution). When set, completions are learned
+         * and, once the estimate is trusted, polls follow it instead of the fixed backoff.
+         */
+        FString LatencyKey;
+
+        /** Wait before the first request when no learned plan applies (0 = poll right away). */
+        float StartDelaySeconds = 0.0f;
         float InitialDelaySeconds = 1.0f;
         float MaxDelaySeconds = 5.0f;
         float MaxTotalSeconds = 120.0f;
@@ -46,17 +60,28 @@ namespace NanoBanana::Http
         void Start();
         void Cancel();
 
+        bool IsActive() const { return !bDone && !bCanceled; }
+
     private:
+        friend class FPollScheduler;
+
         void ScheduleNext();
-        bool TickPoll(float Dt);
         void IssueRequest();
+        void ReleaseSlot();
+        /** Model-planned delay, or false to use the fixed backoff. */
+        bool TryPlanDelay(double Elapsed, float& OutDelay) const;
+        void RecordCompletion();
 
-        FTSTicker::FDelegateHandle TickerHandle;
         TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> InFlight;
 
         double StartTime = 0.0;
         float NextDelay = 1.0f;
+        int32 NumPolls = 0;
+        /** Elapsed seconds when the last "not done yet" response came back; -1 before that. */
+        double LastPendingAt = -1.0;
         bool bCanceled = false;
         bool bDone = false;
+        /** Set by the scheduler while this loop's request counts against its vendor cap. */
+        bool bHoldingSlot = false;
     };
 }
@@ -0,0 +1,259 @@
+#include "PollScheduler.h"
+#include "PollLoop.h"
+#include "NanoBananaLog.h"
+#include "NanoBananaSettings.h"
+#include "HAL/IConsoleManager.h"
+
+namespace NanoBanana::Http
+{
+    namespace
+    {
+        FAutoConsoleCommand DumpStatsCommand(
+            TEXT("NanoBanana.PollScheduler.Stats"),
+            TEXT("Logs queue depth, in-flight status requests per vendor and poll rate of the shared poll scheduler."),
+            FConsoleCommandDelegate::CreateLambda([]()
+            {
+                const FPollSchedulerStats S = FPollScheduler::Get().GetStats();
+                UE_LOG(LogNanoBanana, Display, TEXT("Poll scheduler: %d scheduled, %d ready, %d in flight, %lld polls total, %.2f polls/s"),
+                    S.Scheduled, S.Ready, S.InFlight, S.TotalPolls, S.PollsPerSecond);
+                for (const TPair<FName, int32>& Pair : S.InFlightByVendor)
+                {
+                    const int32* NumReady = S.ReadyByVendor.Find(Pair.Key);
+                    UE_LOG(LogNanoBanana, Display, TEXT("  %s: %d in flight, %d ready"), *Pair.Key.ToString(), Pair.Value, NumReady ? *NumReady : 0);
+                }
+            }));
+    }
+
+    // ---------------------------------------------------------------- Timer wheel
+
+    FPollTimerWheel::FPollTimerWheel(double InResolutionSeconds, int32 InNumSlots)
+        : Resolution(FMath::Max(0.001, InResolutionSeconds))
+    {
+        Slots.SetNum(FMath::Max(1, InNumSlots));
+    }
+
+    void FPollTimerWheel::Reset(double Now)
+    {
+        for (TArray<FEntry>& Slot : Slots)
+        {
+            Slot.Reset();
+        }
+        NumEntries = 0;
+        CurrentTick = (int64)FMath::FloorToDouble(Now / Resolution);
+    }
+
+    void FPollTimerWheel::Add(uint32 Id, double DueTime)
+    {
+        // Round up so an entry never fires before its due time; nothing lands in the
+        // current (already processed) tick.
+        const int64 DueTick = FMath::Max<int64>((int64)FMath::CeilToDouble(DueTime / Resolution), CurrentTick + 1);
+        Slots[(int32)(DueTick % Slots.Num())].Add({ Id, DueTick });
+        ++NumEntries;
+    }
+
+    void FPollTimerWheel::Advance(double Now, TArray<uint32>& OutDue)
+    {
+        const int64 Target = (int64)FMath::FloorToDouble(Now / Resolution);
+        if (Target <= CurrentTick) return;
+
+        // After a long stall every slot is visited once; entries remember their own tick, so
+        // visiting a slot fewer times than it wrapped loses nothing.
+        const int64 Steps = FMath::Min<int64>(Target - CurrentTick, Slots.Num());
+        for (int64 Step = 1; Step <= Steps; ++Step)
+        {
+            TArray<FEntry>& Slot = Slots[(int32)((CurrentTick + Step) % Slots.Num())];
+            for (int32 i = 0; i < Slot.Num(); )
+            {
+                if (Slot[i].DueTick <= Target)
+                {
+                    OutDue.Add(Slot[i].Id);
+                    Slot.RemoveAtSwap(i, 1, EAllowShrinking::No);
+                    --NumEntries;
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+        }
+        CurrentTick = Target;
+    }
+
+    // ---------------------------------------------------------------- Scheduler
+
+    namespace
+    {
+        bool IsLive(const TWeakPtr<FPollLoop, ESPMode::ThreadSafe>& Weak, TSharedPtr<FPollLoop, ESPMode::ThreadSafe>& OutLoop)
+        {
+            OutLoop = Weak.Pin();
+            return OutLoop.IsValid() && OutLoop->IsActive();
+        }
+    }
+
+    FPollScheduler::FPollScheduler() = default;
+
+    FPollScheduler& FPollScheduler::Get()
+    {
+        static FPollScheduler Instance;
+        return Instance;
+    }
+
+    void FPollScheduler::Schedule(const TSharedRef<FPollLoop, ESPMode::ThreadSafe>& Loop, float DelaySeconds)
+    {
+        check(IsInGameThread());
+
+        if (DelaySeconds <= 0.0f)
+        {
+            Ready.FindOrAdd(Loop->Vendor).Add(Loop);
+            Dispatch();
+            return;
+        }
+
+        // Jobs submitted together would otherwise poll in lockstep for their whole lifetime.
+        const float Jitter = FMath::Clamp(GetDefault<UNanoBananaSettings>()->PollJitterFraction, 0.0f, 0.5f);
+        const float Delay = DelaySeconds * (1.0f + FMath::FRandRange(-Jitter, Jitter));
+
+        const double Now = FPlatformTime::Seconds();
+        if (Wheel.Num() == 0)
+        {
+            Wheel.Reset(Now);
+        }
+        const uint32 Id = NextId++;
+        Waiting.Add(Id, Loop);
+        Wheel.Add(Id, Now + Delay);
+        EnsureTicker();
+    }
+
+    void FPollScheduler::Release(FName Vendor)
+    {
+        if (int32* Count = InFlight.Find(Vendor))
+        {
+            *Count = FMath::Max(0, *Count - 1);
+        }
+        Dispatch();
+    }
+
+    void FPollScheduler::Dispatch()
+    {
+        // IssueRequest can re-enter (a request failing synchronously releases its slot, and the
+        // failure handler may start another job); the outer pass keeps going until no vendor
+        // can make progress, so nothing freed meanwhile is missed.
+        if (bDispatching || Ready.Num() == 0) return;
+        TGuardValue<bool> Guard(bDispatching, true);
+
+        const int32 Cap = FMath::Max(1, GetDefault<UNanoBananaSettings>()->MaxConcurrentPollsPerVendor);
+        bool bProgress = true;
+        while (bProgress)
+        {
+            bProgress = false;
+            TArray<FName> Vendors;
+            Ready.GenerateKeyArray(Vendors);
+            for (const FName Vendor : Vendors)
+            {
+                TArray<TWeakPtr<FPollLoop, ESPMode::ThreadSafe>>* Queue = Ready.Find(Vendor);
+                if (!Queue || Queue->Num() == 0 || InFlight.FindRef(Vendor) >= Cap) continue;
+
+                const TWeakPtr<FPollLoop, ESPMode::ThreadSafe> Weak = (*Queue)[0];
+                Queue->RemoveAt(0, 1, EAllowShrinking::No);
+                bProgress = true;
+
+                TSharedPtr<FPollLoop, ESPMode::ThreadSafe> Loop;
+                if (!IsLive(Weak, Loop)) continue;
+
+                const double Now = FPlatformTime::Seconds();
+                ++InFlight.FindOrAdd(Vendor);
+                ++TotalPolls;
+                TrimRate(Now);
+                RecentPolls.Add(Now);
+                Loop->bHoldingSlot = true;
+                Loop->IssueRequest();
+            }
+        }
+    }
+
+    bool FPollScheduler::Tick(float /*DeltaTime*/)
+    {
+        TArray<uint32> Due;
+        Wheel.Advance(FPlatformTime::Seconds(), Due);
+        for (uint32 Id : Due)
+        {
+            TWeakPtr<FPollLoop, ESPMode::ThreadSafe> Weak;
+            if (!Waiting.RemoveAndCopyValue(Id, Weak)) continue;
+
+            TSharedPtr<FPollLoop, ESPMode::ThreadSafe> Loop;
+            if (IsLive(Weak, Loop))
+            {
+                Ready.FindOrAdd(Loop->Vendor).Add(Weak);
+            }
+        }
+        if (Due.Num() > 0)
+        {
+            Dispatch();
+        }
+
+        if (Wheel.Num() > 0) return true;
+        TickerHandle.Reset();
+        return false;
+    }
+
+    void FPollScheduler::EnsureTicker()
+    {
+        if (TickerHandle.IsValid()) return;
+        // Ticks every frame while anything is scheduled; the wheel makes an idle frame O(1).
+        TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FPollScheduler::Tick));
+    }
+
+    void FPollScheduler::TrimRate(double Now) const
+    {
+        int32 NumExpired = 0;
+        while (NumExpired < RecentPolls.Num() && Now - RecentPolls[NumExpired] > RateWindowSeconds)
+        {
+            ++NumExpired;
+        }
+        RecentPolls.RemoveAt(0, NumExpired, EAllowShrinking::No);
+    }
+
+    FPollSchedulerStats FPollScheduler::GetStats() const
+    {
+        FPollSchedulerStats S;
+        TSharedPtr<FPollLoop, ESPMode::ThreadSafe> Loop;
+        for (const TPair<uint32, TWeakPtr<FPollLoop, ESPMode::ThreadSafe>>& Pair : Waiting)
+        {
+            if (IsLive(Pair.Value, Loop)) ++S.Scheduled;
+        }
+        for (const TPair<FName, TArray<TWeakPtr<FPollLoop, ESPMode::ThreadSafe>>>& Pair : Ready)
+        {
+            int32 NumReady = 0;
+            for (const TWeakPtr<FPollLoop, ESPMode::ThreadSafe>& Weak : Pair.Value)
+            {
+                if (IsLive(Weak, Loop)) ++NumReady;
+            }
+            S.ReadyByVendor.Add(Pair.Key, NumReady);
+            S.Ready += NumReady;
+        }
+        for (const TPair<FName, int32>& Pair : InFlight)
+        {
+            S.InFlightByVendor.Add(Pair.Key, Pair.Value);
+            S.InFlight += Pair.Value;
+        }
+
+        TrimRate(FPlatformTime::Seconds());
+        S.TotalPolls = TotalPolls;
+        S.PollsPerSecond = (float)(RecentPolls.Num() / RateWindowSeconds);
+        return S;
+    }
+
+    void FPollScheduler::Shutdown()
+    {
+        if (TickerHandle.IsValid())
+        {
+            FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+            TickerHandle.Reset();
+        }
+        Wheel.Reset(0.0);
+        Waiting.Reset();
+        Ready.Reset();
+        InFlight.Reset();
+        RecentPolls.Reset();
+    }
+}
@@ -0,0 +1,110 @@
+// Process-wide scheduler for status polls. Every FPollLoop (FAL queue jobs, Replicate
+// predictions) is multiplexed onto one core ticker and one timer wheel; the scheduler caps
+// concurrent status requests per vendor and spreads poll times with jitter.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/SharedPointer.h"
+#include "Containers/Ticker.h"
+
+namespace NanoBanana::Http
+{
+    class FPollLoop;
+
+    /**
+     * Hashed timing wheel: O(1) insert, and advancing touches only the slots that elapsed.
+     * Entries further out than one revolution stay in their slot until their tick comes
+     * round. An entry fires at the first tick boundary at or after its due time.
+     */
+    class FPollTimerWheel
+    {
+    public:
+        explicit FPollTimerWheel(double InResolutionSeconds = 0.05, int32 InNumSlots = 512);
+
+        /** Starts the wheel at Now; entries due earlier fire on the next Advance. */
+        void Reset(double Now);
+
+        void Add(uint32 Id, double DueTime);
+
+        /** Appends every entry due at or before Now to OutDue. */
+        void Advance(double Now, TArray<uint32>& OutDue);
+
+        int32 Num() const { return NumEntries; }
+        double GetResolution() const { return Resolution; }
+
+    private:
+        struct FEntry
+        {
+            uint32 Id;
+            int64 DueTick;
+        };
+
+        TArray<TArray<FEntry>> Slots;
+        double Resolution;
+        int64 CurrentTick = 0;
+        int32 NumEntries = 0;
+    };
+
+    struct FPollSchedulerStats
+    {
+        /** Polls waiting in the timer wheel. */
+        int32 Scheduled = 0;
+        /** Polls that are due but waiting for a per-vendor slot. */
+        int32 Ready = 0;
+        /** Status requests currently in flight. */
+        int32 InFlight = 0;
+        TMap<FName, int32> InFlightByVendor;
+        TMap<FName, int32> ReadyByVendor;
+        /** Status requests issued since startup. */
+        int64 TotalPolls = 0;
+        /** Requests per second over the last RateWindowSeconds. */
+        float PollsPerSecond = 0.0f;
+    };
+
+    /**
+     * Game thread only. Loops hand themselves over with Schedule() and get IssueRequest()
+     * called once a delay has elapsed and their vendor has a free slot; they give the slot
+     * back with Release() when the request completes or is canceled.
+     */
+    class FPollScheduler
+    {
+    public:
+        /** Window for FPollSchedulerStats::PollsPerSecond. */
+        static constexpr double RateWindowSeconds = 10.0;
+
+        static FPollScheduler& Get();
+
+        /** Queue Loop's next poll DelaySeconds from now (jittered); 0 polls as soon as a slot is free. */
+        void Schedule(const TSharedRef<FPollLoop, ESPMode::ThreadSafe>& Loop, float DelaySeconds);
+
+        /** A poll request for Vendor finished; frees its slot and dispatches waiting polls. */
+        void Release(FName Vendor);
+
+        FPollSchedulerStats GetStats() const;
+
+        /** Module shutdown: drops all pending polls and the ticker. */
+        void Shutdown();
+
+    private:
+        FPollScheduler();
+
+        bool Tick(float DeltaTime);
+        void Dispatch();
+        void EnsureTicker();
+        void TrimRate(double Now) const;
+
+        FPollTimerWheel Wheel;
+        /** Scheduled polls by wheel id; a canceled or destroyed loop is skipped when its id fires. */
+        TMap<uint32, TWeakPtr<FPollLoop, ESPMode::ThreadSafe>> Waiting;
+        uint32 NextId = 1;
+
+        /** Due polls per vendor, oldest first. */
+        TMap<FName, TArray<TWeakPtr<FPollLoop, ESPMode::ThreadSafe>>> Ready;
+        TMap<FName, int32> InFlight;
+
+        FTSTicker::FDelegateHandle TickerHandle;
+        bool bDispatching = false;
+        int64 TotalPolls = 0;
+        mutable TArray<double> RecentPolls;
+    };
+}
@@ -0,0 +1,115 @@
+#include "ReferenceCache.h"
+#include "NanoBananaLog.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+
+namespace NanoBanana::Image
+{
+    namespace
+    {
+        // Entry-count ceiling for the underlying TLruCache. Eviction is driven by bytes; this
+        // only has to be large enough that TLruCache never evicts on its own behind our back.
+        constexpr int32 MaxEntries = 1024;
+
+        int64 EntryBytes(const TSharedPtr<const FEncodedReference, ESPMode::ThreadSafe>& Ref)
+        {
+            return Ref.IsValid() ? (int64)Ref->GetAllocatedSize() : 0;
+        }
+
+        FAutoConsoleCommand DumpStatsCommand(
+            TEXT("NanoBanana.ReferenceCache.Stats"),
+            TEXT("Logs hit/miss/byte counters of the encoded reference-image cache."),
+            FConsoleCommandDelegate::CreateLambda([]()
+            {
+                const FReferenceCacheStats S = FReferenceCache::Get().GetStats();
+                UE_LOG(LogNanoBanana, Display, TEXT("Reference cache: %d entries, %.1f MB resident, %lld hits, %lld misses, %lld evictions, %.1f MB served from cache"),
+                    S.NumEntries, S.ResidentBytes / (1024.0 * 1024.0), S.Hits, S.Misses, S.Evictions, S.BytesServed / (1024.0 * 1024.0));
+            }));
+
+        FAutoConsoleCommand ClearCommand(
+            TEXT("NanoBanana.ReferenceCache.Clear"),
+            TEXT("Empties the encoded reference-image cache."),
+            FConsoleCommandDelegate::CreateLambda([]()
+            {
+                FReferenceCache::Get().Empty();
+            }));
+    }
+
+    FReferenceCache::FReferenceCache(int64 InBudgetBytes)
+        : Entries(MaxEntries)
+        , BudgetBytes(FMath::Max<int64>(0, InBudgetBytes))
+    {
+    }
+
+    FReferenceCache& FReferenceCache::Get()
+    {
+        // Budget is applied from settings by FReferencePreparer::Start before each use.
+        static FReferenceCache Instance(0);
+        return Instance;
+    }
+
+    void FReferenceCache::SetBudgetBytes(int64 InBudgetBytes)
+    {
+        FScopeLock ScopeLock(&Lock);
+        BudgetBytes = FMath::Max<int64>(0, InBudgetBytes);
+        EvictToFit(0);
+    }
+
+    TSharedPtr<const FEncodedReference, ESPMode::ThreadSafe> FReferenceCache::Find(uint64 Key)
+    {
+        FScopeLock ScopeLock(&Lock);
+        if (const TSharedPtr<const FEncodedReference, ESPMode::ThreadSafe>* Found = Entries.FindAndTouch(Key))
+        {
+            ++Stats.Hits;
+            Stats.BytesServed += (*Found)->Bytes.Num();
+            return *Found;
+        }
+        ++Stats.Misses;
+        return nullptr;
+    }
+
+    void FReferenceCache::Add(uint64 Key, const FEncodedReferenceRef& Ref)
+    {
+        const int64 Bytes = EntryBytes(Ref);
+
+        FScopeLock ScopeLock(&Lock);
+        if (Bytes > BudgetBytes)
+        {
+            return; // Too large to ever fit (or caching disabled).
+        }
+        if (const TSharedPtr<const FEncodedReference, ESPMode::ThreadSafe>* Existing = Entries.Find(Key))
+        {
+            Stats.ResidentBytes -= EntryBytes(*Existing);
+            Entries.Remove(Key);
+        }
+        EvictToFit(Bytes);
+        Entries.Add(Key, Ref);
+        Stats.ResidentBytes += Bytes;
+    }
+
+    void FReferenceCache::Empty()
+    {
+        FScopeLock ScopeLock(&Lock);
+        Entries.Empty(MaxEntries);
+        Stats.ResidentBytes = 0;
+    }
+
+    FReferenceCacheStats FReferenceCache::GetStats() const
+    {
+        FScopeLock ScopeLock(&Lock);
+        FReferenceCacheStats Out = Stats;
+        Out.NumEntries = Entries.Num();
+        return Out;
+    }
+
+    void FReferenceCache::EvictToFit(int64 IncomingBytes)
+    {
+        while (Entries.Num() > 0
+            && (Stats.ResidentBytes + IncomingBytes > BudgetBytes || Entries.Num() >= Entries.Max()))
+        {
+            const TSharedPtr<const FEncodedReference, ESPMode::ThreadSafe> Evicted = Entries.RemoveLeastRecent();
+            Stats.ResidentBytes -= EntryBytes(Evicted);
+            ++Stats.Evictions;
+        }
+    }
+}
@@ -0,0 +1,57 @@
+// Bounded, content-addressed LRU cache of encoded reference images. Lets repeated
+// requests (variations, retries) reuse PNG bytes + base64 data URIs without re-encoding.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/LruCache.h"
+#include "HAL/CriticalSection.h"
+#include "Base64Image.h"
+
+namespace NanoBanana::Image
+{
+    struct FReferenceCacheStats
+    {
+        int64 Hits = 0;
+        int64 Misses = 0;
+        int64 Evictions = 0;
+        /** Bytes currently held (encoded bytes + data URI). */
+        int64 ResidentBytes = 0;
+        /** Encoded bytes handed out from cache instead of being re-encoded. */
+        int64 BytesServed = 0;
+        int32 NumEntries = 0;
+    };
+
+    /**
+     * Thread-safe LRU keyed by a 64-bit content hash (source pixels, or path + mtime + size
+     * for files). Entries are evicted least-recently-used first once ResidentBytes exceeds
+     * the budget; a budget of 0 disables caching.
+     */
+    class FReferenceCache
+    {
+    public:
+        explicit FReferenceCache(int64 InBudgetBytes);
+
+        /** Process-wide instance used by FReferencePreparer. */
+        static FReferenceCache& Get();
+
+        void SetBudgetBytes(int64 InBudgetBytes);
+
+        /** Returns the cached reference and marks it most-recently-used, or nullptr on miss. */
+        TSharedPtr<const FEncodedReference, ESPMode::ThreadSafe> Find(uint64 Key);
+
+        /** Inserts (or replaces) an entry, evicting older ones to stay within budget. */
+        void Add(uint64 Key, const FEncodedReferenceRef& Ref);
+
+        void Empty();
+
+        FReferenceCacheStats GetStats() const;
+
+    private:
+        void EvictToFit(int64 IncomingBytes);
+
+        mutable FCriticalSection Lock;
+        TLruCache<uint64, TSharedPtr<const FEncodedReference, ESPMode::ThreadSafe>> Entries;
+        int64 BudgetBytes = 0;
+        FReferenceCacheStats Stats;
+    };
+}
@@ -0,0 +1,358 @@
+#include "ReferencePreparer.h"
+#include "ReferenceCache.h"
+#include "ImageResample.h"
+#include "NanoBananaSettings.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "Modules/ModuleManager.h"
+#include "PixelFormat.h"
+#include "TextureResource.h"
+#include "Async/Async.h"
+#include "Tasks/Task.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "Hash/xxhash.h"
+
+namespace NanoBanana::Image
+{
+    bool SnapshotTexture(const UTexture2D* Texture, FReferenceSnapshot& Out)
+    {
+        check(IsInGameThread());
+        if (!Texture)
+        {
+            return false;
+        }
+
+        // Same constraints as TextureToPng: mip-0 readback of uncompressed 8-bit textures only.
+        FTexturePlatformData* PD = const_cast<UTexture2D*>(Texture)->GetPlatformData();
+        if (!PD || PD->Mips.Num() == 0)
+        {
+            return false;
+        }
+        const EPixelFormat Fmt = Texture->GetPixelFormat();
+        if (Fmt != PF_B8G8R8A8 && Fmt != PF_R8G8B8A8)
+        {
+            return false;
+        }
+
+        FTexture2DMipMap& Mip = PD->Mips[0];
+        const int32 W = Mip.SizeX;
+        const int32 H = Mip.SizeY;
+        const FColor* Data = static_cast<const FColor*>(Mip.BulkData.LockReadOnly());
+        if (!Data)
+        {
+            return false;
+        }
+
+        Out.Size = FIntPoint(W, H);
+        Out.Pixels.SetNumUninitialized(W * H);
+        if (Fmt == PF_B8G8R8A8)
+        {
+            FMemory::Memcpy(Out.Pixels.GetData(), Data, (SIZE_T)W * H * sizeof(FColor));
+        }
+        else
+        {
+            // RGBA8 in memory: FColor's R/B members land swapped, so swizzle while copying.
+            for (int32 i = 0; i < W * H; ++i)
+            {
+                const FColor& C = Data[i];
+                Out.Pixels[i] = FColor(C.B, C.G, C.R, C.A);
+            }
+        }
+
+        Mip.BulkData.Unlock();
+        return true;
+    }
+
+    bool SnapshotRenderTarget(UTextureRenderTarget2D* RT, FReferenceSnapshot& Out, bool bSRGB)
+    {
+        check(IsInGameThread());
+        if (!RT)
+        {
+            return false;
+        }
+        FTextureRenderTargetResource* RTResource = RT->GameThread_GetRenderTargetResource();
+        if (!RTResource)
+        {
+            return false;
+        }
+
+        FReadSurfaceDataFlags ReadPixelFlags(RCM_UNorm);
+        ReadPixelFlags.SetLinearToGamma(bSRGB);
+        if (!RTResource->ReadPixels(Out.Pixels, ReadPixelFlags))
+        {
+            return false;
+        }
+        Out.Size = FIntPoint(RT->SizeX, RT->SizeY);
+        return Out.HasPixels();
+    }
+
+    bool SnapshotReference(const FNanoBananaReferenceImage& Ref, FReferenceSnapshot& Out)
+    {
+        if (Ref.Texture && SnapshotTexture(Ref.Texture, Out))
+        {
+            return true;
+        }
+        if (Ref.RenderTarget && SnapshotRenderTarget(Ref.RenderTarget, Out, /*bSRGB*/ true))
+        {
+            return true;
+        }
+        if (!Ref.FilePath.IsEmpty())
+        {
+            Out.FilePath = Ref.FilePath;
+            return true;
+        }
+        return false;
+    }
+
+    int32 GetReferenceMaxDimension(const FNanoBananaRequest& Request)
+    {
+        bool bDownscale = false;
+        switch (Request.ReferenceScaling)
+        {
+            case ENanoBananaReferenceScaling::FitToResolution: bDownscale = true; break;
+            case ENanoBananaReferenceScaling::Original:        bDownscale = false; break;
+            default: bDownscale = UNanoBananaSettings::Get().bDownscaleReferencesToResolution; break;
+        }
+        return bDownscale ? FNanoBananaTypeUtils::ResolutionToPixels(Request.Resolution) : 0;
+    }
+
+    /**
+     * Re-encode a file's bytes with the snapshot's profile when they exceed MaxDimension, or
+     * when they are PNG and the profile is lossy. Leaves Bytes alone otherwise.
+     */
+    static void TranscodeFileBytes(IImageWrapperModule& ImageWrapper, const FReferenceSnapshot& Snapshot, TArray<uint8>& Bytes)
+    {
+        const EImageFormat Format = ImageWrapper.DetectImageFormat(Bytes.GetData(), Bytes.Num());
+        TSharedPtr<IImageWrapper> Wrapper = Format != EImageFormat::Invalid ? ImageWrapper.CreateImageWrapper(Format) : nullptr;
+        if (!Wrapper.IsValid() || !Wrapper->SetCompressed(Bytes.GetData(), Bytes.Num()))
+        {
+            return; // unknown format: send as-is and let the vendor decide
+        }
+
+        const FIntPoint SrcSize((int32)Wrapper->GetWidth(), (int32)Wrapper->GetHeight());
+        const bool bResize = ComputeFitSize(SrcSize, Snapshot.MaxDimension) != SrcSize;
+        const bool bTranscode = Snapshot.Profile.IsLossy() && Format == EImageFormat::PNG;
+        if (!bResize && !bTranscode)
+        {
+            return; // already small enough and in a good format; keep the original encoding
+        }
+
+        TArray64<uint8> Raw;
+        if (!Wrapper->GetRaw(ERGBFormat::BGRA, 8, Raw) || Raw.Num() != (int64)SrcSize.X * SrcSize.Y * sizeof(FColor))
+        {
+            return;
+        }
+
+        const TConstArrayView<FColor> Pixels(reinterpret_cast<const FColor*>(Raw.GetData()), SrcSize.X * SrcSize.Y);
+        TArray<FColor> Scaled;
+        FIntPoint ScaledSize;
+        TArray<uint8> Encoded = DownscaleToFit(Pixels, SrcSize, Snapshot.MaxDimension, Scaled, ScaledSize)
+            ? EncodeForUpload(ImageWrapper, Scaled, ScaledSize, Snapshot.Profile)
+            : EncodeForUpload(ImageWrapper, Pixels, SrcSize, Snapshot.Profile);
+
+        // A pure transcode that doesn't shrink the payload isn't worth the quality loss.
+        if (Encoded.Num() > 0 && (bResize || Encoded.Num() < Bytes.Num()))
+        {
+            Bytes = MoveTemp(Encoded);
+        }
+    }
+
+    TSharedPtr<const FEncodedReference, ESPMode::ThreadSafe> EncodeSnapshot(IImageWrapperModule& ImageWrapper, const FReferenceSnapshot& Snapshot)
+    {
+        TArray<uint8> Bytes;
+        if (Snapshot.HasPixels())
+        {
+            TArray<FColor> Scaled;
+            FIntPoint ScaledSize;
+            if (DownscaleToFit(Snapshot.Pixels, Snapshot.Size, Snapshot.MaxDimension, Scaled, ScaledSize))
+            {
+                Bytes = EncodeForUpload(ImageWrapper, Scaled, ScaledSize, Snapshot.Profile);
+            }
+            else
+            {
+                Bytes = EncodeForUpload(ImageWrapper, Snapshot.Pixels, Snapshot.Size, Snapshot.Profile);
+            }
+        }
+        else if (!Snapshot.FilePath.IsEmpty())
+        {
+            FFileHelper::LoadFileToArray(Bytes, *Snapshot.FilePath);
+            if (Bytes.Num() > 0)
+            {
+                TranscodeFileBytes(ImageWrapper, Snapshot, Bytes);
+            }
+        }
+
+        if (Bytes.Num() == 0)
+        {
+            return nullptr;
+        }
+        return MakeEncodedReference(MoveTemp(Bytes));
+    }
+
+    bool ComputeSnapshotKey(const FReferenceSnapshot& Snapshot, uint64& OutKey)
+    {
+        FXxHash64Builder Builder;
+        if (Snapshot.HasPixels())
+        {
+            const uint8 Tag = 'P';
+            Builder.Update(&Tag, sizeof(Tag));
+            Builder.Update(&Snapshot.Size, sizeof(Snapshot.Size));
+            Builder.Update(Snapshot.Pixels.GetData(), (uint64)Snapshot.Pixels.Num() * sizeof(FColor));
+        }
+        else if (!Snapshot.FilePath.IsEmpty())
+        {
+            const FFileStatData Stat = IFileManager::Get().GetStatData(*Snapshot.FilePath);
+            if (!Stat.bIsValid || Stat.bIsDirectory)
+            {
+                return false;
+            }
+            const uint8 Tag = 'F';
+            const FString FullPath = FPaths::ConvertRelativePathToFull(Snapshot.FilePath);
+            const int64 Ticks = Stat.ModificationTime.GetTicks();
+            Builder.Update(&Tag, sizeof(Tag));
+            Builder.Update(*FullPath, FullPath.Len() * sizeof(TCHAR));
+            Builder.Update(&Ticks, sizeof(Ticks));
+            Builder.Update(&Stat.FileSize, sizeof(Stat.FileSize));
+        }
+        else
+        {
+            return false;
+        }
+        if (Snapshot.MaxDimension > 0)
+        {
+            // Same content sent at a different size is a different payload.
+            Builder.Update(&Snapshot.MaxDimension, sizeof(Snapshot.MaxDimension));
+        }
+        const uint8 Encoding = (uint8)Snapshot.Profile.Encoding;
+        const int32 Quality = Snapshot.Profile.IsLossy() ? Snapshot.Profile.Quality : 0;
+        Builder.Update(&Encoding, sizeof(Encoding));
+        Builder.Update(&Quality, sizeof(Quality));
+        OutKey = Builder.Finalize().Hash;
+        return true;
+    }
+
+    static TSharedPtr<const FEncodedReference, ESPMode::ThreadSafe> EncodeSnapshotCached(IImageWrapperModule& ImageWrapper, const FReferenceSnapshot& Snapshot)
+    {
+        FReferenceCache& Cache = FReferenceCache::Get();
+        uint64 Key = 0;
+        const bool bHasKey = ComputeSnapshotKey(Snapshot, Key);
+        if (bHasKey)
+        {
+            if (TSharedPtr<const FEncodedReference, ESPMode::ThreadSafe> Hit = Cache.Find(Key))
+            {
+                return Hit;
+            }
+        }
+
+        TSharedPtr<const FEncodedReference, ESPMode::ThreadSafe> Encoded = EncodeSnapshot(ImageWrapper, Snapshot);
+        if (bHasKey && Encoded.IsValid())
+        {
+            // Freshly built and not yet shared, so stamping the key is still safe.
+            ConstCastSharedPtr<FEncodedReference>(Encoded)->ContentHash = Key;
+            Cache.Add(Key, Encoded.ToSharedRef());
+        }
+        return Encoded;
+    }
+
+    TSharedRef<FReferencePreparer, ESPMode::ThreadSafe> FReferencePreparer::Start(const FNanoBananaRequest& Request, bool bHashMask, FOnReady InOnReady)
+    {
+        check(IsInGameThread());
+        TSharedRef<FReferencePreparer, ESPMode::ThreadSafe> Prep = MakeShared<FReferencePreparer, ESPMode::ThreadSafe>();
+        Prep->OnReady = MoveTemp(InOnReady);
+
+        const int32 MaxDimension = GetReferenceMaxDimension(Request);
+        const FUploadProfile Profile = FUploadProfile::FromSettings();
+        Prep->Snapshots.Reserve(Request.ReferenceImages.Num());
+        for (const FNanoBananaReferenceImage& Ref : Request.ReferenceImages)
+        {
+            FReferenceSnapshot Snap;
+            Snap.MaxDimension = MaxDimension;
+            Snap.Profile = Profile;
+            if (SnapshotReference(Ref, Snap))
+            {
+                Prep->Snapshots.Add(MoveTemp(Snap));
+            }
+        }
+
+        // The mask is never sent, only fingerprinted; read it back in the same pass as the
+        // references rather than on its own.
+        if (bHashMask && Request.OptionalMask)
+        {
+            SnapshotRenderTarget(Request.OptionalMask, Prep->MaskSnapshot, /*bSRGB*/ true);
+        }
+
+        if (Prep->Snapshots.Num() == 0 && !Prep->MaskSnapshot.HasPixels())
+        {
+            Prep->Finish();
+            return Prep;
+        }
+
+        FReferenceCache::Get().SetBudgetBytes((int64)UNanoBananaSettings::Get().ReferenceCacheMaxMegabytes * 1024 * 1024);
+
+        // Workers must not trigger module loads; resolve the module here on the game thread.
+        IImageWrapperModule& ImageWrapper = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+        Prep->Launch(ImageWrapper);
+        return Prep;
+    }
+
+    void FReferencePreparer::Launch(IImageWrapperModule& ImageWrapper)
+    {
+        Encoded.SetNum(Snapshots.Num());
+
+        TSharedRef<FReferencePreparer, ESPMode::ThreadSafe> This = AsShared();
+        TArray<UE::Tasks::FTask> Tasks;
+        Tasks.Reserve(Snapshots.Num() + 1);
+        for (int32 Index = 0; Index < Snapshots.Num(); ++Index)
+        {
+            // Each task writes only its own slot, so no locking is needed.
+            Tasks.Add(UE::Tasks::Launch(UE_SOURCE_LOCATION, [This, Index, &ImageWrapper]()
+            {
+                if (This->IsCanceled()) return;
+                This->Encoded[Index] = EncodeSnapshotCached(ImageWrapper, This->Snapshots[Index]);
+                This->Snapshots[Index] = FReferenceSnapshot(); // release pixel copy early
+            }));
+        }
+        if (MaskSnapshot.HasPixels())
+        {
+            Tasks.Add(UE::Tasks::Launch(UE_SOURCE_LOCATION, [This]()
+            {
+                if (This->IsCanceled()) return;
+                ComputeSnapshotKey(This->MaskSnapshot, This->MaskKey);
+                This->MaskSnapshot = FReferenceSnapshot();
+            }));
+        }
+
+        UE::Tasks::Launch(UE_SOURCE_LOCATION, [This]()
+        {
+            AsyncTask(ENamedThreads::GameThread, [This]()
+            {
+                This->Finish();
+            });
+        }, Tasks);
+    }
+
+    void FReferencePreparer::Finish()
+    {
+        check(IsInGameThread());
+        if (IsCanceled() || !OnReady)
+        {
+            return;
+        }
+
+        TArray<FEncodedReferenceRef> Ready;
+        Ready.Reserve(Encoded.Num());
+        for (TSharedPtr<const FEncodedReference, ESPMode::ThreadSafe>& Ref : Encoded)
+        {
+            if (Ref.IsValid() && Ref->Bytes.Num() > 0)
+            {
+                Ready.Add(Ref.ToSharedRef());
+            }
+        }
+        Encoded.Reset();
+
+        FOnReady Callback = MoveTemp(OnReady);
+        Callback(MoveTemp(Ready), MaskKey);
+    }
+}
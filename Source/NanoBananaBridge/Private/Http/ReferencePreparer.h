@@ -0,0 +1,97 @@
+// Async reference-image preparation: snapshots texture / render-target pixels on the
+// game thread, then encodes every reference in parallel on the task graph.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/SharedPointer.h"
+#include "Templates/Function.h"
+#include "NanoBananaTypes.h"
+#include "Base64Image.h"
+#include "UploadEncoder.h"
+
+#include <atomic>
+
+class IImageWrapperModule;
+
+namespace NanoBanana::Image
+{
+    /** Game-thread copy of one reference, safe to hand to a worker task. */
+    struct FReferenceSnapshot
+    {
+        /** BGRA8 pixels copied out of a texture mip or render target. Empty for file references. */
+        TArray<FColor> Pixels;
+        FIntPoint Size = FIntPoint::ZeroValue;
+
+        /** Set instead of Pixels when the reference lives on disk; read on the worker. */
+        FString FilePath;
+
+        /** Downscale so neither side exceeds this before encoding (0 = keep original size). */
+        int32 MaxDimension = 0;
+
+        /** How pixels (and PNG files) are encoded for upload. */
+        FUploadProfile Profile;
+
+        bool HasPixels() const { return Pixels.Num() > 0 && Size.X > 0 && Size.Y > 0; }
+    };
+
+    /** Copy mip 0 of an uncompressed BGRA8/RGBA8 texture into a snapshot. Game thread only. */
+    bool SnapshotTexture(const UTexture2D* Texture, FReferenceSnapshot& Out);
+
+    /** Read back a render target into a snapshot. Game thread only (blocks on the GPU). */
+    bool SnapshotRenderTarget(UTextureRenderTarget2D* RT, FReferenceSnapshot& Out, bool bSRGB = true);
+
+    /** Snapshot a reference (texture > render target > file path). Game thread only. */
+    bool SnapshotReference(const FNanoBananaReferenceImage& Ref, FReferenceSnapshot& Out);
+
+    /** Longest side references should be sent at for this request (0 = original size). */
+    int32 GetReferenceMaxDimension(const FNanoBananaRequest& Request);
+
+    /**
+     * Encode a snapshot to image bytes with its upload profile, downscaling first when
+     * MaxDimension requires it.
+     * Safe on any thread once the ImageWrapper module is loaded.
+     */
+    TSharedPtr<const FEncodedReference, ESPMode::ThreadSafe> EncodeSnapshot(IImageWrapperModule& ImageWrapper, const FReferenceSnapshot& Snapshot);
+
+    /**
+     * Content key for a snapshot: hash of the pixels + size, or of path + mtime + size for files,
+     * plus the target MaxDimension and upload profile.
+     * Returns false when no stable key exists (e.g. the file cannot be stat'ed).
+     */
+    bool ComputeSnapshotKey(const FReferenceSnapshot& Snapshot, uint64& OutKey);
+
+    /**
+     * Two-stage preparation of a request's reference images:
+     *   1. Start() snapshots every reference on the game thread (pixel copies only, no encoding).
+     *   2. Each snapshot is encoded (or read from disk) on its own task-graph task, unless
+     *      FReferenceCache already holds an encoding for the same content.
+     * OnReady then fires on the game thread with the encoded references in request order,
+     * skipping any that failed. It never fires once Cancel() has been called.
+     * With bHashMask, the request's OptionalMask is snapshotted in the same pass and hashed on a
+     * worker (ComputeSnapshotKey); OnReady receives that key, or 0 without a mask.
+     */
+    class FReferencePreparer : public TSharedFromThis<FReferencePreparer, ESPMode::ThreadSafe>
+    {
+    public:
+        using FOnReady = TFunction<void(TArray<FEncodedReferenceRef> /*References*/, uint64 /*MaskKey*/)>;
+
+        /** Must be called on the game thread. With nothing to snapshot, OnReady runs synchronously. */
+        static TSharedRef<FReferencePreparer, ESPMode::ThreadSafe> Start(const FNanoBananaRequest& Request, bool bHashMask, FOnReady OnReady);
+
+        /** Drop the pending result; workers that have not started encoding yet skip their work. */
+        void Cancel() { bCanceled = true; }
+
+        bool IsCanceled() const { return bCanceled; }
+
+    private:
+        void Launch(IImageWrapperModule& ImageWrapper);
+        void Finish();
+
+        TArray<FReferenceSnapshot> Snapshots;
+        TArray<TSharedPtr<const FEncodedReference, ESPMode::ThreadSafe>> Encoded;
+        FReferenceSnapshot MaskSnapshot;
+        uint64 MaskKey = 0;
+        FOnReady OnReady;
+        std::atomic<bool> bCanceled { false };
+    };
+}
@@ -0,0 +1,27 @@
+#include "ResultDecoder.h"
+#include "ImageUtils.h"
+#include "Engine/Texture2D.h"
+
+namespace NanoBanana::Image
+{
+    bool DecodeResultImage(TConstArrayView<uint8> Bytes, FImage& OutImage)
+    {
+        OutImage = FImage();
+        if (Bytes.Num() == 0)
+        {
+            return false;
+        }
+        return FImageUtils::DecompressImage(Bytes.GetData(), Bytes.Num(), OutImage);
+    }
+
+    UTexture2D* CreateResultTexture(const FImage& Image)
+    {
+        check(IsInGameThread());
+        if (Image.SizeX <= 0 || Image.SizeY <= 0)
+        {
+            return nullptr;
+        }
+        // Same result as ImportBufferAsTexture2D, minus the decode it would do here.
+        return FImageUtils::CreateTexture2DFromImage(Image);
+    }
+}
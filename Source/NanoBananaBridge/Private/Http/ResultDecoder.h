@@ -0,0 +1,20 @@
+// Decoding of generated result images. Pixel decoding runs on worker tasks; only texture
+// creation, which needs UObjects, is left for the game thread.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ImageCore.h"
+
+class UTexture2D;
+
+namespace NanoBanana::Image
+{
+    /**
+     * Decode PNG / JPEG / any ImageWrapper-supported bytes into CPU pixels. Safe on any thread
+     * once the ImageWrapper module is loaded. Returns false (OutImage left empty) on failure.
+     */
+    bool DecodeResultImage(TConstArrayView<uint8> Bytes, FImage& OutImage);
+
+    /** Create a transient texture from decoded pixels. Game thread only; null for an empty image. */
+    UTexture2D* CreateResultTexture(const FImage& Image);
+}
@@ -0,0 +1,172 @@
+#include "ResultDownloader.h"
+#include "HttpModule.h"
+#include "Interfaces/IHttpResponse.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+
+namespace NanoBanana::Http
+{
+    namespace
+    {
+        /** Most results are a few MB; start there and double, so growth costs one copy at most. */
+        constexpr int64 InitialDownloadReserve = 1024 * 1024;
+
+        static FString PartPath(const FString& DestPath)
+        {
+            return DestPath + TEXT(".part");
+        }
+    }
+
+    FDownloadStream::FDownloadStream(const FString& InDestPath)
+        : DestPath(InDestPath)
+    {
+        SetIsSaving(true);
+        SetIsPersistent(false);
+    }
+
+    FDownloadStream::~FDownloadStream()
+    {
+        if (SavedPath.IsEmpty())
+        {
+            DiscardFile();
+        }
+    }
+
+    void FDownloadStream::Serialize(void* V, int64 Length)
+    {
+        if (Length <= 0) return;
+
+        const int64 Needed = (int64)Bytes.Num() + Length;
+        if (Needed > Bytes.Max())
+        {
+            Bytes.Reserve((int32)FMath::Max3(Needed, (int64)Bytes.Max() * 2, InitialDownloadReserve));
+        }
+        Bytes.Append(static_cast<const uint8*>(V), (int32)Length);
+
+        if (DestPath.IsEmpty() || bFileFailed) return;
+        if (!File.IsValid())
+        {
+            File.Reset(IFileManager::Get().CreateFileWriter(*PartPath(DestPath)));
+            bFileFailed = !File.IsValid();
+            if (bFileFailed) return;
+        }
+        File->Serialize(V, Length);
+        bFileFailed = File->IsError();
+    }
+
+    bool FDownloadStream::Commit()
+    {
+        if (DestPath.IsEmpty() || bFileFailed) return false;
+        if (!File.IsValid())
+        {
+            // Empty body: nothing was streamed, so there is no partial file to move.
+            if (!FFileHelper::SaveArrayToFile(Bytes, *DestPath)) return false;
+            SavedPath = DestPath;
+            return true;
+        }
+
+        const bool bClosed = File->Close();
+        File.Reset();
+        if (!bClosed || !IFileManager::Get().Move(*DestPath, *PartPath(DestPath), /*bReplace*/ true, /*bEvenIfReadOnly*/ true))
+        {
+            DiscardFile();
+            return false;
+        }
+        SavedPath = DestPath;
+        return true;
+    }
+
+    void FDownloadStream::DiscardFile()
+    {
+        if (DestPath.IsEmpty()) return;
+        File.Reset();
+        IFileManager::Get().Delete(*PartPath(DestPath), /*RequireExists*/ false, /*EvenReadOnly*/ true, /*Quiet*/ true);
+    }
+
+    void FResultDownloader::Start(const TArray<FString>& Urls)
+    {
+        Pending = Urls.Num();
+        Requests.SetNum(Urls.Num());
+        Streams.SetNum(Urls.Num());
+        if (Urls.Num() == 0)
+        {
+            bDone = true;
+            if (OnSucceeded) OnSucceeded({}, {});
+            return;
+        }
+
+        TWeakPtr<FResultDownloader, ESPMode::ThreadSafe> WeakThis = AsShared();
+        for (int32 i = 0; i < Urls.Num(); ++i)
+        {
+            TSharedRef<FDownloadStream> Stream = MakeShared<FDownloadStream>(ResolvePath ? ResolvePath(i, Urls.Num()) : FString());
+            TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Get = FHttpModule::Get().CreateRequest();
+            Get->SetURL(Urls[i]);
+            Get->SetVerb(TEXT("GET"));
+            for (const TPair<FString, FString>& Header : Headers)
+            {
+                Get->SetHeader(Header.Key, Header.Value);
+            }
+            Get->SetResponseBodyReceiveStream(Stream);
+
+            const int32 Index = i;
+            Get->OnProcessRequestComplete().BindLambda(
+                [WeakThis, Index](FHttpRequestPtr, FHttpResponsePtr Resp, bool bOK)
+                {
+                    if (TSharedPtr<FResultDownloader, ESPMode::ThreadSafe> P = WeakThis.Pin())
+                    {
+                        const bool bHttpOk = bOK && Resp.IsValid() && Resp->GetResponseCode() >= 200 && Resp->GetResponseCode() < 300;
+                        P->HandleComplete(Index, bHttpOk);
+                    }
+                });
+
+            Requests[i] = Get;
+            Streams[i] = Stream;
+            Get->ProcessRequest();
+        }
+    }
+
+    void FResultDownloader::HandleComplete(int32 Index, bool bOk)
+    {
+        if (bDone) return;
+        Requests[Index].Reset();
+        if (!bOk)
+        {
+            Cancel();
+            if (OnFailed) OnFailed(Index);
+            return;
+        }
+
+        // A failed file write is not fatal: the bytes are still here, and the caller saves
+        // whatever comes back without a path.
+        Streams[Index]->Commit();
+
+        if (--Pending > 0) return;
+        bDone = true;
+        TArray<TArray<uint8>> Images;
+        TArray<FString> SavedPaths;
+        Images.SetNum(Streams.Num());
+        SavedPaths.SetNum(Streams.Num());
+        for (int32 i = 0; i < Streams.Num(); ++i)
+        {
+            Images[i] = MoveTemp(Streams[i]->GetBytes());
+            SavedPaths[i] = Streams[i]->GetSavedPath();
+        }
+        Streams.Reset();
+        if (OnSucceeded) OnSucceeded(MoveTemp(Images), MoveTemp(SavedPaths));
+    }
+
+    void FResultDownloader::Cancel()
+    {
+        bDone = true;
+        for (TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>& Request : Requests)
+        {
+            if (Request.IsValid())
+            {
+                Request->CancelRequest();
+                Request.Reset();
+            }
+        }
+        // Dropping the streams deletes any partial files once the requests let go of them.
+        Streams.Reset();
+    }
+}
@@ -0,0 +1,77 @@
+// Parallel result-image downloads used by FAL and Replicate. Each response body is streamed
+// into one buffer and, when a destination is given, into its file in the same pass, so an
+// image is held once in memory and written once.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Serialization/Archive.h"
+#include "Templates/SharedPointer.h"
+#include "Templates/Function.h"
+#include "Interfaces/IHttpRequest.h"
+
+namespace NanoBanana::Http
+{
+    /**
+     * Response-body sink for one download. Serialize() runs on the HTTP thread with each
+     * received chunk: the bytes are appended to the buffer and written to "<Dest>.part".
+     * Commit() moves the file into place once the response checks out; a stream destroyed
+     * without Commit() deletes its partial file.
+     */
+    class FDownloadStream : public FArchive
+    {
+    public:
+        /** DestPath empty = memory only. */
+        explicit FDownloadStream(const FString& InDestPath);
+        virtual ~FDownloadStream() override;
+
+        virtual void Serialize(void* V, int64 Length) override;
+        virtual FString GetArchiveName() const override { return DestPath; }
+
+        /** Finalizes the file; returns false (and removes it) if any write failed. */
+        bool Commit();
+
+        /** The downloaded bytes. Moved out by the owner once the request has completed. */
+        TArray<uint8>& GetBytes() { return Bytes; }
+
+        /** Final path after a successful Commit(), else empty. */
+        const FString& GetSavedPath() const { return SavedPath; }
+
+    private:
+        void DiscardFile();
+
+        FString DestPath;
+        FString SavedPath;
+        TArray<uint8> Bytes;
+        TUniquePtr<FArchive> File;
+        bool bFileFailed = false;
+    };
+
+    /**
+     * Downloads a set of result URLs in parallel and reports them in URL order. Lifetime is
+     * owned by the caller's TSharedPtr, like FPollLoop; Start/Cancel on the game thread.
+     */
+    class FResultDownloader : public TSharedFromThis<FResultDownloader, ESPMode::ThreadSafe>
+    {
+    public:
+        /** Extra headers for every GET (e.g. Replicate's Authorization). */
+        TMap<FString, FString> Headers;
+
+        /** Destination file for image Index of Count; unset or empty keeps it in memory only. */
+        TFunction<FString(int32 /*Index*/, int32 /*Count*/)> ResolvePath;
+
+        /** SavedPaths is parallel to Images; an empty entry was not written. */
+        TFunction<void(TArray<TArray<uint8>> /*Images*/, TArray<FString> /*SavedPaths*/)> OnSucceeded;
+        TFunction<void(int32 /*FailedIndex*/)> OnFailed;
+
+        void Start(const TArray<FString>& Urls);
+        void Cancel();
+
+    private:
+        void HandleComplete(int32 Index, bool bOk);
+
+        TArray<TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>> Requests;
+        TArray<TSharedPtr<FDownloadStream>> Streams;
+        int32 Pending = 0;
+        bool bDone = false;
+    };
+}
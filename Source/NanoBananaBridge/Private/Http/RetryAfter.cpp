@@ -0,0 +1,31 @@
+#include "RetryAfter.h"
+#include "Misc/DateTime.h"
+
+namespace NanoBanana::Http
+{
+    float ParseRetryAfterSeconds(const FString& HeaderValue, const FDateTime& NowUtc)
+    {
+        const FString Value = HeaderValue.TrimStartAndEnd();
+        if (Value.IsEmpty())
+        {
+            return DefaultRetryAfterSeconds;
+        }
+        if (Value.IsNumeric())
+        {
+            return FMath::Clamp(FCString::Atof(*Value), 0.0f, MaxRetryAfterSeconds);
+        }
+        FDateTime At;
+        if (FDateTime::ParseHttpDate(Value, At))
+        {
+            return FMath::Clamp((float)(At - NowUtc).GetTotalSeconds(), 0.0f, MaxRetryAfterSeconds);
+        }
+        return DefaultRetryAfterSeconds;
+    }
+
+    bool IsRateLimited(const IHttpResponse& Resp, float& OutSeconds)
+    {
+        if (Resp.GetResponseCode() != 429) return false;
+        OutSeconds = ParseRetryAfterSeconds(Resp.GetHeader(TEXT("Retry-After")), FDateTime::UtcNow());
+        return true;
+    }
+}
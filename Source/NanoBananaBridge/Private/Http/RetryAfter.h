@@ -0,0 +1,23 @@
+// Reading a vendor's HTTP 429 answer: how long it asks clients to back off.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interfaces/IHttpResponse.h"
+
+namespace NanoBanana::Http
+{
+    /** Back-off used when a 429 carries no (or an unreadable) Retry-After header. */
+    constexpr float DefaultRetryAfterSeconds = 5.0f;
+    /** Upper bound on a single back-off, whatever the vendor asks for. */
+    constexpr float MaxRetryAfterSeconds = 300.0f;
+
+    /**
+     * Seconds to wait according to a Retry-After header value: either delta-seconds ("30") or
+     * an HTTP date, measured against NowUtc. Clamped to [0, MaxRetryAfterSeconds]; unreadable
+     * or empty values give DefaultRetryAfterSeconds.
+     */
+    float ParseRetryAfterSeconds(const FString& HeaderValue, const FDateTime& NowUtc);
+
+    /** True when Resp is an HTTP 429; OutSeconds is then its Retry-After delay. */
+    bool IsRateLimited(const IHttpResponse& Resp, float& OutSeconds);
+}
@@ -0,0 +1,56 @@
+#include "SharedPayload.h"
+#include "Serialization/Archive.h"
+
+namespace NanoBanana
+{
+    const FSharedText& EmptySharedText()
+    {
+        static const FSharedText Empty = MakeSharedText(FString());
+        return Empty;
+    }
+}
+
+namespace NanoBanana::Http
+{
+    namespace
+    {
+        /** Loading archive over a shared buffer; keeps the buffer alive while the request reads it. */
+        class FSharedBytesReader : public FArchive
+        {
+        public:
+            explicit FSharedBytesReader(const FSharedBytes& InBytes)
+                : Bytes(InBytes)
+            {
+                SetIsLoading(true);
+                SetIsPersistent(false);
+            }
+
+            virtual void Serialize(void* V, int64 Length) override
+            {
+                if (Length <= 0) return;
+                if (Offset + Length > TotalSize())
+                {
+                    SetError();
+                    return;
+                }
+                FMemory::Memcpy(V, Bytes->GetData() + Offset, Length);
+                Offset += Length;
+            }
+
+            virtual int64 Tell() override { return Offset; }
+            virtual int64 TotalSize() override { return Bytes->Num(); }
+            virtual void Seek(int64 InPos) override { Offset = FMath::Clamp<int64>(InPos, 0, TotalSize()); }
+            virtual bool AtEnd() override { return Offset >= TotalSize(); }
+            virtual FString GetArchiveName() const override { return TEXT("NanoBanana shared payload"); }
+
+        private:
+            FSharedBytes Bytes;
+            int64 Offset = 0;
+        };
+    }
+
+    void SetSharedContent(IHttpRequest& Request, const FSharedBytes& Body)
+    {
+        Request.SetContentFromStream(MakeShared<FSharedBytesReader, ESPMode::ThreadSafe>(Body));
+    }
+}
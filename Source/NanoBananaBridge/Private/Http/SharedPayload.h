@@ -0,0 +1,42 @@
+// Immutable, ref-counted payload buffers passed down the provider callback chain. A request
+// body or response body is built once and every later stage (debug dump, queue resend, poll
+// handler, async action) holds a reference instead of a copy.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/SharedPointer.h"
+#include "Interfaces/IHttpRequest.h"
+
+namespace NanoBanana
+{
+    /** Read-only bytes shared across threads; never mutated once published. */
+    using FSharedBytes = TSharedRef<const TArray<uint8>, ESPMode::ThreadSafe>;
+
+    /** Read-only text shared across threads (response bodies kept for diagnostics). */
+    using FSharedText = TSharedRef<const FString, ESPMode::ThreadSafe>;
+
+    /** Takes ownership of Bytes without copying them. */
+    inline FSharedBytes MakeSharedBytes(TArray<uint8>&& Bytes)
+    {
+        return MakeShared<TArray<uint8>, ESPMode::ThreadSafe>(MoveTemp(Bytes));
+    }
+
+    /** Takes ownership of Text without copying it. */
+    inline FSharedText MakeSharedText(FString&& Text)
+    {
+        return MakeShared<FString, ESPMode::ThreadSafe>(MoveTemp(Text));
+    }
+
+    /** The shared empty string, for callers with nothing to report. */
+    const FSharedText& EmptySharedText();
+}
+
+namespace NanoBanana::Http
+{
+    /**
+     * Attaches Body as the request payload without copying it: the HTTP module reads it
+     * through an archive that holds a reference, so the same buffer can be sent again
+     * (e.g. FAL's sync-then-queue fallback) or dumped for debugging.
+     */
+    void SetSharedContent(IHttpRequest& Request, const FSharedBytes& Body);
+}
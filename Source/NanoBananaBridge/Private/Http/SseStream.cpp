@@ -0,0 +1,145 @@
+#include "SseStream.h"
+
+#include <cstring>
+
+namespace NanoBanana::Http
+{
+    namespace
+    {
+        /** First CR or LF in [P, End), or End. memchr keeps multi-megabyte base64 lines cheap. */
+        static const uint8* FindLineEnd(const uint8* P, const uint8* End)
+        {
+            const uint8* Lf = static_cast<const uint8*>(memchr(P, '\n', End - P));
+            const uint8* Limit = Lf ? Lf : End;
+            const uint8* Cr = static_cast<const uint8*>(memchr(P, '\r', Limit - P));
+            return Cr ? Cr : Limit;
+        }
+    }
+
+    FSseParser::FSseParser(FSseEventHandler InOnEvent)
+        : OnEvent(MoveTemp(InOnEvent))
+    {
+    }
+
+    void FSseParser::Feed(TConstArrayView<uint8> Bytes)
+    {
+        const uint8* P = Bytes.GetData();
+        const uint8* const End = P + Bytes.Num();
+
+        // A CRLF split across two chunks: the LF belongs to the line already processed.
+        if (bSkipLeadingLF && P < End)
+        {
+            if (*P == '\n') ++P;
+            bSkipLeadingLF = false;
+        }
+
+        while (P < End)
+        {
+            const uint8* Eol = FindLineEnd(P, End);
+            if (Eol == End)
+            {
+                PartialLine.Append(P, (int32)(End - P));
+                break;
+            }
+
+            if (PartialLine.Num() > 0)
+            {
+                PartialLine.Append(P, (int32)(Eol - P));
+                ProcessLine(PartialLine.GetData(), PartialLine.Num());
+                PartialLine.Reset();
+            }
+            else
+            {
+                ProcessLine(P, (int32)(Eol - P));
+            }
+
+            if (*Eol == '\r')
+            {
+                if (Eol + 1 == End) bSkipLeadingLF = true;
+                else if (Eol[1] == '\n') ++Eol;
+            }
+            P = Eol + 1;
+        }
+    }
+
+    void FSseParser::Finish()
+    {
+        if (PartialLine.Num() > 0)
+        {
+            ProcessLine(PartialLine.GetData(), PartialLine.Num());
+            PartialLine.Reset();
+        }
+        Dispatch();
+    }
+
+    void FSseParser::ProcessLine(const uint8* Line, int32 Len)
+    {
+        if (Len == 0)
+        {
+            Dispatch();
+            return;
+        }
+        if (Line[0] == ':') return; // comment / keep-alive
+
+        const uint8* Colon = static_cast<const uint8*>(memchr(Line, ':', Len));
+        const int32 FieldLen = Colon ? (int32)(Colon - Line) : Len;
+        const uint8* Value = Colon ? Colon + 1 : Line + Len;
+        if (Value < Line + Len && *Value == ' ') ++Value;
+        const int32 ValueLen = (int32)(Line + Len - Value);
+
+        const FAnsiStringView Field(reinterpret_cast<const ANSICHAR*>(Line), FieldLen);
+        if (Field.Equals("data", ESearchCase::CaseSensitive))
+        {
+            if (bHasData) Data.Add('\n');
+            Data.Append(Value, ValueLen);
+            bHasData = true;
+        }
+        else if (Field.Equals("event", ESearchCase::CaseSensitive))
+        {
+            EventName.Reset();
+            EventName.Append(reinterpret_cast<const ANSICHAR*>(Value), ValueLen);
+        }
+    }
+
+    void FSseParser::Dispatch()
+    {
+        if (bHasData)
+        {
+            ++NumEvents;
+            if (OnEvent) OnEvent(FAnsiStringView(EventName.GetData(), EventName.Num()), Data);
+        }
+        // Buffers keep their capacity: every Gemini image chunk is about the same size.
+        Data.Reset();
+        EventName.Reset();
+        bHasData = false;
+    }
+
+    FSseReceiveStream::FSseReceiveStream(FSseEventHandler InOnEvent, bool bInKeepBody)
+        : Parser(MoveTemp(InOnEvent))
+        , bKeepBody(bInKeepBody)
+    {
+        SetIsSaving(true);
+        SetIsPersistent(false);
+    }
+
+    void FSseReceiveStream::Serialize(void* V, int64 Length)
+    {
+        if (Length <= 0) return;
+        const uint8* Bytes = static_cast<const uint8*>(V);
+        TotalBytes += Length;
+        if (Head.Num() < HeadBytes)
+        {
+            Head.Append(Bytes, (int32)FMath::Min<int64>(Length, HeadBytes - Head.Num()));
+        }
+        if (bKeepBody)
+        {
+            Body.Append(Bytes, (int32)Length);
+        }
+        Parser.Feed(TConstArrayView<uint8>(Bytes, (int32)Length));
+    }
+
+    void FSseReceiveStream::Finish()
+    {
+        Parser.Finish();
+    }
+}
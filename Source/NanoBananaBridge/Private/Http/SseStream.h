@@ -0,0 +1,79 @@
+// Incremental Server-Sent Events (text/event-stream) parsing for streaming vendor endpoints.
+// FSseParser is transport-agnostic; FSseReceiveStream plugs it into
+// IHttpRequest::SetResponseBodyReceiveStream so events are handled as bytes arrive.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Serialization/Archive.h"
+#include "Templates/Function.h"
+
+namespace NanoBanana::Http
+{
+    /** Called once per dispatched event. Event is empty for the default "message" type. */
+    using FSseEventHandler = TFunction<void(FAnsiStringView /*Event*/, TConstArrayView<uint8> /*Data*/)>;
+
+    /**
+     * Incremental SSE parser. Chunks may split lines, CRLF pairs or UTF-8 sequences
+     * anywhere. Follows the WHATWG field rules for "event" and "data" (multi-line data is
+     * joined with '\n'); comments, "id" and "retry" are ignored.
+     */
+    class FSseParser
+    {
+    public:
+        explicit FSseParser(FSseEventHandler InOnEvent);
+
+        void Feed(TConstArrayView<uint8> Bytes);
+
+        /**
+         * End of stream. Unlike the browser EventSource, an event whose blank-line terminator
+         * never arrived is still dispatched: vendors close the connection right after the
+         * last chunk, and dropping it would lose the final image.
+         */
+        void Finish();
+
+        int32 GetNumEvents() const { return NumEvents; }
+
+    private:
+        void ProcessLine(const uint8* Line, int32 Len);
+        void Dispatch();
+
+        FSseEventHandler OnEvent;
+        TArray<uint8> PartialLine;
+        TArray<uint8> Data;
+        TArray<ANSICHAR> EventName;
+        bool bHasData = false;
+        bool bSkipLeadingLF = false;
+        int32 NumEvents = 0;
+    };
+
+    /**
+     * Write-only archive handed to the HTTP layer as the response body sink. Serialize() runs
+     * on the HTTP thread with each received chunk and feeds the parser. Keeps the first bytes
+     * for error messages, and the whole body only when asked (debug dumps).
+     */
+    class FSseReceiveStream : public FArchive
+    {
+    public:
+        FSseReceiveStream(FSseEventHandler InOnEvent, bool bInKeepBody);
+
+        virtual void Serialize(void* V, int64 Length) override;
+        virtual FString GetArchiveName() const override { return TEXT("NanoBanana SSE stream"); }
+
+        /** Flushes the parser; call once the request has completed. */
+        void Finish();
+
+        FSseParser& GetParser() { return Parser; }
+        const TArray<uint8>& GetHead() const { return Head; }
+        const TArray<uint8>& GetBody() const { return Body; }
+        int64 GetTotalBytes() const { return TotalBytes; }
+
+        static constexpr int32 HeadBytes = 512;
+
+    private:
+        FSseParser Parser;
+        TArray<uint8> Head;
+        TArray<uint8> Body;
+        int64 TotalBytes = 0;
+        bool bKeepBody = false;
+    };
+}
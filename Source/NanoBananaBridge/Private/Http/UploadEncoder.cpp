@@ -0,0 +1,48 @@
+#include "UploadEncoder.h"
+#include "NanoBananaSettings.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+
+namespace NanoBanana::Image
+{
+    FUploadProfile FUploadProfile::FromSettings()
+    {
+        const UNanoBananaSettings& S = UNanoBananaSettings::Get();
+        FUploadProfile Profile;
+        Profile.Encoding = S.UploadEncoding;
+        Profile.Quality = FMath::Clamp(S.UploadJpegQuality, 1, 100);
+        return Profile;
+    }
+
+    const TCHAR* LexToString(ENanoBananaUploadEncoding Encoding)
+    {
+        switch (Encoding)
+        {
+            case ENanoBananaUploadEncoding::PNGFast: return TEXT("PNG (fast)");
+            case ENanoBananaUploadEncoding::JPEG:    return TEXT("JPEG");
+            default:                                 return TEXT("Unknown");
+        }
+    }
+
+    static bool HasTransparency(TConstArrayView<FColor> Pixels)
+    {
+        for (const FColor& Pixel : Pixels)
+        {
+            if (Pixel.A != 255) return true;
+        }
+        return false;
+    }
+
+    TArray<uint8> EncodeForUpload(IImageWrapperModule& ImageWrapper, TConstArrayView<FColor> Pixels, FIntPoint Size, const FUploadProfile& Profile)
+    {
+        // JPEG would silently drop a cut-out's or mask-like reference's alpha.
+        const bool bJpeg = Profile.Encoding == ENanoBananaUploadEncoding::JPEG && !HasTransparency(Pixels);
+        TSharedPtr<IImageWrapper> Wrapper = ImageWrapper.CreateImageWrapper(bJpeg ? EImageFormat::JPEG : EImageFormat::PNG);
+        if (!Wrapper.IsValid()
+            || !Wrapper->SetRaw(Pixels.GetData(), (int64)Pixels.Num() * sizeof(FColor), Size.X, Size.Y, ERGBFormat::BGRA, 8))
+        {
+            return {};
+        }
+        return Wrapper->GetCompressed(bJpeg ? FMath::Clamp(Profile.Quality, 1, 100) : PngFastQuality);
+    }
+}
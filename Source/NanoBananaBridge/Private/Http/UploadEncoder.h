@@ -0,0 +1,40 @@
+// Encodes reference pixels for upload according to the project's upload profile
+// (fast PNG or JPEG at a configurable quality).
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NanoBananaTypes.h"
+
+class IImageWrapperModule;
+
+namespace NanoBanana::Image
+{
+    /**
+     * IImageWrapper PNG quality used for anything we PNG-encode ourselves. 0 is
+     * EImageCompressionQuality::Default, the wrapper's default zlib level; 100 asks for
+     * maximum compression, which costs several times the encode time for a few percent of size.
+     */
+    constexpr int32 PngFastQuality = 0;
+
+    struct FUploadProfile
+    {
+        ENanoBananaUploadEncoding Encoding = ENanoBananaUploadEncoding::PNGFast;
+
+        /** JPEG quality, 1..100. Ignored for PNG. */
+        int32 Quality = 90;
+
+        bool IsLossy() const { return Encoding == ENanoBananaUploadEncoding::JPEG; }
+
+        /** Profile from UNanoBananaSettings. Game thread only (reads the settings CDO). */
+        static FUploadProfile FromSettings();
+    };
+
+    const TCHAR* LexToString(ENanoBananaUploadEncoding Encoding);
+
+    /**
+     * Encode BGRA8 pixels with the given profile. Returns an empty array on failure.
+     * JPEG cannot carry alpha, so pixels with any transparency are sent as fast PNG instead.
+     * Safe on any thread once the ImageWrapper module is loaded.
+     */
+    TArray<uint8> EncodeForUpload(IImageWrapperModule& ImageWrapper, TConstArrayView<FColor> Pixels, FIntPoint Size, const FUploadProfile& Profile);
+}
@@ -0,0 +1,183 @@
+#include "WebhookReceiver.h"
+#include "NanoBananaLog.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/Guid.h"
+#include "Misc/ScopeLock.h"
+#include "HttpServerModule.h"
+#include "IHttpRouter.h"
+#include "HttpPath.h"
+#include "HttpServerRequest.h"
+#include "HttpServerResponse.h"
+#include "HttpResultCallback.h"
+
+namespace NanoBanana::Http
+{
+    namespace
+    {
+        FAutoConsoleCommand DumpStatsCommand(
+            TEXT("NanoBanana.Webhook.Stats"),
+            TEXT("Logs pending registrations and delivered / rejected callbacks of the webhook listener."),
+            FConsoleCommandDelegate::CreateLambda([]()
+            {
+                const FWebhookReceiverStats S = FWebhookReceiver::Get().GetStats();
+                UE_LOG(LogNanoBanana, Display, TEXT("Webhook listener: %d pending, %lld registered, %lld delivered, %lld rejected, %lld unauthorized"),
+                    S.Pending, S.Registered, S.Delivered, S.Rejected, S.Unauthorized);
+            }));
+
+        FString FindHeader(const FHttpServerRequest& Request, const TCHAR* Name)
+        {
+            // TMap<FString, ...> compares keys case-insensitively, as HTTP header names are.
+            const TArray<FString>* Values = Request.Headers.Find(Name);
+            return Values && Values->Num() > 0 ? (*Values)[0] : FString();
+        }
+    }
+
+    FWebhookReceiver& FWebhookReceiver::Get()
+    {
+        static FWebhookReceiver Instance;
+        return Instance;
+    }
+
+    FString FWebhookReceiver::Register(int32 Port, const FString& PublicBaseUrl, const FString& SigningSecret, FHandler Handler, FString& OutToken)
+    {
+        OutToken.Reset();
+        // A loopback URL would be accepted by the vendor and then never called.
+        if (PublicBaseUrl.IsEmpty() || SigningSecret.IsEmpty()) return FString();
+        if (!EnsureListening(Port)) return FString();
+
+        FString Base = PublicBaseUrl;
+        if (Base.EndsWith(TEXT("/"))) Base.LeftChopInline(1);
+
+        // The signature proves the callback came from the vendor; the token, a fresh random
+        // GUID per job, routes it to the right job and keeps stale callbacks from matching.
+        OutToken = FGuid::NewGuid().ToString(EGuidFormats::Digits).ToLower();
+        {
+            FScopeLock ScopeLock(&Lock);
+            Handlers.Add(OutToken, FRegistration{ SigningSecret, MoveTemp(Handler) });
+            ++Stats.Registered;
+        }
+        return FString::Printf(TEXT("%s%s?job=%s"), *Base, RoutePath, *OutToken);
+    }
+
+    void FWebhookReceiver::Unregister(const FString& Token)
+    {
+        if (Token.IsEmpty()) return;
+        FScopeLock ScopeLock(&Lock);
+        Handlers.Remove(Token);
+    }
+
+    bool FWebhookReceiver::EnsureListening(int32 Port)
+    {
+        // Binding touches the HTTPServer module, which is game-thread only.
+        check(IsInGameThread());
+        if (Router.IsValid())
+        {
+            if (BoundPort == Port) return true;
+            UE_LOG(LogNanoBanana, Warning, TEXT("Webhook listener already bound to port %d; ignoring port %d until restart."), BoundPort, Port);
+            return true;
+        }
+
+        Router = FHttpServerModule::Get().GetHttpRouter((uint32)Port, /*bFailOnBindFailure*/ true);
+        if (!Router.IsValid())
+        {
+            UE_LOG(LogNanoBanana, Warning, TEXT("Webhook listener could not bind port %d; falling back to polling."), Port);
+            return false;
+        }
+
+        RouteHandle = Router->BindRoute(FHttpPath(RoutePath), EHttpServerRequestVerbs::VERB_POST,
+            FHttpRequestHandler::CreateLambda([this](const FHttpServerRequest& Request, const FHttpResultCallback& OnComplete)
+            {
+                const FString* Token = Request.QueryParams.Find(TEXT("job"));
+                FWebhookSignatureHeaders Headers;
+                Headers.Id = FindHeader(Request, TEXT("webhook-id"));
+                Headers.Timestamp = FindHeader(Request, TEXT("webhook-timestamp"));
+                Headers.Signature = FindHeader(Request, TEXT("webhook-signature"));
+                switch (Deliver(Token ? *Token : FString(), Headers, Request.Body))
+                {
+                case EHttpServerResponseCodes::Ok:
+                    OnComplete(FHttpServerResponse::Ok());
+                    break;
+                case EHttpServerResponseCodes::Denied:
+                    OnComplete(FHttpServerResponse::Error(EHttpServerResponseCodes::Denied, TEXT("bad_signature"), TEXT("Callback signature did not verify.")));
+                    break;
+                default:
+                    OnComplete(FHttpServerResponse::Error(EHttpServerResponseCodes::NotFound, TEXT("unknown_job"), TEXT("No pending job for this callback.")));
+                    break;
+                }
+                return true;
+            }));
+        if (!RouteHandle.IsValid())
+        {
+            UE_LOG(LogNanoBanana, Warning, TEXT("Webhook route %s is already bound on port %d; falling back to polling."), RoutePath, Port);
+            Router.Reset();
+            return false;
+        }
+
+        BoundPort = Port;
+        FHttpServerModule::Get().StartAllListeners();
+        return true;
+    }
+
+    EHttpServerResponseCodes FWebhookReceiver::Deliver(const FString& Token, const FWebhookSignatureHeaders& Headers, TConstArrayView<uint8> Body)
+    {
+        FString SigningSecret;
+        {
+            FScopeLock ScopeLock(&Lock);
+            const FRegistration* Registration = Token.IsEmpty() ? nullptr : Handlers.Find(Token);
+            if (!Registration)
+            {
+                ++Stats.Rejected;
+                return EHttpServerResponseCodes::NotFound;
+            }
+            SigningSecret = Registration->SigningSecret;
+        }
+
+        // An unsigned or forged callback must not consume the job's one registration.
+        FString Reason;
+        if (!VerifyWebhookSignature(SigningSecret, Headers, Body, FDateTime::UtcNow().ToUnixTimestamp(), Reason))
+        {
+            UE_LOG(LogNanoBanana, Warning, TEXT("Ignoring webhook callback for job %s: %s."), *Token, *Reason);
+            FScopeLock ScopeLock(&Lock);
+            ++Stats.Unauthorized;
+            return EHttpServerResponseCodes::Denied;
+        }
+
+        // A job completes once; the registration goes away with the first valid callback.
+        FRegistration Registration;
+        {
+            FScopeLock ScopeLock(&Lock);
+            const bool bKnown = Handlers.RemoveAndCopyValue(Token, Registration);
+            ++(bKnown ? Stats.Delivered : Stats.Rejected);
+            if (!bKnown) return EHttpServerResponseCodes::NotFound;
+        }
+        if (Registration.Handler)
+        {
+            const FUTF8ToTCHAR Text((const UTF8CHAR*)Body.GetData(), Body.Num());
+            Registration.Handler(MakeSharedText(FString(Text.Length(), Text.Get())));
+        }
+        return EHttpServerResponseCodes::Ok;
+    }
+
+    FWebhookReceiverStats FWebhookReceiver::GetStats() const
+    {
+        FScopeLock ScopeLock(&Lock);
+        FWebhookReceiverStats S = Stats;
+        S.Pending = Handlers.Num();
+        return S;
+    }
+
+    void FWebhookReceiver::Shutdown()
+    {
+        if (Router.IsValid() && RouteHandle.IsValid())
+        {
+            Router->UnbindRoute(RouteHandle);
+        }
+        RouteHandle.Reset();
+        Router.Reset();
+        BoundPort = 0;
+
+        FScopeLock ScopeLock(&Lock);
+        Handlers.Reset();
+    }
+}
@@ -0,0 +1,76 @@
+// Embedded HTTP listener (engine HTTPServer module) for vendor completion callbacks. Each
+// pending job registers under an unguessable token and gets a URL to hand the vendor; the
+// first POST to that URL that carries a valid signature is delivered to the job's handler.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "Templates/Function.h"
+#include "HttpRouteHandle.h"
+#include "HttpServerConstants.h"
+#include "SharedPayload.h"
+#include "WebhookSignature.h"
+
+class IHttpRouter;
+
+namespace NanoBanana::Http
+{
+    struct FWebhookReceiverStats
+    {
+        int32 Pending = 0;
+        int64 Registered = 0;
+        int64 Delivered = 0;
+        /** Callbacks for unknown or already-delivered tokens. */
+        int64 Rejected = 0;
+        /** Callbacks for a pending token whose signature did not verify. */
+        int64 Unauthorized = 0;
+    };
+
+    /**
+     * Register/Unregister are safe from any thread; the listener itself is bound on the game
+     * thread, where handlers are also called.
+     */
+    class FWebhookReceiver
+    {
+    public:
+        using FHandler = TFunction<void(const FSharedText& /*Body*/)>;
+
+        static constexpr const TCHAR* RoutePath = TEXT("/nanobanana/webhook");
+
+        static FWebhookReceiver& Get();
+
+        /**
+         * Starts the listener on Port if needed and returns the callback URL for a new token
+         * (PublicBaseUrl + RoutePath + "?job=<token>"), or empty if PublicBaseUrl or
+         * SigningSecret is empty or the port cannot be bound. Callbacks must be signed with
+         * SigningSecret (see WebhookSignature.h); unsigned ones leave the job pending.
+         * OutToken identifies the registration for Unregister.
+         */
+        FString Register(int32 Port, const FString& PublicBaseUrl, const FString& SigningSecret, FHandler Handler, FString& OutToken);
+
+        void Unregister(const FString& Token);
+
+        FWebhookReceiverStats GetStats() const;
+
+        /** Module shutdown: unbinds the route and drops pending handlers. */
+        void Shutdown();
+
+    private:
+        struct FRegistration
+        {
+            FString SigningSecret;
+            FHandler Handler;
+        };
+
+        bool EnsureListening(int32 Port);
+        /** Returns the HTTP status to answer with. */
+        EHttpServerResponseCodes Deliver(const FString& Token, const FWebhookSignatureHeaders& Headers, TConstArrayView<uint8> Body);
+
+        mutable FCriticalSection Lock;
+        TMap<FString, FRegistration> Handlers;
+        TSharedPtr<IHttpRouter> Router;
+        FHttpRouteHandle RouteHandle;
+        int32 BoundPort = 0;
+        FWebhookReceiverStats Stats;
+    };
+}
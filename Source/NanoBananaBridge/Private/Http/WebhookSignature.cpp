@@ -0,0 +1,191 @@
+#include "WebhookSignature.h"
+#include "Base64Codec.h"
+
+namespace NanoBanana::Http
+{
+    namespace
+    {
+        constexpr uint32 RoundConstants[64] = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+        };
+
+        FORCEINLINE uint32 RotateRight(uint32 X, uint32 N) { return (X >> N) | (X << (32 - N)); }
+
+        /** Incremental SHA-256 (FIPS 180-4), so HMAC can hash its pads and the message without concatenating them. */
+        class FSha256
+        {
+        public:
+            void Update(TConstArrayView<uint8> Data)
+            {
+                for (uint8 Byte : Data)
+                {
+                    Block[BlockLen++] = Byte;
+                    if (BlockLen == 64)
+                    {
+                        Compress();
+                        BlockLen = 0;
+                    }
+                }
+                TotalBytes += Data.Num();
+            }
+
+            void Final(uint8 (&OutDigest)[32])
+            {
+                const uint64 TotalBits = TotalBytes * 8;
+                Block[BlockLen++] = 0x80;
+                if (BlockLen > 56)
+                {
+                    FMemory::Memzero(Block + BlockLen, 64 - BlockLen);
+                    Compress();
+                    BlockLen = 0;
+                }
+                FMemory::Memzero(Block + BlockLen, 56 - BlockLen);
+                for (int32 i = 0; i < 8; ++i)
+                {
+                    Block[63 - i] = (uint8)(TotalBits >> (8 * i));
+                }
+                Compress();
+                for (int32 i = 0; i < 8; ++i)
+                {
+                    OutDigest[4 * i + 0] = (uint8)(State[i] >> 24);
+                    OutDigest[4 * i + 1] = (uint8)(State[i] >> 16);
+                    OutDigest[4 * i + 2] = (uint8)(State[i] >> 8);
+                    OutDigest[4 * i + 3] = (uint8)State[i];
+                }
+            }
+
+        private:
+            void Compress()
+            {
+                uint32 W[64];
+                for (int32 i = 0; i < 16; ++i)
+                {
+                    W[i] = (uint32)Block[4 * i] << 24 | (uint32)Block[4 * i + 1] << 16 | (uint32)Block[4 * i + 2] << 8 | (uint32)Block[4 * i + 3];
+                }
+                for (int32 i = 16; i < 64; ++i)
+                {
+                    const uint32 S0 = RotateRight(W[i - 15], 7) ^ RotateRight(W[i - 15], 18) ^ (W[i - 15] >> 3);
+                    const uint32 S1 = RotateRight(W[i - 2], 17) ^ RotateRight(W[i - 2], 19) ^ (W[i - 2] >> 10);
+                    W[i] = W[i - 16] + S0 + W[i - 7] + S1;
+                }
+
+                uint32 A = State[0], B = State[1], C = State[2], D = State[3], E = State[4], F = State[5], G = State[6], H = State[7];
+                for (int32 i = 0; i < 64; ++i)
+                {
+                    const uint32 T1 = H + (RotateRight(E, 6) ^ RotateRight(E, 11) ^ RotateRight(E, 25)) + ((E & F) ^ (~E & G)) + RoundConstants[i] + W[i];
+                    const uint32 T2 = (RotateRight(A, 2) ^ RotateRight(A, 13) ^ RotateRight(A, 22)) + ((A & B) ^ (A & C) ^ (B & C));
+                    H = G; G = F; F = E; E = D + T1;
+                    D = C; C = B; B = A; A = T1 + T2;
+                }
+                State[0] += A; State[1] += B; State[2] += C; State[3] += D;
+                State[4] += E; State[5] += F; State[6] += G; State[7] += H;
+            }
+
+            uint32 State[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+            uint8 Block[64];
+            int32 BlockLen = 0;
+            uint64 TotalBytes = 0;
+        };
+
+        bool ConstantTimeEquals(TConstArrayView<uint8> A, TConstArrayView<uint8> B)
+        {
+            if (A.Num() != B.Num()) return false;
+            uint8 Diff = 0;
+            for (int32 i = 0; i < A.Num(); ++i)
+            {
+                Diff |= A[i] ^ B[i];
+            }
+            return Diff == 0;
+        }
+    }
+
+    void Sha256(TConstArrayView<uint8> Data, uint8 (&OutDigest)[32])
+    {
+        FSha256 Hash;
+        Hash.Update(Data);
+        Hash.Final(OutDigest);
+    }
+
+    void HmacSha256(TConstArrayView<uint8> Key, TConstArrayView<uint8> Message, uint8 (&OutDigest)[32])
+    {
+        uint8 BlockKey[64] = {};
+        if (Key.Num() > 64)
+        {
+            uint8 KeyDigest[32];
+            Sha256(Key, KeyDigest);
+            FMemory::Memcpy(BlockKey, KeyDigest, sizeof(KeyDigest));
+        }
+        else if (Key.Num() > 0)
+        {
+            FMemory::Memcpy(BlockKey, Key.GetData(), Key.Num());
+        }
+
+        uint8 Pad[64];
+        for (int32 i = 0; i < 64; ++i) Pad[i] = BlockKey[i] ^ 0x36;
+        uint8 Inner[32];
+        FSha256 InnerHash;
+        InnerHash.Update(Pad);
+        InnerHash.Update(Message);
+        InnerHash.Final(Inner);
+
+        for (int32 i = 0; i < 64; ++i) Pad[i] = BlockKey[i] ^ 0x5c;
+        FSha256 OuterHash;
+        OuterHash.Update(Pad);
+        OuterHash.Update(Inner);
+        OuterHash.Final(OutDigest);
+    }
+
+    bool VerifyWebhookSignature(const FString& Secret, const FWebhookSignatureHeaders& Headers, TConstArrayView<uint8> Body, int64 NowUnixSeconds, FString& OutReason)
+    {
+        TArray<uint8> Key;
+        FStringView EncodedKey = Secret;
+        if (EncodedKey.StartsWith(TEXT("whsec_"))) EncodedKey.RightChopInline(6);
+        if (EncodedKey.IsEmpty() || !Base64::Decode(EncodedKey, Key))
+        {
+            OutReason = TEXT("signing secret is not whsec_<base64>");
+            return false;
+        }
+        if (Headers.Id.IsEmpty() || Headers.Timestamp.IsEmpty() || Headers.Signature.IsEmpty())
+        {
+            OutReason = TEXT("missing webhook-id / webhook-timestamp / webhook-signature");
+            return false;
+        }
+        int64 Timestamp = 0;
+        if (!Headers.Timestamp.IsNumeric() || !LexTryParseString(Timestamp, *Headers.Timestamp)
+            || FMath::Abs(NowUnixSeconds - Timestamp) > WebhookTimestampToleranceSeconds)
+        {
+            OutReason = FString::Printf(TEXT("timestamp %s is outside the tolerance"), *Headers.Timestamp);
+            return false;
+        }
+
+        const FTCHARToUTF8 Prefix(*FString::Printf(TEXT("%s.%s."), *Headers.Id, *Headers.Timestamp));
+        TArray<uint8> Signed;
+        Signed.Reserve(Prefix.Length() + Body.Num());
+        Signed.Append((const uint8*)Prefix.Get(), Prefix.Length());
+        Signed.Append(Body.GetData(), Body.Num());
+        uint8 Expected[32];
+        HmacSha256(Key, Signed, Expected);
+
+        TArray<FString> Entries;
+        Headers.Signature.ParseIntoArray(Entries, TEXT(" "));
+        for (const FString& Entry : Entries)
+        {
+            FString Version, Encoded;
+            TArray<uint8> Candidate;
+            if (Entry.Split(TEXT(","), &Version, &Encoded) && Version == TEXT("v1")
+                && Base64::Decode(FStringView(Encoded), Candidate) && ConstantTimeEquals(Candidate, Expected))
+            {
+                return true;
+            }
+        }
+        OutReason = TEXT("no matching v1 signature");
+        return false;
+    }
+}
@@ -0,0 +1,33 @@
+// Signature check for vendor webhook callbacks in the Standard Webhooks scheme Replicate uses:
+// "webhook-signature" carries base64 HMAC-SHA256 over "<webhook-id>.<webhook-timestamp>.<body>",
+// keyed with the account's signing secret ("whsec_" + base64 key).
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace NanoBanana::Http
+{
+    /** Callbacks stamped further than this from the local clock are refused (replays). */
+    constexpr int64 WebhookTimestampToleranceSeconds = 5 * 60;
+
+    /** SHA-256 of Data. */
+    void Sha256(TConstArrayView<uint8> Data, uint8 (&OutDigest)[32]);
+
+    /** HMAC-SHA256 (RFC 2104) of Message under Key. */
+    void HmacSha256(TConstArrayView<uint8> Key, TConstArrayView<uint8> Message, uint8 (&OutDigest)[32]);
+
+    /** What a callback brought besides its body. Header values as received. */
+    struct FWebhookSignatureHeaders
+    {
+        FString Id;
+        FString Timestamp;
+        /** Space-separated "v1,<base64>" entries; any one matching is enough (secret rotation). */
+        FString Signature;
+    };
+
+    /**
+     * True when Headers carry a valid signature of Body under Secret and the timestamp is
+     * within WebhookTimestampToleranceSeconds of NowUnixSeconds. OutReason says why not.
+     */
+    bool VerifyWebhookSignature(const FString& Secret, const FWebhookSignatureHeaders& Headers, TConstArrayView<uint8> Body, int64 NowUnixSeconds, FString& OutReason);
+}
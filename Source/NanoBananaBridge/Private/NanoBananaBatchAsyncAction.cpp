@@ -0,0 +1,163 @@
+#include "NanoBananaBatchAsyncAction.h"
+
+UNanoBananaBatchAsyncAction* UNanoBananaBatchAsyncAction::BatchGenerateImages(UObject* InWorldContextObject, const TArray<FNanoBananaRequest>& InRequests, int32 InMaxConcurrency,
+    ENanoBananaJobPriority InPriority)
+{
+    static uint32 NextBatchSerial = 0;
+
+    UNanoBananaBatchAsyncAction* Action = NewObject<UNanoBananaBatchAsyncAction>();
+    Action->WorldContextObject = InWorldContextObject;
+    Action->Requests = InRequests;
+    for (FNanoBananaRequest& Request : Action->Requests)
+    {
+        Request.Priority = InPriority;
+    }
+    Action->MaxConcurrency = FMath::Max(1, InMaxConcurrency);
+    Action->BatchSerial = ++NextBatchSerial;
+    Action->RegisterWithGameInstance(InWorldContextObject);
+    return Action;
+}
+
+void UNanoBananaBatchAsyncAction::Activate()
+{
+    Items.SetNum(Requests.Num());
+    Results.SetNum(Requests.Num());
+    ItemActions.SetNum(Requests.Num());
+    Pump();
+    FinishIfDone();
+}
+
+void UNanoBananaBatchAsyncAction::Cancel()
+{
+    if (bFinished || bCanceling) return;
+    bCanceling = true;
+    for (int32 i = 0; i < Items.Num(); ++i)
+    {
+        if (Items[i].State == EItemState::Running && ItemActions[i])
+        {
+            // Fails through OnFailedNative, which finishes the item.
+            ItemActions[i]->Cancel();
+        }
+        if (Items[i].State != EItemState::Done)
+        {
+            FNanoBananaBatchItemResult Canceled;
+            Canceled.Error = TEXT("Canceled");
+            FinishItem(i, MoveTemp(Canceled));
+        }
+    }
+}
+
+void UNanoBananaBatchAsyncAction::BeginDestroy()
+{
+    // Items still running keep going on their own and give their scheduler slots back when
+    // they finish; only the bindings to this batch are gone.
+    for (TObjectPtr<UNanoBananaBridgeAsyncAction>& Action : ItemActions)
+    {
+        if (Action)
+        {
+            Action->OnProgressNative.RemoveAll(this);
+            Action->OnCompletedNative.RemoveAll(this);
+            Action->OnFailedNative.RemoveAll(this);
+        }
+    }
+    Super::BeginDestroy();
+}
+
+void UNanoBananaBatchAsyncAction::Pump()
+{
+    // Items finishing synchronously call back in here; the outer pass picks up their places.
+    if (bPumping || bCanceling || bFinished) return;
+    TGuardValue<bool> Guard(bPumping, true);
+
+    for (int32 i = 0; i < Items.Num(); ++i)
+    {
+        if (Items[i].State != EItemState::Pending) continue;
+        int32& InFlight = InFlightByVendor.FindOrAdd(Requests[i].Vendor);
+        if (InFlight >= MaxConcurrency) continue;
+        ++InFlight;
+        StartItem(i);
+    }
+}
+
+void UNanoBananaBatchAsyncAction::StartItem(int32 Index)
+{
+    Items[Index].State = EItemState::Running;
+
+    UNanoBananaBridgeAsyncAction* Action = UNanoBananaBridgeAsyncAction::GenerateImage(WorldContextObject.Get(), Requests[Index], /*bAlsoSaveComposite*/ false);
+    Action->ResultSuffix = FString::Printf(TEXT("_B%u_%03d"), BatchSerial, Index);
+    Action->OnProgressNative.AddUObject(this, &UNanoBananaBatchAsyncAction::HandleItemProgress, Index);
+    Action->OnCompletedNative.AddUObject(this, &UNanoBananaBatchAsyncAction::HandleItemCompleted, Index);
+    Action->OnFailedNative.AddUObject(this, &UNanoBananaBatchAsyncAction::HandleItemFailed, Index);
+    ItemActions[Index] = Action;
+    Action->Activate();
+}
+
+void UNanoBananaBatchAsyncAction::HandleItemProgress(float Percent, const FString& Stage, int32 Index)
+{
+    if (bFinished || Items[Index].State != EItemState::Running) return;
+    Items[Index].Percent = FMath::Clamp(Percent, 0.0f, 1.0f);
+    OnItemProgress.Broadcast(Index, Percent, Stage);
+    BroadcastOverallProgress();
+}
+
+void UNanoBananaBatchAsyncAction::HandleItemCompleted(const TArray<FNanoBananaImageResult>& Images, int32 Index)
+{
+    FNanoBananaBatchItemResult Result;
+    Result.bSucceeded = true;
+    Result.Images = Images;
+    FinishItem(Index, MoveTemp(Result));
+}
+
+void UNanoBananaBatchAsyncAction::HandleItemFailed(const FString& Error, int32 Index)
+{
+    FNanoBananaBatchItemResult Result;
+    Result.Error = Error;
+    FinishItem(Index, MoveTemp(Result));
+}
+
+void UNanoBananaBatchAsyncAction::FinishItem(int32 Index, FNanoBananaBatchItemResult&& Result)
+{
+    FItem& Item = Items[Index];
+    if (bFinished || Item.State == EItemState::Done) return;
+
+    if (Item.State == EItemState::Running)
+    {
+        if (int32* InFlight = InFlightByVendor.Find(Requests[Index].Vendor))
+        {
+            *InFlight = FMath::Max(0, *InFlight - 1);
+        }
+    }
+    Item.State = EItemState::Done;
+    Item.Percent = 1.0f;
+    ++NumDone;
+    if (Result.bSucceeded) ++NumSucceeded;
+    Results[Index] = MoveTemp(Result);
+    ItemActions[Index] = nullptr;
+
+    OnItemFinished.Broadcast(Index, Results[Index]);
+    BroadcastOverallProgress();
+
+    Pump();
+    FinishIfDone();
+}
+
+void UNanoBananaBatchAsyncAction::BroadcastOverallProgress()
+{
+    if (Items.Num() == 0) return;
+    float Sum = 0.0f;
+    for (const FItem& Item : Items)
+    {
+        Sum += Item.Percent;
+    }
+    OnProgress.Broadcast(Sum / Items.Num(), FString::Printf(TEXT("%d/%d done"), NumDone, Items.Num()));
+}
+
+void UNanoBananaBatchAsyncAction::FinishIfDone()
+{
+    if (bFinished || NumDone < Items.Num()) return;
+    bFinished = true;
+    OnProgress.Broadcast(1.0f, TEXT("Completed"));
+    OnCompleted.Broadcast(Results, NumSucceeded, NumDone - NumSucceeded);
+    ItemActions.Empty();
+    SetReadyToDestroy();
+}
@@ -1,10 +1,21 @@
 #include "NanoBananaBridgeAsyncAction.h"
 #include "NanoBananaSettings.h"
+#include "NanoBananaJobScheduler.h"
+#include "NanoBananaLog.h"
 #include "ViewportCaptureLibrary.h"
 #include "ImageComposerLibrary.h"
 #include "Providers/IImageGenProvider.h"
 #include "Providers/ProviderFactory.h"
-#include "ImageUtils.h"
+#include "Http/ReferencePreparer.h"
+#include "Http/ResultDecoder.h"
+#include "Http/SharedPayload.h"
+#include "ProviderEventChannel.h"
+#include "RequestCoalescer.h"
+#include "RequestFingerprint.h"
+#include "ResultCache.h"
+#include "DerivedDataResultCache.h"
+#include "IImageWrapperModule.h"
+#include "Modules/ModuleManager.h"
 
 #include "Engine/Texture2D.h"
 #include "Engine/TextureRenderTarget2D.h"
@@ -13,6 +24,10 @@
 #include "Misc/FileHelper.h"
 #include "Misc/DateTime.h"
 #include "Async/Async.h"
+#include "Tasks/Task.h"
+#include "HAL/PlatformTime.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include <atomic>
 
 UNanoBananaBridgeAsyncAction* UNanoBananaBridgeAsyncAction::GenerateImage(UObject* InWorldContextObject, const FNanoBananaRequest& InRequest, bool bInAlsoSaveComposite)
 {
@@ -56,28 +71,47 @@ UNanoBananaBridgeAsyncAction* UNanoBananaBridgeAsyncAction::CaptureViewportAndGe
 void UNanoBananaBridgeAsyncAction::Cancel()
 {
     if (bFinished) return;
+    ReleaseSchedulerSlot();
+    if (ReferencePrep.IsValid())
+    {
+        ReferencePrep->Cancel();
+    }
     if (Provider.IsValid())
     {
         Provider->Cancel();
     }
+    // Requests that were waiting on this execution start their own.
+    for (UNanoBananaBridgeAsyncAction* Follower : StopLeading())
+    {
+        Follower->JoinOrQueue();
+    }
     Fail(TEXT("Canceled"));
 }
 
 void UNanoBananaBridgeAsyncAction::BeginDestroy()
 {
+    ReleaseSchedulerSlot();
+    StopLeading();
+    if (ReferencePrep.IsValid())
+    {
+        ReferencePrep->Cancel();
+        ReferencePrep.Reset();
+    }
     if (Provider.IsValid())
     {
         Provider->Cancel();
         Provider.Reset();
     }
+    CloseEvents();
     Super::BeginDestroy();
 }
 
 void UNanoBananaBridgeAsyncAction::Activate()
 {
+    ActivatedSeconds = FPlatformTime::Seconds();
     if (Mode == EMode::CaptureFirst)
     {
-        OnProgress.Broadcast(0.05f, TEXT("Capturing viewport"));
+        BroadcastProgress(0.05f, TEXT("Capturing viewport"));
 
         const UNanoBananaSettings& S = UNanoBananaSettings::Get();
         const FString AbsBaseDir = FPaths::ConvertRelativePathToFull(S.OutputDirectory);
@@ -105,136 +139,613 @@ void UNanoBananaBridgeAsyncAction::HandleCaptured(const FViewportCaptureResult&
     Ref.FilePath = SavedPath.IsEmpty() ? InputSavePath : SavedPath;
     Request.ReferenceImages.Insert(Ref, 0);
 
-    OnProgress.Broadcast(0.15f, TEXT("Submitting request"));
+    BroadcastProgress(0.15f, TEXT("Submitting request"));
     RunProvider();
 }
 
 void UNanoBananaBridgeAsyncAction::RunProvider()
 {
-    Provider = FProviderFactory::Make(Request.Vendor);
-    if (!Provider.IsValid())
+    // Snapshot reference pixels here and encode them on the task graph. The encoded bytes
+    // decide the request's fingerprint, so nothing is looked up, queued or sent before this.
+    if (Request.ReferenceImages.Num() > 0)
     {
-        Fail(FString::Printf(TEXT("Unsupported vendor: %s"), *FNanoBananaTypeUtils::VendorToString(Request.Vendor)));
-        return;
+        BroadcastProgress(0.17f, TEXT("Encoding reference images"));
     }
-
-    FProviderCallbacks Cb;
+    // Only coalescing and the result caches read the fingerprint; without them the mask is not
+    // read back and nothing is hashed.
+    const bool bBypass = Request.CachePolicy == ENanoBananaCachePolicy::Bypass;
+    bNeedsFingerprint = NanoBanana::CanCoalesce(Request)
+        || (!bBypass && (NanoBanana::FResultCache::IsCacheable(Request) || NanoBanana::FDerivedDataResultCache::IsEnabledFor(Request)));
     TWeakObjectPtr<UNanoBananaBridgeAsyncAction> Weak(this);
-
-    Cb.OnProgress = [Weak](float Pct, const FString& Stage)
-    {
-        AsyncTask(ENamedThreads::GameThread, [Weak, Pct, Stage]()
+    ReferencePrep = NanoBanana::Image::FReferencePreparer::Start(Request, /*bHashMask*/ bNeedsFingerprint,
+        [Weak](TArray<NanoBanana::Image::FEncodedReferenceRef> References, uint64 MaskKey)
         {
-            if (UNanoBananaBridgeAsyncAction* This = Weak.Get())
+            UNanoBananaBridgeAsyncAction* This = Weak.Get();
+            if (This && !This->bFinished)
             {
-                if (!This->bFinished) This->OnProgress.Broadcast(Pct, Stage);
+                This->ReferencePrep.Reset();
+                This->HandleReferencesReady(MoveTemp(References), MaskKey);
             }
         });
-    };
-    Cb.OnSuccess = [Weak](TArray<TArray<uint8>> Images, const FString& RawResponse)
+}
+
+void UNanoBananaBridgeAsyncAction::HandleReferencesReady(TArray<NanoBanana::Image::FEncodedReferenceRef> References, uint64 MaskKey)
+{
+    PreparedReferences = MoveTemp(References);
+    Fingerprint = bNeedsFingerprint ? NanoBanana::ComputeRequestFingerprint(Request, PreparedReferences, MaskKey) : 0;
+    if (TryServeFromCache()) return;
+    JoinOrQueue();
+}
+
+bool UNanoBananaBridgeAsyncAction::TryServeFromCache()
+{
+    using NanoBanana::FResultCache;
+    const bool bBypass = Request.CachePolicy == ENanoBananaCachePolicy::Bypass;
+    bStoreInResultCache = !bBypass && FResultCache::IsCacheable(Request);
+    bStoreInSharedCache = !bBypass && NanoBanana::FDerivedDataResultCache::IsEnabledFor(Request);
+    // Refresh generates again and overwrites the entries.
+    if (Request.CachePolicy == ENanoBananaCachePolicy::Refresh) return false;
+    if (!bStoreInResultCache)
+    {
+        if (!bStoreInSharedCache) return false;
+        LoadFromSharedCache();
+        return true;
+    }
+
+    const UNanoBananaSettings& S = UNanoBananaSettings::Get();
+    FResultCache& Cache = FResultCache::Get();
+    Cache.SetLimits((int64)S.ResultCacheMaxMegabytes * 1024 * 1024, FTimespan::FromDays(S.ResultCacheMaxAgeDays));
+    if (!Cache.Probe(Fingerprint))
+    {
+        if (!bStoreInSharedCache) return false;
+        LoadFromSharedCache();
+        return true;
+    }
+
+    // A hit needs no provider, vendor slot or network; the files are read on a worker.
+    BroadcastProgress(0.5f, TEXT("Loading cached result"));
+    TWeakObjectPtr<UNanoBananaBridgeAsyncAction> Weak(this);
+    UE::Tasks::Launch(UE_SOURCE_LOCATION, [Weak, Key = Fingerprint]()
     {
-        AsyncTask(ENamedThreads::GameThread, [Weak, Images = MoveTemp(Images), RawResponse]() mutable
+        TArray<TArray<uint8>> Images;
+        TArray<FString> CachePaths;
+        const bool bLoaded = FResultCache::Get().Load(Key, Images, CachePaths);
+        AsyncTask(ENamedThreads::GameThread, [Weak, bLoaded, Images = MoveTemp(Images)]() mutable
         {
-            if (UNanoBananaBridgeAsyncAction* This = Weak.Get())
+            UNanoBananaBridgeAsyncAction* This = Weak.Get();
+            if (!This || This->bFinished) return;
+            if (!bLoaded)
             {
-                This->HandleSuccess(MoveTemp(Images), RawResponse);
+                // The entry vanished from disk; try the team's copy, or generate after all.
+                if (This->bStoreInSharedCache)
+                {
+                    This->LoadFromSharedCache();
+                }
+                else
+                {
+                    This->JoinOrQueue();
+                }
+                return;
             }
+            // Saved to OutputDirectory like any other result: the cache's own files go away on
+            // eviction, Refresh or Clear, so they can't be handed out as SavedPath.
+            This->bServedFromCache = true;
+            This->ResultStamp = FDateTime::Now().ToString(TEXT("%Y%m%d_%H%M%S")) + This->ResultSuffix;
+            This->HandleSuccess(MoveTemp(Images), TArray<FString>(), MakeShared<const FString, ESPMode::ThreadSafe>());
         });
-    };
-    Cb.OnFailure = [Weak](const FString& Err)
-    {
-        AsyncTask(ENamedThreads::GameThread, [Weak, Err]()
+    });
+    return true;
+}
+
+void UNanoBananaBridgeAsyncAction::LoadFromSharedCache()
+{
+    BroadcastProgress(0.17f, TEXT("Checking shared cache"));
+    TWeakObjectPtr<UNanoBananaBridgeAsyncAction> Weak(this);
+    NanoBanana::FDerivedDataResultCache::Get().Load(Fingerprint,
+        [Weak](bool bFound, TArray<TArray<uint8>> Images, NanoBanana::FResultMetadata Metadata)
         {
-            if (UNanoBananaBridgeAsyncAction* This = Weak.Get())
+            AsyncTask(ENamedThreads::GameThread, [Weak, bFound, Images = MoveTemp(Images), CreatedBy = MoveTemp(Metadata.CreatedBy)]() mutable
             {
-                This->Fail(Err);
-            }
+                UNanoBananaBridgeAsyncAction* This = Weak.Get();
+                if (!This || This->bFinished) return;
+                if (!bFound)
+                {
+                    This->JoinOrQueue();
+                    return;
+                }
+                UE_LOG(LogNanoBanana, Verbose, TEXT("Request %016llx served from the DerivedDataCache (generated by %s)."), This->Fingerprint, *CreatedBy);
+                // Saved to OutputDirectory like a fresh result, and kept in the local cache.
+                This->bServedFromSharedCache = true;
+                This->ResultStamp = FDateTime::Now().ToString(TEXT("%Y%m%d_%H%M%S")) + This->ResultSuffix;
+                This->HandleSuccess(MoveTemp(Images), TArray<FString>(), MakeShared<const FString, ESPMode::ThreadSafe>());
+            });
         });
-    };
-    Cb.OnRequestBuilt = [Weak](const FString& Body)
+}
+
+void UNanoBananaBridgeAsyncAction::JoinOrQueue()
+{
+    if (TryJoinInFlight()) return;
+    QueueForVendor();
+}
+
+void UNanoBananaBridgeAsyncAction::QueueForVendor()
+{
+    UNanoBananaJobScheduler* Scheduler = UNanoBananaJobScheduler::Get();
+    if (!Scheduler)
+    {
+        StartProvider();
+        return;
+    }
+
+    // The scheduler decides when this request may reach its vendor (priority, per-vendor cap,
+    // rate limit, Retry-After); the slot is held until the vendor has answered.
+    TWeakObjectPtr<UNanoBananaBridgeAsyncAction> Weak(this);
+    const ENanoBananaVendor Vendor = Request.Vendor;
+    bQueuedInScheduler = true;
+    const UNanoBananaJobScheduler::FJobId JobId = Scheduler->Enqueue(Vendor, Request.Priority, [Weak, Vendor]()
+    {
+        UNanoBananaBridgeAsyncAction* This = Weak.Get();
+        if (!This || This->bFinished || !This->bQueuedInScheduler)
+        {
+            if (UNanoBananaJobScheduler* S = UNanoBananaJobScheduler::Get()) S->Release(Vendor);
+            return;
+        }
+        This->bQueuedInScheduler = false;
+        This->bHoldsSchedulerSlot = true;
+        This->StartProvider();
+    });
+    if (bQueuedInScheduler)
+    {
+        SchedulerJobId = JobId;
+        BroadcastProgress(0.16f, TEXT("Waiting for a free slot"));
+    }
+}
+
+void UNanoBananaBridgeAsyncAction::StartProvider()
+{
+    Provider = FProviderFactory::MakeForRequest(Request);
+    if (!Provider.IsValid())
     {
-        AsyncTask(ENamedThreads::GameThread, [Weak, Body]()
+        Fail(FString::Printf(TEXT("Unsupported vendor: %s"), *FNanoBananaTypeUtils::VendorToString(Request.Vendor)));
+        return;
+    }
+    SubmitToProvider(PreparedReferences);
+}
+
+void UNanoBananaBridgeAsyncAction::SubmitToProvider(const TArray<NanoBanana::Image::FEncodedReferenceRef>& References)
+{
+    if (!Provider.IsValid()) return;
+
+    // Every callback lands in this action's event channel; one per-frame pump delivers them
+    // here, so a progress tick costs a queue slot instead of a task-graph node.
+    using NanoBanana::FProviderEvent;
+    TWeakObjectPtr<UNanoBananaBridgeAsyncAction> Weak(this);
+    TSharedRef<NanoBanana::FProviderEventChannel, ESPMode::ThreadSafe> Channel = NanoBanana::FProviderEventChannel::Create(
+        [Weak](FProviderEvent& Event)
         {
             if (UNanoBananaBridgeAsyncAction* This = Weak.Get())
             {
-                This->DumpDebug(TEXT("_request.json"), Body);
+                This->HandleProviderEvent(Event);
             }
         });
+    Events = Channel;
+
+    FProviderCallbacks Cb;
+    Cb.OnProgress = [Channel](float Pct, const FString& Stage)
+    {
+        Channel->Push(FProviderEvent::MakeProgress(Pct, Stage));
+    };
+    Cb.OnSuccess = [Channel](TArray<TArray<uint8>> Images, TArray<FString> SavedPaths, const NanoBanana::FSharedText& RawResponse)
+    {
+        Channel->Push(FProviderEvent::MakeSucceeded(MoveTemp(Images), MoveTemp(SavedPaths), RawResponse));
     };
+    Cb.OnFailure = [Channel](const FString& Err)
+    {
+        Channel->Push(FProviderEvent::MakeFailed(Err));
+    };
+    // Downloaded results are streamed straight to their final paths.
+    const UNanoBananaSettings& S = UNanoBananaSettings::Get();
+    ResultStamp = FDateTime::Now().ToString(TEXT("%Y%m%d_%H%M%S")) + ResultSuffix;
+    Cb.ResolveDownloadPath = [AbsBaseDir = FPaths::ConvertRelativePathToFull(S.OutputDirectory),
+                              Ext = FNanoBananaTypeUtils::OutputFormatToExt(Request.OutputFormat),
+                              Stamp = ResultStamp](int32 Index, int32 Count)
+    {
+        return MakeResultPath(AbsBaseDir, Stamp, Ext, Index, Count);
+    };
+    Cb.OnImageReady = [Channel](int32 Index, const TArray<uint8>& Bytes)
+    {
+        // Decode where the provider calls from (a worker or the HTTP thread); the game
+        // thread only turns the pixels into a texture.
+        TSharedRef<FImage, ESPMode::ThreadSafe> Image = MakeShared<FImage, ESPMode::ThreadSafe>();
+        if (!NanoBanana::Image::DecodeResultImage(Bytes, *Image)) return;
+        Channel->Push(FProviderEvent::MakeImageReady(Index, Image));
+    };
+    Cb.OnRequestBuilt = [Channel](const NanoBanana::FSharedBytes& Body)
+    {
+        if (!UNanoBananaSettings::Get().bSaveDebugRequestResponse) return;
+        // Holds a reference to the buffer being sent; nothing is copied.
+        Channel->Push(FProviderEvent::MakeRequestBuilt(Body));
+    };
+    Cb.OnRateLimited = [Channel](ENanoBananaVendor Vendor, float RetryAfterSeconds)
+    {
+        Channel->Push(FProviderEvent::MakeRateLimited(Vendor, RetryAfterSeconds));
+    };
+
+    // Streamed images are decoded off the game thread, where modules must not be loaded.
+    FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+    Provider->Submit(Request, References, Cb);
+}
 
-    Provider->Submit(Request, Cb);
+void UNanoBananaBridgeAsyncAction::HandleProviderEvent(NanoBanana::FProviderEvent& Event)
+{
+    using EKind = NanoBanana::FProviderEvent::EKind;
+    if (bFinished) return;
+    switch (Event.Kind)
+    {
+    case EKind::Progress:
+        BroadcastProgress(Event.Percent, Event.Text);
+        ForEachFollower([&Event](UNanoBananaBridgeAsyncAction& Follower) { Follower.BroadcastProgress(Event.Percent, Event.Text); });
+        break;
+    case EKind::ImageReady:
+        HandleImageReady(Event.Index, *Event.Image);
+        break;
+    case EKind::RequestBuilt:
+        DumpDebug(TEXT("_request.json"), *Event.Body);
+        break;
+    case EKind::Succeeded:
+        HandleSuccess(MoveTemp(Event.Images), MoveTemp(Event.SavedPaths), Event.RawResponse.ToSharedRef());
+        break;
+    case EKind::RateLimited:
+        bRateLimited = true;
+        if (UNanoBananaJobScheduler* Scheduler = UNanoBananaJobScheduler::Get())
+        {
+            Scheduler->ReportRateLimited((ENanoBananaVendor)Event.Index, Event.Percent);
+        }
+        break;
+    case EKind::Failed:
+        if (bRateLimited && RateLimitRetries < UNanoBananaSettings::Get().MaxRateLimitRetries)
+        {
+            RetryAfterRateLimit(Event.Text);
+            break;
+        }
+        Fail(Event.Text);
+        break;
+    default:
+        break;
+    }
 }
 
-void UNanoBananaBridgeAsyncAction::HandleSuccess(TArray<TArray<uint8>> Images, const FString& RawResponse)
+void UNanoBananaBridgeAsyncAction::HandleImageReady(int32 Index, const FImage& Image)
 {
     if (bFinished) return;
+    UTexture2D* Texture = NanoBanana::Image::CreateResultTexture(Image);
+    if (!Texture) return;
+    if (StreamedTextures.Num() <= Index)
+    {
+        StreamedTextures.SetNum(Index + 1);
+    }
+    StreamedTextures[Index] = Texture;
+    OnImageReady.Broadcast(Index, Texture);
+    ForEachFollower([Index, Texture](UNanoBananaBridgeAsyncAction& Follower)
+    {
+        if (Follower.StreamedTextures.Num() <= Index)
+        {
+            Follower.StreamedTextures.SetNum(Index + 1);
+        }
+        Follower.StreamedTextures[Index] = Texture;
+        Follower.OnImageReady.Broadcast(Index, Texture);
+    });
+}
+
+void UNanoBananaBridgeAsyncAction::HandleSuccess(TArray<TArray<uint8>> Images, TArray<FString> SavedPaths, const TSharedRef<const FString, ESPMode::ThreadSafe>& RawResponse)
+{
+    if (bFinished) return;
+    // The vendor has answered; saving and decoding don't need its slot.
+    ReleaseSchedulerSlot();
     if (Images.Num() == 0)
     {
         Fail(TEXT("Empty result image."));
         return;
     }
 
-    DumpDebug(TEXT("_response.json"), RawResponse);
-
     const UNanoBananaSettings& S = UNanoBananaSettings::Get();
     const FString AbsBaseDir = FPaths::ConvertRelativePathToFull(S.OutputDirectory);
     const FString Ext = FNanoBananaTypeUtils::OutputFormatToExt(Request.OutputFormat);
+    const FString DebugPath = (S.bSaveDebugRequestResponse && !RawResponse->IsEmpty()) ? MakeDebugPath(TEXT("_response.json")) : FString();
+    const bool bWantComposite = bAlsoSaveComposite && !InputSavePath.IsEmpty();
+    // Fresh results become a cache entry; a hit is already one. A shared hit is new locally.
+    const bool bStoreResults = bStoreInResultCache && !bServedFromCache;
+    const bool bShareResults = bStoreInSharedCache && !bServedFromCache && !bServedFromSharedCache;
+    const NanoBanana::FResultMetadata SharedMetadata = bShareResults ? NanoBanana::FResultMetadata::Describe(Request) : NanoBanana::FResultMetadata();
 
-    OnProgress.Broadcast(0.9f, TEXT("Saving images"));
+    BroadcastProgress(0.9f, TEXT("Saving images"));
+    ForEachFollower([](UNanoBananaBridgeAsyncAction& Follower) { Follower.BroadcastProgress(0.9f, TEXT("Saving images")); });
 
     // Save all results with consistent timestamped basename.
-    const FString Stamp = FDateTime::Now().ToString(TEXT("%Y%m%d_%H%M%S"));
-    IPlatformFile& PF = FPlatformFileManager::Get().GetPlatformFile();
-    if (!PF.DirectoryExists(*AbsBaseDir)) { PF.CreateDirectoryTree(*AbsBaseDir); }
+    const FString Stamp = ResultStamp;
+    const FString CompositePath = !bWantComposite ? FString()
+        : CompositeSavePath.IsEmpty() ? AbsBaseDir / FString::Printf(TEXT("NanoBanana_%s_Composite.png"), *Stamp)
+        : CompositeSavePath;
 
-    TArray<FNanoBananaImageResult> Results;
-    Results.Reserve(Images.Num());
+    // Workers must not trigger module loads; make sure the decoders are resident first.
+    FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+
+    // Staged on workers: every image saves and decodes in its own task, alongside the
+    // composite, the cache stores and the debug dump. The game thread only creates textures
+    // and broadcasts once all of them are done.
+    struct FPrepared
+    {
+        TArray<FNanoBananaImageResult> Results;
+        TArray<FImage> Decoded;
+        FString CompositePath;
+        std::atomic<uint64> SaveCycles { 0 };
+        std::atomic<uint64> DecodeCycles { 0 };
+        uint64 CompositeCycles = 0;
+        uint64 CacheStoreCycles = 0;
+    };
+    TSharedRef<FPrepared, ESPMode::ThreadSafe> Prepared = MakeShared<FPrepared, ESPMode::ThreadSafe>();
+    Prepared->Results.SetNum(Images.Num());
+    Prepared->Decoded.SetNum(Images.Num());
     for (int32 i = 0; i < Images.Num(); ++i)
     {
-        FNanoBananaImageResult R;
-        R.PngBytes = MoveTemp(Images[i]);
-        const FString Suffix = (Images.Num() == 1)
-            ? FString::Printf(TEXT("_Result%s"), *Ext)
-            : FString::Printf(TEXT("_Result_%02d%s"), i + 1, *Ext);
-        R.SavedPath = AbsBaseDir / FString::Printf(TEXT("NanoBanana_%s%s"), *Stamp, *Suffix);
-        FFileHelper::SaveArrayToFile(R.PngBytes, *R.SavedPath);
-        R.Texture = FImageUtils::ImportBufferAsTexture2D(R.PngBytes);
-        Results.Add(MoveTemp(R));
+        Prepared->Results[i].PngBytes = MoveTemp(Images[i]);
     }
+    Timings.ResponseMs = (float)((FPlatformTime::Seconds() - ActivatedSeconds) * 1000.0);
+    const uint64 PersistStartCycles = FPlatformTime::Cycles64();
 
+    // Stages only read PngBytes, and each writes its own fields, so none waits on another.
+    TArray<UE::Tasks::FTask> Stages;
+    if (!DebugPath.IsEmpty())
+    {
+        Stages.Add(UE::Tasks::Launch(UE_SOURCE_LOCATION, [Prepared, RawResponse, DebugPath]()
+        {
+            TRACE_CPUPROFILER_EVENT_SCOPE(NanoBanana_SaveDebugResponse);
+            const uint64 Start = FPlatformTime::Cycles64();
+            FFileHelper::SaveStringToFile(*RawResponse, *DebugPath);
+            Prepared->SaveCycles += FPlatformTime::Cycles64() - Start;
+        }));
+    }
+    for (int32 i = 0; i < Prepared->Results.Num(); ++i)
+    {
+        // Images already streamed through OnImageReady have a texture; don't decode them again.
+        const bool bHasTexture = StreamedTextures.IsValidIndex(i) && StreamedTextures[i] != nullptr;
+        FString SavedPath = SavedPaths.IsValidIndex(i) ? MoveTemp(SavedPaths[i]) : FString();
+        Stages.Add(UE::Tasks::Launch(UE_SOURCE_LOCATION,
+            [Prepared, i, bHasTexture, SavedPath = MoveTemp(SavedPath), AbsBaseDir, Stamp, Ext]() mutable
+            {
+                FNanoBananaImageResult& R = Prepared->Results[i];
+                if (!SavedPath.IsEmpty())
+                {
+                    R.SavedPath = MoveTemp(SavedPath); // already written while downloading
+                }
+                else
+                {
+                    TRACE_CPUPROFILER_EVENT_SCOPE(NanoBanana_SaveResult);
+                    const uint64 Start = FPlatformTime::Cycles64();
+                    R.SavedPath = MakeResultPath(AbsBaseDir, Stamp, Ext, i, Prepared->Results.Num());
+                    FFileHelper::SaveArrayToFile(R.PngBytes, *R.SavedPath);
+                    Prepared->SaveCycles += FPlatformTime::Cycles64() - Start;
+                }
+                if (!bHasTexture)
+                {
+                    TRACE_CPUPROFILER_EVENT_SCOPE(NanoBanana_DecodeResult);
+                    const uint64 Start = FPlatformTime::Cycles64();
+                    NanoBanana::Image::DecodeResultImage(R.PngBytes, Prepared->Decoded[i]);
+                    Prepared->DecodeCycles += FPlatformTime::Cycles64() - Start;
+                }
+            }));
+    }
     // Optional side-by-side composite (only meaningful if there's an input).
-    FString CompositePath;
-    if (bAlsoSaveComposite && Results.Num() > 0)
+    if (!CompositePath.IsEmpty())
     {
-        TArray<uint8> InputPng;
-        if (!InputSavePath.IsEmpty() && FFileHelper::LoadFileToArray(InputPng, *InputSavePath) && InputPng.Num() > 0)
+        Stages.Add(UE::Tasks::Launch(UE_SOURCE_LOCATION, [Prepared, InputPath = InputSavePath, CompositePath]()
         {
+            TRACE_CPUPROFILER_EVENT_SCOPE(NanoBanana_SaveComposite);
+            const uint64 Start = FPlatformTime::Cycles64();
+            TArray<uint8> InputPng;
             TArray<uint8> CompositePng;
-            if (UImageComposerLibrary::ComposeSideBySidePNGs(InputPng, Results[0].PngBytes, CompositePng, 8)
-                && CompositePng.Num() > 0)
+            if (FFileHelper::LoadFileToArray(InputPng, *InputPath) && InputPng.Num() > 0
+                && UImageComposerLibrary::ComposeSideBySidePNGs(InputPng, Prepared->Results[0].PngBytes, CompositePng, 8)
+                && CompositePng.Num() > 0
+                && FFileHelper::SaveArrayToFile(CompositePng, *CompositePath))
             {
-                CompositePath = CompositeSavePath.IsEmpty()
-                    ? AbsBaseDir / FString::Printf(TEXT("NanoBanana_%s_Composite.png"), *Stamp)
-                    : CompositeSavePath;
-                FFileHelper::SaveArrayToFile(CompositePng, *CompositePath);
+                Prepared->CompositePath = CompositePath;
             }
-        }
+            Prepared->CompositeCycles = FPlatformTime::Cycles64() - Start;
+        }));
+    }
+    if (bStoreResults || bShareResults)
+    {
+        Stages.Add(UE::Tasks::Launch(UE_SOURCE_LOCATION, [Prepared, bStoreResults, bShareResults, SharedMetadata, Ext, Key = Fingerprint]()
+        {
+            TRACE_CPUPROFILER_EVENT_SCOPE(NanoBanana_StoreInResultCache);
+            const uint64 Start = FPlatformTime::Cycles64();
+            if (bStoreResults)
+            {
+                NanoBanana::FResultCache::Get().Store(Key, Prepared->Results, Ext);
+            }
+            if (bShareResults)
+            {
+                NanoBanana::FDerivedDataResultCache::Get().Store(Key, Prepared->Results, SharedMetadata);
+            }
+            Prepared->CacheStoreCycles = FPlatformTime::Cycles64() - Start;
+        }));
     }
 
+    TWeakObjectPtr<UNanoBananaBridgeAsyncAction> Weak(this);
+    UE::Tasks::Launch(UE_SOURCE_LOCATION, [Weak, Prepared, PersistStartCycles]()
+    {
+        const float PersistMs = (float)FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - PersistStartCycles);
+        AsyncTask(ENamedThreads::GameThread, [Weak, Prepared, PersistMs]()
+        {
+            UNanoBananaBridgeAsyncAction* This = Weak.Get();
+            if (!This || This->bFinished) return;
+            const uint64 TextureStart = FPlatformTime::Cycles64();
+            for (int32 i = 0; i < Prepared->Results.Num(); ++i)
+            {
+                UTexture2D* Streamed = This->StreamedTextures.IsValidIndex(i) ? This->StreamedTextures[i].Get() : nullptr;
+                Prepared->Results[i].Texture = Streamed ? Streamed : NanoBanana::Image::CreateResultTexture(Prepared->Decoded[i]);
+            }
+            Prepared->Decoded.Empty();
+
+            FNanoBananaResultTimings& T = This->Timings;
+            T.SaveMs = (float)FPlatformTime::ToMilliseconds64(Prepared->SaveCycles.load());
+            T.DecodeMs = (float)FPlatformTime::ToMilliseconds64(Prepared->DecodeCycles.load());
+            T.CompositeMs = (float)FPlatformTime::ToMilliseconds64(Prepared->CompositeCycles);
+            T.CacheStoreMs = (float)FPlatformTime::ToMilliseconds64(Prepared->CacheStoreCycles);
+            T.PersistMs = PersistMs;
+            T.TextureMs = (float)FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - TextureStart);
+            This->CompleteWithResults(MoveTemp(Prepared->Results), Prepared->CompositePath);
+        });
+    }, Stages);
+}
+
+void UNanoBananaBridgeAsyncAction::CompleteWithResults(TArray<FNanoBananaImageResult> Results, const FString& CompositePath)
+{
+    if (bFinished) return;
     bFinished = true;
-    OnProgress.Broadcast(1.0f, TEXT("Completed"));
+    Timings.TotalMs = (float)((FPlatformTime::Seconds() - ActivatedSeconds) * 1000.0);
+    UE_LOG(LogNanoBanana, Verbose, TEXT("Request completed in %.1f ms: response %.1f, persist %.1f (save %.1f, decode %.1f, composite %.1f, cache %.1f), textures %.1f"),
+        Timings.TotalMs, Timings.ResponseMs, Timings.PersistMs, Timings.SaveMs, Timings.DecodeMs, Timings.CompositeMs, Timings.CacheStoreMs, Timings.TextureMs);
+    BroadcastProgress(1.0f, TEXT("Completed"));
     OnCompleted.Broadcast(Results, CompositePath);
+    OnCompletedNative.Broadcast(Results);
     Provider.Reset();
+    CloseEvents();
     SetReadyToDestroy();
+
+    // Followers share this request's files and textures.
+    for (UNanoBananaBridgeAsyncAction* Follower : StopLeading())
+    {
+        Follower->Timings = Timings;
+        Follower->CompleteWithResults(Results, Follower->bAlsoSaveComposite ? CompositePath : FString());
+    }
 }
 
 void UNanoBananaBridgeAsyncAction::Fail(const FString& Error)
 {
     if (bFinished) return;
     bFinished = true;
+    ReleaseSchedulerSlot();
     OnFailed.Broadcast(Error);
+    OnFailedNative.Broadcast(Error);
     Provider.Reset();
+    ReferencePrep.Reset();
+    CloseEvents();
     SetReadyToDestroy();
+
+    for (UNanoBananaBridgeAsyncAction* Follower : StopLeading())
+    {
+        Follower->Fail(Error);
+    }
+}
+
+void UNanoBananaBridgeAsyncAction::RetryAfterRateLimit(const FString& Error)
+{
+    ++RateLimitRetries;
+    bRateLimited = false;
+    UE_LOG(LogNanoBanana, Log, TEXT("%s rate-limited the request (%s); queuing it again (retry %d of %d)."),
+        *FNanoBananaTypeUtils::VendorToString(Request.Vendor), *Error.Left(256), RateLimitRetries, UNanoBananaSettings::Get().MaxRateLimitRetries);
+
+    // Start over with a fresh provider; the scheduler holds it until the Retry-After has passed.
+    if (Provider.IsValid())
+    {
+        Provider->Cancel();
+        Provider.Reset();
+    }
+    CloseEvents();
+    StreamedTextures.Reset();
+    ReleaseSchedulerSlot();
+    BroadcastProgress(0.16f, TEXT("Rate limited, retrying"));
+    // Followers stay attached; this request keeps its place in FRequestCoalescer.
+    ForEachFollower([](UNanoBananaBridgeAsyncAction& Follower) { Follower.BroadcastProgress(0.16f, TEXT("Rate limited, retrying")); });
+    QueueForVendor();
+}
+
+bool UNanoBananaBridgeAsyncAction::TryJoinInFlight()
+{
+    using NanoBanana::FRequestCoalescer;
+    // Already leading (queued again after a 429): keep running for the followers.
+    if (bCoalescingLeader || !NanoBanana::CanCoalesce(Request)) return false;
+
+    const uint64 Key = Fingerprint;
+    FRequestCoalescer& Coalescer = FRequestCoalescer::Get();
+    UNanoBananaBridgeAsyncAction* Leader = Coalescer.FindLeader(Key);
+    if (Leader && Leader != this && !Leader->bFinished)
+    {
+        Leader->Followers.Add(this);
+        Coalescer.NoteJoined();
+        UE_LOG(LogNanoBanana, Verbose, TEXT("Request %016llx is already in flight; waiting for its results."), Key);
+        BroadcastProgress(0.2f, TEXT("Joined an identical request in flight"));
+        return true;
+    }
+
+    bCoalescingLeader = true;
+    Coalescer.AddLeader(Key, this);
+    return false;
+}
+
+TArray<UNanoBananaBridgeAsyncAction*> UNanoBananaBridgeAsyncAction::StopLeading()
+{
+    TArray<UNanoBananaBridgeAsyncAction*> Waiting;
+    if (!bCoalescingLeader) return Waiting;
+    bCoalescingLeader = false;
+    NanoBanana::FRequestCoalescer::Get().RemoveLeader(Fingerprint, this);
+    for (const TWeakObjectPtr<UNanoBananaBridgeAsyncAction>& Weak : Followers)
+    {
+        UNanoBananaBridgeAsyncAction* Follower = Weak.Get();
+        if (Follower && !Follower->bFinished)
+        {
+            Waiting.Add(Follower);
+        }
+    }
+    Followers.Empty();
+    return Waiting;
+}
+
+void UNanoBananaBridgeAsyncAction::ForEachFollower(TFunctionRef<void(UNanoBananaBridgeAsyncAction&)> Visit) const
+{
+    if (Followers.Num() == 0) return;
+    // A follower's delegates may start another identical request, which joins this list.
+    const TArray<TWeakObjectPtr<UNanoBananaBridgeAsyncAction>> Snapshot = Followers;
+    for (const TWeakObjectPtr<UNanoBananaBridgeAsyncAction>& Weak : Snapshot)
+    {
+        UNanoBananaBridgeAsyncAction* Follower = Weak.Get();
+        if (Follower && !Follower->bFinished)
+        {
+            Visit(*Follower);
+        }
+    }
+}
+
+void UNanoBananaBridgeAsyncAction::ReleaseSchedulerSlot()
+{
+    UNanoBananaJobScheduler* Scheduler = UNanoBananaJobScheduler::Get();
+    if (bQueuedInScheduler)
+    {
+        bQueuedInScheduler = false;
+        if (Scheduler) Scheduler->Remove(SchedulerJobId);
+    }
+    if (bHoldsSchedulerSlot)
+    {
+        bHoldsSchedulerSlot = false;
+        if (Scheduler) Scheduler->Release(Request.Vendor);
+    }
+}
+
+void UNanoBananaBridgeAsyncAction::BroadcastProgress(float Percent, const FString& Stage)
+{
+    OnProgress.Broadcast(Percent, Stage);
+    OnProgressNative.Broadcast(Percent, Stage);
+}
+
+void UNanoBananaBridgeAsyncAction::CloseEvents()
+{
+    if (Events.IsValid())
+    {
+        Events->Close();
+        Events.Reset();
+    }
 }
 
 FString UNanoBananaBridgeAsyncAction::MakeTimestampedPath(const FString& BaseDir, const FString& Suffix) const
@@ -246,14 +757,28 @@ FString UNanoBananaBridgeAsyncAction::MakeTimestampedPath(const FString& BaseDir
     return Dir / FString::Printf(TEXT("NanoBanana_%s%s"), *Stamp, *Suffix);
 }
 
-void UNanoBananaBridgeAsyncAction::DumpDebug(const FString& Suffix, const FString& Body) const
+FString UNanoBananaBridgeAsyncAction::MakeResultPath(const FString& AbsBaseDir, const FString& Stamp, const FString& Ext, int32 Index, int32 Count)
+{
+    const FString Suffix = (Count == 1)
+        ? FString::Printf(TEXT("_Result%s"), *Ext)
+        : FString::Printf(TEXT("_Result_%02d%s"), Index + 1, *Ext);
+    return AbsBaseDir / FString::Printf(TEXT("NanoBanana_%s%s"), *Stamp, *Suffix);
+}
+
+FString UNanoBananaBridgeAsyncAction::MakeDebugPath(const FString& Suffix) const
 {
     const UNanoBananaSettings& S = UNanoBananaSettings::Get();
-    if (!S.bSaveDebugRequestResponse || Body.IsEmpty()) return;
     const FString DebugDir = FPaths::ConvertRelativePathToFull(S.OutputDirectory) / TEXT("Debug");
     IPlatformFile& PF = FPlatformFileManager::Get().GetPlatformFile();
     if (!PF.DirectoryExists(*DebugDir)) { PF.CreateDirectoryTree(*DebugDir); }
     const FString Stamp = FDateTime::Now().ToString(TEXT("%Y%m%d_%H%M%S"));
-    const FString Path = DebugDir / FString::Printf(TEXT("%s%s"), *Stamp, *Suffix);
-    FFileHelper::SaveStringToFile(Body, *Path);
+    return DebugDir / FString::Printf(TEXT("%s%s"), *Stamp, *Suffix);
+}
+
+void UNanoBananaBridgeAsyncAction::DumpDebug(const FString& Suffix, const TArray<uint8>& Body) const
+{
+    const UNanoBananaSettings& S = UNanoBananaSettings::Get();
+    if (!S.bSaveDebugRequestResponse || Body.Num() == 0) return;
+    // Written verbatim: the dump is byte-for-byte what went over the wire.
+    FFileHelper::SaveArrayToFile(Body, *MakeDebugPath(Suffix));
 }
@@ -1,10 +1,32 @@
 #include "Modules/ModuleManager.h"
+#include "NanoBananaLog.h"
+#include "NanoBananaSettings.h"
+#include "ProviderEventChannel.h"
+#include "ResultCache.h"
+#include "Http/PollScheduler.h"
+#include "Http/PollLatencyModel.h"
+#include "Http/WebhookReceiver.h"
+
+DEFINE_LOG_CATEGORY(LogNanoBanana);
 
 class FNanoBananaBridgeModule : public IModuleInterface
 {
 public:
-    virtual void StartupModule() override {}
-    virtual void ShutdownModule() override {}
+    virtual void StartupModule() override
+    {
+        // Reads the result cache index on a worker now, so the first request doesn't wait on it.
+        if (UNanoBananaSettings::Get().ResultCacheMaxMegabytes > 0)
+        {
+            NanoBanana::FResultCache::Get();
+        }
+    }
+    virtual void ShutdownModule() override
+    {
+        NanoBanana::FProviderEventChannel::ShutdownPump();
+        NanoBanana::Http::FPollScheduler::Get().Shutdown();
+        NanoBanana::Http::FWebhookReceiver::Get().Shutdown();
+        NanoBanana::Http::FPollLatencyModel::Get().Save();
+    }
 };
 
 IMPLEMENT_MODULE(FNanoBananaBridgeModule, NanoBananaBridge)
@@ -0,0 +1,218 @@
+#include "NanoBananaJobScheduler.h"
+#include "NanoBananaSettings.h"
+#include "NanoBananaLog.h"
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+
+namespace
+{
+    FAutoConsoleCommand DumpStatsCommand(
+        TEXT("NanoBanana.Scheduler.Stats"),
+        TEXT("Logs running and queued requests, token balance and Retry-After back-off per vendor."),
+        FConsoleCommandDelegate::CreateLambda([]()
+        {
+            UNanoBananaJobScheduler* Scheduler = UNanoBananaJobScheduler::Get();
+            if (!Scheduler) return;
+            const FNanoBananaJobSchedulerStats S = Scheduler->GetStats();
+            UE_LOG(LogNanoBanana, Display, TEXT("Job scheduler: %d running, %d queued"), S.Running, S.Queued);
+            for (const FNanoBananaVendorQueueStats& V : S.Vendors)
+            {
+                UE_LOG(LogNanoBanana, Display, TEXT("  %s: %d running, queued %d/%d/%d (interactive/background/bulk), %.1f tokens, held %.1f s, %d x 429, %lld started, mean wait %.2f s"),
+                    *FNanoBananaTypeUtils::VendorToString(V.Vendor), V.Running, V.QueuedInteractive, V.QueuedBackground, V.QueuedBulk,
+                    V.Tokens, V.HeldForSeconds, V.RateLimitedCount, V.Started, V.MeanWaitSeconds);
+            }
+        }));
+}
+
+int32 UNanoBananaJobScheduler::FVendorState::NumQueued() const
+{
+    int32 Num = 0;
+    for (const TArray<FJob>& Jobs : Queued)
+    {
+        Num += Jobs.Num();
+    }
+    return Num;
+}
+
+UNanoBananaJobScheduler* UNanoBananaJobScheduler::Get()
+{
+    return GEngine ? GEngine->GetEngineSubsystem<UNanoBananaJobScheduler>() : nullptr;
+}
+
+UNanoBananaJobScheduler::FJobId UNanoBananaJobScheduler::Enqueue(ENanoBananaVendor Vendor, ENanoBananaJobPriority Priority, TFunction<void()> Start)
+{
+    check(IsInGameThread());
+    const FJobId Id = NextId++;
+    const int32 Class = FMath::Clamp((int32)Priority, 0, NumPriorities - 1);
+    Vendors.FindOrAdd(Vendor).Queued[Class].Add({ Id, FPlatformTime::Seconds(), MoveTemp(Start) });
+    Dispatch();
+    return Id;
+}
+
+bool UNanoBananaJobScheduler::Remove(FJobId Id)
+{
+    check(IsInGameThread());
+    for (TPair<ENanoBananaVendor, FVendorState>& Pair : Vendors)
+    {
+        for (TArray<FJob>& Jobs : Pair.Value.Queued)
+        {
+            const int32 Index = Jobs.IndexOfByPredicate([Id](const FJob& Job) { return Job.Id == Id; });
+            if (Index != INDEX_NONE)
+            {
+                Jobs.RemoveAt(Index, 1, EAllowShrinking::No);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void UNanoBananaJobScheduler::Release(ENanoBananaVendor Vendor)
+{
+    check(IsInGameThread());
+    if (FVendorState* State = Vendors.Find(Vendor))
+    {
+        State->Running = FMath::Max(0, State->Running - 1);
+    }
+    Dispatch();
+}
+
+void UNanoBananaJobScheduler::ReportRateLimited(ENanoBananaVendor Vendor, float RetryAfterSeconds)
+{
+    check(IsInGameThread());
+    FVendorState& State = Vendors.FindOrAdd(Vendor);
+    State.HeldUntil = FMath::Max(State.HeldUntil, FPlatformTime::Seconds() + FMath::Max(0.0f, RetryAfterSeconds));
+    ++State.RateLimitedCount;
+    UE_LOG(LogNanoBanana, Log, TEXT("Scheduler: %s answered 429; holding its queue (%d waiting) for %.1f s."),
+        *FNanoBananaTypeUtils::VendorToString(Vendor), State.NumQueued(), RetryAfterSeconds);
+    Dispatch();
+}
+
+double UNanoBananaJobScheduler::NextStartTime(FVendorState& State, ENanoBananaVendor Vendor, double Now)
+{
+    const UNanoBananaSettings& S = UNanoBananaSettings::Get();
+    // At the cap, the next Release() dispatches; no timer needed.
+    if (State.Running >= FMath::Max(1, S.MaxConcurrentRequestsPerVendor)) return -1.0;
+    if (State.HeldUntil > Now) return State.HeldUntil;
+
+    const FNanoBananaRateLimit& Limit = S.GetRateLimit(Vendor);
+    if (Limit.RequestsPerSecond <= 0.0f) return 0.0;
+    const double Burst = FMath::Max(1, Limit.Burst);
+    State.Tokens = State.Tokens < 0.0 ? Burst : FMath::Min(Burst, State.Tokens + (Now - State.LastRefill) * Limit.RequestsPerSecond);
+    State.LastRefill = Now;
+    return State.Tokens >= 1.0 ? 0.0 : Now + (1.0 - State.Tokens) / Limit.RequestsPerSecond;
+}
+
+void UNanoBananaJobScheduler::Dispatch()
+{
+    // A job can finish inside its own Start (e.g. it fails synchronously) and release its
+    // slot; the outer pass keeps going until no vendor can start anything, so that slot is
+    // not missed.
+    if (bDispatching) return;
+    TGuardValue<bool> Guard(bDispatching, true);
+
+    double Wake = 0.0;
+    bool bProgress = true;
+    while (bProgress)
+    {
+        bProgress = false;
+        Wake = 0.0;
+        const double Now = FPlatformTime::Seconds();
+        TArray<ENanoBananaVendor> Keys;
+        Vendors.GenerateKeyArray(Keys);
+        for (const ENanoBananaVendor Vendor : Keys)
+        {
+            FVendorState* State = Vendors.Find(Vendor);
+            if (!State || State->NumQueued() == 0) continue;
+
+            const double At = NextStartTime(*State, Vendor, Now);
+            if (At < 0.0) continue;
+            if (At > 0.0)
+            {
+                Wake = Wake > 0.0 ? FMath::Min(Wake, At) : At;
+                continue;
+            }
+
+            TArray<FJob>* Jobs = nullptr;
+            for (TArray<FJob>& Class : State->Queued)
+            {
+                if (Class.Num() > 0) { Jobs = &Class; break; }
+            }
+            FJob Job = MoveTemp((*Jobs)[0]);
+            Jobs->RemoveAt(0, 1, EAllowShrinking::No);
+            ++State->Running;
+            ++State->Started;
+            State->TotalWaitSeconds += Now - Job.EnqueuedAt;
+            if (UNanoBananaSettings::Get().GetRateLimit(Vendor).RequestsPerSecond > 0.0f)
+            {
+                State->Tokens -= 1.0;
+            }
+            bProgress = true;
+            // May enqueue, release or remove re-entrantly; State is not used past this point.
+            Job.Start();
+        }
+    }
+    if (Wake > 0.0)
+    {
+        ScheduleWake(Wake);
+    }
+}
+
+void UNanoBananaJobScheduler::ScheduleWake(double At)
+{
+    if (WakeHandle.IsValid())
+    {
+        if (WakeAt <= At) return;
+        FTSTicker::GetCoreTicker().RemoveTicker(WakeHandle);
+    }
+    WakeAt = At;
+    WakeHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UNanoBananaJobScheduler::HandleWake),
+        (float)FMath::Max(0.0, At - FPlatformTime::Seconds()));
+}
+
+bool UNanoBananaJobScheduler::HandleWake(float /*DeltaTime*/)
+{
+    WakeHandle.Reset();
+    Dispatch();
+    return false;
+}
+
+FNanoBananaJobSchedulerStats UNanoBananaJobScheduler::GetStats() const
+{
+    const UNanoBananaSettings& Settings = UNanoBananaSettings::Get();
+    const double Now = FPlatformTime::Seconds();
+    FNanoBananaJobSchedulerStats Out;
+    for (const TPair<ENanoBananaVendor, FVendorState>& Pair : Vendors)
+    {
+        const FVendorState& State = Pair.Value;
+        const FNanoBananaRateLimit& Limit = Settings.GetRateLimit(Pair.Key);
+        const double Burst = FMath::Max(1, Limit.Burst);
+
+        FNanoBananaVendorQueueStats V;
+        V.Vendor = Pair.Key;
+        V.Running = State.Running;
+        V.QueuedInteractive = State.Queued[(int32)ENanoBananaJobPriority::Interactive].Num();
+        V.QueuedBackground = State.Queued[(int32)ENanoBananaJobPriority::Background].Num();
+        V.QueuedBulk = State.Queued[(int32)ENanoBananaJobPriority::Bulk].Num();
+        V.Tokens = (float)(State.Tokens < 0.0 ? Burst : FMath::Min(Burst, State.Tokens + (Now - State.LastRefill) * Limit.RequestsPerSecond));
+        V.HeldForSeconds = (float)FMath::Max(0.0, State.HeldUntil - Now);
+        V.RateLimitedCount = State.RateLimitedCount;
+        V.Started = State.Started;
+        V.MeanWaitSeconds = State.Started > 0 ? (float)(State.TotalWaitSeconds / State.Started) : 0.0f;
+        Out.Running += V.Running;
+        Out.Queued += State.NumQueued();
+        Out.Vendors.Add(V);
+    }
+    return Out;
+}
+
+void UNanoBananaJobScheduler::Deinitialize()
+{
+    if (WakeHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(WakeHandle);
+        WakeHandle.Reset();
+    }
+    Vendors.Reset();
+    Super::Deinitialize();
+}
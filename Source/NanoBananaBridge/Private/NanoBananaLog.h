@@ -0,0 +1,7 @@
+// Log category shared by the NanoBananaBridge module.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Logging/LogMacros.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogNanoBanana, Log, All);
@@ -0,0 +1,18 @@
+#include "NanoBananaResultCacheLibrary.h"
+#include "ResultCache.h"
+#include "DerivedDataResultCache.h"
+
+FNanoBananaResultCacheStats UNanoBananaResultCacheLibrary::GetResultCacheStats()
+{
+    FNanoBananaResultCacheStats Stats = NanoBanana::FResultCache::Get().GetStats();
+    const NanoBanana::FDerivedDataResultCacheStats Shared = NanoBanana::FDerivedDataResultCache::Get().GetStats();
+    Stats.SharedHits = Shared.Hits;
+    Stats.SharedMisses = Shared.Misses;
+    Stats.SharedStores = Shared.Stores;
+    return Stats;
+}
+
+void UNanoBananaResultCacheLibrary::ClearResultCache()
+{
+    NanoBanana::FResultCache::Get().Empty();
+}
@@ -36,3 +36,21 @@ FString UNanoBananaSettings::GetEffectiveApiKey(ENanoBananaVendor Vendor) const
         return FString();
     }
 }
+
+FString UNanoBananaSettings::GetEffectiveReplicateWebhookSecret() const
+{
+    if (!Replicate.WebhookSigningSecret.IsEmpty()) return Replicate.WebhookSigningSecret;
+    return FPlatformMisc::GetEnvironmentVariable(TEXT("REPLICATE_WEBHOOK_SECRET"));
+}
+
+const FNanoBananaRateLimit& UNanoBananaSettings::GetRateLimit(ENanoBananaVendor Vendor) const
+{
+    static const FNanoBananaRateLimit Unlimited;
+    switch (Vendor)
+    {
+    case ENanoBananaVendor::Google:    return Google.RateLimit;
+    case ENanoBananaVendor::Fal:       return Fal.RateLimit;
+    case ENanoBananaVendor::Replicate: return Replicate.RateLimit;
+    default:                           return Unlimited;
+    }
+}
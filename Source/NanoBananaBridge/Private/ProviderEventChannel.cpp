@@ -0,0 +1,221 @@
+#include "ProviderEventChannel.h"
+#include "Containers/Ticker.h"
+#include "Misc/ScopeLock.h"
+
+namespace NanoBanana
+{
+    namespace
+    {
+        /** The single core ticker that drains every live channel once per frame. Game thread only. */
+        struct FProviderEventPump
+        {
+            TArray<TWeakPtr<FProviderEventChannel, ESPMode::ThreadSafe>> Channels;
+            FTSTicker::FDelegateHandle TickerHandle;
+
+            void Add(const TSharedRef<FProviderEventChannel, ESPMode::ThreadSafe>& Channel)
+            {
+                check(IsInGameThread());
+                Channels.Add(Channel);
+                if (!TickerHandle.IsValid())
+                {
+                    TickerHandle = FTSTicker::GetCoreTicker().AddTicker(TEXT("NanoBananaProviderEvents"), 0.0f,
+                        [this](float) { return Tick(); });
+                }
+            }
+
+            bool Tick()
+            {
+                // Handlers may create channels (a new request from a completion handler); iterate by index.
+                for (int32 i = 0; i < Channels.Num(); )
+                {
+                    TSharedPtr<FProviderEventChannel, ESPMode::ThreadSafe> Channel = Channels[i].Pin();
+                    if (!Channel.IsValid() || Channel->IsClosed())
+                    {
+                        Channels.RemoveAtSwap(i, 1, EAllowShrinking::No);
+                        continue;
+                    }
+                    Channel->Drain();
+                    ++i;
+                }
+                if (Channels.Num() == 0)
+                {
+                    TickerHandle.Reset();
+                    return false;
+                }
+                return true;
+            }
+
+            void Shutdown()
+            {
+                if (TickerHandle.IsValid())
+                {
+                    FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+                    TickerHandle.Reset();
+                }
+                Channels.Empty();
+            }
+        };
+
+        static FProviderEventPump& GetPump()
+        {
+            static FProviderEventPump Pump;
+            return Pump;
+        }
+    }
+
+    FProviderEvent FProviderEvent::MakeProgress(float InPercent, const FString& Stage)
+    {
+        FProviderEvent E;
+        E.Kind = EKind::Progress;
+        E.Percent = InPercent;
+        E.Text = Stage;
+        return E;
+    }
+
+    FProviderEvent FProviderEvent::MakeImageReady(int32 InIndex, TSharedRef<FImage, ESPMode::ThreadSafe> InImage)
+    {
+        FProviderEvent E;
+        E.Kind = EKind::ImageReady;
+        E.Index = InIndex;
+        E.Image = MoveTemp(InImage);
+        return E;
+    }
+
+    FProviderEvent FProviderEvent::MakeRequestBuilt(const FSharedBytes& InBody)
+    {
+        FProviderEvent E;
+        E.Kind = EKind::RequestBuilt;
+        E.Body = InBody;
+        return E;
+    }
+
+    FProviderEvent FProviderEvent::MakeSucceeded(TArray<TArray<uint8>> InImages, TArray<FString> InSavedPaths, const FSharedText& InRawResponse)
+    {
+        FProviderEvent E;
+        E.Kind = EKind::Succeeded;
+        E.Images = MoveTemp(InImages);
+        E.SavedPaths = MoveTemp(InSavedPaths);
+        E.RawResponse = InRawResponse;
+        return E;
+    }
+
+    FProviderEvent FProviderEvent::MakeFailed(const FString& Error)
+    {
+        FProviderEvent E;
+        E.Kind = EKind::Failed;
+        E.Text = Error;
+        return E;
+    }
+
+    FProviderEvent FProviderEvent::MakeRateLimited(ENanoBananaVendor Vendor, float RetryAfterSeconds)
+    {
+        FProviderEvent E;
+        E.Kind = EKind::RateLimited;
+        E.Index = (int32)Vendor;
+        E.Percent = RetryAfterSeconds;
+        return E;
+    }
+
+    FProviderEventChannel::FProviderEventChannel(FHandler InHandler)
+        : Handler(MoveTemp(InHandler))
+    {
+    }
+
+    TSharedRef<FProviderEventChannel, ESPMode::ThreadSafe> FProviderEventChannel::Create(FHandler InHandler)
+    {
+        TSharedRef<FProviderEventChannel, ESPMode::ThreadSafe> Channel = MakeShareable(new FProviderEventChannel(MoveTemp(InHandler)));
+        GetPump().Add(Channel);
+        return Channel;
+    }
+
+    void FProviderEventChannel::ShutdownPump()
+    {
+        GetPump().Shutdown();
+    }
+
+    void FProviderEventChannel::Push(FProviderEvent&& Event)
+    {
+        if (IsClosed()) return;
+        if (!bSpilling.load(std::memory_order_acquire) && Ring.TryEnqueue(MoveTemp(Event)))
+        {
+            return;
+        }
+        // Ring full (or already spilling): queue behind it so nothing is lost or reordered.
+        FScopeLock Guard(&SpillLock);
+        Spill.Add(MoveTemp(Event));
+        bSpilling.store(true, std::memory_order_release);
+    }
+
+    void FProviderEventChannel::Deliver(FProviderEvent& Event, int32& Delivered)
+    {
+        if (Event.Kind == FProviderEvent::EKind::Progress)
+        {
+            PendingProgress = MoveTemp(Event);
+            return;
+        }
+        if (PendingProgress.Kind == FProviderEvent::EKind::Progress)
+        {
+            FProviderEvent Progress = MoveTemp(PendingProgress);
+            PendingProgress = FProviderEvent();
+            if (Handler && !IsClosed()) { Handler(Progress); ++Delivered; }
+        }
+        if (Handler && !IsClosed()) { Handler(Event); ++Delivered; }
+    }
+
+    int32 FProviderEventChannel::Drain()
+    {
+        check(IsInGameThread());
+        if (bDraining) return 0; // a handler pumped the ticker re-entrantly
+        TGuardValue<bool> DrainGuard(bDraining, true);
+        int32 Delivered = 0;
+
+        FProviderEvent Event;
+        while (!IsClosed() && Ring.TryDequeue(Event))
+        {
+            Deliver(Event, Delivered);
+        }
+
+        if (bSpilling.load(std::memory_order_acquire))
+        {
+            TArray<FProviderEvent> Overflow;
+            {
+                FScopeLock Guard(&SpillLock);
+                Overflow = MoveTemp(Spill);
+                Spill.Reset();
+                bSpilling.store(false, std::memory_order_release);
+            }
+            for (FProviderEvent& Spilled : Overflow)
+            {
+                if (IsClosed()) break;
+                Deliver(Spilled, Delivered);
+            }
+        }
+
+        // Whatever progress is left is the latest of this frame.
+        if (!IsClosed() && PendingProgress.Kind == FProviderEvent::EKind::Progress)
+        {
+            FProviderEvent Progress = MoveTemp(PendingProgress);
+            PendingProgress = FProviderEvent();
+            if (Handler) { Handler(Progress); ++Delivered; }
+        }
+
+        // A handler that closed the channel could not release itself while running.
+        if (IsClosed())
+        {
+            Handler = nullptr;
+            PendingProgress = FProviderEvent();
+        }
+        return Delivered;
+    }
+
+    void FProviderEventChannel::Close()
+    {
+        check(IsInGameThread());
+        bClosed.store(true, std::memory_order_release);
+        if (!bDraining)
+        {
+            Handler = nullptr;
+            PendingProgress = FProviderEvent();
+        }
+    }
+}
@@ -0,0 +1,101 @@
+// Provider-to-game-thread event channel. Provider callbacks (any thread) push events into a
+// per-action bounded lock-free queue; one core ticker drains every live channel once per
+// frame. Replaces an AsyncTask (and task-graph node) per callback.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/SharedPointer.h"
+#include "Templates/Function.h"
+#include "HAL/CriticalSection.h"
+#include "NanoBananaTypes.h"
+#include "Http/SharedPayload.h"
+#include "BoundedMpscQueue.h"
+
+#include <atomic>
+
+struct FImage;
+
+namespace NanoBanana
+{
+    /** One provider callback, captured on whatever thread fired it. */
+    struct FProviderEvent
+    {
+        enum class EKind : uint8
+        {
+            None,
+            Progress,       // Percent, Text = stage. Coalesced: only the latest per drain survives.
+            ImageReady,     // Index, Image (already decoded off the game thread)
+            RequestBuilt,   // Body
+            Succeeded,      // Images, SavedPaths, RawResponse
+            Failed,         // Text = error
+            RateLimited,    // Index = ENanoBananaVendor, Percent = Retry-After seconds
+        };
+
+        EKind Kind = EKind::None;
+        float Percent = 0.0f;
+        int32 Index = INDEX_NONE;
+        FString Text;
+        TArray<TArray<uint8>> Images;
+        TArray<FString> SavedPaths;
+        TSharedPtr<const FString, ESPMode::ThreadSafe> RawResponse;
+        TSharedPtr<const TArray<uint8>, ESPMode::ThreadSafe> Body;
+        TSharedPtr<FImage, ESPMode::ThreadSafe> Image;
+
+        static FProviderEvent MakeProgress(float InPercent, const FString& Stage);
+        static FProviderEvent MakeImageReady(int32 InIndex, TSharedRef<FImage, ESPMode::ThreadSafe> InImage);
+        static FProviderEvent MakeRequestBuilt(const FSharedBytes& InBody);
+        static FProviderEvent MakeSucceeded(TArray<TArray<uint8>> InImages, TArray<FString> InSavedPaths, const FSharedText& InRawResponse);
+        static FProviderEvent MakeFailed(const FString& Error);
+        static FProviderEvent MakeRateLimited(ENanoBananaVendor Vendor, float RetryAfterSeconds);
+    };
+
+    /**
+     * Per-action event channel. Push() from any thread; delivery happens on the game thread,
+     * in push order per producing thread, with runs of Progress events collapsed to the most
+     * recent one. Progress is always delivered before a later non-progress event, so a
+     * terminal event is never overtaken by stale progress.
+     */
+    class FProviderEventChannel : public TSharedFromThis<FProviderEventChannel, ESPMode::ThreadSafe>
+    {
+    public:
+        using FHandler = TFunction<void(FProviderEvent& /*Event*/)>;
+
+        /** Slots per channel. Non-progress events per request number in the single digits. */
+        static constexpr uint32 Capacity = 64;
+
+        /** Game thread. The channel is drained by the shared per-frame pump until Close() or release. */
+        static TSharedRef<FProviderEventChannel, ESPMode::ThreadSafe> Create(FHandler InHandler);
+
+        /** Any thread. Never blocks or allocates a task; a full ring spills to a locked overflow list. */
+        void Push(FProviderEvent&& Event);
+
+        /** Game thread. Delivers everything queued so far; returns the number of events handed out. */
+        int32 Drain();
+
+        /** Game thread. Drops the handler; later pushes are discarded. */
+        void Close();
+
+        bool IsClosed() const { return bClosed.load(std::memory_order_acquire); }
+
+        /** Module shutdown: removes the per-frame pump ticker. */
+        static void ShutdownPump();
+
+    private:
+        explicit FProviderEventChannel(FHandler InHandler);
+
+        void Deliver(FProviderEvent& Event, int32& Delivered);
+
+        FHandler Handler;
+        TBoundedMpscQueue<FProviderEvent, Capacity> Ring;
+        std::atomic<bool> bClosed { false };
+
+        /** Set while the overflow list is non-empty, so later pushes queue behind it and order holds. */
+        std::atomic<bool> bSpilling { false };
+        FCriticalSection SpillLock;
+        TArray<FProviderEvent> Spill;
+
+        /** Latest coalesced progress not yet delivered (game thread only). */
+        FProviderEvent PendingProgress;
+        bool bDraining = false;
+    };
+}
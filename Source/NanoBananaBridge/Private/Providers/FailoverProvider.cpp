@@ -0,0 +1,349 @@
+#include "FailoverProvider.h"
+#include "ProviderFactory.h"
+#include "../Http/HedgePolicy.h"
+#include "../Http/PollLatencyModel.h"
+#include "../ProviderEventChannel.h"
+#include "NanoBananaJobScheduler.h"
+#include "NanoBananaLog.h"
+
+FFailoverProvider::FFailoverProvider(TArray<FNanoBananaFailoverTarget> InChain, FMakeProvider InMakeProvider)
+    : Chain(MoveTemp(InChain))
+    , MakeProvider(InMakeProvider ? MoveTemp(InMakeProvider) : FMakeProvider(&FProviderFactory::Make))
+{
+}
+
+TArray<FNanoBananaFailoverTarget> FFailoverProvider::BuildTargets(const FNanoBananaRequest& Request, const TArray<FNanoBananaFailoverTarget>& Chain,
+    TFunctionRef<bool(ENanoBananaVendor)> HasApiKey)
+{
+    TArray<FNanoBananaFailoverTarget> Out;
+    FNanoBananaFailoverTarget Own;
+    Own.Vendor = Request.Vendor;
+    Own.Model = Request.Model;
+    Own.CustomModelId = Request.CustomModelId;
+    Out.Add(Own);
+
+    for (const FNanoBananaFailoverTarget& Target : Chain)
+    {
+        const bool bDuplicate = Out.ContainsByPredicate([&Target](const FNanoBananaFailoverTarget& Existing)
+        {
+            return Existing.Vendor == Target.Vendor && Existing.Model == Target.Model
+                && (Target.Model != ENanoBananaModel::Custom || Existing.CustomModelId == Target.CustomModelId);
+        });
+        if (bDuplicate) continue;
+        if (!HasApiKey(Target.Vendor))
+        {
+            UE_LOG(LogNanoBanana, Verbose, TEXT("Failover: skipping %s (no API key)."), *DescribeTarget(Target));
+            continue;
+        }
+        Out.Add(Target);
+    }
+    return Out;
+}
+
+FString FFailoverProvider::DescribeTarget(const FNanoBananaFailoverTarget& Target)
+{
+    const FString Model = Target.Model == ENanoBananaModel::Custom ? Target.CustomModelId : FNanoBananaTypeUtils::ModelToDisplayString(Target.Model);
+    return FString::Printf(TEXT("%s/%s"), *FNanoBananaTypeUtils::VendorToString(Target.Vendor), *Model);
+}
+
+FString FFailoverProvider::MakeLatencyKey(const FNanoBananaFailoverTarget& Target, ENanoBananaResolution Resolution)
+{
+    const FString Model = Target.Model == ENanoBananaModel::Custom ? Target.CustomModelId : FNanoBananaTypeUtils::ModelToDisplayString(Target.Model);
+    // Whole-request times, so kept apart from the per-vendor sync latencies in the same policy.
+    return TEXT("Failover|") + NanoBanana::Http::FPollLatencyModel::MakeKey(Target.Vendor, Model, Resolution);
+}
+
+void FFailoverProvider::Submit(const FNanoBananaRequest& InRequest, const TArray<NanoBanana::Image::FEncodedReferenceRef>& InReferences, const FProviderCallbacks& InCallbacks)
+{
+    Request = InRequest;
+    References = InReferences;
+    Callbacks = MakeShared<FProviderCallbacks, ESPMode::ThreadSafe>(InCallbacks);
+    SubmittedAt = FPlatformTime::Seconds();
+
+    const UNanoBananaSettings& S = UNanoBananaSettings::Get();
+    Targets = BuildTargets(Request, Chain, [&S](ENanoBananaVendor Vendor) { return !S.GetEffectiveApiKey(Vendor).IsEmpty(); });
+    Legs.SetNum(Targets.Num());
+
+    TWeakPtr<FFailoverProvider, ESPMode::ThreadSafe> WeakThis = StaticCastSharedRef<FFailoverProvider>(AsShared());
+    LegEvents = NanoBanana::FProviderEventChannel::Create([WeakThis](NanoBanana::FProviderEvent& Event)
+    {
+        TSharedPtr<FFailoverProvider, ESPMode::ThreadSafe> P = WeakThis.Pin();
+        if (P.IsValid() && !P->bCanceled) P->HandleLegEvent(Event);
+    });
+    StartLeg(0);
+}
+
+void FFailoverProvider::HandleLegEvent(NanoBanana::FProviderEvent& Event)
+{
+    using NanoBanana::FProviderEvent;
+    switch (Event.Kind)
+    {
+    case FProviderEvent::EKind::Succeeded:   FinishWinner(Event.Index); break;
+    case FProviderEvent::EKind::Failed:      HandleLegFailure(Event.Index, Event.Text); break;
+    case FProviderEvent::EKind::RateLimited: Legs[Event.Index].RetryAfterSeconds = Event.Percent; break;
+    default: break;
+    }
+}
+
+void FFailoverProvider::StartLeg(int32 Index)
+{
+    NextTarget = Index + 1;
+    const FNanoBananaFailoverTarget& Target = Targets[Index];
+    FLeg& Leg = Legs[Index];
+    Leg.StartedAt = FPlatformTime::Seconds();
+    Leg.bRunning = true;
+    Leg.Provider = MakeProvider(Target.Vendor);
+    if (!Leg.Provider.IsValid())
+    {
+        HandleLegFailure(Index, FString::Printf(TEXT("Unsupported vendor: %s"), *FNanoBananaTypeUtils::VendorToString(Target.Vendor)));
+        return;
+    }
+
+    FNanoBananaRequest LegRequest = Request;
+    LegRequest.Vendor = Target.Vendor;
+    LegRequest.Model = Target.Model;
+    LegRequest.CustomModelId = Target.CustomModelId;
+
+    ArmHedge(Index);
+    // Keep the provider alive across Submit: a synchronous failure can stop the leg.
+    TSharedPtr<IImageGenProvider, ESPMode::ThreadSafe> Provider = Leg.Provider;
+    Provider->Submit(LegRequest, References, MakeLegCallbacks(Index));
+}
+
+FProviderCallbacks FFailoverProvider::MakeLegCallbacks(int32 Index)
+{
+    TWeakPtr<FFailoverProvider, ESPMode::ThreadSafe> WeakThis = StaticCastSharedRef<FFailoverProvider>(AsShared());
+    const TSharedRef<const FProviderCallbacks, ESPMode::ThreadSafe> Parent = Callbacks.ToSharedRef();
+    const TSharedRef<NanoBanana::FProviderEventChannel, ESPMode::ThreadSafe> Events = LegEvents.ToSharedRef();
+
+    // Leg callbacks can arrive on any thread. Only the winner's results reach the caller;
+    // failures are decided on the game thread, where legs are started and canceled, by way
+    // of the leg event channel.
+    FProviderCallbacks Cb;
+    Cb.OnProgress = [WeakThis, Parent, Index](float Pct, const FString& Stage)
+    {
+        TSharedPtr<FFailoverProvider, ESPMode::ThreadSafe> P = WeakThis.Pin();
+        if (!P.IsValid() || P->bCanceled) return;
+        const int32 Won = P->Winner;
+        if (Won != INDEX_NONE && Won != Index) return;
+        if (Parent->OnProgress) Parent->OnProgress(Pct, Stage);
+    };
+    Cb.OnSuccess = [WeakThis, Parent, Index](TArray<TArray<uint8>> Images, TArray<FString> SavedPaths, const NanoBanana::FSharedText& RawResponse)
+    {
+        TSharedPtr<FFailoverProvider, ESPMode::ThreadSafe> P = WeakThis.Pin();
+        if (!P.IsValid() || P->bCanceled || !P->TryClaim(Index)) return;
+        if (Parent->OnSuccess) Parent->OnSuccess(MoveTemp(Images), MoveTemp(SavedPaths), RawResponse);
+    };
+    Cb.OnFailure = [Events, Index](const FString& Error)
+    {
+        NanoBanana::FProviderEvent Event = NanoBanana::FProviderEvent::MakeFailed(Error);
+        Event.Index = Index;
+        Events->Push(MoveTemp(Event));
+    };
+    if (Parent->OnImageReady)
+    {
+        Cb.OnImageReady = [WeakThis, Parent, Index](int32 ImageIndex, const TArray<uint8>& Image)
+        {
+            TSharedPtr<FFailoverProvider, ESPMode::ThreadSafe> P = WeakThis.Pin();
+            if (!P.IsValid() || P->bCanceled || !P->TryClaim(Index)) return;
+            Parent->OnImageReady(ImageIndex, Image);
+        };
+    }
+    if (Parent->ResolveDownloadPath)
+    {
+        // Two legs must never stream into the same result files: whoever starts downloading
+        // first owns them and the other keeps its bytes in memory. Starting a download is not
+        // a win, so a hedge leg keeps running until one of them has the images.
+        Cb.ResolveDownloadPath = [WeakThis, Parent, Index](int32 ImageIndex, int32 Count) -> FString
+        {
+            TSharedPtr<FFailoverProvider, ESPMode::ThreadSafe> P = WeakThis.Pin();
+            if (!P.IsValid() || P->bCanceled || !P->TryReserveDownload(Index)) return FString();
+            return Parent->ResolveDownloadPath(ImageIndex, Count);
+        };
+    }
+    Cb.OnRequestBuilt = Parent->OnRequestBuilt;
+    // Held until the leg fails: a 429 on a target the chain moves past must not make the
+    // caller retry the whole chain as rate limited.
+    Cb.OnRateLimited = [Events, Index](ENanoBananaVendor Vendor, float RetryAfterSeconds)
+    {
+        NanoBanana::FProviderEvent Event = NanoBanana::FProviderEvent::MakeRateLimited(Vendor, RetryAfterSeconds);
+        Event.Index = Index; // the leg; its vendor is Targets[Index]
+        Events->Push(MoveTemp(Event));
+    };
+    return Cb;
+}
+
+void FFailoverProvider::ArmHedge(int32 Index)
+{
+    const UNanoBananaSettings& S = UNanoBananaSettings::Get();
+    if (!S.bHedgeAcrossVendors || Index + 1 >= Targets.Num()) return;
+
+    const FString Key = MakeLatencyKey(Targets[Index], Request.Resolution);
+    const float MaxDelay = (float)(S.RequestTimeoutSeconds + S.MaxPollSeconds);
+    const float Delay = NanoBanana::Http::FHedgePolicy::Get().GetHedgeDelay(Key, S.FailoverHedgePercentile, S.FailoverHedgeDelayWithoutHistorySeconds, MaxDelay);
+
+    TWeakPtr<FFailoverProvider, ESPMode::ThreadSafe> WeakThis = StaticCastSharedRef<FFailoverProvider>(AsShared());
+    Legs[Index].HedgeTimer = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([WeakThis, Index, Delay](float)
+    {
+        TSharedPtr<FFailoverProvider, ESPMode::ThreadSafe> P = WeakThis.Pin();
+        if (!P.IsValid() || P->bCanceled) return false;
+        P->Legs[Index].HedgeTimer.Reset();
+        // At most two legs at once, and only the target right after this one.
+        if (P->Winner != INDEX_NONE || !P->Legs[Index].bRunning || P->NextTarget != Index + 1 || P->NumRunning() >= 2) return false;
+
+        UE_LOG(LogNanoBanana, Log, TEXT("Failover: %s still running after %.2f s (hedge threshold %.2f s); also starting %s."),
+            *DescribeTarget(P->Targets[Index]), P->SecondsSince(P->Legs[Index].StartedAt), Delay, *DescribeTarget(P->Targets[Index + 1]));
+        P->StartLeg(Index + 1);
+        return false;
+    }), Delay);
+}
+
+bool FFailoverProvider::TryClaim(int32 Index)
+{
+    int32 Expected = INDEX_NONE;
+    if (Winner.compare_exchange_strong(Expected, Index))
+    {
+        // Only the leg index travels; the images go straight to the caller's own callbacks.
+        NanoBanana::FProviderEvent Event = NanoBanana::FProviderEvent::MakeSucceeded({}, {}, NanoBanana::EmptySharedText());
+        Event.Index = Index;
+        LegEvents->Push(MoveTemp(Event));
+        return true;
+    }
+    return Expected == Index;
+}
+
+bool FFailoverProvider::TryReserveDownload(int32 Index)
+{
+    int32 Expected = INDEX_NONE;
+    return DownloadOwner.compare_exchange_strong(Expected, Index) || Expected == Index;
+}
+
+void FFailoverProvider::ReportLegRateLimit(int32 Index, bool bChainEnds)
+{
+    const float RetryAfterSeconds = Legs[Index].RetryAfterSeconds;
+    if (RetryAfterSeconds < 0.0f) return;
+    const ENanoBananaVendor Vendor = Targets[Index].Vendor;
+    if (bChainEnds)
+    {
+        if (Callbacks->OnRateLimited) Callbacks->OnRateLimited(Vendor, RetryAfterSeconds);
+    }
+    else if (UNanoBananaJobScheduler* Scheduler = UNanoBananaJobScheduler::Get())
+    {
+        // Other requests for that vendor still back off; this one just moves on.
+        Scheduler->ReportRateLimited(Vendor, RetryAfterSeconds);
+    }
+}
+
+void FFailoverProvider::FinishWinner(int32 Index)
+{
+    if (Winner != Index) return; // the winner failed after claiming and the chain moved on
+
+    FLeg& Won = Legs[Index];
+    const double Elapsed = SecondsSince(Won.StartedAt);
+    NanoBanana::Http::FHedgePolicy::Get().RecordPrimaryLatency(MakeLatencyKey(Targets[Index], Request.Resolution), (float)Elapsed);
+    if (Index > 0)
+    {
+        UE_LOG(LogNanoBanana, Log, TEXT("Failover: %s won after %.2f s (%.2f s since submit)."),
+            *DescribeTarget(Targets[Index]), Elapsed, SecondsSince(SubmittedAt));
+    }
+
+    for (int32 i = 0; i < Legs.Num(); ++i)
+    {
+        FLeg& Leg = Legs[i];
+        if (i == Index)
+        {
+            if (Leg.HedgeTimer.IsValid()) { FTSTicker::GetCoreTicker().RemoveTicker(Leg.HedgeTimer); Leg.HedgeTimer.Reset(); }
+            continue;
+        }
+        if (!Leg.bRunning) continue;
+
+        // Canceled while still running, so at least this slow.
+        const double LegElapsed = SecondsSince(Leg.StartedAt);
+        NanoBanana::Http::FHedgePolicy::Get().RecordPrimaryLatency(MakeLatencyKey(Targets[i], Request.Resolution), (float)LegElapsed);
+        UE_LOG(LogNanoBanana, Log, TEXT("Failover: canceling %s after %.2f s; %s finished first."),
+            *DescribeTarget(Targets[i]), LegElapsed, *DescribeTarget(Targets[Index]));
+        StopLeg(Leg);
+    }
+}
+
+void FFailoverProvider::HandleLegFailure(int32 Index, const FString& Error)
+{
+    FLeg& Leg = Legs[Index];
+    if (!Leg.bRunning) return; // canceled as a loser
+    const double Elapsed = SecondsSince(Leg.StartedAt);
+    Leg.Error = Error;
+    StopLeg(Leg);
+
+    // A winner that fails hands the job back to the chain, and a failed download frees the
+    // result files for whichever leg downloads next.
+    int32 Expected = Index;
+    Winner.compare_exchange_strong(Expected, INDEX_NONE);
+    Expected = Index;
+    DownloadOwner.compare_exchange_strong(Expected, INDEX_NONE);
+    const bool bChainEnds = Winner == INDEX_NONE && NumRunning() == 0 && NextTarget >= Targets.Num();
+    ReportLegRateLimit(Index, bChainEnds);
+    if (Winner != INDEX_NONE) return;
+
+    const FString Failed = DescribeTarget(Targets[Index]);
+    if (NumRunning() > 0)
+    {
+        UE_LOG(LogNanoBanana, Log, TEXT("Failover: %s failed after %.2f s (%s); waiting on the hedge."), *Failed, Elapsed, *Error.Left(256));
+        return;
+    }
+    if (NextTarget < Targets.Num())
+    {
+        UE_LOG(LogNanoBanana, Log, TEXT("Failover: %s failed after %.2f s (%s); trying %s (%.2f s since submit)."),
+            *Failed, Elapsed, *Error.Left(256), *DescribeTarget(Targets[NextTarget]), SecondsSince(SubmittedAt));
+        if (Callbacks->OnProgress) Callbacks->OnProgress(0.1f, FString::Printf(TEXT("%s failed — trying %s"), *Failed, *DescribeTarget(Targets[NextTarget])));
+        StartLeg(NextTarget);
+        return;
+    }
+
+    LegEvents->Close();
+    if (Targets.Num() == 1)
+    {
+        if (Callbacks->OnFailure) Callbacks->OnFailure(Error);
+        return;
+    }
+    TArray<FString> Errors;
+    for (int32 i = 0; i < Legs.Num(); ++i)
+    {
+        if (!Legs[i].Error.IsEmpty()) Errors.Add(FString::Printf(TEXT("%s: %s"), *DescribeTarget(Targets[i]), *Legs[i].Error));
+    }
+    UE_LOG(LogNanoBanana, Log, TEXT("Failover: all %d targets failed after %.2f s."), Targets.Num(), SecondsSince(SubmittedAt));
+    if (Callbacks->OnFailure) Callbacks->OnFailure(FString::Printf(TEXT("All failover targets failed. %s"), *FString::Join(Errors, TEXT(" | "))));
+}
+
+void FFailoverProvider::StopLeg(FLeg& Leg)
+{
+    Leg.bRunning = false;
+    if (Leg.HedgeTimer.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(Leg.HedgeTimer);
+        Leg.HedgeTimer.Reset();
+    }
+    if (Leg.Provider.IsValid())
+    {
+        Leg.Provider->Cancel();
+    }
+}
+
+int32 FFailoverProvider::NumRunning() const
+{
+    int32 Num = 0;
+    for (const FLeg& Leg : Legs)
+    {
+        if (Leg.bRunning) ++Num;
+    }
+    return Num;
+}
+
+void FFailoverProvider::Cancel()
+{
+    bCanceled = true;
+    if (LegEvents.IsValid()) LegEvents->Close();
+    for (FLeg& Leg : Legs)
+    {
+        if (Leg.bRunning || Leg.HedgeTimer.IsValid()) StopLeg(Leg);
+    }
+}
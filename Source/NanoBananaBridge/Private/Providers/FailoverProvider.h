@@ -0,0 +1,89 @@
+// Provider: vendor failover chain
+// Runs the request on its own vendor/model first and moves down UNanoBananaSettings::
+// FailoverChain when a target fails. With bHedgeAcrossVendors the next target is also started
+// when the current one runs past its usual completion time; the first target to produce
+// images wins and the others are canceled. Every decision is logged with its timing.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IImageGenProvider.h"
+#include "NanoBananaSettings.h"
+#include "Containers/Ticker.h"
+
+#include <atomic>
+
+namespace NanoBanana { class FProviderEventChannel; struct FProviderEvent; }
+
+class FFailoverProvider : public IImageGenProvider
+{
+public:
+    using FMakeProvider = TFunction<TSharedPtr<IImageGenProvider, ESPMode::ThreadSafe>(ENanoBananaVendor)>;
+
+    /** MakeProvider defaults to FProviderFactory::Make; tests substitute scripted providers. */
+    explicit FFailoverProvider(TArray<FNanoBananaFailoverTarget> InChain, FMakeProvider InMakeProvider = FMakeProvider());
+
+    virtual void Submit(const FNanoBananaRequest& Request, const TArray<NanoBanana::Image::FEncodedReferenceRef>& References, const FProviderCallbacks& Callbacks) override;
+    virtual void Cancel() override;
+
+    // ---- Static helpers (testable without HTTP) ----
+
+    /**
+     * The request's own vendor/model, then Chain in order. Duplicates are dropped, and so are
+     * chain targets whose vendor has no API key (the request's own target is always kept).
+     */
+    static TArray<FNanoBananaFailoverTarget> BuildTargets(const FNanoBananaRequest& Request, const TArray<FNanoBananaFailoverTarget>& Chain,
+        TFunctionRef<bool(ENanoBananaVendor)> HasApiKey);
+    /** e.g. "Fal/Nano Banana 2", for logs and error messages. */
+    static FString DescribeTarget(const FNanoBananaFailoverTarget& Target);
+    /** FHedgePolicy key for a target's completion times at Resolution. */
+    static FString MakeLatencyKey(const FNanoBananaFailoverTarget& Target, ENanoBananaResolution Resolution);
+
+private:
+    /** One started target. Game thread only. */
+    struct FLeg
+    {
+        TSharedPtr<IImageGenProvider, ESPMode::ThreadSafe> Provider;
+        FTSTicker::FDelegateHandle HedgeTimer;
+        FString Error;
+        double StartedAt = 0.0;
+        /** Retry-After of the 429 this leg reported; negative when it was not rate limited. */
+        float RetryAfterSeconds = -1.0f;
+        bool bRunning = false;
+    };
+
+    void StartLeg(int32 Index);
+    FProviderCallbacks MakeLegCallbacks(int32 Index);
+    /** Game thread, from LegEvents: a leg's 429, failure or claimed win, in arrival order. */
+    void HandleLegEvent(NanoBanana::FProviderEvent& Event);
+    void ArmHedge(int32 Index);
+    /** Any thread. The first leg to deliver images owns the job. */
+    bool TryClaim(int32 Index);
+    /** Any thread. The first leg to start downloading owns the result files until it fails. */
+    bool TryReserveDownload(int32 Index);
+    /** Game thread. Passes a failed leg's 429 on: to the caller if the chain ends with it, else to the scheduler. */
+    void ReportLegRateLimit(int32 Index, bool bChainEnds);
+    /** Game thread, after a successful claim: cancels the other legs and records timings. */
+    void FinishWinner(int32 Index);
+    void HandleLegFailure(int32 Index, const FString& Error);
+    void StopLeg(FLeg& Leg);
+    int32 NumRunning() const;
+    double SecondsSince(double Time) const { return FPlatformTime::Seconds() - Time; }
+
+    TArray<FNanoBananaFailoverTarget> Chain;
+    FMakeProvider MakeProvider;
+
+    FNanoBananaRequest Request;
+    TArray<NanoBanana::Image::FEncodedReferenceRef> References;
+    TSharedPtr<const FProviderCallbacks, ESPMode::ThreadSafe> Callbacks;
+    TArray<FNanoBananaFailoverTarget> Targets;
+    /** Parallel to Targets; sized once in Submit so callbacks can index it safely. */
+    TArray<FLeg> Legs;
+    /** Carries leg 429s, failures and wins (Index = leg) from any thread to the game thread. */
+    TSharedPtr<NanoBanana::FProviderEventChannel, ESPMode::ThreadSafe> LegEvents;
+    int32 NextTarget = 0;
+    double SubmittedAt = 0.0;
+
+    std::atomic<int32> Winner { INDEX_NONE };
+    std::atomic<int32> DownloadOwner { INDEX_NONE };
+    std::atomic<bool> bCanceled { false };
+};
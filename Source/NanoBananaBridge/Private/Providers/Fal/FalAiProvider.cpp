@@ -1,13 +1,73 @@
 #include "FalAiProvider.h"
 #include "../../Http/Base64Image.h"
+#include "../../Http/JsonBodyWriter.h"
+#include "../PayloadCapabilities.h"
 #include "../../Http/PollLoop.h"
+#include "../../Http/PollLatencyModel.h"
+#include "../../Http/HedgePolicy.h"
+#include "../../Http/ResultDownloader.h"
+#include "../../Http/SseStream.h"
+#include "../../Http/SharedPayload.h"
 #include "NanoBananaSettings.h"
+#include "NanoBananaLog.h"
 #include "HttpModule.h"
 #include "Interfaces/IHttpResponse.h"
 #include "Dom/JsonObject.h"
 #include "Serialization/JsonReader.h"
 #include "Serialization/JsonSerializer.h"
-#include "Serialization/JsonWriter.h"
+#include "Async/Async.h"
+#include "Tasks/Task.h"
+
+#include <atomic>
+
+namespace
+{
+    /** A UTF-8 body (or its first MaxBytes, for error messages) as text. */
+    static FString Utf8ToString(TConstArrayView<uint8> Utf8, int32 MaxBytes = MAX_int32)
+    {
+        const FUTF8ToTCHAR Text((const UTF8CHAR*)Utf8.GetData(), FMath::Min(Utf8.Num(), MaxBytes));
+        return FString(Text.Length(), Text.Get());
+    }
+
+    /** Shared by a status stream's event handler (HTTP thread) and its completion (game thread). */
+    struct FFalStatusStreamState
+    {
+        /** Set by whichever side acts first: a terminal event, or the stream ending without one. */
+        std::atomic<bool> bFinished { false };
+        double OpenedAt = 0.0;
+    };
+
+    /** request_id from a queue submission response; empty if it has none. */
+    static FString ParseQueueRequestId(const FString& Body)
+    {
+        TSharedPtr<FJsonObject> Json;
+        FString RequestId;
+        if (FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Body), Json) && Json.IsValid())
+        {
+            Json->TryGetStringField(TEXT("request_id"), RequestId);
+        }
+        return RequestId;
+    }
+
+    /** PUT .../requests/{id}/cancel for a queued job; fire and forget. */
+    static TSharedRef<IHttpRequest, ESPMode::ThreadSafe> MakeQueueCancelRequest(const FString& Slug, const FString& RequestId, const FString& ApiKey)
+    {
+        TSharedRef<IHttpRequest, ESPMode::ThreadSafe> CancelReq = FHttpModule::Get().CreateRequest();
+        CancelReq->SetURL(FFalAiProvider::BuildQueueCancelUrl(UNanoBananaSettings::Get().Fal.QueueBaseUrlOverride, Slug, RequestId));
+        CancelReq->SetVerb(TEXT("PUT"));
+        CancelReq->SetHeader(TEXT("Authorization"), FString::Printf(TEXT("Key %s"), *ApiKey));
+        return CancelReq;
+    }
+}
+
+struct FFalQueueSubmitState
+{
+    /**
+     * Game thread. The leg was abandoned (or the job canceled) before FAL answered the
+     * submission; once it does, the queued copy is canceled instead of watched.
+     */
+    bool bAbandoned = false;
+};
 
 FString FFalAiProvider::ResolveModelSlug(ENanoBananaModel Model, const FString& CustomModelId)
 {
@@ -45,276 +105,567 @@ FString FFalAiProvider::BuildQueueStatusUrl(const FString& Override, const FStri
     return FString::Printf(TEXT("%s/%s/requests/%s/status"), *Base, *Slug, *RequestId);
 }
 
+FString FFalAiProvider::BuildQueueStatusStreamUrl(const FString& Override, const FString& Slug, const FString& RequestId)
+{
+    return BuildQueueStatusUrl(Override, Slug, RequestId) + TEXT("/stream");
+}
+
+EFalQueueStatus FFalAiProvider::ParseQueueStatus(TConstArrayView<uint8> Utf8Json)
+{
+    // Status events are small flat objects; find the first "status" key and read its string
+    // value rather than building a DOM per event.
+    static constexpr ANSICHAR Key[] = "\"status\"";
+    constexpr int32 KeyLen = UE_ARRAY_COUNT(Key) - 1;
+    const uint8* Data = Utf8Json.GetData();
+    const int32 Num = Utf8Json.Num();
+    for (int32 i = 0; i + KeyLen <= Num; ++i)
+    {
+        if (FMemory::Memcmp(Data + i, Key, KeyLen) != 0) continue;
+
+        int32 j = i + KeyLen;
+        while (j < Num && FChar::IsWhitespace((TCHAR)Data[j])) ++j;
+        if (j >= Num || Data[j] != ':') continue;
+        ++j;
+        while (j < Num && FChar::IsWhitespace((TCHAR)Data[j])) ++j;
+        if (j >= Num || Data[j] != '"') continue;
+        const int32 Start = ++j;
+        while (j < Num && Data[j] != '"') ++j;
+        if (j >= Num) return EFalQueueStatus::Unknown;
+
+        const FAnsiStringView Value((const ANSICHAR*)Data + Start, j - Start);
+        if (Value.Equals("IN_QUEUE", ESearchCase::IgnoreCase)) return EFalQueueStatus::InQueue;
+        if (Value.Equals("IN_PROGRESS", ESearchCase::IgnoreCase)) return EFalQueueStatus::InProgress;
+        if (Value.Equals("COMPLETED", ESearchCase::IgnoreCase)) return EFalQueueStatus::Completed;
+        if (Value.Equals("FAILED", ESearchCase::IgnoreCase) || Value.Equals("ERROR", ESearchCase::IgnoreCase)) return EFalQueueStatus::Failed;
+        return EFalQueueStatus::Unknown;
+    }
+    return EFalQueueStatus::Unknown;
+}
+
 FString FFalAiProvider::BuildQueueResultUrl(const FString& Override, const FString& Slug, const FString& RequestId)
 {
     const FString Base = Override.IsEmpty() ? TEXT("https://queue.fal.run") : TrimSlash(Override);
     return FString::Printf(TEXT("%s/%s/requests/%s"), *Base, *Slug, *RequestId);
 }
 
-FString FFalAiProvider::BuildRequestJson(const FNanoBananaRequest& Request, const TArray<TArray<uint8>>& EncodedReferences)
+FString FFalAiProvider::BuildQueueCancelUrl(const FString& Override, const FString& Slug, const FString& RequestId)
+{
+    return BuildQueueResultUrl(Override, Slug, RequestId) + TEXT("/cancel");
+}
+
+TArray<uint8> FFalAiProvider::BuildRequestBody(const FNanoBananaRequest& Request, const TArray<NanoBanana::Image::FEncodedReferenceRef>& EncodedReferences)
 {
-    TSharedPtr<FJsonObject> Root = MakeShared<FJsonObject>();
+    const FPayloadCapabilities& Caps = FPayloadCapabilityTable::Find(ENanoBananaVendor::Fal, ResolveModelSlug(Request.Model, Request.CustomModelId));
 
-    Root->SetStringField(TEXT("prompt"), Request.Prompt);
-    Root->SetNumberField(TEXT("num_images"), FMath::Max(1, Request.NumImages));
-    Root->SetStringField(TEXT("output_format"),
-        Request.OutputFormat == ENanoBananaOutputFormat::JPEG ? TEXT("jpeg") :
-        Request.OutputFormat == ENanoBananaOutputFormat::WebP ? TEXT("webp") : TEXT("png"));
+    // Size the buffer up front so the data URIs are appended without reallocation.
+    const int64 Estimate = 512 + ((int64)Request.Prompt.Len() + Request.NegativePrompt.Len()) * 3
+        + FPayloadCapabilityTable::EstimateDataUriFieldSize(Caps, EncodedReferences);
+
+    NanoBanana::Json::FJsonBodyWriter W(Estimate);
+    W.BeginObject();
+
+    W.WriteString("prompt", Request.Prompt);
+    W.WriteInt("num_images", FMath::Max(1, Request.NumImages));
+    W.WriteAsciiString("output_format",
+        Request.OutputFormat == ENanoBananaOutputFormat::JPEG ? "jpeg" :
+        Request.OutputFormat == ENanoBananaOutputFormat::WebP ? "webp" : "png");
 
     if (Request.Aspect != ENanoBananaAspect::Auto)
     {
-        Root->SetStringField(TEXT("aspect_ratio"), FNanoBananaTypeUtils::AspectToString(Request.Aspect));
+        W.WriteString("aspect_ratio", FNanoBananaTypeUtils::AspectToString(Request.Aspect));
     }
     if (Request.Resolution != ENanoBananaResolution::Auto)
     {
-        Root->SetStringField(TEXT("resolution"), FNanoBananaTypeUtils::ResolutionToString(Request.Resolution));
+        W.WriteString("resolution", FNanoBananaTypeUtils::ResolutionToString(Request.Resolution));
     }
     if (Request.Seed != 0)
     {
-        Root->SetNumberField(TEXT("seed"), Request.Seed);
+        W.WriteInt("seed", Request.Seed);
     }
     if (!Request.NegativePrompt.IsEmpty())
     {
-        Root->SetStringField(TEXT("negative_prompt"), Request.NegativePrompt);
+        W.WriteString("negative_prompt", Request.NegativePrompt);
     }
 
-    if (EncodedReferences.Num() > 0)
-    {
-        // FAL nano-banana edit endpoints accept image_urls (data URI strings work).
-        TArray<TSharedPtr<FJsonValue>> Urls;
-        for (const TArray<uint8>& Img : EncodedReferences)
-        {
-            if (Img.Num() == 0) continue;
-            const FString Mime = NanoBanana::Image::SniffImageMimeType(Img);
-            const FString Uri = NanoBanana::Image::PngBytesToDataUri(Img, Mime);
-            Urls.Add(MakeShared<FJsonValueString>(Uri));
-        }
-        if (Urls.Num() > 0)
-        {
-            Root->SetArrayField(TEXT("image_urls"), Urls);
-            // Some models also accept singular image_url for the first image.
-            Root->SetStringField(TEXT("image_url"), Urls[0]->AsString());
-        }
-    }
+    // Each reference exactly once, in the field this model reads (nano-banana: image_urls).
+    FPayloadCapabilityTable::WriteDataUriField(W, Caps, EncodedReferences);
 
-    FString Out;
-    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Out);
-    FJsonSerializer::Serialize(Root.ToSharedRef(), Writer);
-    return Out;
+    W.EndObject();
+    return W.Finish();
+}
+
+FString FFalAiProvider::BuildRequestJson(const FNanoBananaRequest& Request, const TArray<NanoBanana::Image::FEncodedReferenceRef>& EncodedReferences)
+{
+    return NanoBanana::Json::FJsonBodyWriter::ToString(BuildRequestBody(Request, EncodedReferences));
 }
 
-void FFalAiProvider::Submit(const FNanoBananaRequest& Request, const FProviderCallbacks& Callbacks)
+void FFalAiProvider::Submit(const FNanoBananaRequest& Request, const TArray<NanoBanana::Image::FEncodedReferenceRef>& References, const FProviderCallbacks& InCallbacks)
 {
+    const FProviderCallbacksRef Callbacks = MakeShared<FProviderCallbacks, ESPMode::ThreadSafe>(InCallbacks);
     const UNanoBananaSettings& S = UNanoBananaSettings::Get();
     const FString ApiKey = S.GetEffectiveApiKey(ENanoBananaVendor::Fal);
     if (ApiKey.IsEmpty())
     {
-        if (Callbacks.OnFailure) Callbacks.OnFailure(TEXT("FAL: missing API key (set in Project Settings or FAL_KEY env var)."));
+        if (Callbacks->OnFailure) Callbacks->OnFailure(TEXT("FAL: missing API key (set in Project Settings or FAL_KEY env var)."));
         return;
     }
 
-    TArray<TArray<uint8>> Refs;
-    NanoBanana::Image::ResolveAllReferences(Request, Refs);
-
     const FString Slug = ResolveModelSlug(Request.Model, Request.CustomModelId);
-    const FString Body = BuildRequestJson(Request, Refs);
+    PollLatencyKey = NanoBanana::Http::FPollLatencyModel::MakeKey(ENanoBananaVendor::Fal, Slug, Request.Resolution);
+    const NanoBanana::FSharedBytes Body = NanoBanana::MakeSharedBytes(BuildRequestBody(Request, References));
 
-    if (Callbacks.OnRequestBuilt) Callbacks.OnRequestBuilt(Body);
+    if (Callbacks->OnRequestBuilt) Callbacks->OnRequestBuilt(Body);
 
+    StartedAt = FPlatformTime::Seconds();
     if (S.Fal.bAlwaysUseQueue)
     {
         SubmitQueue(Slug, Body, ApiKey, Callbacks);
     }
     else
     {
-        const FString SyncUrl = BuildSyncUrl(S.Fal.SyncBaseUrlOverride, Slug);
-        SubmitSync(SyncUrl, Body, ApiKey, Callbacks);
+        SubmitSync(Slug, Body, ApiKey, Callbacks);
     }
 }
 
-void FFalAiProvider::SubmitSync(const FString& Url, const FString& Body, const FString& ApiKey, const FProviderCallbacks& Callbacks)
+void FFalAiProvider::SubmitSync(const FString& Slug, const NanoBanana::FSharedBytes& Body, const FString& ApiKey, const FProviderCallbacksRef& Callbacks)
 {
-    if (Callbacks.OnProgress) Callbacks.OnProgress(0.2f, TEXT("FAL sync request"));
+    if (Callbacks->OnProgress) Callbacks->OnProgress(0.2f, TEXT("FAL sync request"));
     const UNanoBananaSettings& S = UNanoBananaSettings::Get();
+    SyncTimeoutSeconds = (float)FMath::Max(5, S.RequestTimeoutSeconds);
 
     TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Req = FHttpModule::Get().CreateRequest();
-    InFlight = Req;
-    Req->SetURL(Url);
+    SyncRequest = Req;
+    bSyncPending = true;
+    Req->SetURL(BuildSyncUrl(S.Fal.SyncBaseUrlOverride, Slug));
     Req->SetVerb(TEXT("POST"));
     Req->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
     Req->SetHeader(TEXT("Authorization"), FString::Printf(TEXT("Key %s"), *ApiKey));
-    Req->SetTimeout((float)FMath::Max(5, S.RequestTimeoutSeconds));
-    Req->SetContentAsString(Body);
+    Req->SetTimeout(SyncTimeoutSeconds);
+    NanoBanana::Http::SetSharedContent(*Req, Body); // the queue submission resends this same buffer
 
     TWeakPtr<FFalAiProvider, ESPMode::ThreadSafe> WeakThis = StaticCastSharedRef<FFalAiProvider>(AsShared());
     Req->OnProcessRequestComplete().BindLambda(
-        [WeakThis, Callbacks, Body, ApiKey](FHttpRequestPtr ReqPtr, FHttpResponsePtr Resp, bool bSucceeded)
+        [WeakThis, Callbacks, Body, ApiKey, Slug](FHttpRequestPtr Sent, FHttpResponsePtr Resp, bool bSucceeded)
         {
             TSharedPtr<FFalAiProvider, ESPMode::ThreadSafe> Pinned = WeakThis.Pin();
             if (!Pinned.IsValid() || Pinned->bCanceled) return;
-            Pinned->InFlight.Reset();
+            Pinned->SyncRequest.Reset();
+            Pinned->bSyncPending = false;
+            if (Pinned->IsAbandoned(ELeg::Sync)) return;
+            const float Elapsed = (float)(FPlatformTime::Seconds() - Pinned->StartedAt);
 
-            const bool bTimeout = !bSucceeded || !Resp.IsValid();
-            if (!bTimeout)
+            const bool bNoResponse = !bSucceeded || !Resp.IsValid();
+            if (!bNoResponse)
             {
                 const int32 Code = Resp->GetResponseCode();
-                const FString RespStr = Resp->GetContentAsString();
                 if (Code >= 200 && Code < 300)
                 {
-                    Pinned->HandleResultPayload(RespStr, Callbacks);
+                    NanoBanana::Http::FHedgePolicy::Get().RecordPrimaryLatency(Pinned->PollLatencyKey, Elapsed);
+                    if (Pinned->ClaimResult(ELeg::Sync))
+                    {
+                        Pinned->ParseResultOffGameThread(Resp, Callbacks);
+                    }
                     return;
                 }
+                ReportIfRateLimited(ENanoBananaVendor::Fal, *Resp, *Callbacks);
                 // Hard failure (auth, bad request) — don't bother queuing.
                 if (Code == 401 || Code == 403 || Code == 422)
                 {
-                    if (Callbacks.OnFailure) Callbacks.OnFailure(FString::Printf(TEXT("FAL HTTP %d: %s"), Code, *RespStr.Left(512)));
+                    if (Pinned->ShouldReportFailure(ELeg::Sync) && Callbacks->OnFailure) Callbacks->OnFailure(FString::Printf(TEXT("FAL HTTP %d: %s"), Code, *Resp->GetContentAsString().Left(512)));
                     return;
                 }
             }
 
-            // Soft failure (timeout, 5xx) — fall back to queue.
-            if (Callbacks.OnProgress) Callbacks.OnProgress(0.25f, TEXT("FAL sync timed out — switching to queue"));
-            // Re-derive slug from URL (last 2 path components).
-            FString Url2 = ReqPtr.IsValid() ? ReqPtr->GetURL() : FString();
-            const int32 SlashIdx = Url2.Find(TEXT("/fal-ai/"));
-            FString Slug = (SlashIdx != INDEX_NONE) ? Url2.RightChop(SlashIdx + 1) : TEXT("fal-ai/nano-banana");
-            // Strip query string if any.
-            int32 Q = INDEX_NONE; if (Slug.FindChar('?', Q)) Slug.LeftInline(Q);
+            // Soft failure (timeout, network, 5xx). Only a timeout says how slow the sync path
+            // is: the leg was abandoned this long in. A fast error would drag the hedge delay down.
+            if (bNoResponse && Sent.IsValid() && Sent->GetFailureReason() == EHttpFailureReason::TimedOut)
+            {
+                NanoBanana::Http::FHedgePolicy::Get().RecordPrimaryLatency(Pinned->PollLatencyKey, Elapsed);
+            }
+            if (Pinned->bQueueStarted)
+            {
+                // Already hedged; the queued job carries on by itself.
+                if (Pinned->ShouldReportFailure(ELeg::Sync) && Callbacks->OnFailure) Callbacks->OnFailure(TEXT("FAL sync request failed and the queued job did not complete."));
+                return;
+            }
+            Pinned->ClearHedgeTimer();
+            if (Callbacks->OnProgress) Callbacks->OnProgress(0.25f, TEXT("FAL sync timed out — switching to queue"));
             Pinned->SubmitQueue(Slug, Body, ApiKey, Callbacks);
         });
     Req->ProcessRequest();
+
+    if (S.Fal.bHedgeSyncWithQueue)
+    {
+        ScheduleHedge(Slug, Body, ApiKey, Callbacks);
+    }
+}
+
+void FFalAiProvider::ScheduleHedge(const FString& Slug, const NanoBanana::FSharedBytes& Body, const FString& ApiKey, const FProviderCallbacksRef& Callbacks)
+{
+    const UNanoBananaSettings& S = UNanoBananaSettings::Get();
+    bHedging = true;
+    // Past the usual sync latency for this model and resolution the request is in the tail,
+    // where the serial fallback would cost up to a full timeout before the queue even starts.
+    const float Delay = NanoBanana::Http::FHedgePolicy::Get().GetHedgeDelay(PollLatencyKey, S.Fal.HedgePercentile, S.Fal.HedgeDelayWithoutHistorySeconds, SyncTimeoutSeconds);
+    if (Delay >= SyncTimeoutSeconds) return;
+
+    TWeakPtr<FFalAiProvider, ESPMode::ThreadSafe> WeakThis = StaticCastSharedRef<FFalAiProvider>(AsShared());
+    HedgeTimer = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda(
+        [WeakThis, Slug, Body, ApiKey, Callbacks](float)
+        {
+            TSharedPtr<FFalAiProvider, ESPMode::ThreadSafe> P = WeakThis.Pin();
+            if (!P.IsValid() || P->bCanceled) return false;
+            P->HedgeTimer.Reset();
+            if (P->Winner == ELeg::None && P->bSyncPending && !P->bQueueStarted)
+            {
+                P->HedgedAt = FPlatformTime::Seconds();
+                if (Callbacks->OnProgress) Callbacks->OnProgress(0.25f, TEXT("FAL sync running long — also queuing"));
+                P->SubmitQueue(Slug, Body, ApiKey, Callbacks);
+            }
+            return false;
+        }), Delay);
+}
+
+bool FFalAiProvider::ClaimResult(ELeg Leg)
+{
+    if (Winner != ELeg::None) return false;
+    Winner = Leg;
+    ClearHedgeTimer();
+
+    const double Now = FPlatformTime::Seconds();
+    if (Leg == ELeg::Queue && SyncRequest.IsValid())
+    {
+        // Abandoned while still running, so at least this slow; keeps the latency window
+        // from only ever seeing the requests fast enough to win.
+        NanoBanana::Http::FHedgePolicy::Get().RecordPrimaryLatency(PollLatencyKey, (float)(Now - StartedAt));
+        SyncRequest->CancelRequest();
+        SyncRequest.Reset();
+        bSyncPending = false;
+    }
+    if (Leg == ELeg::Sync && bQueueStarted)
+    {
+        CancelQueueLeg();
+    }
+
+    if (bHedging)
+    {
+        NanoBanana::Http::FHedgePolicy::Get().RecordOutcome((float)(Now - StartedAt),
+            HedgedAt >= 0.0 ? (float)(HedgedAt - StartedAt) : -1.0f, Leg == ELeg::Queue, SyncTimeoutSeconds);
+    }
+    return true;
+}
+
+bool FFalAiProvider::ShouldReportFailure(ELeg Leg)
+{
+    if (Winner != ELeg::None) return Winner == Leg;
+    (Leg == ELeg::Sync ? bSyncPending : bQueuePending) = false;
+    if (Leg == ELeg::Sync ? bQueuePending : bSyncPending)
+    {
+        UE_LOG(LogNanoBanana, Log, TEXT("FAL %s request failed; waiting on the %s request."),
+            Leg == ELeg::Sync ? TEXT("sync") : TEXT("queue"), Leg == ELeg::Sync ? TEXT("queue") : TEXT("sync"));
+        return false;
+    }
+    Winner = Leg;
+    ClearHedgeTimer();
+    return true;
+}
+
+void FFalAiProvider::CancelQueueLeg()
+{
+    bQueuePending = false;
+    AbandonQueueSubmit();
+    if (InFlight.IsValid()) { InFlight->CancelRequest(); InFlight.Reset(); }
+    if (StatusStream.IsValid()) { StatusStream->CancelRequest(); StatusStream.Reset(); }
+    if (Poll.IsValid()) { Poll->Cancel(); Poll.Reset(); }
+    if (QueueCancel.IsValid())
+    {
+        // Best effort, so FAL stops (and stops billing) the queued copy; nothing waits on it.
+        QueueCancel->ProcessRequest();
+        QueueCancel.Reset();
+    }
+}
+
+void FFalAiProvider::AbandonQueueSubmit()
+{
+    // Canceling the submission locally would not stop a job FAL may already have accepted,
+    // so it is left to finish and its completion sends the cancel.
+    if (QueueSubmit.IsValid())
+    {
+        QueueSubmit->bAbandoned = true;
+        QueueSubmit.Reset();
+    }
+}
+
+void FFalAiProvider::ClearHedgeTimer()
+{
+    if (HedgeTimer.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(HedgeTimer);
+        HedgeTimer.Reset();
+    }
 }
 
-void FFalAiProvider::SubmitQueue(const FString& Slug, const FString& Body, const FString& ApiKey, const FProviderCallbacks& Callbacks)
+void FFalAiProvider::SubmitQueue(const FString& Slug, const NanoBanana::FSharedBytes& Body, const FString& ApiKey, const FProviderCallbacksRef& Callbacks)
 {
     const UNanoBananaSettings& S = UNanoBananaSettings::Get();
-    if (Callbacks.OnProgress) Callbacks.OnProgress(0.3f, TEXT("FAL queue submit"));
+    if (Callbacks->OnProgress) Callbacks->OnProgress(0.3f, TEXT("FAL queue submit"));
 
     TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Submit = FHttpModule::Get().CreateRequest();
-    InFlight = Submit;
+    TSharedRef<FFalQueueSubmitState> SubmitState = MakeShared<FFalQueueSubmitState>();
+    QueueSubmit = SubmitState;
+    bQueueStarted = true;
+    bQueuePending = true;
     Submit->SetURL(BuildQueueSubmitUrl(S.Fal.QueueBaseUrlOverride, Slug));
     Submit->SetVerb(TEXT("POST"));
     Submit->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
     Submit->SetHeader(TEXT("Authorization"), FString::Printf(TEXT("Key %s"), *ApiKey));
-    Submit->SetContentAsString(Body);
+    NanoBanana::Http::SetSharedContent(*Submit, Body);
 
     TWeakPtr<FFalAiProvider, ESPMode::ThreadSafe> WeakThis = StaticCastSharedRef<FFalAiProvider>(AsShared());
     Submit->OnProcessRequestComplete().BindLambda(
-        [WeakThis, Callbacks, Slug, ApiKey](FHttpRequestPtr, FHttpResponsePtr Resp, bool bSucceeded)
+        [WeakThis, Callbacks, Slug, ApiKey, SubmitState](FHttpRequestPtr, FHttpResponsePtr Resp, bool bSucceeded)
         {
+            if (SubmitState->bAbandoned)
+            {
+                // The sync request won (or the job was canceled) while this was in flight. The
+                // job is queued, and billed, all the same unless it is canceled now. Does not
+                // need the provider, which may already be gone.
+                const FString LateRequestId = (bSucceeded && Resp.IsValid() && Resp->GetResponseCode() >= 200 && Resp->GetResponseCode() < 300)
+                    ? ParseQueueRequestId(Resp->GetContentAsString()) : FString();
+                if (!LateRequestId.IsEmpty())
+                {
+                    UE_LOG(LogNanoBanana, Verbose, TEXT("FAL queue submission %s answered after its leg was abandoned; canceling it."), *LateRequestId);
+                    MakeQueueCancelRequest(Slug, LateRequestId, ApiKey)->ProcessRequest();
+                }
+                return;
+            }
             TSharedPtr<FFalAiProvider, ESPMode::ThreadSafe> Pinned = WeakThis.Pin();
-            if (!Pinned.IsValid() || Pinned->bCanceled) return;
-            Pinned->InFlight.Reset();
+            if (!Pinned.IsValid() || Pinned->bCanceled || Pinned->IsAbandoned(ELeg::Queue)) return;
+            Pinned->QueueSubmit.Reset();
             if (!bSucceeded || !Resp.IsValid())
             {
-                if (Callbacks.OnFailure) Callbacks.OnFailure(TEXT("FAL queue submit failed (network)."));
+                if (Pinned->ShouldReportFailure(ELeg::Queue) && Callbacks->OnFailure) Callbacks->OnFailure(TEXT("FAL queue submit failed (network)."));
                 return;
             }
             const int32 Code = Resp->GetResponseCode();
             const FString RespStr = Resp->GetContentAsString();
             if (Code < 200 || Code >= 300)
             {
-                if (Callbacks.OnFailure) Callbacks.OnFailure(FString::Printf(TEXT("FAL queue HTTP %d: %s"), Code, *RespStr.Left(512)));
+                ReportIfRateLimited(ENanoBananaVendor::Fal, *Resp, *Callbacks);
+                if (Pinned->ShouldReportFailure(ELeg::Queue) && Callbacks->OnFailure) Callbacks->OnFailure(FString::Printf(TEXT("FAL queue HTTP %d: %s"), Code, *RespStr.Left(512)));
                 return;
             }
 
-            // Parse request_id and start polling status.
-            TSharedPtr<FJsonObject> Json;
-            TSharedRef<TJsonReader<>> R = TJsonReaderFactory<>::Create(RespStr);
-            FString RequestId;
-            if (FJsonSerializer::Deserialize(R, Json) && Json.IsValid())
-            {
-                Json->TryGetStringField(TEXT("request_id"), RequestId);
-            }
+            // Parse request_id and start watching the job.
+            const FString RequestId = ParseQueueRequestId(RespStr);
             if (RequestId.IsEmpty())
             {
-                if (Callbacks.OnFailure) Callbacks.OnFailure(TEXT("FAL queue: response missing request_id."));
+                if (Pinned->ShouldReportFailure(ELeg::Queue) && Callbacks->OnFailure) Callbacks->OnFailure(TEXT("FAL queue: response missing request_id."));
                 return;
             }
 
-            const UNanoBananaSettings& S2 = UNanoBananaSettings::Get();
-            const FString StatusUrl = BuildQueueStatusUrl(S2.Fal.QueueBaseUrlOverride, Slug, RequestId);
-            const FString ResultUrl = BuildQueueResultUrl(S2.Fal.QueueBaseUrlOverride, Slug, RequestId);
+            if (Pinned->bSyncPending)
+            {
+                Pinned->QueueCancel = MakeQueueCancelRequest(Slug, RequestId, ApiKey);
+            }
 
-            using namespace NanoBanana::Http;
-            TSharedPtr<FPollLoop, ESPMode::ThreadSafe> Loop = MakeShared<FPollLoop, ESPMode::ThreadSafe>();
-            Pinned->Poll = Loop;
-            Loop->MaxTotalSeconds = (float)FMath::Max(10, S2.MaxPollSeconds);
-            Loop->RequestFactory = [StatusUrl, ApiKey]()
+            if (UNanoBananaSettings::Get().Fal.bStreamQueueStatus)
             {
-                TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Q = FHttpModule::Get().CreateRequest();
-                Q->SetURL(StatusUrl);
-                Q->SetVerb(TEXT("GET"));
-                Q->SetHeader(TEXT("Authorization"), FString::Printf(TEXT("Key %s"), *ApiKey));
-                return Q;
-            };
-            Loop->DecideFn = [](int32 HttpCode, const FString& Body, FString& OutErr) -> EPollDecision
+                Pinned->StreamQueueStatus(Slug, RequestId, ApiKey, Callbacks);
+            }
+            else
             {
-                if (HttpCode < 200 || HttpCode >= 300)
-                {
-                    OutErr = FString::Printf(TEXT("FAL status HTTP %d: %s"), HttpCode, *Body.Left(256));
-                    return EPollDecision::Failed;
-                }
-                TSharedPtr<FJsonObject> J;
-                TSharedRef<TJsonReader<>> R = TJsonReaderFactory<>::Create(Body);
-                if (FJsonSerializer::Deserialize(R, J) && J.IsValid())
-                {
-                    FString St; J->TryGetStringField(TEXT("status"), St);
-                    if (St.Equals(TEXT("COMPLETED"), ESearchCase::IgnoreCase)) return EPollDecision::Succeeded;
-                    if (St.Equals(TEXT("FAILED"), ESearchCase::IgnoreCase) || St.Equals(TEXT("ERROR"), ESearchCase::IgnoreCase))
-                    {
-                        OutErr = FString::Printf(TEXT("FAL job failed: %s"), *Body.Left(512));
-                        return EPollDecision::Failed;
-                    }
-                }
-                return EPollDecision::Continue;
-            };
-            Loop->OnProgress = [Callbacks](float F)
+                Pinned->PollQueueStatus(Slug, RequestId, ApiKey, Callbacks, (float)UNanoBananaSettings::Get().MaxPollSeconds);
+            }
+        });
+    Submit->ProcessRequest();
+}
+
+void FFalAiProvider::StreamQueueStatus(const FString& Slug, const FString& RequestId, const FString& ApiKey, const FProviderCallbacksRef& Callbacks)
+{
+    const UNanoBananaSettings& S = UNanoBananaSettings::Get();
+    TSharedRef<FFalStatusStreamState, ESPMode::ThreadSafe> State = MakeShared<FFalStatusStreamState, ESPMode::ThreadSafe>();
+    State->OpenedAt = FPlatformTime::Seconds();
+
+    TWeakPtr<FFalAiProvider, ESPMode::ThreadSafe> WeakThis = StaticCastSharedRef<FFalAiProvider>(AsShared());
+
+    // Runs on the HTTP thread per event. Only the status field is read; the first terminal
+    // status wins and hops to the game thread, which drops the stream and fetches the result.
+    auto OnEvent = [WeakThis, Callbacks, State, Slug, RequestId, ApiKey](FAnsiStringView, TConstArrayView<uint8> Data)
+    {
+        if (State->bFinished) return;
+        const EFalQueueStatus Status = ParseQueueStatus(Data);
+        switch (Status)
+        {
+        case EFalQueueStatus::InQueue:
+            if (Callbacks->OnProgress) Callbacks->OnProgress(0.35f, TEXT("FAL queued"));
+            return;
+        case EFalQueueStatus::InProgress:
+            if (Callbacks->OnProgress) Callbacks->OnProgress(0.5f, TEXT("FAL running"));
+            return;
+        case EFalQueueStatus::Completed:
+        case EFalQueueStatus::Failed:
+            break;
+        default:
+            return;
+        }
+        if (State->bFinished.exchange(true)) return;
+
+        const double CompletedAt = FPlatformTime::Seconds() - State->OpenedAt;
+        const FString FailureBody = Status == EFalQueueStatus::Failed ? Utf8ToString(Data, 512) : FString();
+        AsyncTask(ENamedThreads::GameThread, [WeakThis, Callbacks, Status, CompletedAt, FailureBody, Slug, RequestId, ApiKey]()
+        {
+            TSharedPtr<FFalAiProvider, ESPMode::ThreadSafe> P = WeakThis.Pin();
+            if (!P.IsValid() || P->bCanceled || P->IsAbandoned(ELeg::Queue)) return;
+            if (P->StatusStream.IsValid())
             {
-                if (Callbacks.OnProgress) Callbacks.OnProgress(0.3f + 0.5f * F, TEXT("FAL polling..."));
-            };
-            Loop->OnFailed = [Callbacks](const FString& E)
+                P->StatusStream->CancelRequest();
+                P->StatusStream.Reset();
+            }
+            if (Status == EFalQueueStatus::Failed)
             {
-                if (Callbacks.OnFailure) Callbacks.OnFailure(E);
-            };
-            Loop->OnSucceeded = [WeakThis, Callbacks, ResultUrl, ApiKey](const FString& /*StatusBody*/)
+                if (P->ShouldReportFailure(ELeg::Queue) && Callbacks->OnFailure) Callbacks->OnFailure(FString::Printf(TEXT("FAL job failed: %s"), *FailureBody));
+                return;
+            }
+            if (!P->ClaimResult(ELeg::Queue)) return;
+            // Exact completion time: feeds the estimates polling uses when the stream is unavailable.
+            NanoBanana::Http::FPollLatencyModel::Get().Observe(P->PollLatencyKey, CompletedAt);
+            P->FetchQueueResult(BuildQueueResultUrl(UNanoBananaSettings::Get().Fal.QueueBaseUrlOverride, Slug, RequestId), ApiKey, Callbacks);
+        });
+    };
+
+    TSharedRef<NanoBanana::Http::FSseReceiveStream> Stream = MakeShared<NanoBanana::Http::FSseReceiveStream>(MoveTemp(OnEvent), /*bKeepBody*/ false);
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Req = FHttpModule::Get().CreateRequest();
+    StatusStream = Req;
+    Req->SetURL(BuildQueueStatusStreamUrl(S.Fal.QueueBaseUrlOverride, Slug, RequestId));
+    Req->SetVerb(TEXT("GET"));
+    Req->SetHeader(TEXT("Accept"), TEXT("text/event-stream"));
+    Req->SetHeader(TEXT("Authorization"), FString::Printf(TEXT("Key %s"), *ApiKey));
+    Req->SetTimeout((float)FMath::Max(10, S.MaxPollSeconds));
+    Req->SetResponseBodyReceiveStream(Stream);
+
+    Req->OnProcessRequestComplete().BindLambda(
+        [WeakThis, Callbacks, State, Stream, Slug, RequestId, ApiKey](FHttpRequestPtr, FHttpResponsePtr, bool)
+        {
+            TSharedPtr<FFalAiProvider, ESPMode::ThreadSafe> P = WeakThis.Pin();
+            if (!P.IsValid() || P->bCanceled) return;
+            P->StatusStream.Reset();
+            Stream->Finish();
+            if (State->bFinished.exchange(true) || P->IsAbandoned(ELeg::Queue)) return;
+
+            // The stream was refused or dropped before a terminal status: poll for the rest of
+            // the budget. A refusal (e.g. HTTP 4xx) is not an error in itself; polling reports
+            // whatever the status endpoint says.
+            const float Remaining = (float)(UNanoBananaSettings::Get().MaxPollSeconds - (FPlatformTime::Seconds() - State->OpenedAt));
+            P->PollQueueStatus(Slug, RequestId, ApiKey, Callbacks, Remaining);
+        });
+    Req->ProcessRequest();
+}
+
+void FFalAiProvider::PollQueueStatus(const FString& Slug, const FString& RequestId, const FString& ApiKey, const FProviderCallbacksRef& Callbacks, float MaxSeconds)
+{
+    const UNanoBananaSettings& S = UNanoBananaSettings::Get();
+    const FString StatusUrl = BuildQueueStatusUrl(S.Fal.QueueBaseUrlOverride, Slug, RequestId);
+    const FString ResultUrl = BuildQueueResultUrl(S.Fal.QueueBaseUrlOverride, Slug, RequestId);
+
+    using namespace NanoBanana::Http;
+    TSharedPtr<FPollLoop, ESPMode::ThreadSafe> Loop = MakeShared<FPollLoop, ESPMode::ThreadSafe>();
+    Poll = Loop;
+    Loop->MaxTotalSeconds = FMath::Max(10.0f, MaxSeconds);
+    Loop->Vendor = FName(*FNanoBananaTypeUtils::VendorToString(ENanoBananaVendor::Fal));
+    Loop->LatencyKey = PollLatencyKey;
+    Loop->RequestFactory = [StatusUrl, ApiKey]()
+    {
+        TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Q = FHttpModule::Get().CreateRequest();
+        Q->SetURL(StatusUrl);
+        Q->SetVerb(TEXT("GET"));
+        Q->SetHeader(TEXT("Authorization"), FString::Printf(TEXT("Key %s"), *ApiKey));
+        return Q;
+    };
+    Loop->DecideFn = [](int32 HttpCode, const FString& Body, FString& OutErr) -> EPollDecision
+    {
+        if (HttpCode < 200 || HttpCode >= 300)
+        {
+            OutErr = FString::Printf(TEXT("FAL status HTTP %d: %s"), HttpCode, *Body.Left(256));
+            return EPollDecision::Failed;
+        }
+        TSharedPtr<FJsonObject> J;
+        TSharedRef<TJsonReader<>> R = TJsonReaderFactory<>::Create(Body);
+        if (FJsonSerializer::Deserialize(R, J) && J.IsValid())
+        {
+            FString St; J->TryGetStringField(TEXT("status"), St);
+            if (St.Equals(TEXT("COMPLETED"), ESearchCase::IgnoreCase)) return EPollDecision::Succeeded;
+            if (St.Equals(TEXT("FAILED"), ESearchCase::IgnoreCase) || St.Equals(TEXT("ERROR"), ESearchCase::IgnoreCase))
             {
-                TSharedPtr<FFalAiProvider, ESPMode::ThreadSafe> P = WeakThis.Pin();
-                if (!P.IsValid() || P->bCanceled) return;
-                if (Callbacks.OnProgress) Callbacks.OnProgress(0.85f, TEXT("FAL fetching result"));
-                TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Get = FHttpModule::Get().CreateRequest();
-                P->InFlight = Get;
-                Get->SetURL(ResultUrl);
-                Get->SetVerb(TEXT("GET"));
-                Get->SetHeader(TEXT("Authorization"), FString::Printf(TEXT("Key %s"), *ApiKey));
-                TWeakPtr<FFalAiProvider, ESPMode::ThreadSafe> Wk = WeakThis;
-                Get->OnProcessRequestComplete().BindLambda(
-                    [Wk, Callbacks](FHttpRequestPtr, FHttpResponsePtr Resp2, bool bOK)
-                    {
-                        TSharedPtr<FFalAiProvider, ESPMode::ThreadSafe> P2 = Wk.Pin();
-                        if (!P2.IsValid() || P2->bCanceled) return;
-                        P2->InFlight.Reset();
-                        if (!bOK || !Resp2.IsValid())
-                        {
-                            if (Callbacks.OnFailure) Callbacks.OnFailure(TEXT("FAL result fetch failed."));
-                            return;
-                        }
-                        P2->HandleResultPayload(Resp2->GetContentAsString(), Callbacks);
-                    });
-                Get->ProcessRequest();
-            };
-            Loop->Start();
+                OutErr = FString::Printf(TEXT("FAL job failed: %s"), *Body.Left(512));
+                return EPollDecision::Failed;
+            }
+        }
+        return EPollDecision::Continue;
+    };
+    Loop->OnProgress = [Callbacks](float F)
+    {
+        if (Callbacks->OnProgress) Callbacks->OnProgress(0.3f + 0.5f * F, TEXT("FAL polling..."));
+    };
+    TWeakPtr<FFalAiProvider, ESPMode::ThreadSafe> WeakThis = StaticCastSharedRef<FFalAiProvider>(AsShared());
+    Loop->OnFailed = [WeakThis, Callbacks](const FString& E)
+    {
+        TSharedPtr<FFalAiProvider, ESPMode::ThreadSafe> P = WeakThis.Pin();
+        if (!P.IsValid() || P->bCanceled || !P->ShouldReportFailure(ELeg::Queue)) return;
+        if (Callbacks->OnFailure) Callbacks->OnFailure(E);
+    };
+    Loop->OnSucceeded = [WeakThis, Callbacks, ResultUrl, ApiKey](const NanoBanana::FSharedText& /*StatusBody*/)
+    {
+        TSharedPtr<FFalAiProvider, ESPMode::ThreadSafe> P = WeakThis.Pin();
+        if (!P.IsValid() || P->bCanceled || !P->ClaimResult(ELeg::Queue)) return;
+        P->FetchQueueResult(ResultUrl, ApiKey, Callbacks);
+    };
+    Loop->Start();
+}
+
+void FFalAiProvider::FetchQueueResult(const FString& ResultUrl, const FString& ApiKey, const FProviderCallbacksRef& Callbacks)
+{
+    if (Callbacks->OnProgress) Callbacks->OnProgress(0.85f, TEXT("FAL fetching result"));
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Get = FHttpModule::Get().CreateRequest();
+    InFlight = Get;
+    Get->SetURL(ResultUrl);
+    Get->SetVerb(TEXT("GET"));
+    Get->SetHeader(TEXT("Authorization"), FString::Printf(TEXT("Key %s"), *ApiKey));
+    TWeakPtr<FFalAiProvider, ESPMode::ThreadSafe> WeakThis = StaticCastSharedRef<FFalAiProvider>(AsShared());
+    Get->OnProcessRequestComplete().BindLambda(
+        [WeakThis, Callbacks](FHttpRequestPtr, FHttpResponsePtr Resp, bool bOK)
+        {
+            TSharedPtr<FFalAiProvider, ESPMode::ThreadSafe> P = WeakThis.Pin();
+            if (!P.IsValid() || P->bCanceled) return;
+            P->InFlight.Reset();
+            if (!bOK || !Resp.IsValid())
+            {
+                if (Callbacks->OnFailure) Callbacks->OnFailure(TEXT("FAL result fetch failed."));
+                return;
+            }
+            P->ParseResultOffGameThread(Resp, Callbacks);
         });
-    Submit->ProcessRequest();
+    Get->ProcessRequest();
+}
+
+void FFalAiProvider::ParseResultOffGameThread(FHttpResponsePtr Resp, const FProviderCallbacksRef& Callbacks)
+{
+    TWeakPtr<FFalAiProvider, ESPMode::ThreadSafe> WeakThis = StaticCastSharedRef<FFalAiProvider>(AsShared());
+    UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, Callbacks, Resp]()
+    {
+        TSharedPtr<FFalAiProvider, ESPMode::ThreadSafe> P = WeakThis.Pin();
+        if (!P.IsValid() || P->bCanceled) return;
+        P->HandleResultPayload(NanoBanana::MakeSharedText(Resp->GetContentAsString()), Callbacks);
+    });
 }
 
-void FFalAiProvider::HandleResultPayload(const FString& Body, const FProviderCallbacks& Callbacks)
+void FFalAiProvider::HandleResultPayload(const NanoBanana::FSharedText& Body, const FProviderCallbacksRef& Callbacks)
 {
     TSharedPtr<FJsonObject> Json;
-    TSharedRef<TJsonReader<>> R = TJsonReaderFactory<>::Create(Body);
+    TSharedRef<TJsonReader<>> R = TJsonReaderFactory<>::Create(*Body);
     if (!FJsonSerializer::Deserialize(R, Json) || !Json.IsValid())
     {
-        if (Callbacks.OnFailure) Callbacks.OnFailure(TEXT("FAL: failed to parse result JSON."));
+        if (Callbacks->OnFailure) Callbacks->OnFailure(TEXT("FAL: failed to parse result JSON."));
         return;
     }
 
@@ -354,56 +705,52 @@ void FFalAiProvider::HandleResultPayload(const FString& Body, const FProviderCal
 
     if (Urls.Num() == 0)
     {
-        if (Callbacks.OnFailure) Callbacks.OnFailure(FString::Printf(TEXT("FAL: result had no image URLs. Body: %s"), *Body.Left(512)));
+        if (Callbacks->OnFailure) Callbacks->OnFailure(FString::Printf(TEXT("FAL: result had no image URLs. Body: %s"), *Body->Left(512)));
         return;
     }
 
-    FetchImageUrls(Urls, Callbacks, Body);
+    // Back to the game thread to issue the downloads (InFlight/Cancel state lives there).
+    TWeakPtr<FFalAiProvider, ESPMode::ThreadSafe> WeakThis = StaticCastSharedRef<FFalAiProvider>(AsShared());
+    AsyncTask(ENamedThreads::GameThread, [WeakThis, Urls = MoveTemp(Urls), Callbacks, Body]()
+    {
+        TSharedPtr<FFalAiProvider, ESPMode::ThreadSafe> P = WeakThis.Pin();
+        if (!P.IsValid() || P->bCanceled) return;
+        P->FetchImageUrls(Urls, Callbacks, Body);
+    });
 }
 
-void FFalAiProvider::FetchImageUrls(const TArray<FString>& Urls, const FProviderCallbacks& Callbacks, const FString& RawResponse)
+void FFalAiProvider::FetchImageUrls(const TArray<FString>& Urls, const FProviderCallbacksRef& Callbacks, const NanoBanana::FSharedText& RawResponse)
 {
-    // Issue parallel GETs and assemble in order.
-    TSharedRef<TArray<TArray<uint8>>> Bucket = MakeShared<TArray<TArray<uint8>>>();
-    Bucket->SetNum(Urls.Num());
-    TSharedRef<int32> Pending = MakeShared<int32>(Urls.Num());
-    TSharedRef<bool> Failed = MakeShared<bool>(false);
+    // Parallel GETs, each streamed to its output file and one buffer; assembled in order.
+    Download = MakeShared<NanoBanana::Http::FResultDownloader, ESPMode::ThreadSafe>();
+    Download->ResolvePath = Callbacks->ResolveDownloadPath;
 
     TWeakPtr<FFalAiProvider, ESPMode::ThreadSafe> WeakThis = StaticCastSharedRef<FFalAiProvider>(AsShared());
-
-    for (int32 i = 0; i < Urls.Num(); ++i)
+    Download->OnSucceeded = [WeakThis, Callbacks, RawResponse](TArray<TArray<uint8>> Images, TArray<FString> SavedPaths)
     {
-        const FString Url = Urls[i];
-        TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Get = FHttpModule::Get().CreateRequest();
-        Get->SetURL(Url);
-        Get->SetVerb(TEXT("GET"));
-        const int32 Index = i;
-        Get->OnProcessRequestComplete().BindLambda(
-            [WeakThis, Callbacks, Bucket, Pending, Failed, Index, RawResponse]
-            (FHttpRequestPtr, FHttpResponsePtr Resp, bool bOK)
-            {
-                TSharedPtr<FFalAiProvider, ESPMode::ThreadSafe> P = WeakThis.Pin();
-                if (!P.IsValid() || P->bCanceled) return;
-                if (*Failed) return;
-                if (!bOK || !Resp.IsValid() || Resp->GetResponseCode() < 200 || Resp->GetResponseCode() >= 300)
-                {
-                    *Failed = true;
-                    if (Callbacks.OnFailure) Callbacks.OnFailure(FString::Printf(TEXT("FAL image download failed (index %d)."), Index));
-                    return;
-                }
-                (*Bucket)[Index] = Resp->GetContent();
-                if (--(*Pending) == 0)
-                {
-                    if (Callbacks.OnSuccess) Callbacks.OnSuccess(MoveTemp(*Bucket), RawResponse);
-                }
-            });
-        Get->ProcessRequest();
-    }
+        TSharedPtr<FFalAiProvider, ESPMode::ThreadSafe> P = WeakThis.Pin();
+        if (!P.IsValid() || P->bCanceled) return;
+        P->Download.Reset();
+        if (Callbacks->OnSuccess) Callbacks->OnSuccess(MoveTemp(Images), MoveTemp(SavedPaths), RawResponse);
+    };
+    Download->OnFailed = [WeakThis, Callbacks](int32 Index)
+    {
+        TSharedPtr<FFalAiProvider, ESPMode::ThreadSafe> P = WeakThis.Pin();
+        if (!P.IsValid() || P->bCanceled) return;
+        P->Download.Reset();
+        if (Callbacks->OnFailure) Callbacks->OnFailure(FString::Printf(TEXT("FAL image download failed (index %d)."), Index));
+    };
+    Download->Start(Urls);
 }
 
 void FFalAiProvider::Cancel()
 {
     bCanceled = true;
+    ClearHedgeTimer();
+    AbandonQueueSubmit();
+    if (SyncRequest.IsValid()) { SyncRequest->CancelRequest(); SyncRequest.Reset(); }
     if (InFlight.IsValid()) { InFlight->CancelRequest(); InFlight.Reset(); }
+    if (StatusStream.IsValid()) { StatusStream->CancelRequest(); StatusStream.Reset(); }
     if (Poll.IsValid()) { Poll->Cancel(); Poll.Reset(); }
+    if (Download.IsValid()) { Download->Cancel(); Download.Reset(); }
 }
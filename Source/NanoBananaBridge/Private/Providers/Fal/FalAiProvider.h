@@ -1,18 +1,36 @@
 // Provider: FAL.ai
 // Tries sync POST https://fal.run/{slug} first (60s blocking), falls back to
-// queue.fal.run/{slug} + status polling on timeout or when settings force it.
+// queue.fal.run/{slug} on timeout or when settings force it. With hedging on, a sync request
+// running past its usual latency is raced against a queue submission instead of waited out.
+// Queued jobs are watched through the status event stream (optional) or by polling, which
+// the stream falls back to.
 #pragma once
 
 #include "CoreMinimal.h"
 #include "../IImageGenProvider.h"
 #include "Interfaces/IHttpRequest.h"
+#include "Interfaces/IHttpResponse.h"
+#include "Containers/Ticker.h"
 
-namespace NanoBanana::Http { class FPollLoop; }
+#include <atomic>
+
+namespace NanoBanana::Http { class FPollLoop; class FResultDownloader; }
+struct FFalQueueSubmitState;
+
+/** Queue status as reported by /requests/{id}/status and its event stream. */
+enum class EFalQueueStatus : uint8
+{
+    Unknown,
+    InQueue,
+    InProgress,
+    Completed,
+    Failed,
+};
 
 class FFalAiProvider : public IImageGenProvider
 {
 public:
-    virtual void Submit(const FNanoBananaRequest& Request, const FProviderCallbacks& Callbacks) override;
+    virtual void Submit(const FNanoBananaRequest& Request, const TArray<NanoBanana::Image::FEncodedReferenceRef>& References, const FProviderCallbacks& Callbacks) override;
     virtual void Cancel() override;
 
     // ---- Static helpers (testable without HTTP) ----
@@ -21,16 +39,76 @@ public:
     static FString BuildSyncUrl(const FString& SyncBaseUrlOverride, const FString& Slug);
     static FString BuildQueueSubmitUrl(const FString& QueueBaseUrlOverride, const FString& Slug);
     static FString BuildQueueStatusUrl(const FString& QueueBaseUrlOverride, const FString& Slug, const FString& RequestId);
+    static FString BuildQueueStatusStreamUrl(const FString& QueueBaseUrlOverride, const FString& Slug, const FString& RequestId);
+    /** Reads the "status" field of one status payload (UTF-8 JSON) without building a DOM. */
+    static EFalQueueStatus ParseQueueStatus(TConstArrayView<uint8> Utf8Json);
     static FString BuildQueueResultUrl(const FString& QueueBaseUrlOverride, const FString& Slug, const FString& RequestId);
-    static FString BuildRequestJson(const FNanoBananaRequest& Request, const TArray<TArray<uint8>>& EncodedReferences);
+    static FString BuildQueueCancelUrl(const FString& QueueBaseUrlOverride, const FString& Slug, const FString& RequestId);
+    /** UTF-8 JSON body, written straight into the buffer handed to the HTTP request. */
+    static TArray<uint8> BuildRequestBody(const FNanoBananaRequest& Request, const TArray<NanoBanana::Image::FEncodedReferenceRef>& EncodedReferences);
+    /** BuildRequestBody decoded to text (tests/diagnostics). */
+    static FString BuildRequestJson(const FNanoBananaRequest& Request, const TArray<NanoBanana::Image::FEncodedReferenceRef>& EncodedReferences);
 
 private:
-    void SubmitSync(const FString& Url, const FString& Body, const FString& ApiKey, const FProviderCallbacks& Callbacks);
-    void SubmitQueue(const FString& Slug, const FString& Body, const FString& ApiKey, const FProviderCallbacks& Callbacks);
-    void HandleResultPayload(const FString& Body, const FProviderCallbacks& Callbacks);
-    void FetchImageUrls(const TArray<FString>& Urls, const FProviderCallbacks& Callbacks, const FString& RawResponse);
+    /** The two ways a job can be submitted; with hedging both may be running at once. */
+    enum class ELeg : uint8
+    {
+        None,
+        Sync,
+        Queue,
+    };
+
+    /** Body is shared, not copied: the sync attempt and the queue submission send the same buffer. */
+    void SubmitSync(const FString& Slug, const NanoBanana::FSharedBytes& Body, const FString& ApiKey, const FProviderCallbacksRef& Callbacks);
+    /** Arms the timer that also submits to the queue if the sync request is still running then. */
+    void ScheduleHedge(const FString& Slug, const NanoBanana::FSharedBytes& Body, const FString& ApiKey, const FProviderCallbacksRef& Callbacks);
+    /**
+     * Game thread. The first leg to reach a result claims the job and the other is canceled;
+     * later claims return false and their callbacks drop out.
+     */
+    bool ClaimResult(ELeg Leg);
+    /** Game thread. True if Leg's failure is the job's outcome, false while the other leg can still deliver. */
+    bool ShouldReportFailure(ELeg Leg);
+    bool IsAbandoned(ELeg Leg) const { return Winner != ELeg::None && Winner != Leg; }
+    void CancelQueueLeg();
+    /** Lets an in-flight queue submission finish, then cancel the job it queued. */
+    void AbandonQueueSubmit();
+    void ClearHedgeTimer();
+    void SubmitQueue(const FString& Slug, const NanoBanana::FSharedBytes& Body, const FString& ApiKey, const FProviderCallbacksRef& Callbacks);
+    /** One server-sent-events connection per job; falls back to PollQueueStatus if it ends early. */
+    void StreamQueueStatus(const FString& Slug, const FString& RequestId, const FString& ApiKey, const FProviderCallbacksRef& Callbacks);
+    void PollQueueStatus(const FString& Slug, const FString& RequestId, const FString& ApiKey, const FProviderCallbacksRef& Callbacks, float MaxSeconds);
+    void FetchQueueResult(const FString& ResultUrl, const FString& ApiKey, const FProviderCallbacksRef& Callbacks);
+    /** Game thread: hand a result response to a worker task for HandleResultPayload. */
+    void ParseResultOffGameThread(FHttpResponsePtr Resp, const FProviderCallbacksRef& Callbacks);
+    /** Worker thread: parse image URLs, then hop back to the game thread to download them. */
+    void HandleResultPayload(const NanoBanana::FSharedText& Body, const FProviderCallbacksRef& Callbacks);
+    void FetchImageUrls(const TArray<FString>& Urls, const FProviderCallbacksRef& Callbacks, const NanoBanana::FSharedText& RawResponse);
 
+    /** Queue leg's submission while FAL has not answered it. */
+    TSharedPtr<FFalQueueSubmitState> QueueSubmit;
+    /** Queue leg's result fetch. */
     TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> InFlight;
+    TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> SyncRequest;
+    /** Prepared once the queued job has an id; sent if the sync request wins the race. */
+    TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> QueueCancel;
+    TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> StatusStream;
     TSharedPtr<NanoBanana::Http::FPollLoop, ESPMode::ThreadSafe> Poll;
-    bool bCanceled = false;
+    /** FPollLatencyModel key for this request's (model, resolution). */
+    FString PollLatencyKey;
+    TSharedPtr<NanoBanana::Http::FResultDownloader, ESPMode::ThreadSafe> Download;
+    FTSTicker::FDelegateHandle HedgeTimer;
+
+    // Race state, game thread only.
+    double StartedAt = 0.0;
+    /** When the queue submission went out alongside the sync request; < 0 if it never did. */
+    double HedgedAt = -1.0;
+    float SyncTimeoutSeconds = 0.0f;
+    bool bHedging = false;
+    bool bSyncPending = false;
+    bool bQueueStarted = false;
+    bool bQueuePending = false;
+    ELeg Winner = ELeg::None;
+    /** Read by response-parsing worker tasks, hence atomic. */
+    std::atomic<bool> bCanceled { false };
 };
@@ -1,14 +1,31 @@
 #include "GoogleGeminiProvider.h"
 #include "../../Http/Base64Image.h"
+#include "../../Http/JsonBodyWriter.h"
+#include "../PayloadCapabilities.h"
 #include "../../Http/JsonResponseScanner.h"
+#include "../../Http/SseStream.h"
+#include "../../Http/SharedPayload.h"
 #include "NanoBananaSettings.h"
 #include "HttpModule.h"
 #include "Interfaces/IHttpResponse.h"
-#include "Dom/JsonObject.h"
-#include "Serialization/JsonSerializer.h"
-#include "Serialization/JsonWriter.h"
-#include "Misc/Base64.h"
 #include "GenericPlatform/GenericPlatformHttp.h"
+#include "Tasks/Task.h"
+
+namespace
+{
+    /** A UTF-8 body (or its first MaxBytes, for error messages) as text. */
+    static FString Utf8ToString(TConstArrayView<uint8> Utf8, int32 MaxBytes = MAX_int32)
+    {
+        const FUTF8ToTCHAR Text((const UTF8CHAR*)Utf8.GetData(), FMath::Min(Utf8.Num(), MaxBytes));
+        return FString(Text.Length(), Text.Get());
+    }
+
+    /** Images decoded so far by a streamed request; written on the HTTP thread, read at completion. */
+    struct FGeminiStreamState
+    {
+        TArray<TArray<uint8>> Images;
+    };
+}
 
 FString FGoogleGeminiProvider::ResolveModelId(ENanoBananaModel Model, const FString& CustomModelId)
 {
@@ -22,117 +39,124 @@ FString FGoogleGeminiProvider::ResolveModelId(ENanoBananaModel Model, const FStr
     }
 }
 
-FString FGoogleGeminiProvider::BuildEndpointUrl(const FString& BaseUrlOverride, const FString& ModelId, const FString& ApiKey)
+FString FGoogleGeminiProvider::BuildEndpointUrl(const FString& BaseUrlOverride, const FString& ModelId, const FString& ApiKey, bool bStream)
 {
     FString Base = BaseUrlOverride.IsEmpty()
         ? TEXT("https://generativelanguage.googleapis.com/v1beta")
         : BaseUrlOverride.TrimEnd();
     if (Base.EndsWith(TEXT("/"))) Base.LeftChopInline(1);
 
-    FString Url = FString::Printf(TEXT("%s/models/%s:generateContent"), *Base, *ModelId);
+    FString Url = bStream
+        ? FString::Printf(TEXT("%s/models/%s:streamGenerateContent?alt=sse"), *Base, *ModelId)
+        : FString::Printf(TEXT("%s/models/%s:generateContent"), *Base, *ModelId);
     if (!ApiKey.IsEmpty())
     {
-        Url += TEXT("?key=") + FGenericPlatformHttp::UrlEncode(ApiKey);
+        Url += (bStream ? TEXT("&key=") : TEXT("?key=")) + FGenericPlatformHttp::UrlEncode(ApiKey);
     }
     return Url;
 }
 
-FString FGoogleGeminiProvider::BuildRequestJson(const FNanoBananaRequest& Request, const TArray<TArray<uint8>>& EncodedReferences)
+TArray<uint8> FGoogleGeminiProvider::BuildRequestBody(const FNanoBananaRequest& Request, const TArray<NanoBanana::Image::FEncodedReferenceRef>& EncodedReferences)
 {
-    TSharedPtr<FJsonObject> Root = MakeShared<FJsonObject>();
+    // Always include prompt text — combine with negative if present.
+    FString FullPrompt = Request.Prompt;
+    if (!Request.NegativePrompt.IsEmpty())
+    {
+        FullPrompt += FString::Printf(TEXT("\n\nNegative: %s"), *Request.NegativePrompt);
+    }
+
+    const FPayloadCapabilities& Caps = FPayloadCapabilityTable::Find(ENanoBananaVendor::Google, ResolveModelId(Request.Model, Request.CustomModelId));
+
+    // Size the buffer up front so the base64 payloads are appended without reallocation.
+    int64 Estimate = 512 + (int64)FullPrompt.Len() * 3;
+    for (const NanoBanana::Image::FEncodedReferenceRef& Img : EncodedReferences)
+    {
+        Estimate += (int64)Img->GetBase64().Len() + Img->MimeType.Len() + 64;
+    }
+
+    NanoBanana::Json::FJsonBodyWriter W(Estimate);
+    W.BeginObject();
 
     // contents: [ { role: "user", parts: [ {text}, {inlineData}*N ] } ]
-    TArray<TSharedPtr<FJsonValue>> Parts;
+    W.BeginArray("contents");
+    W.BeginObject();
+    W.WriteAsciiString("role", "user");
+    W.BeginArray("parts");
     {
-        TSharedPtr<FJsonObject> TextPart = MakeShared<FJsonObject>();
-        // Always include prompt text — combine with negative if present.
-        FString FullPrompt = Request.Prompt;
-        if (!Request.NegativePrompt.IsEmpty())
-        {
-            FullPrompt += FString::Printf(TEXT("\n\nNegative: %s"), *Request.NegativePrompt);
-        }
-        TextPart->SetStringField(TEXT("text"), FullPrompt);
-        Parts.Add(MakeShared<FJsonValueObject>(TextPart));
+        W.BeginObject();
+        W.WriteString("text", FullPrompt);
+        W.EndObject();
     }
-    for (const TArray<uint8>& Img : EncodedReferences)
+    for (const NanoBanana::Image::FEncodedReferenceRef& Img : EncodedReferences)
     {
-        if (Img.Num() == 0) continue;
-        const FString Mime = NanoBanana::Image::SniffImageMimeType(Img);
-        TSharedPtr<FJsonObject> Inline = MakeShared<FJsonObject>();
-        Inline->SetStringField(TEXT("mimeType"), Mime);
-        Inline->SetStringField(TEXT("mime_type"), Mime); // tolerate both casings server-side
-        Inline->SetStringField(TEXT("data"), FBase64::Encode(Img));
-        TSharedPtr<FJsonObject> Part = MakeShared<FJsonObject>();
-        Part->SetObjectField(TEXT("inlineData"), Inline);
-        Part->SetObjectField(TEXT("inline_data"), Inline);
-        Parts.Add(MakeShared<FJsonValueObject>(Part));
+        if (Img->Bytes.Num() == 0) continue;
+        const FAnsiStringView B64 = Img->GetBase64(); // pre-encoded by FReferencePreparer
+        W.BeginObject();
+        W.BeginObject(Caps.InlineDataKey);
+        W.WriteString(Caps.MimeTypeKey, Img->MimeType);
+        W.WriteAsciiString("data", B64);
+        W.EndObject();
+        W.EndObject();
     }
-
-    TSharedPtr<FJsonObject> UserContent = MakeShared<FJsonObject>();
-    UserContent->SetStringField(TEXT("role"), TEXT("user"));
-    UserContent->SetArrayField(TEXT("parts"), Parts);
-    TArray<TSharedPtr<FJsonValue>> Contents;
-    Contents.Add(MakeShared<FJsonValueObject>(UserContent));
-    Root->SetArrayField(TEXT("contents"), Contents);
+    W.EndArray(); // parts
+    W.EndObject();
+    W.EndArray(); // contents
 
     // generationConfig
+    W.BeginObject("generationConfig");
+    W.BeginArray("responseModalities");
+    W.WriteString(TEXT("IMAGE"));
+    W.WriteString(TEXT("TEXT"));
+    W.EndArray();
+    W.WriteInt("candidateCount", FMath::Max(1, Request.NumImages));
+    if (Request.Seed != 0)
     {
-        TSharedPtr<FJsonObject> Gen = MakeShared<FJsonObject>();
-        TArray<TSharedPtr<FJsonValue>> Modalities;
-        Modalities.Add(MakeShared<FJsonValueString>(TEXT("IMAGE")));
-        Modalities.Add(MakeShared<FJsonValueString>(TEXT("TEXT")));
-        Gen->SetArrayField(TEXT("responseModalities"), Modalities);
-        Gen->SetNumberField(TEXT("candidateCount"), FMath::Max(1, Request.NumImages));
-        if (Request.Seed != 0)
-        {
-            Gen->SetNumberField(TEXT("seed"), Request.Seed);
-        }
-        Root->SetObjectField(TEXT("generationConfig"), Gen);
+        W.WriteInt("seed", Request.Seed);
     }
+    W.EndObject();
 
     // imageConfig (Gemini 3+)
+    if (Request.Aspect != ENanoBananaAspect::Auto || Request.Resolution != ENanoBananaResolution::Auto)
     {
-        TSharedPtr<FJsonObject> ImgCfg = MakeShared<FJsonObject>();
+        W.BeginObject("imageConfig");
         if (Request.Aspect != ENanoBananaAspect::Auto)
         {
-            ImgCfg->SetStringField(TEXT("aspectRatio"), FNanoBananaTypeUtils::AspectToString(Request.Aspect));
+            W.WriteString("aspectRatio", FNanoBananaTypeUtils::AspectToString(Request.Aspect));
         }
         if (Request.Resolution != ENanoBananaResolution::Auto)
         {
-            ImgCfg->SetStringField(TEXT("imageSize"), FNanoBananaTypeUtils::ResolutionToString(Request.Resolution));
-        }
-        if (ImgCfg->Values.Num() > 0)
-        {
-            Root->SetObjectField(TEXT("imageConfig"), ImgCfg);
+            W.WriteString("imageSize", FNanoBananaTypeUtils::ResolutionToString(Request.Resolution));
         }
+        W.EndObject();
     }
 
-    FString Out;
-    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Out);
-    FJsonSerializer::Serialize(Root.ToSharedRef(), Writer);
-    return Out;
+    W.EndObject();
+    return W.Finish();
+}
+
+FString FGoogleGeminiProvider::BuildRequestJson(const FNanoBananaRequest& Request, const TArray<NanoBanana::Image::FEncodedReferenceRef>& EncodedReferences)
+{
+    return NanoBanana::Json::FJsonBodyWriter::ToString(BuildRequestBody(Request, EncodedReferences));
 }
 
-void FGoogleGeminiProvider::Submit(const FNanoBananaRequest& Request, const FProviderCallbacks& Callbacks)
+void FGoogleGeminiProvider::Submit(const FNanoBananaRequest& Request, const TArray<NanoBanana::Image::FEncodedReferenceRef>& References, const FProviderCallbacks& InCallbacks)
 {
+    const FProviderCallbacksRef Callbacks = MakeShared<FProviderCallbacks, ESPMode::ThreadSafe>(InCallbacks);
     const UNanoBananaSettings& S = UNanoBananaSettings::Get();
     const FString ApiKey = S.GetEffectiveApiKey(ENanoBananaVendor::Google);
     if (ApiKey.IsEmpty())
     {
-        if (Callbacks.OnFailure) Callbacks.OnFailure(TEXT("Google: missing API key (set in Project Settings or GEMINI_API_KEY env var)."));
+        if (Callbacks->OnFailure) Callbacks->OnFailure(TEXT("Google: missing API key (set in Project Settings or GEMINI_API_KEY env var)."));
         return;
     }
 
-    // Resolve all references to image bytes (texture / RT / file).
-    TArray<TArray<uint8>> Refs;
-    NanoBanana::Image::ResolveAllReferences(Request, Refs);
-
     const FString ModelId = ResolveModelId(Request.Model, Request.CustomModelId);
-    const FString Url = BuildEndpointUrl(S.Google.BaseUrlOverride, ModelId, ApiKey);
-    const FString Body = BuildRequestJson(Request, Refs);
+    const bool bStream = S.Google.bStreamResponses;
+    const FString Url = BuildEndpointUrl(S.Google.BaseUrlOverride, ModelId, ApiKey, bStream);
+    const NanoBanana::FSharedBytes Body = NanoBanana::MakeSharedBytes(BuildRequestBody(Request, References));
 
-    if (Callbacks.OnRequestBuilt) Callbacks.OnRequestBuilt(Body);
-    if (Callbacks.OnProgress) Callbacks.OnProgress(0.2f, FString::Printf(TEXT("Calling Gemini %s"), *ModelId));
+    if (Callbacks->OnRequestBuilt) Callbacks->OnRequestBuilt(Body);
+    if (Callbacks->OnProgress) Callbacks->OnProgress(0.2f, FString::Printf(TEXT("Calling Gemini %s"), *ModelId));
 
     TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Req = FHttpModule::Get().CreateRequest();
     InFlight = Req;
@@ -140,11 +164,25 @@ void FGoogleGeminiProvider::Submit(const FNanoBananaRequest& Request, const FPro
     Req->SetVerb(TEXT("POST"));
     Req->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
     Req->SetTimeout((float)FMath::Max(5, S.RequestTimeoutSeconds));
-    Req->SetContentAsString(Body);
+    NanoBanana::Http::SetSharedContent(*Req, Body);
+
+    if (bStream)
+    {
+        Req->SetHeader(TEXT("Accept"), TEXT("text/event-stream"));
+        BindStreamedResponse(*Req, Callbacks, S.bSaveDebugRequestResponse, FMath::Max(1, Request.NumImages));
+    }
+    else
+    {
+        BindBufferedResponse(*Req, Callbacks, S.bSaveDebugRequestResponse);
+    }
+    Req->ProcessRequest();
+}
 
+void FGoogleGeminiProvider::BindBufferedResponse(IHttpRequest& Req, const FProviderCallbacksRef& Callbacks, bool bKeepRawResponse)
+{
     TWeakPtr<FGoogleGeminiProvider, ESPMode::ThreadSafe> WeakThis = StaticCastSharedRef<FGoogleGeminiProvider>(AsShared());
-    Req->OnProcessRequestComplete().BindLambda(
-        [WeakThis, Callbacks](FHttpRequestPtr, FHttpResponsePtr Resp, bool bSucceeded)
+    Req.OnProcessRequestComplete().BindLambda(
+        [WeakThis, Callbacks, bKeepRawResponse](FHttpRequestPtr, FHttpResponsePtr Resp, bool bSucceeded)
         {
             TSharedPtr<FGoogleGeminiProvider, ESPMode::ThreadSafe> Pinned = WeakThis.Pin();
             if (!Pinned.IsValid() || Pinned->bCanceled) return;
@@ -152,29 +190,110 @@ void FGoogleGeminiProvider::Submit(const FNanoBananaRequest& Request, const FPro
 
             if (!bSucceeded || !Resp.IsValid())
             {
-                if (Callbacks.OnFailure) Callbacks.OnFailure(TEXT("Gemini request failed (network)."));
+                if (Callbacks->OnFailure) Callbacks->OnFailure(TEXT("Gemini request failed (network)."));
                 return;
             }
             const int32 Code = Resp->GetResponseCode();
-            const FString RespStr = Resp->GetContentAsString();
             if (Code < 200 || Code >= 300)
             {
-                if (Callbacks.OnFailure) Callbacks.OnFailure(FString::Printf(TEXT("Gemini HTTP %d: %s"), Code, *RespStr.Left(512)));
+                ReportIfRateLimited(ENanoBananaVendor::Google, *Resp, *Callbacks);
+                if (Callbacks->OnFailure) Callbacks->OnFailure(FString::Printf(TEXT("Gemini HTTP %d: %s"), Code, *Utf8ToString(Resp->GetContent(), 512)));
                 return;
             }
 
-            if (Callbacks.OnProgress) Callbacks.OnProgress(0.85f, TEXT("Decoding Gemini response"));
+            if (Callbacks->OnProgress) Callbacks->OnProgress(0.85f, TEXT("Decoding Gemini response"));
 
-            TArray<TArray<uint8>> Images;
-            NanoBanana::Json::CollectInlineImagesFromResponseBody(RespStr, Images);
-            if (Images.Num() == 0)
+            // A multi-image 2K/4K response is tens of MB of base64; parse and decode it on a
+            // worker so the game thread never sees it. Callbacks marshal back on their own.
+            UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, Callbacks, Resp, bKeepRawResponse]()
             {
-                if (Callbacks.OnFailure) Callbacks.OnFailure(FString::Printf(TEXT("Gemini returned no images. Body: %s"), *RespStr.Left(512)));
+                TSharedPtr<FGoogleGeminiProvider, ESPMode::ThreadSafe> P = WeakThis.Pin();
+                if (!P.IsValid() || P->bCanceled) return;
+
+                // Scan the UTF-8 bytes in place; the UTF-16 copy is only worth making for a debug dump.
+                const TArray<uint8>& Content = Resp->GetContent();
+                TArray<TArray<uint8>> Images;
+                if (!NanoBanana::Json::CollectInlineImagesFromUtf8(Content, Images) || Images.Num() == 0)
+                {
+                    if (Callbacks->OnFailure) Callbacks->OnFailure(FString::Printf(TEXT("Gemini returned no images. Body: %s"), *Utf8ToString(Content, 512)));
+                    return;
+                }
+                if (Callbacks->OnSuccess)
+                {
+                    Callbacks->OnSuccess(MoveTemp(Images), {}, bKeepRawResponse ? NanoBanana::MakeSharedText(Resp->GetContentAsString()) : NanoBanana::EmptySharedText());
+                }
+            });
+        });
+}
+
+void FGoogleGeminiProvider::BindStreamedResponse(IHttpRequest& Req, const FProviderCallbacksRef& Callbacks, bool bKeepRawResponse, int32 ExpectedImages)
+{
+    TWeakPtr<FGoogleGeminiProvider, ESPMode::ThreadSafe> WeakThis = StaticCastSharedRef<FGoogleGeminiProvider>(AsShared());
+    TSharedRef<FGeminiStreamState, ESPMode::ThreadSafe> State = MakeShared<FGeminiStreamState, ESPMode::ThreadSafe>();
+
+    // Each SSE event is a complete GenerateContentResponse chunk, and Gemini never splits an
+    // inlineData part across chunks, so every image found in a chunk is already final. This
+    // runs on the HTTP thread as bytes arrive; the per-chunk base64 decode is cheap next to
+    // the network time it overlaps with.
+    auto OnEvent = [WeakThis, Callbacks, State, ExpectedImages](FAnsiStringView, TConstArrayView<uint8> Data)
+    {
+        TSharedPtr<FGoogleGeminiProvider, ESPMode::ThreadSafe> P = WeakThis.Pin();
+        if (!P.IsValid() || P->bCanceled) return;
+
+        const int32 First = State->Images.Num();
+        if (!NanoBanana::Json::CollectInlineImagesFromUtf8(Data, State->Images)) return;
+        for (int32 i = First; i < State->Images.Num(); ++i)
+        {
+            if (Callbacks->OnImageReady) Callbacks->OnImageReady(i, State->Images[i]);
+        }
+        if (State->Images.Num() > First && Callbacks->OnProgress)
+        {
+            const float Received = (float)FMath::Min(State->Images.Num(), ExpectedImages) / ExpectedImages;
+            Callbacks->OnProgress(0.3f + 0.55f * Received, FString::Printf(TEXT("Received %d of %d images"), State->Images.Num(), ExpectedImages));
+        }
+    };
+    TSharedRef<NanoBanana::Http::FSseReceiveStream> Stream = MakeShared<NanoBanana::Http::FSseReceiveStream>(MoveTemp(OnEvent), bKeepRawResponse);
+    Req.SetResponseBodyReceiveStream(Stream);
+
+    Req.OnProcessRequestComplete().BindLambda(
+        [WeakThis, Callbacks, State, Stream](FHttpRequestPtr, FHttpResponsePtr Resp, bool bSucceeded)
+        {
+            TSharedPtr<FGoogleGeminiProvider, ESPMode::ThreadSafe> Pinned = WeakThis.Pin();
+            if (!Pinned.IsValid() || Pinned->bCanceled) return;
+            Pinned->InFlight.Reset();
+
+            if (!bSucceeded || !Resp.IsValid())
+            {
+                if (Callbacks->OnFailure) Callbacks->OnFailure(TEXT("Gemini request failed (network)."));
                 return;
             }
-            if (Callbacks.OnSuccess) Callbacks.OnSuccess(MoveTemp(Images), RespStr);
+            const int32 Code = Resp->GetResponseCode();
+            if (Code < 200 || Code >= 300)
+            {
+                ReportIfRateLimited(ENanoBananaVendor::Google, *Resp, *Callbacks);
+                if (Callbacks->OnFailure) Callbacks->OnFailure(FString::Printf(TEXT("Gemini HTTP %d: %s"), Code, *Utf8ToString(Stream->GetHead(), 512)));
+                return;
+            }
+
+            // The last event may still be unterminated; flush it off the game thread.
+            UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, Callbacks, State, Stream]()
+            {
+                TSharedPtr<FGoogleGeminiProvider, ESPMode::ThreadSafe> P = WeakThis.Pin();
+                if (!P.IsValid() || P->bCanceled) return;
+
+                Stream->Finish();
+                if (State->Images.Num() == 0)
+                {
+                    if (Callbacks->OnFailure) Callbacks->OnFailure(FString::Printf(TEXT("Gemini returned no images. Body: %s"), *Utf8ToString(Stream->GetHead(), 512)));
+                    return;
+                }
+                if (Callbacks->OnSuccess)
+                {
+                    Callbacks->OnSuccess(MoveTemp(State->Images), {},
+                        Stream->GetBody().Num() > 0 ? NanoBanana::MakeSharedText(Utf8ToString(Stream->GetBody())) : NanoBanana::EmptySharedText());
+                }
+            });
         });
-    Req->ProcessRequest();
 }
 
 void FGoogleGeminiProvider::Cancel()
@@ -1,5 +1,6 @@
 // Provider: Google Generative Language API (generativelanguage.googleapis.com)
 // Endpoint: POST {base}/models/{modelId}:generateContent?key=...
+//       or POST {base}/models/{modelId}:streamGenerateContent?alt=sse&key=... (bStreamResponses)
 // All image inputs/outputs are base64 inline_data inside JSON.
 #pragma once
 
@@ -7,10 +8,12 @@
 #include "../IImageGenProvider.h"
 #include "Interfaces/IHttpRequest.h"
 
+#include <atomic>
+
 class FGoogleGeminiProvider : public IImageGenProvider
 {
 public:
-    virtual void Submit(const FNanoBananaRequest& Request, const FProviderCallbacks& Callbacks) override;
+    virtual void Submit(const FNanoBananaRequest& Request, const TArray<NanoBanana::Image::FEncodedReferenceRef>& References, const FProviderCallbacks& Callbacks) override;
     virtual void Cancel() override;
 
     // ---- Static helpers (testable without HTTP) ----
@@ -18,13 +21,23 @@ public:
     /** Map model enum to canonical Google model id. Honors Custom + CustomModelId. */
     static FString ResolveModelId(ENanoBananaModel Model, const FString& CustomModelId);
 
-    /** Build the full URL including ?key=... query param. */
-    static FString BuildEndpointUrl(const FString& BaseUrlOverride, const FString& ModelId, const FString& ApiKey);
+    /** Build the full URL including the key query param. bStream selects the SSE endpoint. */
+    static FString BuildEndpointUrl(const FString& BaseUrlOverride, const FString& ModelId, const FString& ApiKey, bool bStream = false);
+
+    /** Build the UTF-8 JSON request body. EncodedReferences carry image bytes (PNG/JPEG/WebP) + MIME type. */
+    static TArray<uint8> BuildRequestBody(const FNanoBananaRequest& Request, const TArray<NanoBanana::Image::FEncodedReferenceRef>& EncodedReferences);
 
-    /** Build the JSON request body. EncodedReferences are raw image bytes (PNG/JPEG/WebP). */
-    static FString BuildRequestJson(const FNanoBananaRequest& Request, const TArray<TArray<uint8>>& EncodedReferences);
+    /** BuildRequestBody decoded to text (tests/diagnostics). */
+    static FString BuildRequestJson(const FNanoBananaRequest& Request, const TArray<NanoBanana::Image::FEncodedReferenceRef>& EncodedReferences);
 
 private:
+    /** Bind completion for :generateContent: the whole body is scanned once it has arrived. */
+    void BindBufferedResponse(IHttpRequest& Req, const FProviderCallbacksRef& Callbacks, bool bKeepRawResponse);
+
+    /** Bind a receive stream for :streamGenerateContent: images are decoded per SSE chunk. */
+    void BindStreamedResponse(IHttpRequest& Req, const FProviderCallbacksRef& Callbacks, bool bKeepRawResponse, int32 ExpectedImages);
+
     TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> InFlight;
-    bool bCanceled = false;
+    /** Read by response-parsing worker tasks, hence atomic. */
+    std::atomic<bool> bCanceled { false };
 };
@@ -6,23 +6,63 @@
 #include "Templates/SharedPointer.h"
 #include "Templates/Function.h"
 #include "NanoBananaTypes.h"
+#include "../Http/Base64Image.h"
+#include "../Http/SharedPayload.h"
+#include "../Http/RetryAfter.h"
 
-/** Callbacks fired by a provider over the lifetime of a single Submit() call. */
+/**
+ * Callbacks fired by a provider over the lifetime of a single Submit() call. Providers parse
+ * and decode responses on worker tasks, so any callback may run off the game thread.
+ */
 struct FProviderCallbacks
 {
     /** Percent in [0, 1], plus a human-readable stage label. */
     TFunction<void(float /*Percent*/, const FString& /*Stage*/)> OnProgress;
 
     /** One or more decoded image byte buffers (already in their native format — usually PNG).
-     *  RawResponse is the full response body as text (or summary) for debug capture. */
-    TFunction<void(TArray<TArray<uint8>> /*Images*/, const FString& /*RawResponse*/)> OnSuccess;
+     *  Images have a single owner and are moved, never copied, through to the result struct.
+     *  SavedPaths is parallel to Images: non-empty where the provider already wrote that image
+     *  (see ResolveDownloadPath). RawResponse is the full response body as text (or summary)
+     *  for debug capture, shared rather than copied; empty unless debug dumps are on or the
+     *  provider already had it as text. */
+    TFunction<void(TArray<TArray<uint8>> /*Images*/, TArray<FString> /*SavedPaths*/, const NanoBanana::FSharedText& /*RawResponse*/)> OnSuccess;
 
     TFunction<void(const FString& /*Error*/)> OnFailure;
 
-    /** Optional: invoked once with the serialized request body, before HTTP send (for debug dump). */
-    TFunction<void(const FString& /*RequestJson*/)> OnRequestBuilt;
+    /** Optional: streaming providers fire this once per image, in order, as soon as its bytes
+     *  are complete. OnSuccess still follows with every image. */
+    TFunction<void(int32 /*Index*/, const TArray<uint8>& /*Image*/)> OnImageReady;
+
+    /** Optional: destination for downloaded result Index of Count. Providers that fetch result
+     *  URLs stream each body straight into this file while downloading. */
+    TFunction<FString(int32 /*Index*/, int32 /*Count*/)> ResolveDownloadPath;
+
+    /** Optional: invoked once with the exact UTF-8 request body, before HTTP send (for debug dump).
+     *  The buffer is the one being sent; keep the reference rather than copying it. */
+    TFunction<void(const NanoBanana::FSharedBytes& /*RequestBody*/)> OnRequestBuilt;
+
+    /** Optional: Vendor answered HTTP 429. Fired before the failure (or fallback) that follows,
+     *  with the Retry-After delay, so the scheduler can hold further requests to that vendor. */
+    TFunction<void(ENanoBananaVendor /*Vendor*/, float /*RetryAfterSeconds*/)> OnRateLimited;
 };
 
+/** Fires Callbacks.OnRateLimited when Resp is an HTTP 429. */
+inline void ReportIfRateLimited(ENanoBananaVendor Vendor, const IHttpResponse& Resp, const FProviderCallbacks& Callbacks)
+{
+    float RetryAfterSeconds = 0.0f;
+    if (Callbacks.OnRateLimited && NanoBanana::Http::IsRateLimited(Resp, RetryAfterSeconds))
+    {
+        Callbacks.OnRateLimited(Vendor, RetryAfterSeconds);
+    }
+}
+
+/**
+ * Providers copy the caller's callbacks once per Submit() into this shared, immutable form;
+ * every nested HTTP / task lambda then captures the reference instead of another copy of
+ * each TFunction.
+ */
+using FProviderCallbacksRef = TSharedRef<const FProviderCallbacks, ESPMode::ThreadSafe>;
+
 /**
  * Vendor-agnostic image generation provider.
  * Lifetime is managed via TSharedPtr held by the async action. Each instance handles
@@ -33,8 +73,12 @@ class IImageGenProvider : public TSharedFromThis<IImageGenProvider, ESPMode::Thr
 public:
     virtual ~IImageGenProvider() = default;
 
-    /** Begin processing the request. Must invoke exactly one of OnSuccess/OnFailure. */
-    virtual void Submit(const FNanoBananaRequest& Request, const FProviderCallbacks& Callbacks) = 0;
+    /**
+     * Begin processing the request. Must invoke exactly one of OnSuccess/OnFailure.
+     * References are the request's reference images, already encoded off the game thread
+     * (see NanoBanana::Image::FReferencePreparer); providers never resolve them themselves.
+     */
+    virtual void Submit(const FNanoBananaRequest& Request, const TArray<NanoBanana::Image::FEncodedReferenceRef>& References, const FProviderCallbacks& Callbacks) = 0;
 
     /** Best-effort cancel of any in-flight HTTP request or poll loop. */
     virtual void Cancel() = 0;
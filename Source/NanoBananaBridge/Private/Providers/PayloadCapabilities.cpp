@@ -0,0 +1,129 @@
+#include "PayloadCapabilities.h"
+#include "../Http/JsonBodyWriter.h"
+
+namespace
+{
+    struct FCapabilityRow
+    {
+        ENanoBananaVendor Vendor;
+        /** Matched against the start of the model id; empty = vendor default (must be last per vendor). */
+        const TCHAR* ModelPrefix;
+        FPayloadCapabilities Caps;
+    };
+
+    FPayloadCapabilities MakeCaps(const ANSICHAR* ImageField, bool bList, int32 MaxImages = 0)
+    {
+        FPayloadCapabilities Caps;
+        Caps.ImageField = ImageField;
+        Caps.bImageFieldIsList = bList;
+        Caps.MaxReferenceImages = MaxImages;
+        return Caps;
+    }
+
+    const FCapabilityRow* GetRows(int32& OutNum)
+    {
+        // First match wins, so more specific prefixes go first.
+        static const FCapabilityRow Rows[] =
+        {
+            // Gemini accepts one casing per field; only the parts keys matter here.
+            { ENanoBananaVendor::Google,    TEXT(""),                               FPayloadCapabilities() },
+
+            // FAL nano-banana tiers take a list of image URLs (data URIs accepted).
+            { ENanoBananaVendor::Fal,       TEXT("fal-ai/nano-banana"),             MakeCaps("image_urls", true) },
+            // FLUX Kontext image editing takes a single image_url.
+            { ENanoBananaVendor::Fal,       TEXT("fal-ai/flux-pro/kontext"),        MakeCaps("image_url", false) },
+            { ENanoBananaVendor::Fal,       TEXT(""),                               MakeCaps("image_urls", true) },
+
+            // Replicate google/nano-banana* take image_input: [uri, ...].
+            { ENanoBananaVendor::Replicate, TEXT("google/nano-banana"),             MakeCaps("image_input", true) },
+            // FLUX Kontext on Replicate takes a single input_image.
+            { ENanoBananaVendor::Replicate, TEXT("black-forest-labs/flux-kontext"), MakeCaps("input_image", false) },
+            { ENanoBananaVendor::Replicate, TEXT(""),                               MakeCaps("image_input", true) },
+        };
+        OutNum = UE_ARRAY_COUNT(Rows);
+        return Rows;
+    }
+}
+
+const FPayloadCapabilities& FPayloadCapabilityTable::Find(ENanoBananaVendor Vendor, const FString& ModelId)
+{
+    int32 Num = 0;
+    const FCapabilityRow* Rows = GetRows(Num);
+    const FCapabilityRow* VendorDefault = nullptr;
+    for (int32 i = 0; i < Num; ++i)
+    {
+        const FCapabilityRow& Row = Rows[i];
+        if (Row.Vendor != Vendor)
+        {
+            continue;
+        }
+        if (*Row.ModelPrefix == 0)
+        {
+            VendorDefault = &Row;
+            break;
+        }
+        if (ModelId.StartsWith(Row.ModelPrefix, ESearchCase::IgnoreCase))
+        {
+            return Row.Caps;
+        }
+    }
+
+    static const FPayloadCapabilities Fallback;
+    return VendorDefault ? VendorDefault->Caps : Fallback;
+}
+
+namespace
+{
+    template <typename FunctorType>
+    void ForEachSentReference(const FPayloadCapabilities& Caps, const TArray<NanoBanana::Image::FEncodedReferenceRef>& References, FunctorType&& Fn)
+    {
+        int32 Usable = 0;
+        for (const NanoBanana::Image::FEncodedReferenceRef& Img : References)
+        {
+            Usable += Img->Bytes.Num() > 0 ? 1 : 0;
+        }
+        int32 Remaining = Caps.ClampReferenceCount(Usable);
+        for (const NanoBanana::Image::FEncodedReferenceRef& Img : References)
+        {
+            if (Remaining <= 0) break;
+            if (Img->Bytes.Num() == 0) continue;
+            Fn(*Img);
+            --Remaining;
+        }
+    }
+}
+
+void FPayloadCapabilityTable::WriteDataUriField(NanoBanana::Json::FJsonBodyWriter& Writer, const FPayloadCapabilities& Caps,
+    const TArray<NanoBanana::Image::FEncodedReferenceRef>& References)
+{
+    // Data URIs are pre-built (and cached) by FReferencePreparer; no base64 work here.
+    bool bOpened = false;
+    ForEachSentReference(Caps, References, [&](const NanoBanana::Image::FEncodedReference& Img)
+    {
+        if (!Caps.bImageFieldIsList)
+        {
+            Writer.WriteAsciiString(Caps.ImageField, Img.GetDataUri());
+            return;
+        }
+        if (!bOpened)
+        {
+            Writer.BeginArray(Caps.ImageField);
+            bOpened = true;
+        }
+        Writer.WriteAsciiString(Img.GetDataUri());
+    });
+    if (bOpened)
+    {
+        Writer.EndArray();
+    }
+}
+
+int64 FPayloadCapabilityTable::EstimateDataUriFieldSize(const FPayloadCapabilities& Caps, const TArray<NanoBanana::Image::FEncodedReferenceRef>& References)
+{
+    int64 Bytes = 16 + FCStringAnsi::Strlen(Caps.ImageField);
+    ForEachSentReference(Caps, References, [&Bytes](const NanoBanana::Image::FEncodedReference& Img)
+    {
+        Bytes += Img.GetDataUri().Len() + 3;
+    });
+    return Bytes;
+}
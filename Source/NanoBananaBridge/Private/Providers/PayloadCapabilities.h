@@ -0,0 +1,54 @@
+// Per-vendor / per-model description of how reference images go into a request body:
+// which field and casing the endpoint actually reads, and whether it takes a list or a
+// single image. Builders consult this so every reference is emitted exactly once.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NanoBananaTypes.h"
+#include "../Http/Base64Image.h"
+
+namespace NanoBanana::Json { class FJsonBodyWriter; }
+
+struct FPayloadCapabilities
+{
+    /** Gemini inline part keys (the REST API's canonical lowerCamelCase JSON names). */
+    const ANSICHAR* InlineDataKey = "inlineData";
+    const ANSICHAR* MimeTypeKey = "mimeType";
+
+    /** FAL / Replicate: input field that carries reference images (data URIs). */
+    const ANSICHAR* ImageField = "image_urls";
+
+    /** True if ImageField is an array; false if the model accepts a single image string. */
+    bool bImageFieldIsList = true;
+
+    /** Upper bound on references the model accepts (0 = no known limit). Extras are dropped. */
+    int32 MaxReferenceImages = 0;
+
+    /** Number of references from Available that will actually be sent. */
+    int32 ClampReferenceCount(int32 Available) const
+    {
+        const int32 Cap = bImageFieldIsList ? MaxReferenceImages : 1;
+        return Cap > 0 ? FMath::Min(Available, Cap) : Available;
+    }
+};
+
+class FPayloadCapabilityTable
+{
+public:
+    /**
+     * Capabilities for a resolved model id / slug (see each provider's ResolveModelId /
+     * ResolveModelSlug). Known models match by slug prefix; anything else gets the
+     * vendor default.
+     */
+    static const FPayloadCapabilities& Find(ENanoBananaVendor Vendor, const FString& ModelId);
+
+    /**
+     * FAL / Replicate: write References as data URIs under Caps.ImageField, as a list or a
+     * single string, each image exactly once. Writes nothing when there are no usable images.
+     */
+    static void WriteDataUriField(NanoBanana::Json::FJsonBodyWriter& Writer, const FPayloadCapabilities& Caps,
+        const TArray<NanoBanana::Image::FEncodedReferenceRef>& References);
+
+    /** Byte count WriteDataUriField will add for these references (for buffer pre-sizing). */
+    static int64 EstimateDataUriFieldSize(const FPayloadCapabilities& Caps, const TArray<NanoBanana::Image::FEncodedReferenceRef>& References);
+};
@@ -3,6 +3,8 @@
 #include "Google/GoogleGeminiProvider.h"
 #include "Fal/FalAiProvider.h"
 #include "Replicate/ReplicateProvider.h"
+#include "FailoverProvider.h"
+#include "NanoBananaSettings.h"
 
 TSharedPtr<IImageGenProvider, ESPMode::ThreadSafe> FProviderFactory::Make(ENanoBananaVendor Vendor)
 {
@@ -18,3 +20,13 @@ TSharedPtr<IImageGenProvider, ESPMode::ThreadSafe> FProviderFactory::Make(ENanoB
         return nullptr;
     }
 }
+
+TSharedPtr<IImageGenProvider, ESPMode::ThreadSafe> FProviderFactory::MakeForRequest(const FNanoBananaRequest& Request)
+{
+    const TArray<FNanoBananaFailoverTarget>& Chain = UNanoBananaSettings::Get().FailoverChain;
+    if (Chain.Num() == 0)
+    {
+        return Make(Request.Vendor);
+    }
+    return MakeShared<FFailoverProvider, ESPMode::ThreadSafe>(Chain);
+}
@@ -11,4 +11,10 @@ class FProviderFactory
 {
 public:
     static TSharedPtr<IImageGenProvider, ESPMode::ThreadSafe> Make(ENanoBananaVendor Vendor);
+
+    /**
+     * Provider for a whole request: the request's own vendor, wrapped in an FFailoverProvider
+     * when the project has a failover chain configured.
+     */
+    static TSharedPtr<IImageGenProvider, ESPMode::ThreadSafe> MakeForRequest(const FNanoBananaRequest& Request);
 };
@@ -1,13 +1,21 @@
 #include "ReplicateProvider.h"
 #include "../../Http/Base64Image.h"
+#include "../../Http/JsonBodyWriter.h"
+#include "../PayloadCapabilities.h"
 #include "../../Http/PollLoop.h"
+#include "../../Http/PollLatencyModel.h"
+#include "../../Http/ResultDownloader.h"
+#include "../../Http/SharedPayload.h"
+#include "../../Http/WebhookReceiver.h"
 #include "NanoBananaSettings.h"
+#include "NanoBananaLog.h"
 #include "HttpModule.h"
 #include "Interfaces/IHttpResponse.h"
 #include "Dom/JsonObject.h"
 #include "Serialization/JsonReader.h"
 #include "Serialization/JsonSerializer.h"
-#include "Serialization/JsonWriter.h"
+#include "Async/Async.h"
+#include "Tasks/Task.h"
 
 FString FReplicateProvider::ResolveModelSlug(ENanoBananaModel Model, const FString& CustomModelId)
 {
@@ -43,94 +51,98 @@ FString FReplicateProvider::BuildPredictionsUrl(const FString& Override)
     return Base + TEXT("/predictions");
 }
 
-FString FReplicateProvider::BuildRequestJson(const FNanoBananaRequest& Request, const TArray<TArray<uint8>>& EncodedReferences)
+TArray<uint8> FReplicateProvider::BuildRequestBody(const FNanoBananaRequest& Request, const TArray<NanoBanana::Image::FEncodedReferenceRef>& EncodedReferences, const FString& WebhookUrl)
 {
-    TSharedPtr<FJsonObject> Root = MakeShared<FJsonObject>();
-
     const FString Slug = ResolveModelSlug(Request.Model, Request.CustomModelId);
+    const FPayloadCapabilities& Caps = FPayloadCapabilityTable::Find(ENanoBananaVendor::Replicate, Slug);
+
+    // Size the buffer up front so the data URIs are appended without reallocation.
+    const int64 Estimate = 512 + ((int64)Request.Prompt.Len() + Request.NegativePrompt.Len() + WebhookUrl.Len()) * 3
+        + FPayloadCapabilityTable::EstimateDataUriFieldSize(Caps, EncodedReferences);
+
+    NanoBanana::Json::FJsonBodyWriter W(Estimate);
+    W.BeginObject();
+
     const FString VersionHash = ResolveVersionOverride(Request.Model);
     if (!VersionHash.IsEmpty())
     {
-        Root->SetStringField(TEXT("version"), VersionHash);
+        W.WriteString("version", VersionHash);
     }
     else
     {
-        Root->SetStringField(TEXT("model"), Slug);
+        W.WriteString("model", Slug);
     }
 
-    TSharedPtr<FJsonObject> Input = MakeShared<FJsonObject>();
-    Input->SetStringField(TEXT("prompt"), Request.Prompt);
+    W.BeginObject("input");
+    W.WriteString("prompt", Request.Prompt);
     if (Request.NumImages > 1)
     {
-        Input->SetNumberField(TEXT("num_outputs"), Request.NumImages);
+        W.WriteInt("num_outputs", Request.NumImages);
     }
     if (Request.Aspect != ENanoBananaAspect::Auto)
     {
-        Input->SetStringField(TEXT("aspect_ratio"), FNanoBananaTypeUtils::AspectToString(Request.Aspect));
+        W.WriteString("aspect_ratio", FNanoBananaTypeUtils::AspectToString(Request.Aspect));
     }
     if (Request.Resolution != ENanoBananaResolution::Auto)
     {
         const int32 Px = FNanoBananaTypeUtils::ResolutionToPixels(Request.Resolution);
         if (Px > 0)
         {
-            Input->SetNumberField(TEXT("width"), Px);
-            Input->SetNumberField(TEXT("height"), Px);
+            W.WriteInt("width", Px);
+            W.WriteInt("height", Px);
         }
     }
     if (Request.Seed != 0)
     {
-        Input->SetNumberField(TEXT("seed"), Request.Seed);
+        W.WriteInt("seed", Request.Seed);
     }
     if (!Request.NegativePrompt.IsEmpty())
     {
-        Input->SetStringField(TEXT("negative_prompt"), Request.NegativePrompt);
+        W.WriteString("negative_prompt", Request.NegativePrompt);
     }
-    Input->SetStringField(TEXT("output_format"),
-        Request.OutputFormat == ENanoBananaOutputFormat::JPEG ? TEXT("jpg") :
-        Request.OutputFormat == ENanoBananaOutputFormat::WebP ? TEXT("webp") : TEXT("png"));
+    W.WriteAsciiString("output_format",
+        Request.OutputFormat == ENanoBananaOutputFormat::JPEG ? "jpg" :
+        Request.OutputFormat == ENanoBananaOutputFormat::WebP ? "webp" : "png");
 
-    if (EncodedReferences.Num() > 0)
+    // Each reference exactly once, in the field this model reads (nano-banana: image_input).
+    FPayloadCapabilityTable::WriteDataUriField(W, Caps, EncodedReferences);
+
+    W.EndObject(); // input
+
+    if (!WebhookUrl.IsEmpty())
     {
-        TArray<TSharedPtr<FJsonValue>> Imgs;
-        for (const TArray<uint8>& Img : EncodedReferences)
-        {
-            if (Img.Num() == 0) continue;
-            const FString Mime = NanoBanana::Image::SniffImageMimeType(Img);
-            const FString Uri = NanoBanana::Image::PngBytesToDataUri(Img, Mime);
-            Imgs.Add(MakeShared<FJsonValueString>(Uri));
-        }
-        if (Imgs.Num() > 0)
-        {
-            Input->SetArrayField(TEXT("image_input"), Imgs);
-            Input->SetStringField(TEXT("image"), Imgs[0]->AsString()); // alias for single-image models
-        }
+        W.WriteString("webhook", WebhookUrl);
+        W.BeginArray("webhook_events_filter");
+        W.WriteAsciiString("completed");
+        W.EndArray();
     }
+    W.EndObject();
+    return W.Finish();
+}
 
-    Root->SetObjectField(TEXT("input"), Input);
-
-    FString Out;
-    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Out);
-    FJsonSerializer::Serialize(Root.ToSharedRef(), Writer);
-    return Out;
+FString FReplicateProvider::BuildRequestJson(const FNanoBananaRequest& Request, const TArray<NanoBanana::Image::FEncodedReferenceRef>& EncodedReferences, const FString& WebhookUrl)
+{
+    return NanoBanana::Json::FJsonBodyWriter::ToString(BuildRequestBody(Request, EncodedReferences, WebhookUrl));
 }
 
-void FReplicateProvider::Submit(const FNanoBananaRequest& Request, const FProviderCallbacks& Callbacks)
+void FReplicateProvider::Submit(const FNanoBananaRequest& Request, const TArray<NanoBanana::Image::FEncodedReferenceRef>& References, const FProviderCallbacks& InCallbacks)
 {
+    const FProviderCallbacksRef Callbacks = MakeShared<FProviderCallbacks, ESPMode::ThreadSafe>(InCallbacks);
     const UNanoBananaSettings& S = UNanoBananaSettings::Get();
     const FString ApiKey = S.GetEffectiveApiKey(ENanoBananaVendor::Replicate);
     if (ApiKey.IsEmpty())
     {
-        if (Callbacks.OnFailure) Callbacks.OnFailure(TEXT("Replicate: missing API key (set in Project Settings or REPLICATE_API_TOKEN env var)."));
+        if (Callbacks->OnFailure) Callbacks->OnFailure(TEXT("Replicate: missing API key (set in Project Settings or REPLICATE_API_TOKEN env var)."));
         return;
     }
 
-    TArray<TArray<uint8>> Refs;
-    NanoBanana::Image::ResolveAllReferences(Request, Refs);
+    const FString WebhookUrl = S.Replicate.bUseWebhook ? RegisterWebhook(ApiKey, Callbacks) : FString();
+    const NanoBanana::FSharedBytes Body = NanoBanana::MakeSharedBytes(BuildRequestBody(Request, References, WebhookUrl));
+    if (Callbacks->OnRequestBuilt) Callbacks->OnRequestBuilt(Body);
 
-    const FString Body = BuildRequestJson(Request, Refs);
-    if (Callbacks.OnRequestBuilt) Callbacks.OnRequestBuilt(Body);
+    PollLatencyKey = NanoBanana::Http::FPollLatencyModel::MakeKey(ENanoBananaVendor::Replicate, ResolveModelSlug(Request.Model, Request.CustomModelId), Request.Resolution);
 
-    if (Callbacks.OnProgress) Callbacks.OnProgress(0.2f, TEXT("Replicate submit"));
+    if (Callbacks->OnProgress) Callbacks->OnProgress(0.2f, TEXT("Replicate submit"));
 
     TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Req = FHttpModule::Get().CreateRequest();
     InFlight = Req;
@@ -143,7 +155,7 @@ void FReplicateProvider::Submit(const FNanoBananaRequest& Request, const FProvid
         Req->SetHeader(TEXT("Prefer"), TEXT("wait"));
     }
     Req->SetTimeout((float)FMath::Max(5, S.RequestTimeoutSeconds + 5));
-    Req->SetContentAsString(Body);
+    NanoBanana::Http::SetSharedContent(*Req, Body);
 
     TWeakPtr<FReplicateProvider, ESPMode::ThreadSafe> WeakThis = StaticCastSharedRef<FReplicateProvider>(AsShared());
     Req->OnProcessRequestComplete().BindLambda(
@@ -154,28 +166,34 @@ void FReplicateProvider::Submit(const FNanoBananaRequest& Request, const FProvid
             P->InFlight.Reset();
             if (!bSucceeded || !Resp.IsValid())
             {
-                if (Callbacks.OnFailure) Callbacks.OnFailure(TEXT("Replicate request failed (network)."));
+                if (P->ClaimResult() && Callbacks->OnFailure) Callbacks->OnFailure(TEXT("Replicate request failed (network)."));
                 return;
             }
             const int32 Code = Resp->GetResponseCode();
-            const FString RespStr = Resp->GetContentAsString();
             if (Code < 200 || Code >= 300)
             {
-                if (Callbacks.OnFailure) Callbacks.OnFailure(FString::Printf(TEXT("Replicate HTTP %d: %s"), Code, *RespStr.Left(512)));
+                ReportIfRateLimited(ENanoBananaVendor::Replicate, *Resp, *Callbacks);
+                if (P->ClaimResult() && Callbacks->OnFailure) Callbacks->OnFailure(FString::Printf(TEXT("Replicate HTTP %d: %s"), Code, *Resp->GetContentAsString().Left(512)));
                 return;
             }
-            P->HandleInitialResponse(RespStr, ApiKey, Callbacks);
+            // Parse on a worker; HandleInitialResponse hops back to the game thread for any follow-up HTTP.
+            UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, Callbacks, ApiKey, Resp]()
+            {
+                TSharedPtr<FReplicateProvider, ESPMode::ThreadSafe> P2 = WeakThis.Pin();
+                if (!P2.IsValid() || P2->bCanceled) return;
+                P2->HandleInitialResponse(NanoBanana::MakeSharedText(Resp->GetContentAsString()), ApiKey, Callbacks);
+            });
         });
     Req->ProcessRequest();
 }
 
-void FReplicateProvider::HandleInitialResponse(const FString& Body, const FString& ApiKey, const FProviderCallbacks& Callbacks)
+void FReplicateProvider::HandleInitialResponse(const NanoBanana::FSharedText& Body, const FString& ApiKey, const FProviderCallbacksRef& Callbacks)
 {
     TSharedPtr<FJsonObject> Json;
-    TSharedRef<TJsonReader<>> R = TJsonReaderFactory<>::Create(Body);
+    TSharedRef<TJsonReader<>> R = TJsonReaderFactory<>::Create(*Body);
     if (!FJsonSerializer::Deserialize(R, Json) || !Json.IsValid())
     {
-        if (Callbacks.OnFailure) Callbacks.OnFailure(TEXT("Replicate: failed to parse response JSON."));
+        if (Callbacks->OnFailure) Callbacks->OnFailure(TEXT("Replicate: failed to parse response JSON."));
         return;
     }
 
@@ -183,6 +201,10 @@ void FReplicateProvider::HandleInitialResponse(const FString& Body, const FStrin
     const bool bTerminalSuccess = Status.Equals(TEXT("succeeded"), ESearchCase::IgnoreCase);
     const bool bTerminalFail    = Status.Equals(TEXT("failed"), ESearchCase::IgnoreCase) || Status.Equals(TEXT("canceled"), ESearchCase::IgnoreCase);
 
+    if ((bTerminalSuccess || bTerminalFail) && !ClaimResult())
+    {
+        return;
+    }
     if (bTerminalSuccess)
     {
         HandleTerminalPrediction(Body, Callbacks);
@@ -191,7 +213,7 @@ void FReplicateProvider::HandleInitialResponse(const FString& Body, const FStrin
     if (bTerminalFail)
     {
         FString Err; Json->TryGetStringField(TEXT("error"), Err);
-        if (Callbacks.OnFailure) Callbacks.OnFailure(FString::Printf(TEXT("Replicate prediction %s: %s"), *Status, *Err.Left(256)));
+        if (Callbacks->OnFailure) Callbacks->OnFailure(FString::Printf(TEXT("Replicate prediction %s: %s"), *Status, *Err.Left(256)));
         return;
     }
 
@@ -207,7 +229,7 @@ void FReplicateProvider::HandleInitialResponse(const FString& Body, const FStrin
         FString Id; Json->TryGetStringField(TEXT("id"), Id);
         if (Id.IsEmpty())
         {
-            if (Callbacks.OnFailure) Callbacks.OnFailure(TEXT("Replicate: missing urls.get and id in response."));
+            if (Callbacks->OnFailure) Callbacks->OnFailure(TEXT("Replicate: missing urls.get and id in response."));
             return;
         }
         const UNanoBananaSettings& S = UNanoBananaSettings::Get();
@@ -216,10 +238,17 @@ void FReplicateProvider::HandleInitialResponse(const FString& Body, const FStrin
         GetUrl = FString::Printf(TEXT("%s/predictions/%s"), *Base, *Id);
     }
 
-    PollPrediction(GetUrl, ApiKey, Callbacks);
+    TWeakPtr<FReplicateProvider, ESPMode::ThreadSafe> WeakThis = StaticCastSharedRef<FReplicateProvider>(AsShared());
+    AsyncTask(ENamedThreads::GameThread, [WeakThis, GetUrl, ApiKey, Callbacks]()
+    {
+        TSharedPtr<FReplicateProvider, ESPMode::ThreadSafe> P = WeakThis.Pin();
+        // The webhook may already have delivered the outcome.
+        if (!P.IsValid() || P->bCanceled || P->bResultClaimed) return;
+        P->PollPrediction(GetUrl, ApiKey, Callbacks);
+    });
 }
 
-void FReplicateProvider::PollPrediction(const FString& GetUrl, const FString& ApiKey, const FProviderCallbacks& Callbacks)
+void FReplicateProvider::PollPrediction(const FString& GetUrl, const FString& ApiKey, const FProviderCallbacksRef& Callbacks)
 {
     using namespace NanoBanana::Http;
     const UNanoBananaSettings& S = UNanoBananaSettings::Get();
@@ -227,6 +256,18 @@ void FReplicateProvider::PollPrediction(const FString& GetUrl, const FString& Ap
     TSharedPtr<FPollLoop, ESPMode::ThreadSafe> Loop = MakeShared<FPollLoop, ESPMode::ThreadSafe>();
     Poll = Loop;
     Loop->MaxTotalSeconds = (float)FMath::Max(10, S.MaxPollSeconds);
+    Loop->Vendor = FName(*FNanoBananaTypeUtils::VendorToString(ENanoBananaVendor::Replicate));
+    if (WebhookToken.IsEmpty())
+    {
+        Loop->LatencyKey = PollLatencyKey;
+    }
+    else
+    {
+        // Safety net only: the webhook normally finishes the job long before these polls.
+        Loop->StartDelaySeconds = WebhookSafetyPollSeconds;
+        Loop->InitialDelaySeconds = WebhookSafetyPollSeconds;
+        Loop->MaxDelaySeconds = 3.0f * WebhookSafetyPollSeconds;
+    }
     Loop->RequestFactory = [GetUrl, ApiKey]()
     {
         TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Q = FHttpModule::Get().CreateRequest();
@@ -259,29 +300,36 @@ void FReplicateProvider::PollPrediction(const FString& GetUrl, const FString& Ap
     };
     Loop->OnProgress = [Callbacks](float F)
     {
-        if (Callbacks.OnProgress) Callbacks.OnProgress(0.3f + 0.5f * F, TEXT("Replicate polling..."));
+        if (Callbacks->OnProgress) Callbacks->OnProgress(0.3f + 0.5f * F, TEXT("Replicate polling..."));
     };
-    Loop->OnFailed = [Callbacks](const FString& E)
+    TWeakPtr<FReplicateProvider, ESPMode::ThreadSafe> WeakThis = StaticCastSharedRef<FReplicateProvider>(AsShared());
+    Loop->OnFailed = [WeakThis, Callbacks](const FString& E)
     {
-        if (Callbacks.OnFailure) Callbacks.OnFailure(E);
+        TSharedPtr<FReplicateProvider, ESPMode::ThreadSafe> P = WeakThis.Pin();
+        if (!P.IsValid() || P->bCanceled || !P->ClaimResult()) return;
+        if (Callbacks->OnFailure) Callbacks->OnFailure(E);
     };
-    TWeakPtr<FReplicateProvider, ESPMode::ThreadSafe> WeakThis = StaticCastSharedRef<FReplicateProvider>(AsShared());
-    Loop->OnSucceeded = [WeakThis, Callbacks](const FString& Body)
+    Loop->OnSucceeded = [WeakThis, Callbacks](const NanoBanana::FSharedText& Body)
     {
         TSharedPtr<FReplicateProvider, ESPMode::ThreadSafe> P = WeakThis.Pin();
-        if (!P.IsValid() || P->bCanceled) return;
-        P->HandleTerminalPrediction(Body, Callbacks);
+        if (!P.IsValid() || P->bCanceled || !P->ClaimResult()) return;
+        UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, Body, Callbacks]()
+        {
+            TSharedPtr<FReplicateProvider, ESPMode::ThreadSafe> P2 = WeakThis.Pin();
+            if (!P2.IsValid() || P2->bCanceled) return;
+            P2->HandleTerminalPrediction(Body, Callbacks);
+        });
     };
     Loop->Start();
 }
 
-void FReplicateProvider::HandleTerminalPrediction(const FString& Body, const FProviderCallbacks& Callbacks)
+void FReplicateProvider::HandleTerminalPrediction(const NanoBanana::FSharedText& Body, const FProviderCallbacksRef& Callbacks)
 {
     TSharedPtr<FJsonObject> Json;
-    TSharedRef<TJsonReader<>> R = TJsonReaderFactory<>::Create(Body);
+    TSharedRef<TJsonReader<>> R = TJsonReaderFactory<>::Create(*Body);
     if (!FJsonSerializer::Deserialize(R, Json) || !Json.IsValid())
     {
-        if (Callbacks.OnFailure) Callbacks.OnFailure(TEXT("Replicate: failed to parse terminal prediction JSON."));
+        if (Callbacks->OnFailure) Callbacks->OnFailure(TEXT("Replicate: failed to parse terminal prediction JSON."));
         return;
     }
 
@@ -309,62 +357,99 @@ void FReplicateProvider::HandleTerminalPrediction(const FString& Body, const FPr
 
     if (Urls.Num() == 0)
     {
-        if (Callbacks.OnFailure) Callbacks.OnFailure(FString::Printf(TEXT("Replicate: no output URLs. Body: %s"), *Body.Left(512)));
+        if (Callbacks->OnFailure) Callbacks->OnFailure(FString::Printf(TEXT("Replicate: no output URLs. Body: %s"), *Body->Left(512)));
         return;
     }
 
-    if (Callbacks.OnProgress) Callbacks.OnProgress(0.85f, TEXT("Replicate fetching images"));
-    FetchImageUrls(Urls, Callbacks, Body);
+    if (Callbacks->OnProgress) Callbacks->OnProgress(0.85f, TEXT("Replicate fetching images"));
+    TWeakPtr<FReplicateProvider, ESPMode::ThreadSafe> WeakThis = StaticCastSharedRef<FReplicateProvider>(AsShared());
+    AsyncTask(ENamedThreads::GameThread, [WeakThis, Urls = MoveTemp(Urls), Callbacks, Body]()
+    {
+        TSharedPtr<FReplicateProvider, ESPMode::ThreadSafe> P = WeakThis.Pin();
+        if (!P.IsValid() || P->bCanceled) return;
+        P->FetchImageUrls(Urls, Callbacks, Body);
+    });
 }
 
-void FReplicateProvider::FetchImageUrls(const TArray<FString>& Urls, const FProviderCallbacks& Callbacks, const FString& RawResponse)
+void FReplicateProvider::FetchImageUrls(const TArray<FString>& Urls, const FProviderCallbacksRef& Callbacks, const NanoBanana::FSharedText& RawResponse)
 {
     const UNanoBananaSettings& S = UNanoBananaSettings::Get();
     const FString ApiKey = S.GetEffectiveApiKey(ENanoBananaVendor::Replicate);
 
-    TSharedRef<TArray<TArray<uint8>>> Bucket = MakeShared<TArray<TArray<uint8>>>();
-    Bucket->SetNum(Urls.Num());
-    TSharedRef<int32> Pending = MakeShared<int32>(Urls.Num());
-    TSharedRef<bool> Failed = MakeShared<bool>(false);
+    // Parallel GETs, each streamed to its output file and one buffer; assembled in order.
+    Download = MakeShared<NanoBanana::Http::FResultDownloader, ESPMode::ThreadSafe>();
+    Download->ResolvePath = Callbacks->ResolveDownloadPath;
+    if (!ApiKey.IsEmpty())
+    {
+        Download->Headers.Add(TEXT("Authorization"), FString::Printf(TEXT("Bearer %s"), *ApiKey));
+    }
 
     TWeakPtr<FReplicateProvider, ESPMode::ThreadSafe> WeakThis = StaticCastSharedRef<FReplicateProvider>(AsShared());
+    Download->OnSucceeded = [WeakThis, Callbacks, RawResponse](TArray<TArray<uint8>> Images, TArray<FString> SavedPaths)
+    {
+        TSharedPtr<FReplicateProvider, ESPMode::ThreadSafe> P = WeakThis.Pin();
+        if (!P.IsValid() || P->bCanceled) return;
+        P->Download.Reset();
+        if (Callbacks->OnSuccess) Callbacks->OnSuccess(MoveTemp(Images), MoveTemp(SavedPaths), RawResponse);
+    };
+    Download->OnFailed = [WeakThis, Callbacks](int32 Index)
+    {
+        TSharedPtr<FReplicateProvider, ESPMode::ThreadSafe> P = WeakThis.Pin();
+        if (!P.IsValid() || P->bCanceled) return;
+        P->Download.Reset();
+        if (Callbacks->OnFailure) Callbacks->OnFailure(FString::Printf(TEXT("Replicate image download failed (index %d)."), Index));
+    };
+    Download->Start(Urls);
+}
 
-    for (int32 i = 0; i < Urls.Num(); ++i)
+FString FReplicateProvider::RegisterWebhook(const FString& ApiKey, const FProviderCallbacksRef& Callbacks)
+{
+    const UNanoBananaSettings& S = UNanoBananaSettings::Get();
+    const FString SigningSecret = S.GetEffectiveReplicateWebhookSecret();
+    // Without both, a registered webhook could never complete the job (or could be forged),
+    // so the job keeps its normal poll schedule instead of the slow safety-net one.
+    if (S.Replicate.WebhookPublicUrl.IsEmpty() || SigningSecret.IsEmpty())
     {
-        TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Get = FHttpModule::Get().CreateRequest();
-        Get->SetURL(Urls[i]);
-        Get->SetVerb(TEXT("GET"));
-        if (!ApiKey.IsEmpty())
+        static bool bWarned = false;
+        if (!bWarned)
         {
-            Get->SetHeader(TEXT("Authorization"), FString::Printf(TEXT("Bearer %s"), *ApiKey));
+            bWarned = true;
+            UE_LOG(LogNanoBanana, Warning, TEXT("Replicate: bUseWebhook is on but %s is not set; polling instead."),
+                S.Replicate.WebhookPublicUrl.IsEmpty() ? TEXT("WebhookPublicUrl") : TEXT("WebhookSigningSecret"));
         }
-        const int32 Index = i;
-        Get->OnProcessRequestComplete().BindLambda(
-            [WeakThis, Callbacks, Bucket, Pending, Failed, Index, RawResponse]
-            (FHttpRequestPtr, FHttpResponsePtr Resp, bool bOK)
-            {
-                TSharedPtr<FReplicateProvider, ESPMode::ThreadSafe> P = WeakThis.Pin();
-                if (!P.IsValid() || P->bCanceled) return;
-                if (*Failed) return;
-                if (!bOK || !Resp.IsValid() || Resp->GetResponseCode() < 200 || Resp->GetResponseCode() >= 300)
-                {
-                    *Failed = true;
-                    if (Callbacks.OnFailure) Callbacks.OnFailure(FString::Printf(TEXT("Replicate image download failed (index %d)."), Index));
-                    return;
-                }
-                (*Bucket)[Index] = Resp->GetContent();
-                if (--(*Pending) == 0)
-                {
-                    if (Callbacks.OnSuccess) Callbacks.OnSuccess(MoveTemp(*Bucket), RawResponse);
-                }
-            });
-        Get->ProcessRequest();
+        return FString();
     }
+
+    TWeakPtr<FReplicateProvider, ESPMode::ThreadSafe> WeakThis = StaticCastSharedRef<FReplicateProvider>(AsShared());
+    // Game thread. The callback body is the finished prediction, the same object a poll
+    // would return, so it goes through the initial-response path and claims the result there.
+    auto OnCallback = [WeakThis, ApiKey, Callbacks](const NanoBanana::FSharedText& Body)
+    {
+        TSharedPtr<FReplicateProvider, ESPMode::ThreadSafe> P = WeakThis.Pin();
+        if (!P.IsValid() || P->bCanceled || P->bResultClaimed) return;
+        if (P->Poll.IsValid()) { P->Poll->Cancel(); P->Poll.Reset(); }
+        UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, ApiKey, Callbacks, Body]()
+        {
+            TSharedPtr<FReplicateProvider, ESPMode::ThreadSafe> P2 = WeakThis.Pin();
+            if (!P2.IsValid() || P2->bCanceled) return;
+            P2->HandleInitialResponse(Body, ApiKey, Callbacks);
+        });
+    };
+    return NanoBanana::Http::FWebhookReceiver::Get().Register(S.Replicate.WebhookListenPort, S.Replicate.WebhookPublicUrl, SigningSecret, MoveTemp(OnCallback), WebhookToken);
+}
+
+bool FReplicateProvider::ClaimResult()
+{
+    if (bResultClaimed.exchange(true)) return false;
+    NanoBanana::Http::FWebhookReceiver::Get().Unregister(WebhookToken);
+    return true;
 }
 
 void FReplicateProvider::Cancel()
 {
     bCanceled = true;
+    NanoBanana::Http::FWebhookReceiver::Get().Unregister(WebhookToken);
     if (InFlight.IsValid()) { InFlight->CancelRequest(); InFlight.Reset(); }
     if (Poll.IsValid()) { Poll->Cancel(); Poll.Reset(); }
+    if (Download.IsValid()) { Download->Cancel(); Download.Reset(); }
 }
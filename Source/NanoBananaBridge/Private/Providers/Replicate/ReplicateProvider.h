@@ -1,18 +1,21 @@
 // Provider: Replicate
 // POST /v1/predictions with `Prefer: wait` for sync attempt; if response is non-terminal,
-// poll urls.get until succeeded/failed/canceled, then HTTP-fetch output URLs to bytes.
+// poll urls.get until succeeded/failed/canceled (or, with a webhook registered, until
+// Replicate calls back), then HTTP-fetch output URLs to bytes.
 #pragma once
 
 #include "CoreMinimal.h"
 #include "../IImageGenProvider.h"
 #include "Interfaces/IHttpRequest.h"
 
-namespace NanoBanana::Http { class FPollLoop; }
+#include <atomic>
+
+namespace NanoBanana::Http { class FPollLoop; class FResultDownloader; }
 
 class FReplicateProvider : public IImageGenProvider
 {
 public:
-    virtual void Submit(const FNanoBananaRequest& Request, const FProviderCallbacks& Callbacks) override;
+    virtual void Submit(const FNanoBananaRequest& Request, const TArray<NanoBanana::Image::FEncodedReferenceRef>& References, const FProviderCallbacks& Callbacks) override;
     virtual void Cancel() override;
 
     // ---- Static helpers (testable) ----
@@ -24,15 +27,39 @@ public:
     static FString ResolveVersionOverride(ENanoBananaModel Model);
 
     static FString BuildPredictionsUrl(const FString& BaseUrlOverride);
-    static FString BuildRequestJson(const FNanoBananaRequest& Request, const TArray<TArray<uint8>>& EncodedReferences);
+    /**
+     * UTF-8 JSON body, written straight into the buffer handed to the HTTP request. A non-empty
+     * WebhookUrl is registered for the "completed" event only.
+     */
+    static TArray<uint8> BuildRequestBody(const FNanoBananaRequest& Request, const TArray<NanoBanana::Image::FEncodedReferenceRef>& EncodedReferences, const FString& WebhookUrl = FString());
+    /** BuildRequestBody decoded to text (tests/diagnostics). */
+    static FString BuildRequestJson(const FNanoBananaRequest& Request, const TArray<NanoBanana::Image::FEncodedReferenceRef>& EncodedReferences, const FString& WebhookUrl = FString());
+
+    /** With a webhook registered, polling only backs it up: first poll after this long. */
+    static constexpr float WebhookSafetyPollSeconds = 10.0f;
 
 private:
-    void HandleInitialResponse(const FString& Body, const FString& ApiKey, const FProviderCallbacks& Callbacks);
-    void PollPrediction(const FString& GetUrl, const FString& ApiKey, const FProviderCallbacks& Callbacks);
-    void HandleTerminalPrediction(const FString& Body, const FProviderCallbacks& Callbacks);
-    void FetchImageUrls(const TArray<FString>& Urls, const FProviderCallbacks& Callbacks, const FString& RawResponse);
+    // Handle* run on worker tasks and hop back to the game thread before touching HTTP / poll state.
+    void HandleInitialResponse(const NanoBanana::FSharedText& Body, const FString& ApiKey, const FProviderCallbacksRef& Callbacks);
+    void PollPrediction(const FString& GetUrl, const FString& ApiKey, const FProviderCallbacksRef& Callbacks);
+    void HandleTerminalPrediction(const NanoBanana::FSharedText& Body, const FProviderCallbacksRef& Callbacks);
+    void FetchImageUrls(const TArray<FString>& Urls, const FProviderCallbacksRef& Callbacks, const NanoBanana::FSharedText& RawResponse);
+    /** Returns the callback URL, or empty without a public URL and signing secret or when the listener is unavailable (polling only). */
+    FString RegisterWebhook(const FString& ApiKey, const FProviderCallbacksRef& Callbacks);
+    /**
+     * The initial response, the webhook and the poll loop can each report the outcome; the
+     * first to claim it delivers, the others drop theirs. Any thread.
+     */
+    bool ClaimResult();
 
     TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> InFlight;
     TSharedPtr<NanoBanana::Http::FPollLoop, ESPMode::ThreadSafe> Poll;
-    bool bCanceled = false;
+    /** FPollLatencyModel key for this request's (model, resolution). */
+    FString PollLatencyKey;
+    TSharedPtr<NanoBanana::Http::FResultDownloader, ESPMode::ThreadSafe> Download;
+    /** Set once in Submit, before any callback can run; read from any thread afterwards. */
+    FString WebhookToken;
+    /** Read by response-parsing worker tasks, hence atomic. */
+    std::atomic<bool> bCanceled { false };
+    std::atomic<bool> bResultClaimed { false };
 };
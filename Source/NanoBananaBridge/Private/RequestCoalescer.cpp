@@ -0,0 +1,68 @@
+#include "RequestCoalescer.h"
+#include "NanoBananaBridgeAsyncAction.h"
+#include "NanoBananaSettings.h"
+#include "NanoBananaLog.h"
+#include "HAL/IConsoleManager.h"
+
+namespace NanoBanana
+{
+    namespace
+    {
+        FAutoConsoleCommand DumpStatsCommand(
+            TEXT("NanoBanana.Coalescing.Stats"),
+            TEXT("Logs how many requests are in flight for others to join, and how many have joined one."),
+            FConsoleCommandDelegate::CreateLambda([]()
+            {
+                const FRequestCoalescerStats S = FRequestCoalescer::Get().GetStats();
+                UE_LOG(LogNanoBanana, Display, TEXT("Request coalescing: %d in flight, %lld requests joined one instead of running"),
+                    S.NumInFlight, S.NumJoined);
+            }));
+    }
+
+    bool CanCoalesce(const FNanoBananaRequest& Request)
+    {
+        const UNanoBananaSettings& S = UNanoBananaSettings::Get();
+        return S.bCoalesceIdenticalRequests && (Request.Seed != 0 || S.bCoalesceUnseededRequests);
+    }
+
+    FRequestCoalescer& FRequestCoalescer::Get()
+    {
+        static FRequestCoalescer Instance;
+        return Instance;
+    }
+
+    UNanoBananaBridgeAsyncAction* FRequestCoalescer::FindLeader(uint64 Fingerprint) const
+    {
+        check(IsInGameThread());
+        const TWeakObjectPtr<UNanoBananaBridgeAsyncAction>* Leader = Leaders.Find(Fingerprint);
+        return Leader ? Leader->Get() : nullptr;
+    }
+
+    void FRequestCoalescer::AddLeader(uint64 Fingerprint, UNanoBananaBridgeAsyncAction* Action)
+    {
+        check(IsInGameThread());
+        Leaders.Add(Fingerprint, Action);
+    }
+
+    void FRequestCoalescer::RemoveLeader(uint64 Fingerprint, const UNanoBananaBridgeAsyncAction* Action)
+    {
+        check(IsInGameThread());
+        const TWeakObjectPtr<UNanoBananaBridgeAsyncAction>* Leader = Leaders.Find(Fingerprint);
+        // A stale (destroyed) entry goes too; nothing can join it any more.
+        if (Leader && (!Leader->IsValid() || Leader->Get() == Action))
+        {
+            Leaders.Remove(Fingerprint);
+        }
+    }
+
+    FRequestCoalescerStats FRequestCoalescer::GetStats() const
+    {
+        FRequestCoalescerStats Out;
+        for (const TPair<uint64, TWeakObjectPtr<UNanoBananaBridgeAsyncAction>>& Pair : Leaders)
+        {
+            if (Pair.Value.IsValid()) ++Out.NumInFlight;
+        }
+        Out.NumJoined = NumJoined;
+        return Out;
+    }
+}
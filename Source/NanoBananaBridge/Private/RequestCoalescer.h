@@ -0,0 +1,50 @@
+// In-flight request coalescing: identical requests (same RequestFingerprint) started while one
+// is still running share that one's provider execution instead of generating again.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+#include "NanoBananaTypes.h"
+
+class UNanoBananaBridgeAsyncAction;
+
+namespace NanoBanana
+{
+    /** Whether settings allow Request to share another request's execution (Seed 0 is opt-in). */
+    bool CanCoalesce(const FNanoBananaRequest& Request);
+
+    struct FRequestCoalescerStats
+    {
+        /** Requests currently running on behalf of others (or able to). */
+        int32 NumInFlight = 0;
+        /** Requests that joined one in flight instead of running, since startup. */
+        int64 NumJoined = 0;
+    };
+
+    /**
+     * Game-thread registry of the request currently running for each fingerprint. The running
+     * action keeps its own list of waiting followers and fans its results out to them; this
+     * only lets new arrivals find it.
+     */
+    class FRequestCoalescer
+    {
+    public:
+        static FRequestCoalescer& Get();
+
+        /** The live action running Fingerprint, or null. */
+        UNanoBananaBridgeAsyncAction* FindLeader(uint64 Fingerprint) const;
+
+        void AddLeader(uint64 Fingerprint, UNanoBananaBridgeAsyncAction* Action);
+
+        /** Unregisters Action; a no-op if another action has since taken over Fingerprint. */
+        void RemoveLeader(uint64 Fingerprint, const UNanoBananaBridgeAsyncAction* Action);
+
+        void NoteJoined() { ++NumJoined; }
+
+        FRequestCoalescerStats GetStats() const;
+
+    private:
+        TMap<uint64, TWeakObjectPtr<UNanoBananaBridgeAsyncAction>> Leaders;
+        int64 NumJoined = 0;
+    };
+}
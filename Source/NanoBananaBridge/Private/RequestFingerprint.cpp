@@ -0,0 +1,55 @@
+#include "RequestFingerprint.h"
+#include "Hash/xxhash.h"
+
+namespace NanoBanana
+{
+    namespace
+    {
+        /** Field-by-field hashing; strings carry their length so adjacent fields can't run together. */
+        struct FFingerprintBuilder
+        {
+            FXxHash64Builder Builder;
+
+            template <typename T>
+            void Add(const T& Value)
+            {
+                static_assert(TIsPODType<T>::Value, "hash strings with AddString");
+                Builder.Update(&Value, sizeof(Value));
+            }
+
+            void AddString(const FString& Value)
+            {
+                const int32 Len = Value.Len();
+                Add(Len);
+                Builder.Update(*Value, Len * sizeof(TCHAR));
+            }
+        };
+    }
+
+    uint64 ComputeRequestFingerprint(const FNanoBananaRequest& Request, const TArray<Image::FEncodedReferenceRef>& References, uint64 MaskKey)
+    {
+        FFingerprintBuilder F;
+        F.AddString(Request.Prompt);
+        F.Add((uint8)Request.Vendor);
+        F.Add((uint8)Request.Model);
+        F.AddString(Request.CustomModelId);
+        F.Add((uint8)Request.Aspect);
+        F.Add((uint8)Request.Resolution);
+        F.Add(Request.NumImages);
+        F.AddString(Request.NegativePrompt);
+        F.Add(Request.Seed);
+        F.Add((uint8)Request.OutputFormat);
+        F.Add((uint8)Request.ReferenceScaling);
+        F.Add(MaskKey);
+
+        // The encoded references are what the vendor sees, whichever of texture, render target
+        // or file they came from.
+        F.Add(References.Num());
+        for (const Image::FEncodedReferenceRef& Ref : References)
+        {
+            const uint64 Hash = Ref->ContentHash != 0 ? Ref->ContentHash : FXxHash64::HashBuffer(Ref->Bytes.GetData(), Ref->Bytes.Num()).Hash;
+            F.Add(Hash);
+        }
+        return F.Builder.Finalize().Hash;
+    }
+}
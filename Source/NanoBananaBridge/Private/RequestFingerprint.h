@@ -0,0 +1,21 @@
+// Canonical request fingerprint: one hash of everything that decides what a request generates.
+// Identical requests in flight share one execution (FRequestCoalescer), and finished ones are
+// served again from FResultCache.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NanoBananaTypes.h"
+#include "Http/Base64Image.h"
+
+namespace NanoBanana
+{
+    /**
+     * Hash of every FNanoBananaRequest field except Priority and CachePolicy (which only decide
+     * how the request is run), with reference images folded in by encoded content
+     * (FEncodedReference::ContentHash, or the bytes when a reference was not cached) in
+     * request order. OptionalMask is folded in as MaskKey, the content key of its pixels
+     * (FReferencePreparer hashes it; 0 without a mask). Stable across sessions for unchanged
+     * inputs.
+     */
+    uint64 ComputeRequestFingerprint(const FNanoBananaRequest& Request, const TArray<Image::FEncodedReferenceRef>& References, uint64 MaskKey = 0);
+}
@@ -0,0 +1,336 @@
+#include "ResultCache.h"
+#include "NanoBananaSettings.h"
+#include "NanoBananaLog.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+namespace NanoBanana
+{
+    namespace
+    {
+        const TCHAR* ManifestName = TEXT("Entry.json");
+
+        FAutoConsoleCommand DumpStatsCommand(
+            TEXT("NanoBanana.ResultCache.Stats"),
+            TEXT("Logs size and hit rate of the on-disk result cache."),
+            FConsoleCommandDelegate::CreateLambda([]()
+            {
+                const FNanoBananaResultCacheStats S = FResultCache::Get().GetStats();
+                UE_LOG(LogNanoBanana, Display, TEXT("Result cache: %d entries, %.1f MB, %lld hits, %lld misses (%.0f%% hit rate), %lld stored, %lld evicted"),
+                    S.NumEntries, S.SizeBytes / (1024.0 * 1024.0), S.Hits, S.Misses, S.HitRate * 100.0f, S.Stores, S.Evictions);
+            }));
+
+        FAutoConsoleCommand ClearCommand(
+            TEXT("NanoBanana.ResultCache.Clear"),
+            TEXT("Deletes every cached result."),
+            FConsoleCommandDelegate::CreateLambda([]()
+            {
+                FResultCache::Get().Empty();
+            }));
+    }
+
+    FResultCache::FResultCache(const FString& InRootDir)
+        : RootDir(FPaths::ConvertRelativePathToFull(InRootDir))
+    {
+        ScanTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [this]() { Scan(); });
+    }
+
+    FResultCache::~FResultCache()
+    {
+        ScanTask.Wait();
+    }
+
+    FResultCache& FResultCache::Get()
+    {
+        static FResultCache Instance(FPaths::ProjectSavedDir() / TEXT("NanoBanana") / TEXT("Cache"));
+        return Instance;
+    }
+
+    bool FResultCache::IsCacheable(const FNanoBananaRequest& Request)
+    {
+        const UNanoBananaSettings& S = UNanoBananaSettings::Get();
+        return S.ResultCacheMaxMegabytes > 0 && (Request.Seed != 0 || S.bCacheUnseededResults);
+    }
+
+    void FResultCache::SetLimits(int64 InMaxBytes, FTimespan InMaxAge)
+    {
+        FScopeLock ScopeLock(&Lock);
+        MaxBytes = FMath::Max<int64>(0, InMaxBytes);
+        MaxAge = InMaxAge;
+    }
+
+    FString FResultCache::GetEntryDir(uint64 Key) const
+    {
+        return RootDir / FString::Printf(TEXT("%016llx"), Key);
+    }
+
+    bool FResultCache::IsExpired(const FEntry& Entry, const FDateTime& NowUtc) const
+    {
+        return MaxAge > FTimespan::Zero() && NowUtc - Entry.CreatedUtc > MaxAge;
+    }
+
+    bool FResultCache::Probe(uint64 Key)
+    {
+        FScopeLock ScopeLock(&Lock);
+        // Expired entries stay on disk until the next Store() evicts them. A request that comes
+        // in before the scan is done generates rather than wait on the disk.
+        const FEntry* Entry = bScanned ? Entries.Find(Key) : nullptr;
+        if (!Entry || IsExpired(*Entry, FDateTime::UtcNow()))
+        {
+            ++Misses;
+            return false;
+        }
+        return true;
+    }
+
+    bool FResultCache::Load(uint64 Key, TArray<TArray<uint8>>& OutImages, TArray<FString>& OutPaths)
+    {
+        WaitForScan();
+        TArray<FString> Files;
+        {
+            FScopeLock ScopeLock(&Lock);
+            const FEntry* Entry = Entries.Find(Key);
+            if (!Entry)
+            {
+                ++Misses;
+                return false;
+            }
+            Files = Entry->Files;
+        }
+
+        const FString Dir = GetEntryDir(Key);
+        OutImages.SetNum(Files.Num());
+        OutPaths.SetNum(Files.Num());
+        for (int32 i = 0; i < Files.Num(); ++i)
+        {
+            OutPaths[i] = Dir / Files[i];
+            if (!FFileHelper::LoadFileToArray(OutImages[i], *OutPaths[i]) || OutImages[i].Num() == 0)
+            {
+                UE_LOG(LogNanoBanana, Warning, TEXT("Result cache entry %s is incomplete; discarding it."), *Dir);
+                {
+                    FScopeLock ScopeLock(&Lock);
+                    RemoveLocked(Key);
+                    ++Misses;
+                }
+                DeleteEntryDirs({ Key });
+                OutImages.Reset();
+                OutPaths.Reset();
+                return false;
+            }
+        }
+
+        const FDateTime NowUtc = FDateTime::UtcNow();
+        {
+            FScopeLock ScopeLock(&Lock);
+            if (FEntry* Entry = Entries.Find(Key))
+            {
+                Entry->LastUsedUtc = NowUtc;
+            }
+            ++Hits;
+        }
+        // The manifest's timestamp carries last use across sessions.
+        IFileManager::Get().SetTimeStamp(*(Dir / ManifestName), NowUtc);
+        return true;
+    }
+
+    void FResultCache::Store(uint64 Key, const TArray<FNanoBananaImageResult>& Results, const FString& Ext)
+    {
+        if (Results.Num() == 0) return;
+        WaitForScan();
+        {
+            FScopeLock ScopeLock(&Lock);
+            if (MaxBytes <= 0) return;
+            RemoveLocked(Key);
+        }
+
+        const FString Dir = GetEntryDir(Key);
+        IFileManager& FM = IFileManager::Get();
+        FM.DeleteDirectory(*Dir, /*RequireExists*/ false, /*Tree*/ true);
+        FM.MakeDirectory(*Dir, /*Tree*/ true);
+
+        FEntry Entry;
+        Entry.CreatedUtc = FDateTime::UtcNow();
+        Entry.LastUsedUtc = Entry.CreatedUtc;
+        TArray<TSharedPtr<FJsonValue>> FileValues;
+        for (int32 i = 0; i < Results.Num(); ++i)
+        {
+            const FString File = FString::Printf(TEXT("Result_%02d%s"), i, *Ext);
+            if (!FFileHelper::SaveArrayToFile(Results[i].PngBytes, *(Dir / File)))
+            {
+                UE_LOG(LogNanoBanana, Warning, TEXT("Could not write result cache entry %s."), *Dir);
+                FM.DeleteDirectory(*Dir, false, true);
+                return;
+            }
+            Entry.Files.Add(File);
+            Entry.Bytes += Results[i].PngBytes.Num();
+            FileValues.Add(MakeShared<FJsonValueString>(File));
+        }
+
+        // Written last: its presence marks the entry complete.
+        TSharedRef<FJsonObject> Manifest = MakeShared<FJsonObject>();
+        Manifest->SetNumberField(TEXT("version"), FormatVersion);
+        Manifest->SetStringField(TEXT("created"), Entry.CreatedUtc.ToIso8601());
+        Manifest->SetArrayField(TEXT("files"), FileValues);
+        FString Text;
+        const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Text);
+        if (!FJsonSerializer::Serialize(Manifest, Writer) || !FFileHelper::SaveStringToFile(Text, *(Dir / ManifestName)))
+        {
+            FM.DeleteDirectory(*Dir, false, true);
+            return;
+        }
+
+        TArray<uint64> Victims;
+        {
+            FScopeLock ScopeLock(&Lock);
+            ResidentBytes += Entry.Bytes;
+            Entries.Add(Key, MoveTemp(Entry));
+            ++Stores;
+            CollectVictimsLocked(Key, Victims);
+        }
+        DeleteEntryDirs(Victims);
+    }
+
+    void FResultCache::Empty()
+    {
+        WaitForScan();
+        {
+            FScopeLock ScopeLock(&Lock);
+            Entries.Reset();
+            ResidentBytes = 0;
+        }
+        IFileManager::Get().DeleteDirectory(*RootDir, /*RequireExists*/ false, /*Tree*/ true);
+    }
+
+    FNanoBananaResultCacheStats FResultCache::GetStats() const
+    {
+        FScopeLock ScopeLock(&Lock);
+        FNanoBananaResultCacheStats Out;
+        Out.NumEntries = Entries.Num();
+        Out.SizeBytes = ResidentBytes;
+        Out.Hits = Hits;
+        Out.Misses = Misses;
+        Out.Stores = Stores;
+        Out.Evictions = Evictions;
+        Out.HitRate = Hits + Misses > 0 ? (float)((double)Hits / (Hits + Misses)) : 0.0f;
+        return Out;
+    }
+
+    void FResultCache::WaitForScan()
+    {
+        ScanTask.Wait();
+    }
+
+    void FResultCache::Scan()
+    {
+        TMap<uint64, FEntry> Found;
+        int64 FoundBytes = 0;
+        IFileManager& FM = IFileManager::Get();
+        TArray<FString> Dirs;
+        FM.FindFiles(Dirs, *(RootDir / TEXT("*")), /*Files*/ false, /*Directories*/ true);
+        TArray<uint64> Stale;
+        for (const FString& Name : Dirs)
+        {
+            const uint64 Key = FParse::HexNumber64(*Name);
+            const FString Dir = RootDir / Name;
+            const FString ManifestPath = Dir / ManifestName;
+
+            FString Text;
+            TSharedPtr<FJsonObject> Manifest;
+            int32 Version = 0;
+            FString Created;
+            const TArray<TSharedPtr<FJsonValue>>* FileValues = nullptr;
+            FEntry Entry;
+            bool bValid = Name.Len() == 16 && FFileHelper::LoadFileToString(Text, *ManifestPath)
+                && FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Text), Manifest) && Manifest.IsValid()
+                && Manifest->TryGetNumberField(TEXT("version"), Version) && Version == FormatVersion
+                && Manifest->TryGetStringField(TEXT("created"), Created) && FDateTime::ParseIso8601(*Created, Entry.CreatedUtc)
+                && Manifest->TryGetArrayField(TEXT("files"), FileValues);
+            if (bValid)
+            {
+                for (const TSharedPtr<FJsonValue>& Value : *FileValues)
+                {
+                    const int64 Size = FM.FileSize(*(Dir / Value->AsString()));
+                    if (Size <= 0) { bValid = false; break; }
+                    Entry.Files.Add(Value->AsString());
+                    Entry.Bytes += Size;
+                }
+            }
+            if (!bValid || Entry.Files.Num() == 0)
+            {
+                // Interrupted store, other format version, or not ours: reclaim the space.
+                FM.DeleteDirectory(*Dir, false, true);
+                continue;
+            }
+            Entry.LastUsedUtc = FM.GetTimeStamp(*ManifestPath);
+            FoundBytes += Entry.Bytes;
+            Found.Add(Key, MoveTemp(Entry));
+        }
+        if (Found.Num() > 0)
+        {
+            UE_LOG(LogNanoBanana, Log, TEXT("Result cache: %d entries (%.1f MB) in %s"), Found.Num(), FoundBytes / (1024.0 * 1024.0), *RootDir);
+        }
+
+        // Everything that changes the index waits for this task, so it is still empty here.
+        FScopeLock ScopeLock(&Lock);
+        Entries = MoveTemp(Found);
+        ResidentBytes = FoundBytes;
+        bScanned = true;
+    }
+
+    void FResultCache::CollectVictimsLocked(uint64 Keep, TArray<uint64>& OutVictims)
+    {
+        const FDateTime NowUtc = FDateTime::UtcNow();
+        for (const TPair<uint64, FEntry>& Pair : Entries)
+        {
+            if (Pair.Key != Keep && IsExpired(Pair.Value, NowUtc))
+            {
+                OutVictims.Add(Pair.Key);
+            }
+        }
+        for (const uint64 Key : OutVictims)
+        {
+            RemoveLocked(Key);
+        }
+
+        if (ResidentBytes > MaxBytes)
+        {
+            TArray<TPair<FDateTime, uint64>> ByLastUse;
+            for (const TPair<uint64, FEntry>& Pair : Entries)
+            {
+                if (Pair.Key != Keep) ByLastUse.Emplace(Pair.Value.LastUsedUtc, Pair.Key);
+            }
+            ByLastUse.Sort([](const TPair<FDateTime, uint64>& A, const TPair<FDateTime, uint64>& B) { return A.Key < B.Key; });
+            for (const TPair<FDateTime, uint64>& Oldest : ByLastUse)
+            {
+                if (ResidentBytes <= MaxBytes) break;
+                RemoveLocked(Oldest.Value);
+                OutVictims.Add(Oldest.Value);
+            }
+        }
+        Evictions += OutVictims.Num();
+    }
+
+    void FResultCache::RemoveLocked(uint64 Key)
+    {
+        FEntry Removed;
+        if (Entries.RemoveAndCopyValue(Key, Removed))
+        {
+            ResidentBytes -= Removed.Bytes;
+        }
+    }
+
+    void FResultCache::DeleteEntryDirs(const TArray<uint64>& Keys) const
+    {
+        for (const uint64 Key : Keys)
+        {
+            IFileManager::Get().DeleteDirectory(*GetEntryDir(Key), /*RequireExists*/ false, /*Tree*/ true);
+        }
+    }
+}
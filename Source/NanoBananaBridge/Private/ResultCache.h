@@ -0,0 +1,96 @@
+// Persistent, content-addressed cache of finished results under Saved/NanoBanana/Cache. A
+// request whose fingerprint has an entry is served from disk without contacting its vendor.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "Tasks/Task.h"
+#include "NanoBananaTypes.h"
+#include "NanoBananaResultCacheLibrary.h"
+
+namespace NanoBanana
+{
+    /**
+     * One directory per request fingerprint (16 hex digits) holding the result images and an
+     * Entry.json manifest, which is written last: a directory without one is an interrupted
+     * store and is discarded. Entries older than the age limit are dropped, and least recently
+     * used ones go first once the cache is over its byte budget.
+     *
+     * Thread-safe. The index is read from disk on a worker as soon as the cache is created (the
+     * module creates the shared one at startup). Probe() only consults the in-memory index and
+     * misses until the scan is in, rather than block its caller; Load(), Store() and Empty() wait
+     * for the scan, do file IO and belong on a worker.
+     */
+    class FResultCache
+    {
+    public:
+        /** Bumped when the on-disk layout changes; entries written by other versions are ignored. */
+        static constexpr int32 FormatVersion = 1;
+
+        /** Starts reading the index from InRootDir on a worker. */
+        explicit FResultCache(const FString& InRootDir);
+        ~FResultCache();
+
+        /** Process-wide cache in Saved/NanoBanana/Cache. */
+        static FResultCache& Get();
+
+        /** Settings allow caching Request at all (budget above 0; Seed 0 only on opt-in). */
+        static bool IsCacheable(const FNanoBananaRequest& Request);
+
+        /** MaxAge of zero = no age limit. */
+        void SetLimits(int64 InMaxBytes, FTimespan InMaxAge);
+
+        /** True when Key has a live entry. A miss is counted otherwise; a hit once Load succeeds. */
+        bool Probe(uint64 Key);
+
+        /** Blocks until the index has been read from disk. */
+        void WaitForScan();
+
+        /**
+         * Reads Key's images (and their paths inside the cache) and marks the entry used. Fails,
+         * counting a miss and dropping the entry, when its files have gone missing.
+         */
+        bool Load(uint64 Key, TArray<TArray<uint8>>& OutImages, TArray<FString>& OutPaths);
+
+        /** Writes Results' bytes as Key's entry, replacing any older one, then evicts to fit. */
+        void Store(uint64 Key, const TArray<FNanoBananaImageResult>& Results, const FString& Ext);
+
+        /** Deletes every entry. */
+        void Empty();
+
+        FNanoBananaResultCacheStats GetStats() const;
+
+        const FString& GetRootDir() const { return RootDir; }
+
+    private:
+        struct FEntry
+        {
+            TArray<FString> Files;
+            int64 Bytes = 0;
+            FDateTime CreatedUtc;
+            FDateTime LastUsedUtc;
+        };
+
+        FString GetEntryDir(uint64 Key) const;
+        bool IsExpired(const FEntry& Entry, const FDateTime& NowUtc) const;
+        /** Worker. Reads every entry's manifest, then publishes the index under the lock. */
+        void Scan();
+        /** Lock held. Unlinks expired entries, then least recently used ones until within budget. */
+        void CollectVictimsLocked(uint64 Keep, TArray<uint64>& OutVictims);
+        void RemoveLocked(uint64 Key);
+        void DeleteEntryDirs(const TArray<uint64>& Keys) const;
+
+        const FString RootDir;
+        mutable FCriticalSection Lock;
+        TMap<uint64, FEntry> Entries;
+        bool bScanned = false;
+        UE::Tasks::FTask ScanTask;
+        int64 MaxBytes = 0;
+        FTimespan MaxAge = FTimespan::Zero();
+        int64 ResidentBytes = 0;
+        int64 Hits = 0;
+        int64 Misses = 0;
+        int64 Stores = 0;
+        int64 Evictions = 0;
+    };
+}
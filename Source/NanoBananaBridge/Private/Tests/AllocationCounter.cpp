@@ -0,0 +1,94 @@
+#include "AllocationCounter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HAL/MemoryBase.h"
+#include "HAL/UnrealMemory.h"
+
+#include <atomic>
+
+namespace NanoBanana::Tests
+{
+    namespace
+    {
+        /**
+         * Forwards everything to the allocator it replaced. It lives in static storage and is
+         * never destroyed: other threads may still be inside a call when GMalloc is restored.
+         */
+        class FCountingMalloc final : public FMalloc
+        {
+        public:
+            /** Left set after uninstall so late callers still reach the real allocator. */
+            FMalloc* Inner = nullptr;
+            bool bInstalled = false;
+            std::atomic<SIZE_T> LargeThreshold { 0 };
+            std::atomic<int64> NumAllocations { 0 };
+            std::atomic<int64> NumLarge { 0 };
+            std::atomic<int64> LargeBytes { 0 };
+
+            void Count(SIZE_T Size)
+            {
+                NumAllocations.fetch_add(1, std::memory_order_relaxed);
+                if (Size >= LargeThreshold.load(std::memory_order_relaxed))
+                {
+                    NumLarge.fetch_add(1, std::memory_order_relaxed);
+                    LargeBytes.fetch_add((int64)Size, std::memory_order_relaxed);
+                }
+            }
+
+            virtual void* Malloc(SIZE_T Size, uint32 Alignment) override { Count(Size); return Inner->Malloc(Size, Alignment); }
+            virtual void* TryMalloc(SIZE_T Size, uint32 Alignment) override { Count(Size); return Inner->TryMalloc(Size, Alignment); }
+            virtual void* Realloc(void* Ptr, SIZE_T NewSize, uint32 Alignment) override { Count(NewSize); return Inner->Realloc(Ptr, NewSize, Alignment); }
+            virtual void* TryRealloc(void* Ptr, SIZE_T NewSize, uint32 Alignment) override { Count(NewSize); return Inner->TryRealloc(Ptr, NewSize, Alignment); }
+            virtual void Free(void* Ptr) override { Inner->Free(Ptr); }
+            virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+            virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+            virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+            virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+            virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+            virtual void UpdateStats() override { Inner->UpdateStats(); }
+            virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+            virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+            virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+            virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+            virtual const TCHAR* GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+        };
+
+        static FCountingMalloc& GetCountingMalloc()
+        {
+            static FCountingMalloc* Instance = new FCountingMalloc(); // intentionally leaked, see above
+            return *Instance;
+        }
+    }
+
+    FScopedAllocationCounter::FScopedAllocationCounter(SIZE_T LargeThreshold)
+    {
+        FCountingMalloc& Counter = GetCountingMalloc();
+        check(IsInGameThread() && !Counter.bInstalled);
+        Counter.LargeThreshold = FMath::Max<SIZE_T>(1, LargeThreshold);
+        Counter.NumAllocations = 0;
+        Counter.NumLarge = 0;
+        Counter.LargeBytes = 0;
+        Counter.Inner = GMalloc;
+        Counter.bInstalled = true;
+        GMalloc = &Counter;
+
+        // Probe: some builds call a fixed allocator class directly and never see the swap.
+        FMemory::Free(FMemory::Malloc(16));
+        bActive = Counter.NumAllocations.load() > 0;
+        Counter.NumAllocations = 0;
+    }
+
+    FScopedAllocationCounter::~FScopedAllocationCounter()
+    {
+        FCountingMalloc& Counter = GetCountingMalloc();
+        GMalloc = Counter.Inner;
+        Counter.bInstalled = false;
+    }
+
+    int64 FScopedAllocationCounter::GetNumAllocations() const { return GetCountingMalloc().NumAllocations.load(); }
+    int64 FScopedAllocationCounter::GetNumLargeAllocations() const { return GetCountingMalloc().NumLarge.load(); }
+    int64 FScopedAllocationCounter::GetLargeBytes() const { return GetCountingMalloc().LargeBytes.load(); }
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
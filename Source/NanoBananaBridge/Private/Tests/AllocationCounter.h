@@ -0,0 +1,31 @@
+// Test-only allocation counter: while in scope, every heap allocation in the process goes
+// through a forwarding FMalloc that counts calls, and separately counts "large" ones, which
+// is how a test observes whole-buffer copies of a multi-megabyte payload.
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace NanoBanana::Tests
+{
+    class FScopedAllocationCounter
+    {
+    public:
+        /** Allocations (and reallocations) of at least LargeThreshold bytes are counted as large. */
+        explicit FScopedAllocationCounter(SIZE_T LargeThreshold);
+        ~FScopedAllocationCounter();
+
+        /** False if this build routes allocations around GMalloc (e.g. a fixed allocator class); counts are then meaningless. */
+        bool IsActive() const { return bActive; }
+
+        int64 GetNumAllocations() const;
+        int64 GetNumLargeAllocations() const;
+        int64 GetLargeBytes() const;
+
+    private:
+        bool bActive = false;
+    };
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,198 @@
+// Tests for the vectorized base64 codec: every kernel the CPU supports must match FBase64
+// byte-for-byte, reject malformed input, and report its throughput.
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Base64.h"
+#include "Math/RandomStream.h"
+#include "HAL/PlatformTime.h"
+
+#include "Http/Base64Codec.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    using NanoBanana::Base64::EKernel;
+
+    const EKernel AllKernels[] = {EKernel::Scalar, EKernel::SSE, EKernel::AVX2, EKernel::NEON};
+
+    static TArray<uint8> MakeRandomBytes(int32 Num, int32 Seed)
+    {
+        FRandomStream Rng(Seed);
+        TArray<uint8> Bytes;
+        Bytes.SetNumUninitialized(Num);
+        for (uint8& B : Bytes)
+        {
+            B = (uint8)Rng.RandHelper(256);
+        }
+        return Bytes;
+    }
+
+    static FString EncodeWith(EKernel Kernel, const TArray<uint8>& Bytes)
+    {
+        TArray<ANSICHAR> Ascii;
+        Ascii.SetNumUninitialized(NanoBanana::Base64::GetEncodedSize(Bytes.Num()));
+        NanoBanana::Base64::Encode(Bytes.GetData(), Bytes.Num(), Ascii.GetData(), Kernel);
+        return FString(Ascii.Num(), Ascii.GetData());
+    }
+
+    static bool DecodeWith(EKernel Kernel, const FString& Encoded, TArray<uint8>& Out)
+    {
+        const FTCHARToUTF8 Ascii(*Encoded);
+        Out.SetNumUninitialized(NanoBanana::Base64::GetMaxDecodedSize(Ascii.Length()));
+        const int64 Written = NanoBanana::Base64::Decode(Ascii.Get(), Ascii.Length(), Out.GetData(), Kernel);
+        if (Written == INDEX_NONE)
+        {
+            return false;
+        }
+        Out.SetNum(Written);
+        return true;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBase64Codec_MatchesFBase64_Test,
+    "UnrealBanana.Http.Base64Codec.MatchesFBase64",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FBase64Codec_MatchesFBase64_Test::RunTest(const FString&)
+{
+    // Every length up to a few vector widths exercises each kernel's block/tail boundary.
+    TArray<int32> Lengths;
+    for (int32 N = 0; N <= 200; ++N) Lengths.Add(N);
+    Lengths.Append({1023, 1024, 1025, 4095, 4096, 4097, 65536 + 7});
+
+    for (const EKernel Kernel : AllKernels)
+    {
+        if (!NanoBanana::Base64::IsKernelSupported(Kernel))
+        {
+            AddInfo(FString::Printf(TEXT("%s not supported on this CPU, skipped"), NanoBanana::Base64::LexToString(Kernel)));
+            continue;
+        }
+        for (const int32 N : Lengths)
+        {
+            const TArray<uint8> Bytes = MakeRandomBytes(N, N * 31 + 7);
+            const FString Expected = FBase64::Encode(Bytes);
+            const FString Encoded = EncodeWith(Kernel, Bytes);
+            if (!TestEqual(FString::Printf(TEXT("%s encode, %d bytes"), NanoBanana::Base64::LexToString(Kernel), N), Encoded, Expected))
+            {
+                return false;
+            }
+
+            TArray<uint8> Decoded;
+            const bool bDecoded = DecodeWith(Kernel, Expected, Decoded);
+            if (!TestTrue(FString::Printf(TEXT("%s decode, %d bytes"), NanoBanana::Base64::LexToString(Kernel), N), bDecoded && Decoded == Bytes))
+            {
+                return false;
+            }
+        }
+    }
+
+    // FString overload (used by the response scanner) goes through the chunked narrowing path.
+    const TArray<uint8> Large = MakeRandomBytes(100 * 1024 + 1, 99);
+    TArray<uint8> Decoded;
+    TestTrue(TEXT("FStringView decode"), NanoBanana::Base64::Decode(FBase64::Encode(Large), Decoded) && Decoded == Large);
+    TestEqual(TEXT("FString encode"), NanoBanana::Base64::Encode(Large), FBase64::Encode(Large));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBase64Codec_RejectsMalformed_Test,
+    "UnrealBanana.Http.Base64Codec.RejectsMalformed",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FBase64Codec_RejectsMalformed_Test::RunTest(const FString&)
+{
+    const FString Valid = FBase64::Encode(MakeRandomBytes(300, 5)); // 400 chars, no padding
+    const TCHAR BadChars[] = {TEXT('!'), TEXT('-'), TEXT('_'), TEXT(' '), TEXT('\n'), TEXT('='), TEXT('\x7f')};
+
+    for (const EKernel Kernel : AllKernels)
+    {
+        if (!NanoBanana::Base64::IsKernelSupported(Kernel)) continue;
+
+        // Corrupt positions inside vector blocks and inside the scalar tail.
+        for (const int32 Pos : {0, 5, 17, 40, 63, 100, 250, 399})
+        {
+            for (const TCHAR Bad : BadChars)
+            {
+                if (Bad == TEXT('=') && Pos >= Valid.Len() - 2) continue; // becomes legal padding
+                FString Corrupt = Valid;
+                Corrupt[Pos] = Bad;
+                TArray<uint8> Out;
+                TestFalse(FString::Printf(TEXT("%s rejects 0x%02x at %d"), NanoBanana::Base64::LexToString(Kernel), (int32)Bad, Pos),
+                    DecodeWith(Kernel, Corrupt, Out));
+            }
+        }
+
+        TArray<uint8> Out;
+        TestFalse(TEXT("length % 4 == 1"), DecodeWith(Kernel, Valid.Left(Valid.Len() - 3), Out));
+        TestFalse(TEXT("padding on a short quad"), DecodeWith(Kernel, TEXT("QUJD="), Out));
+    }
+
+    TArray<uint8> Out;
+    FString NonAscii = Valid;
+    NonAscii[123] = TEXT('é');
+    TestFalse(TEXT("FStringView rejects non-ASCII"), NanoBanana::Base64::Decode(NonAscii, Out));
+    TestTrue(TEXT("unpadded input accepted"), NanoBanana::Base64::Decode(FStringView(TEXT("QUI")), Out) && Out.Num() == 2 && Out[0] == 'A' && Out[1] == 'B');
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBase64Codec_Benchmark_Test,
+    "UnrealBanana.Http.Base64Codec.Benchmark",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FBase64Codec_Benchmark_Test::RunTest(const FString&)
+{
+    // Roughly one 4K Gemini result: 16 MB of image bytes, ~21 MB of base64.
+    constexpr int32 NumBytes = 16 * 1024 * 1024;
+    constexpr int32 Iterations = 4;
+    const TArray<uint8> Bytes = MakeRandomBytes(NumBytes, 1234);
+
+    TArray<ANSICHAR> Ascii;
+    Ascii.SetNumUninitialized(NanoBanana::Base64::GetEncodedSize(NumBytes));
+    TArray<uint8> Decoded;
+    Decoded.SetNumUninitialized(NanoBanana::Base64::GetMaxDecodedSize(Ascii.Num()));
+
+    auto GBps = [](double Bytes, double Seconds) { return Seconds > 0.0 ? Bytes / Seconds / 1e9 : 0.0; };
+
+    // FBase64 baseline.
+    {
+        double EncodeSeconds = 0.0, DecodeSeconds = 0.0;
+        FString Encoded;
+        TArray<uint8> Out;
+        for (int32 i = 0; i < Iterations; ++i)
+        {
+            const double T0 = FPlatformTime::Seconds();
+            Encoded = FBase64::Encode(Bytes);
+            const double T1 = FPlatformTime::Seconds();
+            FBase64::Decode(Encoded, Out);
+            const double T2 = FPlatformTime::Seconds();
+            EncodeSeconds += T1 - T0;
+            DecodeSeconds += T2 - T1;
+        }
+        AddInfo(FString::Printf(TEXT("FBase64: encode %.2f GB/s, decode %.2f GB/s"),
+            GBps((double)NumBytes * Iterations, EncodeSeconds), GBps((double)Ascii.Num() * Iterations, DecodeSeconds)));
+    }
+
+    for (const EKernel Kernel : AllKernels)
+    {
+        if (!NanoBanana::Base64::IsKernelSupported(Kernel)) continue;
+
+        double EncodeSeconds = 0.0, DecodeSeconds = 0.0;
+        bool bRoundTrip = true;
+        for (int32 i = 0; i < Iterations; ++i)
+        {
+            const double T0 = FPlatformTime::Seconds();
+            NanoBanana::Base64::Encode(Bytes.GetData(), NumBytes, Ascii.GetData(), Kernel);
+            const double T1 = FPlatformTime::Seconds();
+            const int64 Written = NanoBanana::Base64::Decode(Ascii.GetData(), Ascii.Num(), Decoded.GetData(), Kernel);
+            const double T2 = FPlatformTime::Seconds();
+            EncodeSeconds += T1 - T0;
+            DecodeSeconds += T2 - T1;
+            bRoundTrip &= (Written == NumBytes) && FMemory::Memcmp(Decoded.GetData(), Bytes.GetData(), NumBytes) == 0;
+        }
+        TestTrue(FString::Printf(TEXT("%s round-trips"), NanoBanana::Base64::LexToString(Kernel)), bRoundTrip);
+        AddInfo(FString::Printf(TEXT("%s%s: encode %.2f GB/s, decode %.2f GB/s"),
+            NanoBanana::Base64::LexToString(Kernel),
+            Kernel == NanoBanana::Base64::GetActiveKernel() ? TEXT(" (active)") : TEXT(""),
+            GBps((double)NumBytes * Iterations, EncodeSeconds), GBps((double)Ascii.Num() * Iterations, DecodeSeconds)));
+    }
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,111 @@
+// Batch generation run end to end against a stand-in Gemini endpoint (bounded concurrency,
+// input-order results, isolated failures).
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Engine/World.h"
+
+#include "NanoBananaSettings.h"
+#include "NanoBananaBatchAsyncAction.h"
+#include "Http/Base64Codec.h"
+#include "Tests/FakeHttpServer.h"
+#include "Tests/TestHelpers.h"
+
+#include <atomic>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBatchGenerate_EndToEnd_Test,
+    "UnrealBanana.Batch.EndToEnd",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FBatchGenerate_EndToEnd_Test::RunTest(const FString&)
+{
+    using namespace NanoBanana::Tests;
+
+    constexpr int32 NumItems = 6;
+    constexpr int32 FailingItem = 2;
+    constexpr double ResponseSeconds = 0.5;
+    TArray<TArray<uint8>> Pngs;
+    TArray<FString> Bodies;
+    for (int32 i = 0; i < NumItems; ++i)
+    {
+        Pngs.Add(MakeSolidPng((uint8)(40 * i)));
+        Bodies.Add(FString::Printf(TEXT("{\"candidates\":[{\"content\":{\"role\":\"model\",\"parts\":[{\"inlineData\":{\"mimeType\":\"image/png\",\"data\":\"%s\"}}]}}]}"),
+            *NanoBanana::Base64::Encode(Pngs[i])));
+    }
+
+    // Every item takes ResponseSeconds; the server tracks how many overlap.
+    TSharedRef<std::atomic<int32>> Active = MakeShared<std::atomic<int32>>(0);
+    TSharedRef<std::atomic<int32>> PeakActive = MakeShared<std::atomic<int32>>(0);
+    FFakeHttpServer Server;
+    Server.On(TEXT("POST"), TEXT("/models/"), [Bodies, Active, PeakActive, ResponseSeconds](const FFakeHttpServer::FRequest& Req)
+    {
+        const int32 Now = ++*Active;
+        int32 Peak = PeakActive->load();
+        while (Now > Peak && !PeakActive->compare_exchange_weak(Peak, Now)) {}
+        FPlatformProcess::Sleep((float)ResponseSeconds);
+        --*Active;
+
+        const FString Body(FUTF8ToTCHAR((const ANSICHAR*)Req.Body.GetData(), Req.Body.Num()));
+        for (int32 i = 0; i < Bodies.Num(); ++i)
+        {
+            if (!Body.Contains(FString::Printf(TEXT("batch item %d."), i))) continue;
+            return i == FailingItem
+                ? FFakeHttpServer::FResponse::Json(TEXT("{\"error\":{\"code\":500,\"message\":\"scripted\"}}"), 500)
+                : FFakeHttpServer::FResponse::Json(Bodies[i]);
+        }
+        return FFakeHttpServer::FResponse::Json(TEXT("{\"error\":{\"message\":\"unknown item\"}}"), 400);
+    });
+    if (!TestTrue(TEXT("stand-in server listening"), Server.Start())) return false;
+    FScopedGoogleStandIn StandIn(Server.GetBaseUrl(), FPaths::AutomationTransientDir() / TEXT("NanoBananaBatch"));
+    TGuardValue<int32> RequestCap(GetMutableDefault<UNanoBananaSettings>()->MaxConcurrentRequestsPerVendor, 8);
+
+    TArray<FNanoBananaRequest> Requests;
+    for (int32 i = 0; i < NumItems; ++i)
+    {
+        FNanoBananaRequest Request;
+        Request.Vendor = ENanoBananaVendor::Google;
+        Request.Model = ENanoBananaModel::NanoBanana2;
+        Request.Prompt = FString::Printf(TEXT("batch item %d."), i);
+        Requests.Add(Request);
+    }
+
+    constexpr int32 MaxConcurrency = 3;
+    UNanoBananaBatchAsyncAction* Batch = UNanoBananaBatchAsyncAction::BatchGenerateImages(GWorld, Requests, MaxConcurrency);
+    Batch->AddToRoot();
+
+    const double Start = FPlatformTime::Seconds();
+    static_cast<UBlueprintAsyncActionBase*>(Batch)->Activate();
+    PumpUntil([Batch]() { return Batch->IsFinished(); }, 20.0);
+    const double Seconds = FPlatformTime::Seconds() - Start;
+
+    TestTrue(TEXT("batch finished"), Batch->IsFinished());
+    if (Batch->IsFinished())
+    {
+        const TArray<FNanoBananaBatchItemResult>& Results = Batch->GetResults();
+        TestEqual(TEXT("one result per request"), Results.Num(), NumItems);
+        for (int32 i = 0; i < Results.Num(); ++i)
+        {
+            const FNanoBananaBatchItemResult& R = Results[i];
+            if (i == FailingItem)
+            {
+                TestFalse(TEXT("the failing item failed"), R.bSucceeded);
+                TestTrue(FString::Printf(TEXT("failure carries the vendor error (%s)"), *R.Error), R.Error.Contains(TEXT("500")));
+                continue;
+            }
+            TestTrue(FString::Printf(TEXT("item %d succeeded (%s)"), i, *R.Error), R.bSucceeded);
+            TestTrue(FString::Printf(TEXT("item %d holds its own image (input order)"), i), R.Images.Num() == 1 && R.Images[0].PngBytes == Pngs[i]);
+        }
+    }
+    TestTrue(FString::Printf(TEXT("at most %d requests in flight (saw %d)"), MaxConcurrency, PeakActive->load()), PeakActive->load() <= MaxConcurrency);
+    TestTrue(FString::Printf(TEXT("concurrency actually used (saw %d)"), PeakActive->load()), PeakActive->load() >= 2);
+    // Sequential would be NumItems * ResponseSeconds (3 s); two waves of three is ~1 s.
+    TestTrue(FString::Printf(TEXT("items overlap (%.2f s)"), Seconds), Seconds < NumItems * ResponseSeconds * 0.75);
+
+    Batch->RemoveFromRoot();
+    return true;
+}
+
+#endif
@@ -0,0 +1,154 @@
+// DerivedDataCache-backed result cache: a record stored through the local filesystem DDC is found
+// again with its images and metadata; then a seeded GenerateImage answered from the DDC alone.
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Guid.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeExit.h"
+
+#include "NanoBananaSettings.h"
+#include "DerivedDataResultCache.h"
+#include "Http/Base64Codec.h"
+#include "Tests/FakeHttpServer.h"
+#include "Tests/TestHelpers.h"
+
+#include <atomic>
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+namespace
+{
+    using namespace NanoBanana::Tests;
+
+    /** What the cache answered; shared with its callbacks, which run off the game thread. */
+    struct FCacheReply
+    {
+        std::atomic<bool> bDone { false };
+        bool bOk = false;
+        TArray<TArray<uint8>> Images;
+        NanoBanana::FResultMetadata Metadata;
+    };
+
+    /** A key no earlier run can have stored. */
+    static uint64 MakeUniqueFingerprint()
+    {
+        const FGuid Guid = FGuid::NewGuid();
+        return ((uint64)Guid.A << 32 | Guid.B) ^ ((uint64)Guid.C << 32 | Guid.D);
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDerivedDataResultCache_RoundTrip_Test,
+    "UnrealBanana.SharedResultCache.RoundTrip",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FDerivedDataResultCache_RoundTrip_Test::RunTest(const FString&)
+{
+    using namespace NanoBanana;
+    const uint64 Key = MakeUniqueFingerprint();
+    FNanoBananaRequest Request;
+    Request.Prompt = TEXT("shared portrait");
+    Request.Seed = 42;
+    const FResultMetadata Metadata = FResultMetadata::Describe(Request);
+
+    TArray<FNanoBananaImageResult> Results;
+    Results.SetNum(2);
+    Results[0].PngBytes = MakeSolidPng(10);
+    Results[1].PngBytes = MakeSolidPng(200);
+
+    // Local-only: exercises the machine's filesystem DDC without touching a shared one.
+    FDerivedDataResultCache Writer(/*bLocalOnly*/ true);
+    TSharedRef<FCacheReply, ESPMode::ThreadSafe> Miss = MakeShared<FCacheReply, ESPMode::ThreadSafe>();
+    Writer.Load(Key, [Miss](bool bFound, TArray<TArray<uint8>>, FResultMetadata)
+    {
+        Miss->bOk = bFound;
+        Miss->bDone = true;
+    });
+    TestTrue(TEXT("lookup answers"), PumpUntil([Miss]() { return Miss->bDone.load(); }));
+    TestFalse(TEXT("unknown key misses"), Miss->bOk);
+
+    TSharedRef<FCacheReply, ESPMode::ThreadSafe> Stored = MakeShared<FCacheReply, ESPMode::ThreadSafe>();
+    Writer.Store(Key, Results, Metadata, [Stored](bool bOk)
+    {
+        Stored->bOk = bOk;
+        Stored->bDone = true;
+    });
+    TestTrue(TEXT("store answers"), PumpUntil([Stored]() { return Stored->bDone.load(); }));
+    TestTrue(TEXT("stored"), Stored->bOk);
+
+    // A separate instance stands in for another editor reading the same store.
+    FDerivedDataResultCache Reader(/*bLocalOnly*/ true);
+    TSharedRef<FCacheReply, ESPMode::ThreadSafe> Hit = MakeShared<FCacheReply, ESPMode::ThreadSafe>();
+    Reader.Load(Key, [Hit](bool bFound, TArray<TArray<uint8>> InImages, FResultMetadata InMetadata)
+    {
+        Hit->bOk = bFound;
+        Hit->Images = MoveTemp(InImages);
+        Hit->Metadata = MoveTemp(InMetadata);
+        Hit->bDone = true;
+    });
+    TestTrue(TEXT("lookup answers"), PumpUntil([Hit]() { return Hit->bDone.load(); }));
+    TestTrue(TEXT("stored key hits"), Hit->bOk);
+    const TArray<TArray<uint8>>& Images = Hit->Images;
+    const FResultMetadata& Loaded = Hit->Metadata;
+    TestTrue(TEXT("every image comes back in order"), Images.Num() == 2 && Images[0] == Results[0].PngBytes && Images[1] == Results[1].PngBytes);
+    TestEqual(TEXT("ext"), Loaded.Ext, Metadata.Ext);
+    TestEqual(TEXT("prompt"), Loaded.Prompt, Metadata.Prompt);
+    TestEqual(TEXT("seed"), Loaded.Seed, 42);
+    TestEqual(TEXT("created by"), Loaded.CreatedBy, Metadata.CreatedBy);
+
+    TestEqual(TEXT("writer counted one miss and one store"), Writer.GetStats().Misses + Writer.GetStats().Stores, (int64)2);
+    TestEqual(TEXT("reader counted one hit"), Reader.GetStats().Hits, (int64)1);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDerivedDataResultCache_EndToEnd_Test,
+    "UnrealBanana.SharedResultCache.EndToEnd",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FDerivedDataResultCache_EndToEnd_Test::RunTest(const FString&)
+{
+    using NanoBanana::FDerivedDataResultCache;
+    const TArray<uint8> Png = MakeSolidPng(60);
+    const FString Body = FString::Printf(TEXT("{\"candidates\":[{\"content\":{\"role\":\"model\",\"parts\":[{\"inlineData\":{\"mimeType\":\"image/png\",\"data\":\"%s\"}}]}}]}"),
+        *NanoBanana::Base64::Encode(Png));
+
+    FFakeHttpServer Server;
+    Server.On(TEXT("POST"), TEXT("/models/"), [Body](const FFakeHttpServer::FRequest&)
+    {
+        return FFakeHttpServer::FResponse::Json(Body);
+    });
+    if (!TestTrue(TEXT("stand-in server listening"), Server.Start())) return false;
+
+    // Only the DerivedDataCache tier.
+    FScopedGoogleStandIn StandIn(Server.GetBaseUrl(), FPaths::AutomationTransientDir() / TEXT("NanoBananaSharedCache"));
+    TGuardValue<int32> LocalCacheOff(GetMutableDefault<UNanoBananaSettings>()->ResultCacheMaxMegabytes, 0);
+    TGuardValue<bool> ShareOn(GetMutableDefault<UNanoBananaSettings>()->bShareResultsThroughDerivedDataCache, true);
+    FNanoBananaRequest Request;
+    Request.Vendor = ENanoBananaVendor::Google;
+    Request.Model = ENanoBananaModel::NanoBanana2;
+    Request.Prompt = FString::Printf(TEXT("shared portrait %s"), *FGuid::NewGuid().ToString());
+    Request.Seed = 5;
+
+    // The action goes through the process-wide instance; keep its records on this machine.
+    FDerivedDataResultCache& Cache = FDerivedDataResultCache::Get();
+    const bool bWasLocalOnly = Cache.IsLocalOnly();
+    ON_SCOPE_EXIT { Cache.SetLocalOnly(bWasLocalOnly); };
+    Cache.SetLocalOnly(true);
+    const int64 StoresBefore = Cache.GetStats().Stores;
+    TestTrue(TEXT("first run generates"), RunGenerateImage(Request)->FirstImage() == Png);
+    TestEqual(TEXT("first run calls the vendor"), Server.CountRequests(TEXT("POST"), TEXT("/models/")), 1);
+
+    // The put is fire-and-forget; wait for it like a teammate starting a little later would.
+    PumpUntil([&Cache, StoresBefore]() { return Cache.GetStats().Stores != StoresBefore; });
+    TestEqual(TEXT("result shared"), Cache.GetStats().Stores - StoresBefore, (int64)1);
+
+    const int64 HitsBefore = Cache.GetStats().Hits;
+    TestTrue(TEXT("second run returns the same image"), RunGenerateImage(Request)->FirstImage() == Png);
+    TestEqual(TEXT("second run is answered by the DerivedDataCache"), Server.CountRequests(TEXT("POST"), TEXT("/models/")), 1);
+    TestEqual(TEXT("hit counted"), Cache.GetStats().Hits - HitsBefore, (int64)1);
+    TestEqual(TEXT("a shared hit is not stored again"), Cache.GetStats().Stores - StoresBefore, (int64)1);
+
+    Request.CachePolicy = ENanoBananaCachePolicy::Bypass;
+    TestTrue(TEXT("bypass completes"), RunGenerateImage(Request)->FirstImage() == Png);
+    TestEqual(TEXT("bypass calls the vendor"), Server.CountRequests(TEXT("POST"), TEXT("/models/")), 2);
+    return true;
+}
+
+#endif
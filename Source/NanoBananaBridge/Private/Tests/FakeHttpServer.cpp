@@ -0,0 +1,287 @@
+#include "FakeHttpServer.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Async/Async.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/ScopeLock.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "IPAddress.h"
+
+namespace NanoBanana::Tests
+{
+    namespace
+    {
+        static const TCHAR* ReasonPhrase(int32 Code)
+        {
+            switch (Code)
+            {
+            case 200: return TEXT("OK");
+            case 201: return TEXT("Created");
+            case 202: return TEXT("Accepted");
+            case 400: return TEXT("Bad Request");
+            case 401: return TEXT("Unauthorized");
+            case 404: return TEXT("Not Found");
+            case 429: return TEXT("Too Many Requests");
+            case 500: return TEXT("Internal Server Error");
+            case 503: return TEXT("Service Unavailable");
+            default:  return TEXT("Status");
+            }
+        }
+    }
+
+    FFakeHttpServer::FResponse FFakeHttpServer::FResponse::Json(const FString& Text, int32 InCode)
+    {
+        FResponse R;
+        R.Code = InCode;
+        const FTCHARToUTF8 Utf8(*Text, Text.Len());
+        R.Body.Append((const uint8*)Utf8.Get(), Utf8.Length());
+        return R;
+    }
+
+    FFakeHttpServer::FResponse FFakeHttpServer::FResponse::Bytes(TArray<uint8> InBody, const FString& InContentType)
+    {
+        FResponse R;
+        R.Body = MoveTemp(InBody);
+        R.ContentType = InContentType;
+        return R;
+    }
+
+    FFakeHttpServer::FResponse FFakeHttpServer::FResponse::EventStream(const TArray<TPair<double, FString>>& Events)
+    {
+        FResponse R;
+        R.ContentType = TEXT("text/event-stream");
+        for (const TPair<double, FString>& Event : Events)
+        {
+            const FString Text = FString::Printf(TEXT("data: %s\r\n\r\n"), *Event.Value);
+            const FTCHARToUTF8 Utf8(*Text, Text.Len());
+            FChunk& Chunk = R.Chunks.AddDefaulted_GetRef();
+            Chunk.DelaySeconds = Event.Key;
+            Chunk.Bytes.Append((const uint8*)Utf8.Get(), Utf8.Length());
+        }
+        return R;
+    }
+
+    FFakeHttpServer::FFakeHttpServer() = default;
+
+    FFakeHttpServer::~FFakeHttpServer()
+    {
+        Stop();
+        if (Thread)
+        {
+            Thread->WaitForCompletion();
+            delete Thread;
+        }
+        TArray<TFuture<void>> Pending;
+        {
+            FScopeLock Guard(&Lock);
+            Pending = MoveTemp(Connections);
+        }
+        for (TFuture<void>& Connection : Pending)
+        {
+            Connection.Wait();
+        }
+        if (Listener)
+        {
+            Listener->Close();
+            ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Listener);
+        }
+    }
+
+    void FFakeHttpServer::On(const FString& Method, const FString& PathPrefix, FHandler Handler)
+    {
+        Routes.Add({ Method, PathPrefix, MoveTemp(Handler) });
+    }
+
+    bool FFakeHttpServer::Start()
+    {
+        ISocketSubsystem* Sockets = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+        if (!Sockets) return false;
+
+        Listener = Sockets->CreateSocket(NAME_Stream, TEXT("NanoBanana fake HTTP server"), false);
+        if (!Listener) return false;
+
+        TSharedRef<FInternetAddr> Addr = Sockets->CreateInternetAddr();
+        Addr->SetLoopbackAddress();
+        Addr->SetPort(0);
+        if (!Listener->Bind(*Addr) || !Listener->Listen(16)) return false;
+        Listener->GetAddress(*Addr);
+        Port = Addr->GetPort();
+
+        Thread = FRunnableThread::Create(this, TEXT("NanoBananaFakeHttpServer"));
+        return Thread != nullptr;
+    }
+
+    FString FFakeHttpServer::GetBaseUrl() const
+    {
+        return FString::Printf(TEXT("http://127.0.0.1:%d"), Port);
+    }
+
+    TArray<FFakeHttpServer::FRequest> FFakeHttpServer::GetRequests() const
+    {
+        FScopeLock Guard(&Lock);
+        return Log;
+    }
+
+    int32 FFakeHttpServer::CountRequests(const FString& Method, const FString& PathPrefix) const
+    {
+        FScopeLock Guard(&Lock);
+        int32 Count = 0;
+        for (const FRequest& Request : Log)
+        {
+            if (Request.Method == Method && Request.Path.StartsWith(PathPrefix, ESearchCase::CaseSensitive)) ++Count;
+        }
+        return Count;
+    }
+
+    uint32 FFakeHttpServer::Run()
+    {
+        while (!bStopping)
+        {
+            bool bPending = false;
+            Listener->WaitForPendingConnection(bPending, FTimespan::FromMilliseconds(20));
+            if (!bPending) continue;
+
+            FSocket* Conn = Listener->Accept(TEXT("NanoBanana fake HTTP connection"));
+            if (!Conn) continue;
+            FScopeLock Guard(&Lock);
+            Connections.Add(Async(EAsyncExecution::Thread, [this, Conn]() { ServeConnection(Conn); }));
+        }
+        return 0;
+    }
+
+    bool FFakeHttpServer::SendAll(FSocket& Socket, const uint8* Data, int32 Num)
+    {
+        while (Num > 0 && !bStopping)
+        {
+            int32 Sent = 0;
+            if (!Socket.Send(Data, Num, Sent)) return false;
+            Data += Sent;
+            Num -= Sent;
+        }
+        return Num == 0;
+    }
+
+    bool FFakeHttpServer::ReadRequest(FSocket& Conn, FRequest& Out)
+    {
+        // Headers first, answering Expect: 100-continue; then drain the body by Content-Length.
+        TArray<uint8> Head;
+        int32 HeaderEnd = INDEX_NONE;
+        int64 ContentLength = 0;
+        uint8 Buffer[16 * 1024];
+        while (!bStopping && HeaderEnd == INDEX_NONE)
+        {
+            if (!Conn.Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromSeconds(5.0))) return false;
+            int32 Read = 0;
+            if (!Conn.Recv(Buffer, sizeof(Buffer), Read) || Read == 0) return false;
+            const int32 SearchFrom = FMath::Max(0, Head.Num() - 3);
+            Head.Append(Buffer, Read);
+            for (int32 i = SearchFrom; i + 3 < Head.Num(); ++i)
+            {
+                if (FMemory::Memcmp(&Head[i], "\r\n\r\n", 4) == 0) { HeaderEnd = i + 4; break; }
+            }
+        }
+        if (HeaderEnd == INDEX_NONE) return false;
+
+        const FString HeaderText(HeaderEnd - 4, (const ANSICHAR*)Head.GetData());
+        TArray<FString> Lines;
+        HeaderText.ParseIntoArrayLines(Lines);
+        if (Lines.Num() == 0) return false;
+
+        TArray<FString> RequestLine;
+        Lines[0].ParseIntoArrayWS(RequestLine);
+        if (RequestLine.Num() < 2) return false;
+        Out.Method = RequestLine[0];
+        Out.Path = RequestLine[1];
+
+        bool bExpectContinue = false;
+        for (int32 i = 1; i < Lines.Num(); ++i)
+        {
+            FString Name, Value;
+            if (!Lines[i].Split(TEXT(":"), &Name, &Value)) continue;
+            Name.ToLowerInline();
+            Value.TrimStartAndEndInline();
+            if (Name == TEXT("content-length")) LexFromString(ContentLength, *Value);
+            if (Name == TEXT("expect") && Value.Equals(TEXT("100-continue"), ESearchCase::IgnoreCase)) bExpectContinue = true;
+            Out.Headers.Add(MoveTemp(Name), MoveTemp(Value));
+        }
+        if (bExpectContinue)
+        {
+            static const char Continue[] = "HTTP/1.1 100 Continue\r\n\r\n";
+            SendAll(Conn, (const uint8*)Continue, sizeof(Continue) - 1);
+        }
+
+        auto Keep = [this, &Out](const uint8* Data, int64 Num)
+        {
+            const int64 Room = FMath::Max<int64>(0, MaxKeptBodyBytes - Out.Body.Num());
+            if (Room > 0) Out.Body.Append(Data, (int32)FMath::Min(Room, Num));
+            Out.BodyBytes += Num;
+        };
+        Keep(Head.GetData() + HeaderEnd, Head.Num() - HeaderEnd);
+        while (!bStopping && Out.BodyBytes < ContentLength)
+        {
+            if (!Conn.Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromSeconds(5.0))) return false;
+            int32 Read = 0;
+            if (!Conn.Recv(Buffer, sizeof(Buffer), Read) || Read == 0) return false;
+            Keep(Buffer, Read);
+        }
+        return Out.BodyBytes >= ContentLength;
+    }
+
+    void FFakeHttpServer::ServeConnection(FSocket* Conn)
+    {
+        FRequest Request;
+        if (ReadRequest(*Conn, Request))
+        {
+            const FHandler* Handler = nullptr;
+            for (const FRoute& Route : Routes)
+            {
+                if (Route.Method == Request.Method && Request.Path.StartsWith(Route.PathPrefix, ESearchCase::CaseSensitive))
+                {
+                    Handler = &Route.Handler;
+                    break;
+                }
+            }
+            {
+                FScopeLock Guard(&Lock);
+                Log.Add(Request);
+            }
+
+            FResponse Response = Handler ? (*Handler)(Request) : FResponse::Json(TEXT("{\"error\":\"no route\"}"), 404);
+            if (Response.DelaySeconds > 0.0)
+            {
+                const double Until = FPlatformTime::Seconds() + Response.DelaySeconds;
+                while (!bStopping && FPlatformTime::Seconds() < Until) FPlatformProcess::Sleep(0.005f);
+            }
+
+            FString Header = FString::Printf(TEXT("HTTP/1.1 %d %s\r\nContent-Type: %s\r\nConnection: close\r\n"),
+                Response.Code, ReasonPhrase(Response.Code), *Response.ContentType);
+            if (Response.Chunks.Num() == 0)
+            {
+                Header += FString::Printf(TEXT("Content-Length: %d\r\n"), Response.Body.Num());
+            }
+            for (const TPair<FString, FString>& Extra : Response.Headers)
+            {
+                Header += FString::Printf(TEXT("%s: %s\r\n"), *Extra.Key, *Extra.Value);
+            }
+            Header += TEXT("\r\n");
+            const FTCHARToUTF8 HeaderUtf8(*Header, Header.Len());
+            bool bSent = SendAll(*Conn, (const uint8*)HeaderUtf8.Get(), HeaderUtf8.Length())
+                && SendAll(*Conn, Response.Body.GetData(), Response.Body.Num());
+            for (int32 i = 0; bSent && i < Response.Chunks.Num(); ++i)
+            {
+                const double Until = FPlatformTime::Seconds() + Response.Chunks[i].DelaySeconds;
+                while (!bStopping && FPlatformTime::Seconds() < Until) FPlatformProcess::Sleep(0.005f);
+                bSent = SendAll(*Conn, Response.Chunks[i].Bytes.GetData(), Response.Chunks[i].Bytes.Num());
+            }
+        }
+
+        Conn->Shutdown(ESocketShutdownMode::ReadWrite);
+        Conn->Close();
+        ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Conn);
+    }
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
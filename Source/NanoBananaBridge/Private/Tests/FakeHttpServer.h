@@ -0,0 +1,114 @@
+// Loopback stand-in for vendor REST endpoints, used by automation tests. Routes requests by
+// method and path prefix to scripted handlers, serves each connection on its own thread (so
+// a delayed response does not hold up the others) and keeps a log of what the client sent.
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HAL/Runnable.h"
+#include "HAL/CriticalSection.h"
+#include "Async/Future.h"
+
+#include <atomic>
+
+class FSocket;
+class FRunnableThread;
+
+namespace NanoBanana::Tests
+{
+    class FFakeHttpServer : public FRunnable
+    {
+    public:
+        struct FRequest
+        {
+            FString Method;
+            /** Path including any query string, e.g. "/queue/fal-ai/nano-banana/requests/r1". */
+            FString Path;
+            /** Header names lower-cased. */
+            TMap<FString, FString> Headers;
+            /** First MaxKeptBodyBytes of the body; the rest is counted and dropped. */
+            TArray<uint8> Body;
+            /** Full body length as received. */
+            int64 BodyBytes = 0;
+        };
+
+        struct FResponse
+        {
+            int32 Code = 200;
+            FString ContentType = TEXT("application/json");
+            TArray<uint8> Body;
+            /** Extra response headers, e.g. Retry-After. */
+            TMap<FString, FString> Headers;
+            /** Pause before the response is written. */
+            double DelaySeconds = 0.0;
+
+            struct FChunk
+            {
+                double DelaySeconds = 0.0;
+                TArray<uint8> Bytes;
+            };
+            /**
+             * Written after Body, each after its own pause. A response with chunks has no
+             * Content-Length; closing the connection ends it, the way an event stream does.
+             */
+            TArray<FChunk> Chunks;
+
+            static FResponse Json(const FString& Text, int32 InCode = 200);
+            static FResponse Bytes(TArray<uint8> InBody, const FString& InContentType);
+            /** text/event-stream; each entry is one "data:" event sent after its delay. */
+            static FResponse EventStream(const TArray<TPair<double, FString>>& Events);
+        };
+
+        using FHandler = TFunction<FResponse(const FRequest&)>;
+
+        FFakeHttpServer();
+        virtual ~FFakeHttpServer() override;
+
+        /** Registers a handler; the first route whose method and path prefix match wins. */
+        void On(const FString& Method, const FString& PathPrefix, FHandler Handler);
+
+        /** Binds 127.0.0.1 on an ephemeral port and starts serving. */
+        bool Start();
+
+        /** Base URL to point a provider at, e.g. http://127.0.0.1:54321 */
+        FString GetBaseUrl() const;
+
+        /** Every request received so far, in arrival order. */
+        TArray<FRequest> GetRequests() const;
+
+        /** Number of requests received with this method and path prefix. */
+        int32 CountRequests(const FString& Method, const FString& PathPrefix) const;
+
+        /** Bodies larger than this are counted but not stored, so the server stays out of allocation measurements. */
+        int64 MaxKeptBodyBytes = 64 * 1024;
+
+        virtual uint32 Run() override;
+        virtual void Stop() override { bStopping = true; }
+
+    private:
+        struct FRoute
+        {
+            FString Method;
+            FString PathPrefix;
+            FHandler Handler;
+        };
+
+        void ServeConnection(FSocket* Conn);
+        bool ReadRequest(FSocket& Conn, FRequest& Out);
+        bool SendAll(FSocket& Socket, const uint8* Data, int32 Num);
+
+        TArray<FRoute> Routes;
+        FSocket* Listener = nullptr;
+        FRunnableThread* Thread = nullptr;
+        int32 Port = 0;
+        std::atomic<bool> bStopping { false };
+
+        mutable FCriticalSection Lock;
+        TArray<FRequest> Log;
+        TArray<TFuture<void>> Connections;
+    };
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
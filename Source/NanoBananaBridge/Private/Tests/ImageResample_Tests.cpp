@@ -0,0 +1,156 @@
+// Tests for resolution-aware reference downscaling: fit sizes, filter correctness, and the
+// upload size saved for a typical 4K capture sent to a 1K request.
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "IImageWrapperModule.h"
+#include "Modules/ModuleManager.h"
+
+#include "Http/ImageResample.h"
+#include "Http/ReferencePreparer.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    static TArray<FColor> MakeGradient(int32 W, int32 H)
+    {
+        TArray<FColor> Pixels;
+        Pixels.SetNumUninitialized(W * H);
+        for (int32 Y = 0; Y < H; ++Y)
+        {
+            for (int32 X = 0; X < W; ++X)
+            {
+                Pixels[Y * W + X] = FColor((uint8)(X * 255 / FMath::Max(1, W - 1)), (uint8)(Y * 255 / FMath::Max(1, H - 1)), (uint8)((X + Y) & 0xFF), 255);
+            }
+        }
+        return Pixels;
+    }
+
+    static FLinearColor MeanColor(const TArray<FColor>& Pixels)
+    {
+        double Sum[4] = {0, 0, 0, 0};
+        for (const FColor& C : Pixels)
+        {
+            Sum[0] += C.R; Sum[1] += C.G; Sum[2] += C.B; Sum[3] += C.A;
+        }
+        const double N = FMath::Max(1, Pixels.Num());
+        return FLinearColor(Sum[0] / N, Sum[1] / N, Sum[2] / N, Sum[3] / N);
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FImageResample_FitSize_Test,
+    "UnrealBanana.ImageResample.FitSize",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FImageResample_FitSize_Test::RunTest(const FString&)
+{
+    using NanoBanana::Image::ComputeFitSize;
+    TestEqual(TEXT("16:9 4K -> 1K keeps aspect"), ComputeFitSize(FIntPoint(4096, 2304), 1024), FIntPoint(1024, 576));
+    TestEqual(TEXT("portrait"), ComputeFitSize(FIntPoint(1080, 1920), 1024), FIntPoint(576, 1024));
+    TestEqual(TEXT("already fits"), ComputeFitSize(FIntPoint(800, 600), 1024), FIntPoint(800, 600));
+    TestEqual(TEXT("never upscales"), ComputeFitSize(FIntPoint(512, 512), 4096), FIntPoint(512, 512));
+    TestEqual(TEXT("0 = original"), ComputeFitSize(FIntPoint(4096, 4096), 0), FIntPoint(4096, 4096));
+    TestEqual(TEXT("thin strip keeps 1px"), ComputeFitSize(FIntPoint(8192, 2), 1024), FIntPoint(1024, 1));
+
+    FNanoBananaRequest Request;
+    Request.Resolution = ENanoBananaResolution::Res1K;
+    Request.ReferenceScaling = ENanoBananaReferenceScaling::FitToResolution;
+    TestEqual(TEXT("request opt-in uses resolution"), NanoBanana::Image::GetReferenceMaxDimension(Request), 1024);
+    Request.ReferenceScaling = ENanoBananaReferenceScaling::Original;
+    TestEqual(TEXT("request opt-out"), NanoBanana::Image::GetReferenceMaxDimension(Request), 0);
+    Request.ReferenceScaling = ENanoBananaReferenceScaling::FitToResolution;
+    Request.Resolution = ENanoBananaResolution::Auto;
+    TestEqual(TEXT("Auto resolution never downscales"), NanoBanana::Image::GetReferenceMaxDimension(Request), 0);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FImageResample_Filter_Test,
+    "UnrealBanana.ImageResample.Filter",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FImageResample_Filter_Test::RunTest(const FString&)
+{
+    using namespace NanoBanana::Image;
+
+    // A flat colour must come out exactly the same: weights are normalized per sample.
+    {
+        TArray<FColor> Src;
+        Src.Init(FColor(12, 200, 77, 255), 300 * 170);
+        TArray<FColor> Dst;
+        ResamplePixels(Src, FIntPoint(300, 170), FIntPoint(97, 55), Dst);
+        TestEqual(TEXT("output size"), Dst.Num(), 97 * 55);
+        bool bFlat = true;
+        for (const FColor& C : Dst) bFlat &= (C == FColor(12, 200, 77, 255));
+        TestTrue(TEXT("constant colour preserved"), bFlat);
+    }
+
+    // An identity resample is a copy.
+    {
+        const TArray<FColor> Src = MakeGradient(64, 48);
+        TArray<FColor> Dst;
+        ResamplePixels(Src, FIntPoint(64, 48), FIntPoint(64, 48), Dst);
+        TestTrue(TEXT("1:1 resample is lossless"), Dst == Src);
+    }
+
+    // Downscaling a gradient keeps the mean colour and the channel order (B/G/R/A lanes).
+    {
+        const TArray<FColor> Src = MakeGradient(1000, 640);
+        TArray<FColor> Dst;
+        FIntPoint DstSize;
+        TestTrue(TEXT("downscale happens"), DownscaleToFit(Src, FIntPoint(1000, 640), 250, Dst, DstSize));
+        TestEqual(TEXT("downscaled size"), DstSize, FIntPoint(250, 160));
+        const FLinearColor SrcMean = MeanColor(Src);
+        const FLinearColor DstMean = MeanColor(Dst);
+        TestTrue(TEXT("mean R preserved"), FMath::IsNearlyEqual(SrcMean.R, DstMean.R, 1.0f));
+        TestTrue(TEXT("mean G preserved"), FMath::IsNearlyEqual(SrcMean.G, DstMean.G, 1.0f));
+        TestTrue(TEXT("mean B preserved"), FMath::IsNearlyEqual(SrcMean.B, DstMean.B, 2.0f));
+        TestEqual(TEXT("alpha stays opaque"), Dst[DstSize.X * DstSize.Y / 2].A, (uint8)255);
+        TestTrue(TEXT("left edge dark red, right edge bright red"), Dst[0].R < 8 && Dst[DstSize.X - 1].R > 247);
+    }
+
+    TArray<FColor> Untouched;
+    FIntPoint UntouchedSize(-1, -1);
+    TestFalse(TEXT("no-op when the image fits"), DownscaleToFit(MakeGradient(16, 16), FIntPoint(16, 16), 1024, Untouched, UntouchedSize));
+    TestEqual(TEXT("outputs untouched"), UntouchedSize, FIntPoint(-1, -1));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FImageResample_UploadSize_Test,
+    "UnrealBanana.ImageResample.UploadSize",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FImageResample_UploadSize_Test::RunTest(const FString&)
+{
+    using namespace NanoBanana::Image;
+    IImageWrapperModule& ImageWrapper = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+
+    // A 4K 16:9 viewport capture used as a reference for a 1K request.
+    FReferenceSnapshot Snap;
+    Snap.Profile.Encoding = ENanoBananaUploadEncoding::PNGFast;
+    Snap.Size = FIntPoint(3840, 2160);
+    Snap.Pixels = MakeGradient(Snap.Size.X, Snap.Size.Y);
+
+    const double T0 = FPlatformTime::Seconds();
+    const TSharedPtr<const FEncodedReference, ESPMode::ThreadSafe> Full = EncodeSnapshot(ImageWrapper, Snap);
+    const double T1 = FPlatformTime::Seconds();
+    Snap.MaxDimension = 1024;
+    const TSharedPtr<const FEncodedReference, ESPMode::ThreadSafe> Scaled = EncodeSnapshot(ImageWrapper, Snap);
+    const double T2 = FPlatformTime::Seconds();
+
+    if (!TestTrue(TEXT("both encodes succeed"), Full.IsValid() && Scaled.IsValid()))
+    {
+        return false;
+    }
+    TestTrue(TEXT("downscaled upload is smaller"), Scaled->GetDataUri().Len() * 2 < Full->GetDataUri().Len());
+
+    uint64 FullKey = 0, ScaledKey = 0;
+    Snap.MaxDimension = 0;
+    ComputeSnapshotKey(Snap, FullKey);
+    Snap.MaxDimension = 1024;
+    ComputeSnapshotKey(Snap, ScaledKey);
+    TestNotEqual(TEXT("target size is part of the cache key"), FullKey, ScaledKey);
+
+    AddInfo(FString::Printf(TEXT("3840x2160 as-is: %lld base64 bytes, %.1f ms"), (int64)Full->GetDataUri().Len(), (T1 - T0) * 1000.0));
+    AddInfo(FString::Printf(TEXT("fit to 1024:    %lld base64 bytes, %.1f ms (resample + encode)"), (int64)Scaled->GetDataUri().Len(), (T2 - T1) * 1000.0));
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
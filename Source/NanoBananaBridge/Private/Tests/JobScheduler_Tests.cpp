@@ -0,0 +1,148 @@
+// Tests for the engine-wide job scheduler: priority ordering under a vendor cap, token-bucket
+// pacing, Retry-After holds, and reading Retry-After headers.
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+
+#include "NanoBananaSettings.h"
+#include "NanoBananaJobScheduler.h"
+#include "Http/RetryAfter.h"
+#include "Tests/TestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    /** Applies a Replicate cap and rate limit for the duration of a test. */
+    struct FScopedSchedulerSettings
+    {
+        TGuardValue<int32> Cap;
+        TGuardValue<float> RequestsPerSecond;
+        TGuardValue<int32> Burst;
+        FScopedSchedulerSettings(int32 InCap, float InRequestsPerSecond, int32 InBurst)
+            : Cap(GetMutableDefault<UNanoBananaSettings>()->MaxConcurrentRequestsPerVendor, InCap)
+            , RequestsPerSecond(GetMutableDefault<UNanoBananaSettings>()->Replicate.RateLimit.RequestsPerSecond, InRequestsPerSecond)
+            , Burst(GetMutableDefault<UNanoBananaSettings>()->Replicate.RateLimit.Burst, InBurst)
+        {
+        }
+    };
+
+    static const FNanoBananaVendorQueueStats* FindVendor(const FNanoBananaJobSchedulerStats& Stats, ENanoBananaVendor Vendor)
+    {
+        return Stats.Vendors.FindByPredicate([Vendor](const FNanoBananaVendorQueueStats& V) { return V.Vendor == Vendor; });
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FJobScheduler_Priorities_Test,
+    "UnrealBanana.Scheduler.Priorities",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FJobScheduler_Priorities_Test::RunTest(const FString&)
+{
+    UNanoBananaJobScheduler* Scheduler = UNanoBananaJobScheduler::Get();
+    if (!TestNotNull(TEXT("scheduler subsystem"), Scheduler)) return false;
+    FScopedSchedulerSettings Settings(1, 0.0f, 1);
+    constexpr ENanoBananaVendor Vendor = ENanoBananaVendor::Replicate;
+
+    // Jobs can start after this function returns (a failed check), so they record into shared state.
+    TSharedRef<TArray<FString>> Started = MakeShared<TArray<FString>>();
+    auto Job = [Started](const TCHAR* Name) { return [Started, Name]() { Started->Add(Name); }; };
+    Scheduler->Enqueue(Vendor, ENanoBananaJobPriority::Bulk, Job(TEXT("first")));
+    TestEqual(TEXT("an idle vendor starts at once"), Started->Num(), 1);
+
+    Scheduler->Enqueue(Vendor, ENanoBananaJobPriority::Bulk, Job(TEXT("bulk")));
+    const UNanoBananaJobScheduler::FJobId Dropped = Scheduler->Enqueue(Vendor, ENanoBananaJobPriority::Bulk, Job(TEXT("dropped")));
+    Scheduler->Enqueue(Vendor, ENanoBananaJobPriority::Background, Job(TEXT("background")));
+    Scheduler->Enqueue(Vendor, ENanoBananaJobPriority::Interactive, Job(TEXT("interactive")));
+    TestEqual(TEXT("the cap holds the rest back"), Started->Num(), 1);
+    TestTrue(TEXT("a waiting job can be removed"), Scheduler->Remove(Dropped));
+
+    if (const FNanoBananaVendorQueueStats* V = FindVendor(Scheduler->GetStats(), Vendor))
+    {
+        TestEqual(TEXT("one running"), V->Running, 1);
+        TestEqual(TEXT("interactive queued"), V->QueuedInteractive, 1);
+        TestEqual(TEXT("background queued"), V->QueuedBackground, 1);
+        TestEqual(TEXT("bulk queued"), V->QueuedBulk, 1);
+    }
+    else
+    {
+        AddError(TEXT("no stats for the vendor"));
+    }
+
+    for (int32 i = 0; i < 4; ++i)
+    {
+        Scheduler->Release(Vendor);
+    }
+    TestTrue(FString::Printf(TEXT("highest priority first (%s)"), *FString::Join(*Started, TEXT(","))),
+        *Started == TArray<FString>({ TEXT("first"), TEXT("interactive"), TEXT("background"), TEXT("bulk") }));
+    TestFalse(TEXT("started jobs cannot be removed"), Scheduler->Remove(Dropped));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FJobScheduler_RateLimit_Test,
+    "UnrealBanana.Scheduler.RateLimit",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FJobScheduler_RateLimit_Test::RunTest(const FString&)
+{
+    UNanoBananaJobScheduler* Scheduler = UNanoBananaJobScheduler::Get();
+    if (!TestNotNull(TEXT("scheduler subsystem"), Scheduler)) return false;
+    constexpr ENanoBananaVendor Vendor = ENanoBananaVendor::Replicate;
+
+    {
+        // Burst of 2, then one every 0.1 s: the last of 5 starts about 0.3 s in.
+        FScopedSchedulerSettings Settings(8, 10.0f, 2);
+        TSharedRef<int32> Started = MakeShared<int32>(0);
+        const double Start = FPlatformTime::Seconds();
+        for (int32 i = 0; i < 5; ++i)
+        {
+            Scheduler->Enqueue(Vendor, ENanoBananaJobPriority::Background, [Started]() { ++*Started; });
+        }
+        TestEqual(TEXT("the burst starts at once"), *Started, 2);
+        NanoBanana::Tests::PumpUntil([Started]() { return *Started >= 5; }, 5.0);
+        const double Seconds = FPlatformTime::Seconds() - Start;
+        TestEqual(TEXT("every job started"), *Started, 5);
+        TestTrue(FString::Printf(TEXT("paced by the bucket (%.2f s)"), Seconds), Seconds >= 0.25 && Seconds < 2.0);
+        for (int32 i = 0; i < *Started; ++i)
+        {
+            Scheduler->Release(Vendor);
+        }
+    }
+
+    {
+        FScopedSchedulerSettings Settings(8, 0.0f, 1);
+        TSharedRef<bool> bStarted = MakeShared<bool>(false);
+        const double Start = FPlatformTime::Seconds();
+        Scheduler->ReportRateLimited(Vendor, 0.3f);
+        Scheduler->Enqueue(Vendor, ENanoBananaJobPriority::Interactive, [bStarted]() { *bStarted = true; });
+        TestFalse(TEXT("held while Retry-After runs"), *bStarted);
+        if (const FNanoBananaVendorQueueStats* V = FindVendor(Scheduler->GetStats(), Vendor))
+        {
+            TestTrue(TEXT("stats show the hold"), V->HeldForSeconds > 0.0f);
+        }
+        NanoBanana::Tests::PumpUntil([bStarted]() { return *bStarted; }, 5.0);
+        TestTrue(TEXT("starts once the hold passes"), *bStarted);
+        TestTrue(TEXT("not before Retry-After"), FPlatformTime::Seconds() - Start >= 0.25);
+        if (*bStarted)
+        {
+            Scheduler->Release(Vendor);
+        }
+    }
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FJobScheduler_RetryAfter_Test,
+    "UnrealBanana.Scheduler.RetryAfter",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FJobScheduler_RetryAfter_Test::RunTest(const FString&)
+{
+    using namespace NanoBanana::Http;
+    const FDateTime Now(2025, 3, 1, 12, 0, 0);
+    TestEqual(TEXT("delta seconds"), ParseRetryAfterSeconds(TEXT("30"), Now), 30.0f);
+    TestEqual(TEXT("HTTP date"), ParseRetryAfterSeconds(TEXT("Sat, 01 Mar 2025 12:00:45 GMT"), Now), 45.0f);
+    TestEqual(TEXT("date in the past"), ParseRetryAfterSeconds(TEXT("Sat, 01 Mar 2025 11:00:00 GMT"), Now), 0.0f);
+    TestEqual(TEXT("clamped"), ParseRetryAfterSeconds(TEXT("86400"), Now), MaxRetryAfterSeconds);
+    TestEqual(TEXT("missing"), ParseRetryAfterSeconds(FString(), Now), DefaultRetryAfterSeconds);
+    TestEqual(TEXT("unreadable"), ParseRetryAfterSeconds(TEXT("soon"), Now), DefaultRetryAfterSeconds);
+    return true;
+}
+
+#endif
@@ -0,0 +1,117 @@
+// Tests for the streaming UTF-8 request-body writer: escaping, nesting, and that every
+// provider body still parses with the engine JSON reader and carries the references intact.
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#include "NanoBananaTypes.h"
+#include "Http/Base64Image.h"
+#include "Http/JsonBodyWriter.h"
+#include "Providers/Google/GoogleGeminiProvider.h"
+#include "Providers/Fal/FalAiProvider.h"
+#include "Providers/Replicate/ReplicateProvider.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    static TSharedPtr<FJsonObject> ParseBody(const TArray<uint8>& Body)
+    {
+        TSharedPtr<FJsonObject> Json;
+        TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(NanoBanana::Json::FJsonBodyWriter::ToString(Body));
+        FJsonSerializer::Deserialize(Reader, Json);
+        return Json;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FJsonBodyWriter_Escaping_Test,
+    "UnrealBanana.Http.JsonBodyWriter.Escaping",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FJsonBodyWriter_Escaping_Test::RunTest(const FString&)
+{
+    // Quotes, backslash, control chars, BMP and astral code points.
+    const FString Tricky = FString(TEXT("say \"hi\"\\ \n\t\x01 café 日本 ")) + FString(TEXT("\U0001F34C"));
+
+    NanoBanana::Json::FJsonBodyWriter W;
+    W.BeginObject();
+    W.WriteString("text", Tricky);
+    W.WriteInt("n", -7);
+    W.WriteBool("b", true);
+    W.BeginArray("list");
+    W.WriteAsciiString("abc");
+    W.WriteInt(3);
+    W.BeginObject();
+    W.EndObject();
+    W.EndArray();
+    W.BeginObject("empty");
+    W.EndObject();
+    W.EndObject();
+    const TArray<uint8> Body = W.Finish();
+
+    const FString Expected = TEXT("{\"text\":\"say \\\"hi\\\"\\\\ \\n\\t\\u0001 café 日本 \U0001F34C\",\"n\":-7,\"b\":true,\"list\":[\"abc\",3,{}],\"empty\":{}}");
+    TestEqual(TEXT("compact output"), NanoBanana::Json::FJsonBodyWriter::ToString(Body), Expected);
+
+    TSharedPtr<FJsonObject> Json = ParseBody(Body);
+    if (!TestTrue(TEXT("parses"), Json.IsValid())) return false;
+    TestEqual(TEXT("string round-trips"), Json->GetStringField(TEXT("text")), Tricky);
+
+    // The astral code point must be a single 4-byte UTF-8 sequence, not two encoded surrogates.
+    const uint8 Banana[] = {0xF0, 0x9F, 0x8D, 0x8C};
+    bool bFound = false;
+    for (int32 i = 0; i + 4 <= Body.Num() && !bFound; ++i)
+    {
+        bFound = FMemory::Memcmp(Body.GetData() + i, Banana, 4) == 0;
+    }
+    TestTrue(TEXT("4-byte UTF-8 sequence"), bFound);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FJsonBodyWriter_ProviderBodies_Test,
+    "UnrealBanana.Http.JsonBodyWriter.ProviderBodies",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FJsonBodyWriter_ProviderBodies_Test::RunTest(const FString&)
+{
+    FNanoBananaRequest R;
+    R.Prompt = TEXT("a \"quoted\" banana\nsecond line");
+    R.NumImages = 2;
+    R.Aspect = ENanoBananaAspect::R16x9;
+    R.Resolution = ENanoBananaResolution::Res2K;
+    R.Seed = 42;
+
+    TArray<uint8> Png = {0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A};
+    Png.AddZeroed(4096);
+    TArray<NanoBanana::Image::FEncodedReferenceRef> Refs;
+    Refs.Add(NanoBanana::Image::MakeEncodedReference(MoveTemp(Png)));
+    const FAnsiStringView DataUri = Refs[0]->GetDataUri();
+    const FAnsiStringView B64 = Refs[0]->GetBase64();
+
+    {
+        TSharedPtr<FJsonObject> Json = ParseBody(FGoogleGeminiProvider::BuildRequestBody(R, Refs));
+        if (!TestTrue(TEXT("gemini parses"), Json.IsValid())) return false;
+        const TSharedPtr<FJsonObject> Content = Json->GetArrayField(TEXT("contents"))[0]->AsObject();
+        const TArray<TSharedPtr<FJsonValue>>& Parts = Content->GetArrayField(TEXT("parts"));
+        TestEqual(TEXT("gemini prompt"), Parts[0]->AsObject()->GetStringField(TEXT("text")), R.Prompt);
+        TestEqual(TEXT("gemini data"), Parts[1]->AsObject()->GetObjectField(TEXT("inlineData"))->GetStringField(TEXT("data")),
+            FString(B64.Len(), B64.GetData()));
+        TestEqual(TEXT("gemini candidateCount"), (int32)Json->GetObjectField(TEXT("generationConfig"))->GetNumberField(TEXT("candidateCount")), 2);
+    }
+    {
+        TSharedPtr<FJsonObject> Json = ParseBody(FFalAiProvider::BuildRequestBody(R, Refs));
+        if (!TestTrue(TEXT("fal parses"), Json.IsValid())) return false;
+        TestEqual(TEXT("fal prompt"), Json->GetStringField(TEXT("prompt")), R.Prompt);
+        TestEqual(TEXT("fal image_urls"), Json->GetArrayField(TEXT("image_urls"))[0]->AsString(), FString(DataUri.Len(), DataUri.GetData()));
+    }
+    {
+        TSharedPtr<FJsonObject> Json = ParseBody(FReplicateProvider::BuildRequestBody(R, Refs));
+        if (!TestTrue(TEXT("replicate parses"), Json.IsValid())) return false;
+        const TSharedPtr<FJsonObject> Input = Json->GetObjectField(TEXT("input"));
+        TestEqual(TEXT("replicate prompt"), Input->GetStringField(TEXT("prompt")), R.Prompt);
+        TestEqual(TEXT("replicate width"), (int32)Input->GetNumberField(TEXT("width")), 2048);
+        TestEqual(TEXT("replicate image_input"), Input->GetArrayField(TEXT("image_input"))[0]->AsString(), FString(DataUri.Len(), DataUri.GetData()));
+    }
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,186 @@
+// Tests for the streaming UTF-8 response scanner: parity with the DOM walker on every vendor
+// shape, the edge cases the DOM used to absorb for us, and a large-response benchmark.
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+#include "Http/Base64Codec.h"
+#include "Http/JsonResponseScanner.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    static TArray<uint8> ToUtf8(const FString& Text)
+    {
+        const FTCHARToUTF8 Utf8(*Text, Text.Len());
+        return TArray<uint8>((const uint8*)Utf8.Get(), Utf8.Length());
+    }
+
+    static TArray<TArray<uint8>> ScanDom(const FString& Text)
+    {
+        TArray<TArray<uint8>> Images;
+        TSharedPtr<FJsonObject> Root;
+        TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Text);
+        if (FJsonSerializer::Deserialize(Reader, Root))
+        {
+            NanoBanana::Json::CollectInlineImages(Root, Images);
+        }
+        return Images;
+    }
+
+    static TArray<uint8> MakeBytes(int32 Num, int32 Seed)
+    {
+        FRandomStream Rng(Seed);
+        TArray<uint8> Bytes;
+        Bytes.SetNumUninitialized(Num);
+        for (uint8& B : Bytes) B = (uint8)Rng.RandHelper(256);
+        return Bytes;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FJsonResponseScanner_Parity_Test,
+    "UnrealBanana.Http.JsonResponseScanner.Parity",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FJsonResponseScanner_Parity_Test::RunTest(const FString&)
+{
+    const TArray<uint8> A = MakeBytes(3000, 1), B = MakeBytes(17, 2), C = MakeBytes(1, 3);
+    const FString A64 = NanoBanana::Base64::Encode(A), B64 = NanoBanana::Base64::Encode(B), C64 = NanoBanana::Base64::Encode(C);
+
+    const FString Shapes[] =
+    {
+        // Gemini camelCase, with text parts and usage metadata around the images.
+        FString::Printf(TEXT("{\"candidates\":[{\"content\":{\"parts\":[{\"text\":\"here \\\"you\\\" go\"},{\"inlineData\":{\"mimeType\":\"image/png\",\"data\":\"%s\"}},{\"inlineData\":{\"data\":\"%s\",\"mimeType\":\"image/jpeg\"}}]},\"finishReason\":\"STOP\"}],\"usageMetadata\":{\"totalTokenCount\":1290,\"ratio\":1.5e-3,\"cached\":false,\"x\":null}}"), *A64, *B64),
+        // Gemini snake_case.
+        FString::Printf(TEXT("{\"candidates\":[{\"content\":{\"parts\":[{\"inline_data\":{\"mime_type\":\"image/png\",\"data\":\"%s\"}}]}}]}"), *C64),
+        // OpenAI-style b64_json, plus Imagen-style bytesBase64 one level deeper.
+        FString::Printf(TEXT("{\"created\":1,\"data\":[{\"b64_json\":\"%s\"},{\"meta\":[{\"bytesBase64\":\"%s\"}]}]}"), *B64, *A64),
+        // A text/* inline part is not an image, even when the MIME type arrives after the data.
+        FString::Printf(TEXT("{\"parts\":[{\"inlineData\":{\"data\":\"%s\",\"mimeType\":\"text/plain\"}},{\"inlineData\":{\"data\":\"%s\"}}]}"), *A64, *C64),
+    };
+
+    for (int32 i = 0; i < UE_ARRAY_COUNT(Shapes); ++i)
+    {
+        const TArray<TArray<uint8>> Dom = ScanDom(Shapes[i]);
+        TArray<TArray<uint8>> Streamed;
+        TestTrue(FString::Printf(TEXT("shape %d scans"), i), NanoBanana::Json::CollectInlineImagesFromUtf8(ToUtf8(Shapes[i]), Streamed));
+        TestTrue(FString::Printf(TEXT("shape %d matches the DOM walker"), i), Dom.Num() > 0 && Streamed == Dom);
+    }
+
+    TArray<TArray<uint8>> FromText;
+    NanoBanana::Json::CollectInlineImagesFromResponseBody(Shapes[0], FromText);
+    TestTrue(TEXT("FString convenience matches"), FromText.Num() == 2 && FromText[0] == A && FromText[1] == B);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FJsonResponseScanner_EdgeCases_Test,
+    "UnrealBanana.Http.JsonResponseScanner.EdgeCases",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FJsonResponseScanner_EdgeCases_Test::RunTest(const FString&)
+{
+    using NanoBanana::Json::CollectInlineImagesFromUtf8;
+    const TArray<uint8> Bytes = MakeBytes(4096, 7);
+    const FString B64 = NanoBanana::Base64::Encode(Bytes);
+
+    auto Scan = [](const FString& Text, TArray<TArray<uint8>>& Out)
+    {
+        return CollectInlineImagesFromUtf8(ToUtf8(Text), Out);
+    };
+
+    // Encoders may escape '/' and wrap long base64 lines; both must decode to the same bytes.
+    {
+        const FString Escaped = B64.Replace(TEXT("/"), TEXT("\\/"));
+        FString Wrapped = B64;
+        Wrapped.InsertAt(76, TEXT("\\n"));
+        TArray<TArray<uint8>> Out;
+        TestTrue(TEXT("escaped body scans"), Scan(FString::Printf(TEXT("{\"b64_json\":\"%s\",\"also\":{\"inlineData\":{\"data\":\"%s\"}}}"), *Escaped, *Wrapped), Out));
+        TestTrue(TEXT("escaped and wrapped base64 decode"), Out.Num() == 2 && Out[0] == Bytes && Out[1] == Bytes);
+    }
+
+    // Quotes and backslashes inside unrelated strings never confuse the string scanner.
+    {
+        TArray<TArray<uint8>> Out;
+        TestTrue(TEXT("tricky strings scan"), Scan(FString::Printf(TEXT("{\"t\":\"\\\"inlineData\\\":{\\\"data\\\":\\\"x\",\"u\":\"ends in \\\\\",\"b64_json\":\"%s\"}"), *B64), Out));
+        TestEqual(TEXT("only the real field decoded"), Out.Num(), 1);
+    }
+
+    // A "data" field outside an inline-data object is not an image.
+    {
+        TArray<TArray<uint8>> Out;
+        TestTrue(TEXT("stray data scans"), Scan(FString::Printf(TEXT("{\"data\":\"%s\",\"x\":{\"data\":\"%s\"}}"), *B64, *B64), Out));
+        TestEqual(TEXT("stray data ignored"), Out.Num(), 0);
+    }
+
+    // Malformed bodies fail without touching what the caller already collected.
+    const TCHAR* Malformed[] =
+    {
+        TEXT(""),
+        TEXT("{\"b64_json\":\"AAAA\",\"x\":[1,2"),
+        TEXT("{\"b64_json\":\"AAAA\"} trailing"),
+        TEXT("{\"a\":[}"),
+        TEXT("{\"a\" 1}"),
+        TEXT("{\"a\":tru}"),
+    };
+    for (const TCHAR* Text : Malformed)
+    {
+        TArray<TArray<uint8>> Out;
+        Out.Add(Bytes);
+        TestFalse(FString::Printf(TEXT("rejects %s"), Text), Scan(Text, Out));
+        TestTrue(FString::Printf(TEXT("output untouched for %s"), Text), Out.Num() == 1 && Out[0] == Bytes);
+    }
+
+    // A UTF-8 BOM and surrounding whitespace are accepted.
+    {
+        TArray<uint8> Body = { 0xEF, 0xBB, 0xBF, ' ', '\n' };
+        Body.Append(ToUtf8(FString::Printf(TEXT("{ \"b64_json\" : \"%s\" }\r\n"), *B64)));
+        TArray<TArray<uint8>> Out;
+        TestTrue(TEXT("BOM body scans"), CollectInlineImagesFromUtf8(Body, Out));
+        TestEqual(TEXT("BOM body decoded"), Out.Num(), 1);
+    }
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FJsonResponseScanner_Benchmark_Test,
+    "UnrealBanana.Http.JsonResponseScanner.Benchmark",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FJsonResponseScanner_Benchmark_Test::RunTest(const FString&)
+{
+    // Four ~3.7 MB images: a ~20 MB response, about what a 4-candidate 4K Gemini reply weighs.
+    constexpr int32 NumImages = 4;
+    const TArray<uint8> Image = MakeBytes(3700 * 1024, 11);
+    const FString B64 = NanoBanana::Base64::Encode(Image);
+    FString Parts;
+    for (int32 i = 0; i < NumImages; ++i)
+    {
+        Parts += FString::Printf(TEXT("%s{\"inlineData\":{\"mimeType\":\"image/png\",\"data\":\"%s\"}}"), i ? TEXT(",") : TEXT(""), *B64);
+    }
+    const FString Text = FString::Printf(TEXT("{\"candidates\":[{\"content\":{\"parts\":[{\"text\":\"ok\"},%s]}}]}"), *Parts);
+    const TArray<uint8> Body = ToUtf8(Text);
+
+    // Old path: UTF-8 -> UTF-16 string -> DOM -> decode.
+    const double T0 = FPlatformTime::Seconds();
+    const FUTF8ToTCHAR Wide((const UTF8CHAR*)Body.GetData(), Body.Num());
+    const TArray<TArray<uint8>> Dom = ScanDom(FString(Wide.Length(), Wide.Get()));
+    const double T1 = FPlatformTime::Seconds();
+    TArray<TArray<uint8>> Streamed;
+    const bool bOk = NanoBanana::Json::CollectInlineImagesFromUtf8(Body, Streamed);
+    const double T2 = FPlatformTime::Seconds();
+
+    TestTrue(TEXT("streaming scan succeeds"), bOk);
+    TestEqual(TEXT("every image found"), Streamed.Num(), NumImages);
+    TestTrue(TEXT("same bytes as the DOM path"), Streamed == Dom);
+
+    // Transient copies beyond the response and decoded images: the DOM path holds the body
+    // as UTF-16 plus a UTF-16 FString per base64 value; the scanner holds nothing extra.
+    const int64 DecodedBytes = (int64)Image.Num() * NumImages;
+    const int64 DomTransient = (int64)Body.Num() * sizeof(TCHAR) + (int64)B64.Len() * NumImages * sizeof(TCHAR);
+    AddInfo(FString::Printf(TEXT("%.1f MB response, %d images: DOM %.1f ms (~%.1f MB transient), streaming %.1f ms (0 MB transient, %.1f MB decoded)"),
+        Body.Num() / (1024.0 * 1024.0), NumImages, (T1 - T0) * 1000.0, DomTransient / (1024.0 * 1024.0), (T2 - T1) * 1000.0, DecodedBytes / (1024.0 * 1024.0)));
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,145 @@
+// Tests for learned poll intervals: the estimator converges, planned schedules beat the fixed
+// backoff on both short and long jobs, and estimates survive a save / load round trip.
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "Math/RandomStream.h"
+
+#include "Http/PollLatencyModel.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    /** Replays a planned schedule against a job that completes at CompletedAt. */
+    static int32 ReplayPlannedSchedule(const NanoBanana::Http::FPollLatencyEstimate& Estimate, double CompletedAt, float MaxDelay, double& OutDetectedAt)
+    {
+        double At = NanoBanana::Http::FPollLatencyModel::PlanDelay(Estimate, 0.0, MaxDelay);
+        int32 Polls = 1;
+        while (At < CompletedAt)
+        {
+            At += NanoBanana::Http::FPollLatencyModel::PlanDelay(Estimate, At, MaxDelay);
+            ++Polls;
+        }
+        OutDetectedAt = At;
+        return Polls;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPollLatencyModel_Estimator_Test,
+    "UnrealBanana.Http.PollLatency.Estimator",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPollLatencyModel_Estimator_Test::RunTest(const FString&)
+{
+    using NanoBanana::Http::FPollLatencyEstimate;
+
+    FPollLatencyEstimate Steady;
+    for (int32 i = 0; i < 40; ++i) Steady.Observe(20.0);
+    TestEqual(TEXT("steady mean"), Steady.Mean, 20.0, 0.01);
+    TestTrue(TEXT("steady deviation decays"), Steady.Deviation < 0.1);
+
+    // Noisy samples around 45 s: the mean settles nearby and the deviation reflects the spread.
+    FPollLatencyEstimate Noisy;
+    FRandomStream Rng(3);
+    for (int32 i = 0; i < 200; ++i) Noisy.Observe(45.0 + Rng.FRandRange(-5.0f, 5.0f));
+    TestEqual(TEXT("noisy mean"), Noisy.Mean, 45.0, 2.0);
+    TestTrue(TEXT("noisy deviation in range"), Noisy.Deviation > 1.0 && Noisy.Deviation < 5.0);
+
+    // A model change (e.g. vendor speeds up) is tracked within a few dozen samples.
+    for (int32 i = 0; i < 40; ++i) Noisy.Observe(10.0);
+    TestEqual(TEXT("mean tracks a shift"), Noisy.Mean, 10.0, 0.5);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPollLatencyModel_Plan_Test,
+    "UnrealBanana.Http.PollLatency.Plan",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPollLatencyModel_Plan_Test::RunTest(const FString&)
+{
+    using NanoBanana::Http::FPollLatencyEstimate;
+    using NanoBanana::Http::FPollLatencyModel;
+
+    constexpr float MaxDelay = 5.0f;
+    FPollLatencyEstimate Long;
+    Long.Mean = 60.0;
+    Long.Deviation = 4.0;
+    Long.Samples = 10;
+
+    TestEqual(TEXT("sleeps until the window opens"), FPollLatencyModel::PlanDelay(Long, 0.0, MaxDelay), 52.0f, 0.01f);
+    TestEqual(TEXT("halves the distance to the mean"), FPollLatencyModel::PlanDelay(Long, 56.0, MaxDelay), 2.0f, 0.01f);
+    TestEqual(TEXT("never tighter than a quarter of the spread"), FPollLatencyModel::PlanDelay(Long, 59.9, MaxDelay), 1.0f, 0.01f);
+    TestTrue(TEXT("backs off once overdue"), FPollLatencyModel::PlanDelay(Long, 70.0, MaxDelay) > FPollLatencyModel::PlanDelay(Long, 62.0, MaxDelay));
+    TestEqual(TEXT("overdue backoff capped"), FPollLatencyModel::PlanDelay(Long, 200.0, MaxDelay), MaxDelay, 0.01f);
+
+    // Long job: far fewer polls and no idle wait compared to the fixed schedule.
+    {
+        double FixedAt = 0.0, PlannedAt = 0.0;
+        const int32 FixedPolls = FPollLatencyModel::ReplayFixedSchedule(61.0, 1.0f, MaxDelay, 1.5f, FixedAt);
+        const int32 PlannedPolls = ReplayPlannedSchedule(Long, 61.0, MaxDelay, PlannedAt);
+        AddInfo(FString::Printf(TEXT("61 s job: fixed %d polls, +%.2f s; planned %d polls, +%.2f s"), FixedPolls, FixedAt - 61.0, PlannedPolls, PlannedAt - 61.0));
+        TestTrue(TEXT("long job: fewer polls"), PlannedPolls * 2 <= FixedPolls);
+        TestTrue(TEXT("long job: noticed sooner"), PlannedAt - 61.0 < FixedAt - 61.0);
+    }
+
+    // Short job: noticed sooner, for about the same number of polls.
+    {
+        FPollLatencyEstimate Short;
+        Short.Mean = 6.0;
+        Short.Deviation = 1.0;
+        Short.Samples = 10;
+        double FixedAt = 0.0, PlannedAt = 0.0;
+        const int32 FixedPolls = FPollLatencyModel::ReplayFixedSchedule(6.0, 1.0f, MaxDelay, 1.5f, FixedAt);
+        const int32 PlannedPolls = ReplayPlannedSchedule(Short, 6.0, MaxDelay, PlannedAt);
+        AddInfo(FString::Printf(TEXT("6 s job: fixed %d polls, +%.2f s; planned %d polls, +%.2f s"), FixedPolls, FixedAt - 6.0, PlannedPolls, PlannedAt - 6.0));
+        TestTrue(TEXT("short job: noticed sooner"), PlannedAt - 6.0 < FixedAt - 6.0);
+        TestTrue(TEXT("short job: polls within reason"), PlannedPolls <= FixedPolls + 2);
+    }
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPollLatencyModel_Persistence_Test,
+    "UnrealBanana.Http.PollLatency.Persistence",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPollLatencyModel_Persistence_Test::RunTest(const FString&)
+{
+    using NanoBanana::Http::FPollLatencyModel;
+
+    const FString Path = FPaths::ConvertRelativePathToFull(FPaths::AutomationTransientDir() / TEXT("NanoBananaPollLatency") / TEXT("PollLatency.json"));
+    IFileManager::Get().Delete(*Path, false, true, true);
+
+    const FString Key = FPollLatencyModel::MakeKey(ENanoBananaVendor::Fal, TEXT("fal-ai/nano-banana-pro"), ENanoBananaResolution::Res4K);
+    {
+        FPollLatencyModel Model(Path);
+        float Delay = 0.0f;
+        for (int32 i = 0; i < FPollLatencyModel::MinSamples; ++i)
+        {
+            TestFalse(TEXT("untrusted until enough samples"), Model.TryPlanDelay(Key, 0.0, 5.0f, Delay));
+            Model.RecordCompletion(Key, 40.0, 41.0, 4, 1.0f, 5.0f, 1.5f);
+        }
+        TestTrue(TEXT("trusted after enough samples"), Model.TryPlanDelay(Key, 0.0, 5.0f, Delay));
+        TestTrue(TEXT("plans a long first wait"), Delay > 10.0f);
+
+        const NanoBanana::Http::FPollLatencyStats& Stats = Model.GetStats();
+        TestEqual(TEXT("jobs counted"), Stats.Jobs, (int64)FPollLatencyModel::MinSamples);
+        TestTrue(TEXT("saved polls reported"), Stats.SavedPolls() > 0);
+        TestTrue(TEXT("saved latency reported"), Stats.SavedSeconds() > 0.0);
+        TestTrue(TEXT("saved"), Model.Save());
+        TestFalse(TEXT("nothing to save twice"), Model.Save());
+    }
+    {
+        FPollLatencyModel Reloaded(Path);
+        TestTrue(TEXT("loaded"), Reloaded.Load());
+        const NanoBanana::Http::FPollLatencyEstimate* Estimate = Reloaded.Find(Key);
+        if (TestNotNull(TEXT("estimate survives reload"), Estimate))
+        {
+            TestEqual(TEXT("mean"), Estimate->Mean, 40.0, 0.001);
+            TestEqual(TEXT("samples"), Estimate->Samples, FPollLatencyModel::MinSamples);
+        }
+    }
+
+    IFileManager::Get().Delete(*Path, false, true, true);
+    return true;
+}
+
+#endif
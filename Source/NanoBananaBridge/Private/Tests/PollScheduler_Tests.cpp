@@ -0,0 +1,193 @@
+// Tests for the shared poll scheduler: the timer wheel never fires early (including entries
+// more than one revolution out), and loops against a stand-in server never exceed the
+// per-vendor cap on concurrent status requests.
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformProcess.h"
+#include "Math/RandomStream.h"
+#include "Misc/ScopeLock.h"
+#include "HttpModule.h"
+
+#include "NanoBananaSettings.h"
+#include "Http/PollLoop.h"
+#include "Http/PollScheduler.h"
+#include "Tests/FakeHttpServer.h"
+#include "Tests/TestHelpers.h"
+
+#include <atomic>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    /** What the stand-in and the loops saw; shared with their callbacks, which may outlive the test. */
+    struct FVendorCapState
+    {
+        std::atomic<int32> Concurrent { 0 };
+        std::atomic<int32> MaxConcurrent { 0 };
+        FCriticalSection SeenLock;
+        TSet<FString> Seen;
+        int32 NumSucceeded = 0;
+        int32 NumFailed = 0;
+    };
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPollScheduler_TimerWheel_Test,
+    "UnrealBanana.Http.PollScheduler.TimerWheel",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPollScheduler_TimerWheel_Test::RunTest(const FString&)
+{
+    using NanoBanana::Http::FPollTimerWheel;
+
+    // 0.1 s ticks, 8 slots: one revolution is 0.8 s.
+    FPollTimerWheel Wheel(0.1, 8);
+    Wheel.Reset(100.0);
+    Wheel.Add(1, 100.25);
+    Wheel.Add(2, 100.25);
+    Wheel.Add(3, 101.55);   // Two revolutions out, same slot region as nearer entries.
+    Wheel.Add(4, 99.0);     // Already overdue: fires on the next tick.
+    TestEqual(TEXT("all entries held"), Wheel.Num(), 4);
+
+    TArray<uint32> Due;
+    Wheel.Advance(100.05, Due);
+    TestEqual(TEXT("nothing fires inside the current tick"), Due.Num(), 0);
+
+    Wheel.Advance(100.15, Due);
+    TestTrue(TEXT("overdue entry fires on the next tick"), Due.Num() == 1 && Due[0] == 4);
+
+    Due.Reset();
+    Wheel.Advance(100.22, Due);
+    TestEqual(TEXT("not early"), Due.Num(), 0);
+    Wheel.Advance(100.31, Due);
+    Due.Sort();
+    TestTrue(TEXT("both entries at 100.25 fire together"), Due.Num() == 2 && Due[0] == 1 && Due[1] == 2);
+
+    Due.Reset();
+    Wheel.Advance(101.05, Due);
+    TestEqual(TEXT("far entry waits while its slot passes"), Due.Num(), 0);
+
+    // A long stall skips several revolutions in one step; the far entry still fires once.
+    Wheel.Advance(105.0, Due);
+    TestTrue(TEXT("far entry fires after a stall"), Due.Num() == 1 && Due[0] == 3);
+    TestEqual(TEXT("wheel empty"), Wheel.Num(), 0);
+
+    // Random due times: every entry fires exactly once, never before its time.
+    FPollTimerWheel Random(0.05, 16);
+    Random.Reset(0.0);
+    FRandomStream Rng(11);
+    TMap<uint32, double> DueTimes;
+    for (uint32 Id = 1; Id <= 200; ++Id)
+    {
+        const double At = Rng.FRandRange(0.0f, 5.0f);
+        DueTimes.Add(Id, At);
+        Random.Add(Id, At);
+    }
+    TSet<uint32> Fired;
+    for (double Now = 0.0; Now <= 5.2; Now += Rng.FRandRange(0.01f, 0.3f))
+    {
+        TArray<uint32> Step;
+        Random.Advance(Now, Step);
+        for (uint32 Id : Step)
+        {
+            if (DueTimes[Id] > Now + KINDA_SMALL_NUMBER)
+            {
+                AddError(FString::Printf(TEXT("entry %u due at %.3f fired at %.3f"), Id, DueTimes[Id], Now));
+            }
+            bool bAlreadyFired = false;
+            Fired.Add(Id, &bAlreadyFired);
+            if (bAlreadyFired) AddError(FString::Printf(TEXT("entry %u fired twice"), Id));
+        }
+    }
+    TArray<uint32> Rest;
+    Random.Advance(6.0, Rest);
+    for (uint32 Id : Rest) Fired.Add(Id);
+    TestEqual(TEXT("every entry fired"), Fired.Num(), DueTimes.Num());
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPollScheduler_VendorCap_Test,
+    "UnrealBanana.Http.PollScheduler.VendorCap",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPollScheduler_VendorCap_Test::RunTest(const FString&)
+{
+    using namespace NanoBanana::Http;
+    using NanoBanana::Tests::FFakeHttpServer;
+
+    constexpr int32 NumJobs = 10;
+    constexpr int32 Cap = 2;
+    TGuardValue<int32> PollCap(GetMutableDefault<UNanoBananaSettings>()->MaxConcurrentPollsPerVendor, Cap);
+    TGuardValue<float> Jitter(GetMutableDefault<UNanoBananaSettings>()->PollJitterFraction, 0.2f);
+
+    // Each job reports "running" once, then "done". Every status request holds its connection
+    // for a while so overlapping requests are visible to the server.
+    TSharedRef<FVendorCapState, ESPMode::ThreadSafe> State = MakeShared<FVendorCapState, ESPMode::ThreadSafe>();
+    FFakeHttpServer Server;
+    Server.On(TEXT("GET"), TEXT("/status/"), [State](const FFakeHttpServer::FRequest& Req)
+    {
+        const int32 Now = ++State->Concurrent;
+        int32 Max = State->MaxConcurrent.load();
+        while (Now > Max && !State->MaxConcurrent.compare_exchange_weak(Max, Now)) {}
+        FPlatformProcess::Sleep(0.1f);
+        --State->Concurrent;
+
+        bool bAgain = false;
+        {
+            FScopeLock ScopeLock(&State->SeenLock);
+            State->Seen.Add(Req.Path, &bAgain);
+        }
+        return FFakeHttpServer::FResponse::Json(bAgain ? TEXT("{\"status\":\"done\"}") : TEXT("{\"status\":\"running\"}"));
+    });
+    if (!TestTrue(TEXT("stand-in server started"), Server.Start())) return false;
+
+    const FPollSchedulerStats Before = FPollScheduler::Get().GetStats();
+
+    TArray<TSharedPtr<FPollLoop, ESPMode::ThreadSafe>> Loops;
+    for (int32 i = 0; i < NumJobs; ++i)
+    {
+        const FString Url = FString::Printf(TEXT("%s/status/%d"), *Server.GetBaseUrl(), i);
+        TSharedPtr<FPollLoop, ESPMode::ThreadSafe> Loop = MakeShared<FPollLoop, ESPMode::ThreadSafe>();
+        Loop->Vendor = TEXT("StandIn");
+        Loop->InitialDelaySeconds = 0.1f;
+        Loop->MaxTotalSeconds = 30.0f;
+        Loop->RequestFactory = [Url]()
+        {
+            TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Q = FHttpModule::Get().CreateRequest();
+            Q->SetURL(Url);
+            Q->SetVerb(TEXT("GET"));
+            return Q;
+        };
+        Loop->DecideFn = [](int32 Code, const FString& Body, FString& OutErr) -> EPollDecision
+        {
+            if (Code != 200) { OutErr = TEXT("unexpected status"); return EPollDecision::Failed; }
+            return Body.Contains(TEXT("done")) ? EPollDecision::Succeeded : EPollDecision::Continue;
+        };
+        Loop->OnSucceeded = [State](const NanoBanana::FSharedText&) { ++State->NumSucceeded; };
+        Loop->OnFailed = [State](const FString&) { ++State->NumFailed; };
+        Loops.Add(Loop);
+    }
+    for (const TSharedPtr<FPollLoop, ESPMode::ThreadSafe>& Loop : Loops)
+    {
+        Loop->Start();
+    }
+
+    const FPollSchedulerStats Started = FPollScheduler::Get().GetStats();
+    TestEqual(TEXT("cap holds back the first polls"), Started.InFlightByVendor.FindRef(TEXT("StandIn")), Cap);
+    TestEqual(TEXT("the rest wait for a slot"), Started.ReadyByVendor.FindRef(TEXT("StandIn")), NumJobs - Cap);
+
+    NanoBanana::Tests::PumpUntil([State]() { return State->NumSucceeded + State->NumFailed >= NumJobs; }, 30.0);
+
+    const int32 MaxConcurrent = State->MaxConcurrent.load();
+    TestEqual(TEXT("every job completed"), State->NumSucceeded, NumJobs);
+    TestEqual(TEXT("no job failed"), State->NumFailed, 0);
+    TestTrue(FString::Printf(TEXT("at most %d status requests at once (saw %d)"), Cap, MaxConcurrent), MaxConcurrent <= Cap);
+    TestEqual(TEXT("two polls per job"), Server.CountRequests(TEXT("GET"), TEXT("/status/")), 2 * NumJobs);
+
+    const FPollSchedulerStats After = FPollScheduler::Get().GetStats();
+    TestEqual(TEXT("polls counted"), After.TotalPolls - Before.TotalPolls, (int64)(2 * NumJobs));
+    TestEqual(TEXT("slots all returned"), After.InFlightByVendor.FindRef(TEXT("StandIn")), 0);
+    TestTrue(TEXT("poll rate reported"), After.PollsPerSecond > 0.0f);
+    AddInfo(FString::Printf(TEXT("max concurrent status requests: %d, rate %.2f polls/s"), MaxConcurrent, After.PollsPerSecond));
+    return true;
+}
+
+#endif
@@ -0,0 +1,191 @@
+// Tests for the provider event channel: the bounded MPSC ring under concurrent producers,
+// progress coalescing around terminal events, overflow, and closing from a handler.
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Async/Async.h"
+#include "HAL/PlatformProcess.h"
+
+#include "BoundedMpscQueue.h"
+#include "ProviderEventChannel.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    /** Renders an event as "P0.50", "B", "F<text>" so sequences compare as strings. */
+    static FString Describe(const NanoBanana::FProviderEvent& Event)
+    {
+        using EKind = NanoBanana::FProviderEvent::EKind;
+        switch (Event.Kind)
+        {
+        case EKind::Progress:     return FString::Printf(TEXT("P%.2f"), Event.Percent);
+        case EKind::RequestBuilt: return TEXT("B");
+        case EKind::Failed:       return TEXT("F") + Event.Text;
+        default:                  return TEXT("?");
+        }
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBoundedMpscQueue_Producers_Test,
+    "UnrealBanana.Events.BoundedMpscQueue",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FBoundedMpscQueue_Producers_Test::RunTest(const FString&)
+{
+    constexpr int32 NumProducers = 4;
+    constexpr int32 PerProducer = 20000;
+    NanoBanana::TBoundedMpscQueue<uint32, 64> Queue;
+
+    // A tiny ring against fast producers: exercises wrap-around and the full path constantly.
+    TArray<TFuture<void>> Producers;
+    for (int32 p = 0; p < NumProducers; ++p)
+    {
+        Producers.Add(Async(EAsyncExecution::Thread, [&Queue, p]()
+        {
+            for (uint32 i = 0; i < (uint32)PerProducer; ++i)
+            {
+                uint32 Item = ((uint32)p << 24) | i;
+                while (!Queue.TryEnqueue(MoveTemp(Item)))
+                {
+                    FPlatformProcess::Yield();
+                }
+            }
+        }));
+    }
+
+    TArray<int64> Next;
+    Next.Init(0, NumProducers);
+    int32 Received = 0;
+    bool bInOrder = true;
+    const double Deadline = FPlatformTime::Seconds() + 30.0;
+    while (Received < NumProducers * PerProducer && FPlatformTime::Seconds() < Deadline)
+    {
+        uint32 Item = 0;
+        if (!Queue.TryDequeue(Item))
+        {
+            FPlatformProcess::Yield();
+            continue;
+        }
+        const int32 Producer = (int32)(Item >> 24);
+        const int64 Seq = Item & 0xFFFFFF;
+        bInOrder &= Producer < NumProducers && Seq == Next[Producer];
+        if (Producer < NumProducers) Next[Producer] = Seq + 1;
+        ++Received;
+    }
+    for (TFuture<void>& Producer : Producers) Producer.Wait();
+
+    TestEqual(TEXT("every item received exactly once"), Received, NumProducers * PerProducer);
+    TestTrue(TEXT("each producer's items arrive in its order"), bInOrder);
+    TestTrue(TEXT("queue empty afterwards"), Queue.IsEmpty());
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FProviderEventChannel_Coalescing_Test,
+    "UnrealBanana.Events.ProviderEventChannel",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FProviderEventChannel_Coalescing_Test::RunTest(const FString&)
+{
+    using NanoBanana::FProviderEvent;
+    using NanoBanana::FProviderEventChannel;
+
+    // Progress collapses to the latest value, but never past a non-progress event.
+    {
+        TArray<FString> Seen;
+        TSharedRef<FProviderEventChannel, ESPMode::ThreadSafe> Channel = FProviderEventChannel::Create(
+            [&Seen](FProviderEvent& Event) { Seen.Add(Describe(Event)); });
+        for (int32 i = 1; i <= 50; ++i) Channel->Push(FProviderEvent::MakeProgress(i / 100.0f, TEXT("polling")));
+        Channel->Push(FProviderEvent::MakeRequestBuilt(NanoBanana::MakeSharedBytes(TArray<uint8>{ 1 })));
+        for (int32 i = 51; i <= 80; ++i) Channel->Push(FProviderEvent::MakeProgress(i / 100.0f, TEXT("polling")));
+        Channel->Push(FProviderEvent::MakeFailed(TEXT("boom")));
+        for (int32 i = 81; i <= 90; ++i) Channel->Push(FProviderEvent::MakeProgress(i / 100.0f, TEXT("polling")));
+
+        const int32 Delivered = Channel->Drain();
+        TestEqual(TEXT("coalesced order"), FString::Join(Seen, TEXT(",")), FString(TEXT("P0.50,B,P0.80,Fboom,P0.90")));
+        TestEqual(TEXT("delivered count"), Delivered, 5);
+        TestEqual(TEXT("second drain is empty"), Channel->Drain(), 0);
+        Channel->Close();
+    }
+
+    // More events than ring slots spill over without loss or reordering.
+    {
+        TArray<FString> Seen;
+        TSharedRef<FProviderEventChannel, ESPMode::ThreadSafe> Channel = FProviderEventChannel::Create(
+            [&Seen](FProviderEvent& Event) { Seen.Add(Describe(Event)); });
+        TArray<FString> Expected;
+        for (int32 i = 0; i < (int32)FProviderEventChannel::Capacity * 3; ++i)
+        {
+            Channel->Push(FProviderEvent::MakeFailed(FString::FromInt(i)));
+            Expected.Add(FString::Printf(TEXT("F%d"), i));
+        }
+        Channel->Drain();
+        TestTrue(TEXT("overflow delivered in order"), Seen == Expected);
+        Channel->Close();
+    }
+
+    // A handler that closes the channel (the action finishing) stops delivery at once.
+    {
+        TArray<FString> Seen;
+        TSharedPtr<FProviderEventChannel, ESPMode::ThreadSafe> Channel;
+        Channel = FProviderEventChannel::Create([&Seen, &Channel](FProviderEvent& Event)
+        {
+            Seen.Add(Describe(Event));
+            if (Event.Kind == FProviderEvent::EKind::Failed) Channel->Close();
+        });
+        Channel->Push(FProviderEvent::MakeProgress(0.3f, TEXT("x")));
+        Channel->Push(FProviderEvent::MakeFailed(TEXT("first")));
+        Channel->Push(FProviderEvent::MakeFailed(TEXT("second")));
+        Channel->Push(FProviderEvent::MakeProgress(0.9f, TEXT("x")));
+        Channel->Drain();
+        TestEqual(TEXT("nothing after close"), FString::Join(Seen, TEXT(",")), FString(TEXT("P0.30,Ffirst")));
+        Channel->Push(FProviderEvent::MakeFailed(TEXT("late")));
+        TestEqual(TEXT("pushes after close are dropped"), Channel->Drain(), 0);
+    }
+
+    // Concurrent producers, drained while they run, as the per-frame pump does.
+    {
+        constexpr int32 NumProducers = 4;
+        constexpr int32 PerProducer = 2000;
+        TArray<int32> Next;
+        Next.Init(0, NumProducers);
+        bool bInOrder = true;
+        int32 Terminal = 0;
+        TSharedRef<FProviderEventChannel, ESPMode::ThreadSafe> Channel = FProviderEventChannel::Create(
+            [&](FProviderEvent& Event)
+            {
+                if (Event.Kind != FProviderEvent::EKind::Failed) return;
+                FString P, I;
+                Event.Text.Split(TEXT(":"), &P, &I);
+                const int32 Producer = FCString::Atoi(*P);
+                bInOrder &= FCString::Atoi(*I) == Next[Producer];
+                ++Next[Producer];
+                ++Terminal;
+            });
+
+        TArray<TFuture<void>> Producers;
+        for (int32 p = 0; p < NumProducers; ++p)
+        {
+            Producers.Add(Async(EAsyncExecution::Thread, [Channel, p]()
+            {
+                for (int32 i = 0; i < PerProducer; ++i)
+                {
+                    Channel->Push(FProviderEvent::MakeProgress(0.5f, TEXT("tick")));
+                    Channel->Push(FProviderEvent::MakeFailed(FString::Printf(TEXT("%d:%d"), p, i)));
+                }
+            }));
+        }
+        const double Deadline = FPlatformTime::Seconds() + 30.0;
+        while (Terminal < NumProducers * PerProducer && FPlatformTime::Seconds() < Deadline)
+        {
+            Channel->Drain();
+            FPlatformProcess::Sleep(0.001f);
+        }
+        for (TFuture<void>& Producer : Producers) Producer.Wait();
+        Channel->Drain();
+
+        TestEqual(TEXT("concurrent: no event lost"), Terminal, NumProducers * PerProducer);
+        TestTrue(TEXT("concurrent: per-producer order kept"), bInOrder);
+        Channel->Close();
+    }
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
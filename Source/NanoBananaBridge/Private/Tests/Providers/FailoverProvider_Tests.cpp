@@ -0,0 +1,305 @@
+// Vendor failover chain with scripted vendors (no HTTP): target ordering, moving down the
+// chain on failure, hedging a slow vendor with the next one, the combined error when every
+// target fails, which 429s reach the caller, and a leg's download start not counting as a win.
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Containers/Ticker.h"
+
+#include "NanoBananaSettings.h"
+#include "Providers/FailoverProvider.h"
+#include "Http/HedgePolicy.h"
+#include "Tests/TestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    using FRunResult = NanoBanana::Tests::FProviderRun::FResult;
+
+    /** What a scripted vendor does, and what happened to it. */
+    struct FScript
+    {
+        double Delay = 0.05;
+        bool bSucceed = true;
+        uint8 Marker = 0;
+        /** At least 0: answers 429 with this Retry-After before failing. */
+        float RateLimitRetryAfter = -1.0f;
+        /** Asks for result file paths before finishing, as a downloading provider does. */
+        bool bDownloads = false;
+        int32 Submits = 0;
+        int32 DownloadPathsGranted = 0;
+        bool bCanceled = false;
+    };
+    using FScripts = TMap<ENanoBananaVendor, TSharedRef<FScript>>;
+
+    /** Succeeds with a one-byte "image" (its marker) or fails, after its delay, unless canceled. */
+    class FScriptedProvider : public IImageGenProvider
+    {
+    public:
+        FScriptedProvider(TSharedRef<FScript> InScript, ENanoBananaVendor InVendor) : Script(InScript), Vendor(InVendor) {}
+
+        virtual void Submit(const FNanoBananaRequest&, const TArray<NanoBanana::Image::FEncodedReferenceRef>&, const FProviderCallbacks& Callbacks) override
+        {
+            ++Script->Submits;
+            TSharedRef<FScript> S = Script;
+            Timer = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([S, Callbacks, Vendor = Vendor](float)
+            {
+                if (S->bDownloads && Callbacks.ResolveDownloadPath && !Callbacks.ResolveDownloadPath(0, 1).IsEmpty())
+                {
+                    ++S->DownloadPathsGranted;
+                }
+                if (S->bSucceed)
+                {
+                    TArray<TArray<uint8>> Images;
+                    Images.Add({ S->Marker });
+                    if (Callbacks.OnSuccess) Callbacks.OnSuccess(MoveTemp(Images), { FString() }, NanoBanana::EmptySharedText());
+                }
+                else if (Callbacks.OnFailure)
+                {
+                    if (S->RateLimitRetryAfter >= 0.0f && Callbacks.OnRateLimited)
+                    {
+                        Callbacks.OnRateLimited(Vendor, S->RateLimitRetryAfter);
+                    }
+                    Callbacks.OnFailure(FString::Printf(TEXT("scripted failure %d"), S->Marker));
+                }
+                return false;
+            }), (float)Script->Delay);
+        }
+
+        virtual void Cancel() override
+        {
+            Script->bCanceled = true;
+            FTSTicker::GetCoreTicker().RemoveTicker(Timer);
+        }
+
+    private:
+        TSharedRef<FScript> Script;
+        ENanoBananaVendor Vendor;
+        FTSTicker::FDelegateHandle Timer;
+    };
+
+    /** API keys for every vendor (so no target is skipped) and hedging as requested. */
+    struct FScopedFailoverConfig
+    {
+        FString GoogleKey, FalKey, ReplicateKey;
+        bool bHedge;
+        FScopedFailoverConfig(bool bInHedge)
+        {
+            UNanoBananaSettings* S = GetMutableDefault<UNanoBananaSettings>();
+            GoogleKey = S->Google.ApiKey; FalKey = S->Fal.ApiKey; ReplicateKey = S->Replicate.ApiKey;
+            bHedge = S->bHedgeAcrossVendors;
+            S->Google.ApiKey = S->Fal.ApiKey = S->Replicate.ApiKey = TEXT("stand-in-key");
+            S->bHedgeAcrossVendors = bInHedge;
+        }
+        ~FScopedFailoverConfig()
+        {
+            UNanoBananaSettings* S = GetMutableDefault<UNanoBananaSettings>();
+            S->Google.ApiKey = GoogleKey; S->Fal.ApiKey = FalKey; S->Replicate.ApiKey = ReplicateKey;
+            S->bHedgeAcrossVendors = bHedge;
+        }
+    };
+
+    static FNanoBananaFailoverTarget MakeTarget(ENanoBananaVendor Vendor, ENanoBananaModel Model = ENanoBananaModel::NanoBanana2)
+    {
+        FNanoBananaFailoverTarget Target;
+        Target.Vendor = Vendor;
+        Target.Model = Model;
+        return Target;
+    }
+
+    /** Google first, then the chain; scripted vendors only, everything on the game thread. */
+    static FRunResult RunChain(const FScripts& Scripts, const TArray<FNanoBananaFailoverTarget>& Chain, ENanoBananaResolution Resolution = ENanoBananaResolution::Res1K,
+        FProviderCallbacks Extra = FProviderCallbacks())
+    {
+        FNanoBananaRequest Request;
+        Request.Vendor = ENanoBananaVendor::Google;
+        Request.Model = ENanoBananaModel::NanoBanana2;
+        Request.Resolution = Resolution;
+        Request.Prompt = TEXT("a banana");
+
+        TSharedRef<FFailoverProvider, ESPMode::ThreadSafe> Provider = MakeShared<FFailoverProvider, ESPMode::ThreadSafe>(Chain,
+            [Scripts](ENanoBananaVendor Vendor) -> TSharedPtr<IImageGenProvider, ESPMode::ThreadSafe>
+            {
+                const TSharedRef<FScript>* Script = Scripts.Find(Vendor);
+                if (!Script) return nullptr;
+                return MakeShared<FScriptedProvider, ESPMode::ThreadSafe>(*Script, Vendor);
+            });
+        // One settle frame lets the winner's cleanup (canceling the other legs) run.
+        return NanoBanana::Tests::RunProvider(*Provider, Request, 10.0, /*SettleFrames*/ 1, MoveTemp(Extra));
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFailoverProvider_Targets_Test,
+    "UnrealBanana.Providers.Failover.Targets",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FFailoverProvider_Targets_Test::RunTest(const FString&)
+{
+    FNanoBananaRequest Request;
+    Request.Vendor = ENanoBananaVendor::Fal;
+    Request.Model = ENanoBananaModel::NanoBananaPro;
+
+    const TArray<FNanoBananaFailoverTarget> Chain = {
+        MakeTarget(ENanoBananaVendor::Fal, ENanoBananaModel::NanoBananaPro),    // the request itself
+        MakeTarget(ENanoBananaVendor::Google, ENanoBananaModel::NanoBananaPro),
+        MakeTarget(ENanoBananaVendor::Replicate, ENanoBananaModel::NanoBananaPro), // no key
+        MakeTarget(ENanoBananaVendor::Fal, ENanoBananaModel::NanoBanana2),
+        MakeTarget(ENanoBananaVendor::Google, ENanoBananaModel::NanoBananaPro),  // repeated
+    };
+    const TArray<FNanoBananaFailoverTarget> Targets = FFailoverProvider::BuildTargets(Request, Chain,
+        [](ENanoBananaVendor Vendor) { return Vendor != ENanoBananaVendor::Replicate; });
+
+    if (!TestEqual(TEXT("request, then unique keyed chain targets"), Targets.Num(), 3)) return false;
+    TestTrue(TEXT("request's own target first"), Targets[0].Vendor == ENanoBananaVendor::Fal && Targets[0].Model == ENanoBananaModel::NanoBananaPro);
+    TestTrue(TEXT("then Google"), Targets[1].Vendor == ENanoBananaVendor::Google);
+    TestTrue(TEXT("then the other FAL model"), Targets[2].Vendor == ENanoBananaVendor::Fal && Targets[2].Model == ENanoBananaModel::NanoBanana2);
+    TestNotEqual(TEXT("latency keys differ per target"),
+        FFailoverProvider::MakeLatencyKey(Targets[0], ENanoBananaResolution::Res1K), FFailoverProvider::MakeLatencyKey(Targets[2], ENanoBananaResolution::Res1K));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFailoverProvider_Failover_Test,
+    "UnrealBanana.Providers.Failover.MovesDownTheChain",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FFailoverProvider_Failover_Test::RunTest(const FString&)
+{
+    FScopedFailoverConfig Config(/*bHedge*/ false);
+    FScripts Scripts;
+    Scripts.Add(ENanoBananaVendor::Google, MakeShared<FScript>());
+    Scripts.Add(ENanoBananaVendor::Fal, MakeShared<FScript>());
+    Scripts.Add(ENanoBananaVendor::Replicate, MakeShared<FScript>());
+    Scripts[ENanoBananaVendor::Google]->bSucceed = false;
+    Scripts[ENanoBananaVendor::Google]->Marker = 1;
+    Scripts[ENanoBananaVendor::Fal]->Marker = 2;
+    Scripts[ENanoBananaVendor::Replicate]->Marker = 3;
+
+    const FRunResult Result = RunChain(Scripts, { MakeTarget(ENanoBananaVendor::Fal), MakeTarget(ENanoBananaVendor::Replicate) });
+    TestTrue(FString::Printf(TEXT("completed without error (%s)"), *Result.Error), Result.bDone && Result.Error.IsEmpty());
+    TestTrue(TEXT("FAL's image"), Result.Images.Num() == 1 && Result.Images[0].Num() == 1 && Result.Images[0][0] == 2);
+    TestEqual(TEXT("Google tried once"), Scripts[ENanoBananaVendor::Google]->Submits, 1);
+    TestEqual(TEXT("FAL tried once"), Scripts[ENanoBananaVendor::Fal]->Submits, 1);
+    TestEqual(TEXT("Replicate never needed"), Scripts[ENanoBananaVendor::Replicate]->Submits, 0);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFailoverProvider_Hedge_Test,
+    "UnrealBanana.Providers.Failover.HedgesSlowVendor",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FFailoverProvider_Hedge_Test::RunTest(const FString&)
+{
+    FScopedFailoverConfig Config(/*bHedge*/ true);
+    // Google normally answers within 0.2 s at 2K; this time it hangs for 5 s.
+    const ENanoBananaResolution Resolution = ENanoBananaResolution::Res2K;
+    const FString GoogleKey = FFailoverProvider::MakeLatencyKey(MakeTarget(ENanoBananaVendor::Google), Resolution);
+    for (int32 i = 0; i < NanoBanana::Http::FHedgePolicy::WindowSize; ++i)
+    {
+        NanoBanana::Http::FHedgePolicy::Get().RecordPrimaryLatency(GoogleKey, 0.2f);
+    }
+
+    FScripts Scripts;
+    Scripts.Add(ENanoBananaVendor::Google, MakeShared<FScript>());
+    Scripts.Add(ENanoBananaVendor::Fal, MakeShared<FScript>());
+    Scripts[ENanoBananaVendor::Google]->Delay = 5.0;
+    Scripts[ENanoBananaVendor::Google]->Marker = 1;
+    Scripts[ENanoBananaVendor::Fal]->Delay = 0.2;
+    Scripts[ENanoBananaVendor::Fal]->Marker = 2;
+
+    const FRunResult Result = RunChain(Scripts, { MakeTarget(ENanoBananaVendor::Fal) }, Resolution);
+    TestTrue(FString::Printf(TEXT("completed without error (%s)"), *Result.Error), Result.bDone && Result.Error.IsEmpty());
+    TestTrue(TEXT("FAL's image"), Result.Images.Num() == 1 && Result.Images[0].Num() == 1 && Result.Images[0][0] == 2);
+    TestTrue(FString::Printf(TEXT("finished by the hedge, not the slow vendor (%.2f s)"), Result.Seconds), Result.Seconds < 2.0);
+    TestTrue(TEXT("slow vendor canceled"), Scripts[ENanoBananaVendor::Google]->bCanceled);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFailoverProvider_AllFail_Test,
+    "UnrealBanana.Providers.Failover.AllFail",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FFailoverProvider_AllFail_Test::RunTest(const FString&)
+{
+    FScopedFailoverConfig Config(/*bHedge*/ false);
+    FScripts Scripts;
+    Scripts.Add(ENanoBananaVendor::Google, MakeShared<FScript>());
+    Scripts.Add(ENanoBananaVendor::Fal, MakeShared<FScript>());
+    Scripts[ENanoBananaVendor::Google]->bSucceed = false;
+    Scripts[ENanoBananaVendor::Google]->Marker = 1;
+    Scripts[ENanoBananaVendor::Fal]->bSucceed = false;
+    Scripts[ENanoBananaVendor::Fal]->Marker = 2;
+
+    const FRunResult Result = RunChain(Scripts, { MakeTarget(ENanoBananaVendor::Fal) });
+    TestTrue(TEXT("failed"), Result.bDone && Result.Images.Num() == 0);
+    TestTrue(FString::Printf(TEXT("names every target's error (%s)"), *Result.Error),
+        Result.Error.Contains(TEXT("scripted failure 1")) && Result.Error.Contains(TEXT("scripted failure 2")));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFailoverProvider_RateLimit_Test,
+    "UnrealBanana.Providers.Failover.RateLimitEndsChain",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FFailoverProvider_RateLimit_Test::RunTest(const FString&)
+{
+    FScopedFailoverConfig Config(/*bHedge*/ false);
+    auto Run = [](float GoogleRetryAfter, float FalRetryAfter, TArray<ENanoBananaVendor>& OutForwarded)
+    {
+        FScripts Scripts;
+        Scripts.Add(ENanoBananaVendor::Google, MakeShared<FScript>());
+        Scripts.Add(ENanoBananaVendor::Fal, MakeShared<FScript>());
+        Scripts[ENanoBananaVendor::Google]->bSucceed = false;
+        Scripts[ENanoBananaVendor::Google]->RateLimitRetryAfter = GoogleRetryAfter;
+        Scripts[ENanoBananaVendor::Fal]->bSucceed = false;
+        Scripts[ENanoBananaVendor::Fal]->RateLimitRetryAfter = FalRetryAfter;
+
+        TSharedRef<TArray<ENanoBananaVendor>> Forwarded = MakeShared<TArray<ENanoBananaVendor>>();
+        FProviderCallbacks Extra;
+        Extra.OnRateLimited = [Forwarded](ENanoBananaVendor Vendor, float) { Forwarded->Add(Vendor); };
+        const FRunResult Result = RunChain(Scripts, { MakeTarget(ENanoBananaVendor::Fal) }, ENanoBananaResolution::Res1K, MoveTemp(Extra));
+        OutForwarded = *Forwarded;
+        return Result;
+    };
+
+    // Retry-After 0, so the scheduler's hold on a skipped vendor ends at once.
+    TArray<ENanoBananaVendor> Forwarded;
+    FRunResult Result = Run(/*Google*/ 0.0f, /*Fal*/ -1.0f, Forwarded);
+    TestTrue(TEXT("chain failed"), Result.bDone && !Result.Error.IsEmpty());
+    TestEqual(TEXT("a 429 on a target the chain moved past is not the chain's"), Forwarded.Num(), 0);
+
+    Result = Run(/*Google*/ -1.0f, /*Fal*/ 0.0f, Forwarded);
+    TestTrue(TEXT("chain failed again"), Result.bDone && !Result.Error.IsEmpty());
+    TestTrue(TEXT("the last target's 429 reaches the caller"), Forwarded.Num() == 1 && Forwarded[0] == ENanoBananaVendor::Fal);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFailoverProvider_DownloadIsNotAWin_Test,
+    "UnrealBanana.Providers.Failover.DownloadIsNotAWin",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FFailoverProvider_DownloadIsNotAWin_Test::RunTest(const FString&)
+{
+    FScopedFailoverConfig Config(/*bHedge*/ true);
+    const ENanoBananaResolution Resolution = ENanoBananaResolution::Res4K;
+    const FString GoogleKey = FFailoverProvider::MakeLatencyKey(MakeTarget(ENanoBananaVendor::Google), Resolution);
+    for (int32 i = 0; i < NanoBanana::Http::FHedgePolicy::WindowSize; ++i)
+    {
+        NanoBanana::Http::FHedgePolicy::Get().RecordPrimaryLatency(GoogleKey, 0.2f);
+    }
+
+    // Google is hedged by FAL, then starts downloading and fails; FAL must still be running.
+    FScripts Scripts;
+    Scripts.Add(ENanoBananaVendor::Google, MakeShared<FScript>());
+    Scripts.Add(ENanoBananaVendor::Fal, MakeShared<FScript>());
+    Scripts[ENanoBananaVendor::Google]->Delay = 0.6;
+    Scripts[ENanoBananaVendor::Google]->bDownloads = true;
+    Scripts[ENanoBananaVendor::Google]->bSucceed = false;
+    Scripts[ENanoBananaVendor::Fal]->Delay = 1.0;
+    Scripts[ENanoBananaVendor::Fal]->bDownloads = true;
+    Scripts[ENanoBananaVendor::Fal]->Marker = 2;
+
+    FProviderCallbacks Extra;
+    Extra.ResolveDownloadPath = [](int32 Index, int32) { return FString::Printf(TEXT("Result_%d.png"), Index); };
+    const FRunResult Result = RunChain(Scripts, { MakeTarget(ENanoBananaVendor::Fal) }, Resolution, MoveTemp(Extra));
+    TestTrue(FString::Printf(TEXT("the hedge delivered (%s)"), *Result.Error), Result.bDone && Result.Error.IsEmpty());
+    TestTrue(TEXT("FAL's image"), Result.Images.Num() == 1 && Result.Images[0].Num() == 1 && Result.Images[0][0] == 2);
+    TestEqual(TEXT("Google got the result files first"), Scripts[ENanoBananaVendor::Google]->DownloadPathsGranted, 1);
+    TestEqual(TEXT("its failure freed them for FAL"), Scripts[ENanoBananaVendor::Fal]->DownloadPathsGranted, 1);
+    return true;
+}
+
+#endif
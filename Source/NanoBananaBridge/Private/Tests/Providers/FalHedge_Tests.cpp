@@ -0,0 +1,260 @@
+// Hedged FAL submission against the loopback stand-in: a sync request running past the learned
+// threshold is raced against a queue submission, the first to reach a result wins and the other
+// is canceled (a queued loser also gets a cancel request, even one whose submission was still
+// in flight). Plus the percentile policy itself, and which sync outcomes feed it.
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#include "NanoBananaSettings.h"
+#include "Providers/Fal/FalAiProvider.h"
+#include "Http/HedgePolicy.h"
+#include "Http/PollLatencyModel.h"
+#include "Tests/FakeHttpServer.h"
+#include "Tests/TestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    using NanoBanana::Tests::FFakeHttpServer;
+    using FRunResult = NanoBanana::Tests::FProviderRun::FResult;
+    using NanoBanana::Http::FHedgePolicy;
+    using NanoBanana::Http::FHedgeStats;
+
+    /** Sync first with hedging on, both endpoints on the stand-in, status by polling. */
+    struct FScopedFalHedgeConfig
+    {
+        FFalVendorConfig Saved;
+        FScopedFalHedgeConfig(const FString& BaseUrl)
+        {
+            FFalVendorConfig& Fal = GetMutableDefault<UNanoBananaSettings>()->Fal;
+            Saved = Fal;
+            Fal.ApiKey = TEXT("stand-in-key");
+            Fal.bAlwaysUseQueue = false;
+            Fal.bStreamQueueStatus = false;
+            Fal.bHedgeSyncWithQueue = true;
+            Fal.HedgePercentile = 0.9f;
+            Fal.SyncBaseUrlOverride = BaseUrl / TEXT("sync");
+            Fal.QueueBaseUrlOverride = BaseUrl / TEXT("queue");
+        }
+        ~FScopedFalHedgeConfig()
+        {
+            GetMutableDefault<UNanoBananaSettings>()->Fal = Saved;
+        }
+    };
+
+    static FNanoBananaRequest MakeRequest(const FString& Slug)
+    {
+        FNanoBananaRequest Request;
+        Request.Vendor = ENanoBananaVendor::Fal;
+        Request.Model = ENanoBananaModel::Custom;
+        Request.CustomModelId = Slug;
+        Request.Prompt = TEXT("a banana");
+        return Request;
+    }
+
+    /** Teaches the global policy that sync requests for Slug usually answer within SyncSeconds. */
+    static void SeedSyncLatency(const FNanoBananaRequest& Request, float SyncSeconds)
+    {
+        const FString Key = NanoBanana::Http::FPollLatencyModel::MakeKey(ENanoBananaVendor::Fal, Request.CustomModelId, Request.Resolution);
+        for (int32 i = 0; i < FHedgePolicy::WindowSize; ++i)
+        {
+            FHedgePolicy::Get().RecordPrimaryLatency(Key, SyncSeconds);
+        }
+    }
+
+    /** Sync, queue submit/status/result and download routes for Slug; each test picks the timings. */
+    static void AddRoutes(FFakeHttpServer& Server, const FString& Slug, double SyncDelay, const FString& QueueStatus, const TArray<uint8>& ResultImage,
+        int32 SyncCode = 200, double QueueSubmitDelay = 0.0)
+    {
+        const FString ImageJson = FString::Printf(TEXT("{\"images\":[{\"url\":\"%s/files/0.png\"}]}"), *Server.GetBaseUrl());
+        Server.On(TEXT("POST"), TEXT("/sync/") + Slug, [ImageJson, SyncDelay, SyncCode](const FFakeHttpServer::FRequest&)
+        {
+            FFakeHttpServer::FResponse Response = SyncCode == 200
+                ? FFakeHttpServer::FResponse::Json(ImageJson)
+                : FFakeHttpServer::FResponse::Json(TEXT("{\"detail\":\"scripted\"}"), SyncCode);
+            Response.DelaySeconds = SyncDelay;
+            return Response;
+        });
+        Server.On(TEXT("POST"), TEXT("/queue/") + Slug, [QueueSubmitDelay](const FFakeHttpServer::FRequest&)
+        {
+            FFakeHttpServer::FResponse Response = FFakeHttpServer::FResponse::Json(TEXT("{\"request_id\":\"r1\"}"));
+            Response.DelaySeconds = QueueSubmitDelay;
+            return Response;
+        });
+        Server.On(TEXT("PUT"), TEXT("/queue/") + Slug + TEXT("/requests/r1/cancel"), [](const FFakeHttpServer::FRequest&) { return FFakeHttpServer::FResponse::Json(TEXT("{\"status\":\"CANCELLATION_REQUESTED\"}"), 202); });
+        Server.On(TEXT("GET"), TEXT("/queue/") + Slug + TEXT("/requests/r1/status"), [QueueStatus](const FFakeHttpServer::FRequest&)
+        {
+            return FFakeHttpServer::FResponse::Json(FString::Printf(TEXT("{\"status\":\"%s\"}"), *QueueStatus));
+        });
+        Server.On(TEXT("GET"), TEXT("/queue/") + Slug + TEXT("/requests/r1"), [ImageJson](const FFakeHttpServer::FRequest&) { return FFakeHttpServer::FResponse::Json(ImageJson); });
+        Server.On(TEXT("GET"), TEXT("/files/"), [ResultImage](const FFakeHttpServer::FRequest&) { return FFakeHttpServer::FResponse::Bytes(ResultImage, TEXT("image/png")); });
+    }
+
+    static FRunResult RunFalRequest(const FNanoBananaRequest& Request, double TimeoutSeconds)
+    {
+        TSharedRef<FFalAiProvider, ESPMode::ThreadSafe> Provider = MakeShared<FFalAiProvider, ESPMode::ThreadSafe>();
+        // Settle frames let the loser's cancellation go out.
+        return NanoBanana::Tests::RunProvider(*Provider, Request, TimeoutSeconds, /*SettleFrames*/ 20);
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHedgePolicy_Delay_Test,
+    "UnrealBanana.Http.Hedge.Policy",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FHedgePolicy_Delay_Test::RunTest(const FString&)
+{
+    TestEqual(TEXT("empty"), FHedgePolicy::Percentile({}, 0.9f), 0.0f);
+    TestEqual(TEXT("p90 of 1..10"), FHedgePolicy::Percentile({ 7, 1, 3, 10, 2, 9, 4, 8, 6, 5 }, 0.9f), 9.0f);
+    TestEqual(TEXT("p50 of 1..10"), FHedgePolicy::Percentile({ 7, 1, 3, 10, 2, 9, 4, 8, 6, 5 }, 0.5f), 5.0f);
+    TestEqual(TEXT("p100 is the max"), FHedgePolicy::Percentile({ 3, 1, 2 }, 1.0f), 3.0f);
+
+    FHedgePolicy Policy;
+    const FString Key = TEXT("Fal|test|1K");
+    TestEqual(TEXT("fallback without history"), Policy.GetHedgeDelay(Key, 0.9f, 20.0f, 60.0f), 20.0f);
+    TestEqual(TEXT("fallback capped by the timeout"), Policy.GetHedgeDelay(Key, 0.9f, 90.0f, 60.0f), 60.0f);
+
+    for (int32 i = 1; i < FHedgePolicy::MinSamples; ++i)
+    {
+        Policy.RecordPrimaryLatency(Key, (float)i);
+    }
+    TestEqual(TEXT("still the fallback below MinSamples"), Policy.GetHedgeDelay(Key, 0.9f, 20.0f, 60.0f), 20.0f);
+    for (int32 i = FHedgePolicy::MinSamples; i <= 10; ++i)
+    {
+        Policy.RecordPrimaryLatency(Key, (float)i);
+    }
+    TestEqual(TEXT("p90 of the window"), Policy.GetHedgeDelay(Key, 0.9f, 20.0f, 60.0f), 9.0f);
+    TestEqual(TEXT("p0 is the fastest sample"), Policy.GetHedgeDelay(Key, 0.0f, 20.0f, 60.0f), 1.0f);
+
+    for (int32 i = 0; i < FHedgePolicy::WindowSize; ++i)
+    {
+        Policy.RecordPrimaryLatency(Key, 0.01f);
+    }
+    TestEqual(TEXT("window keeps only recent samples"), Policy.NumSamples(Key), FHedgePolicy::WindowSize);
+    TestEqual(TEXT("old slow samples gone, floor applies"), Policy.GetHedgeDelay(Key, 0.9f, 20.0f, 60.0f), FHedgePolicy::MinHedgeDelaySeconds);
+
+    Policy.RecordOutcome(2.0f, -1.0f, false, 60.0f);
+    Policy.RecordOutcome(3.0f, 1.0f, true, 60.0f);
+    Policy.RecordOutcome(4.0f, 1.0f, false, 60.0f);
+    const FHedgeStats S = Policy.GetStats();
+    TestEqual(TEXT("jobs"), S.Jobs, (int64)3);
+    TestEqual(TEXT("hedged"), S.Hedged, (int64)2);
+    TestEqual(TEXT("backup wins"), S.BackupWins, (int64)1);
+    TestEqual(TEXT("primary wins"), S.PrimaryWins, (int64)1);
+    TestEqual(TEXT("saved up to timeout - hedge time"), S.SavedUpToSeconds, 59.0);
+    TestEqual(TEXT("p50 time to result"), S.P50Seconds, 3.0f);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFalAiProvider_HedgeQueueWins_Test,
+    "UnrealBanana.Providers.Fal.HedgeQueueWins",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FFalAiProvider_HedgeQueueWins_Test::RunTest(const FString&)
+{
+    const FString Slug = TEXT("fal-ai/hedge-test-slow-sync");
+    const TArray<uint8> ResultImage = { 0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 1, 8 };
+    FFakeHttpServer Server;
+    // The sync request hangs for 4 s; the queue has the result at once.
+    AddRoutes(Server, Slug, 4.0, TEXT("COMPLETED"), ResultImage);
+    if (!TestTrue(TEXT("stand-in server listening"), Server.Start())) return false;
+    FScopedFalHedgeConfig Config(Server.GetBaseUrl());
+
+    const FNanoBananaRequest Request = MakeRequest(Slug);
+    SeedSyncLatency(Request, 0.3f);
+    const FHedgeStats Before = FHedgePolicy::Get().GetStats();
+
+    const FRunResult Result = RunFalRequest(Request, 20.0);
+    const FHedgeStats After = FHedgePolicy::Get().GetStats();
+    TestTrue(FString::Printf(TEXT("completed without error (%s)"), *Result.Error), Result.bDone && Result.Error.IsEmpty());
+    TestTrue(TEXT("result image downloaded"), Result.Images.Num() == 1 && Result.Images[0] == ResultImage);
+    TestTrue(FString::Printf(TEXT("finished through the queue before the sync answered (%.2f s)"), Result.Seconds), Result.Seconds < 3.0);
+    TestEqual(TEXT("one sync request"), Server.CountRequests(TEXT("POST"), TEXT("/sync/")), 1);
+    TestEqual(TEXT("one queue submission"), Server.CountRequests(TEXT("POST"), TEXT("/queue/")), 1);
+    TestEqual(TEXT("counted as hedged"), After.Hedged - Before.Hedged, (int64)1);
+    TestEqual(TEXT("counted as a backup win"), After.BackupWins - Before.BackupWins, (int64)1);
+    AddInfo(FString::Printf(TEXT("hedged job finished in %.2f s"), Result.Seconds));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFalAiProvider_HedgeSyncWins_Test,
+    "UnrealBanana.Providers.Fal.HedgeSyncWins",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FFalAiProvider_HedgeSyncWins_Test::RunTest(const FString&)
+{
+    const FString Slug = TEXT("fal-ai/hedge-test-slow-queue");
+    const TArray<uint8> ResultImage = { 0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 8, 1 };
+    FFakeHttpServer Server;
+    // Hedged at ~0.3 s, but the queued copy never finishes; the sync answer at 1 s must win
+    // and the queued job must be canceled.
+    AddRoutes(Server, Slug, 1.0, TEXT("IN_PROGRESS"), ResultImage);
+    if (!TestTrue(TEXT("stand-in server listening"), Server.Start())) return false;
+    FScopedFalHedgeConfig Config(Server.GetBaseUrl());
+
+    const FNanoBananaRequest Request = MakeRequest(Slug);
+    SeedSyncLatency(Request, 0.3f);
+    const FHedgeStats Before = FHedgePolicy::Get().GetStats();
+
+    const FRunResult Result = RunFalRequest(Request, 20.0);
+    const FHedgeStats After = FHedgePolicy::Get().GetStats();
+    TestTrue(FString::Printf(TEXT("completed without error (%s)"), *Result.Error), Result.bDone && Result.Error.IsEmpty());
+    TestTrue(TEXT("result image downloaded"), Result.Images.Num() == 1 && Result.Images[0] == ResultImage);
+    TestEqual(TEXT("queue submitted as the hedge"), Server.CountRequests(TEXT("POST"), TEXT("/queue/")), 1);
+    TestEqual(TEXT("queued copy canceled"), Server.CountRequests(TEXT("PUT"), TEXT("/queue/") + Slug + TEXT("/requests/r1/cancel")), 1);
+    TestEqual(TEXT("one image download"), Server.CountRequests(TEXT("GET"), TEXT("/files/")), 1);
+    TestEqual(TEXT("counted as a primary win"), After.PrimaryWins - Before.PrimaryWins, (int64)1);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFalAiProvider_HedgeSyncWinsBeforeSubmit_Test,
+    "UnrealBanana.Providers.Fal.HedgeSyncWinsBeforeSubmit",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FFalAiProvider_HedgeSyncWinsBeforeSubmit_Test::RunTest(const FString&)
+{
+    const FString Slug = TEXT("fal-ai/hedge-test-slow-submit");
+    const TArray<uint8> ResultImage = { 0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 3, 3 };
+    FFakeHttpServer Server;
+    // Hedged at ~0.3 s; the sync answer at 0.8 s wins while FAL is still answering the queue
+    // submission (1.5 s). The job it queued must still be canceled once its id is known.
+    AddRoutes(Server, Slug, 0.8, TEXT("IN_PROGRESS"), ResultImage, 200, /*QueueSubmitDelay*/ 1.5);
+    if (!TestTrue(TEXT("stand-in server listening"), Server.Start())) return false;
+    FScopedFalHedgeConfig Config(Server.GetBaseUrl());
+
+    const FNanoBananaRequest Request = MakeRequest(Slug);
+    SeedSyncLatency(Request, 0.3f);
+
+    const FRunResult Result = RunFalRequest(Request, 20.0);
+    TestTrue(FString::Printf(TEXT("completed without error (%s)"), *Result.Error), Result.bDone && Result.Error.IsEmpty());
+    TestTrue(TEXT("sync result"), Result.Images.Num() == 1 && Result.Images[0] == ResultImage);
+
+    const FString CancelPath = TEXT("/queue/") + Slug + TEXT("/requests/r1/cancel");
+    NanoBanana::Tests::PumpUntil([&Server, &CancelPath]() { return Server.CountRequests(TEXT("PUT"), CancelPath) > 0; }, 5.0);
+    TestEqual(TEXT("queue submitted as the hedge"), Server.CountRequests(TEXT("POST"), TEXT("/queue/")), 1);
+    TestEqual(TEXT("late-queued copy canceled"), Server.CountRequests(TEXT("PUT"), CancelPath), 1);
+    TestEqual(TEXT("never watched"), Server.CountRequests(TEXT("GET"), TEXT("/queue/")), 0);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFalAiProvider_HedgeLatencySamples_Test,
+    "UnrealBanana.Providers.Fal.HedgeLatencySamples",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FFalAiProvider_HedgeLatencySamples_Test::RunTest(const FString&)
+{
+    const FString Slug = TEXT("fal-ai/hedge-test-sync-error");
+    const TArray<uint8> ResultImage = { 0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 5, 5 };
+    FFakeHttpServer Server;
+    // The sync endpoint fails fast with a 503; the serial fallback to the queue finishes the job.
+    AddRoutes(Server, Slug, 0.0, TEXT("COMPLETED"), ResultImage, 503);
+    if (!TestTrue(TEXT("stand-in server listening"), Server.Start())) return false;
+    FScopedFalHedgeConfig Config(Server.GetBaseUrl());
+
+    const FNanoBananaRequest Request = MakeRequest(Slug);
+    const FString Key = NanoBanana::Http::FPollLatencyModel::MakeKey(ENanoBananaVendor::Fal, Request.CustomModelId, Request.Resolution);
+    const int32 SamplesBefore = FHedgePolicy::Get().NumSamples(Key);
+
+    const FRunResult Result = RunFalRequest(Request, 20.0);
+    TestTrue(FString::Printf(TEXT("completed through the queue (%s)"), *Result.Error), Result.bDone && Result.Error.IsEmpty() && Result.Images.Num() == 1);
+    TestEqual(TEXT("a fast sync error is not a latency sample"), FHedgePolicy::Get().NumSamples(Key), SamplesBefore);
+    return true;
+}
+
+#endif
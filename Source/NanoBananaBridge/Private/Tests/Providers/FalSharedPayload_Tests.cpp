@@ -0,0 +1,127 @@
+// End-to-end allocation test for shared payload buffers: a FAL request whose sync attempt
+// fails over to the queue must send the same multi-megabyte body twice without ever copying
+// it, and a stand-in server checks both sends arrived whole.
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+
+#include "NanoBananaSettings.h"
+#include "Http/Base64Image.h"
+#include "Providers/Fal/FalAiProvider.h"
+#include "Tests/AllocationCounter.h"
+#include "Tests/FakeHttpServer.h"
+#include "Tests/TestHelpers.h"
+
+#include <atomic>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    /** Points the FAL vendor at the stand-in for the duration of a test. */
+    struct FScopedFalConfig
+    {
+        FFalVendorConfig Saved;
+        FScopedFalConfig(const FString& BaseUrl)
+        {
+            FFalVendorConfig& Fal = GetMutableDefault<UNanoBananaSettings>()->Fal;
+            Saved = Fal;
+            Fal.ApiKey = TEXT("stand-in-key");
+            Fal.bAlwaysUseQueue = false;
+            Fal.SyncBaseUrlOverride = BaseUrl / TEXT("sync");
+            Fal.QueueBaseUrlOverride = BaseUrl / TEXT("queue");
+        }
+        ~FScopedFalConfig()
+        {
+            GetMutableDefault<UNanoBananaSettings>()->Fal = Saved;
+        }
+    };
+
+    /** A reference large enough that any copy of the request body stands out. */
+    static NanoBanana::Image::FEncodedReferenceRef MakeLargeReference(int32 NumBytes)
+    {
+        FRandomStream Rng(7);
+        TArray<uint8> Bytes = { 0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A };
+        Bytes.Reserve(NumBytes);
+        while (Bytes.Num() < NumBytes) Bytes.Add((uint8)Rng.RandHelper(256));
+        return NanoBanana::Image::MakeEncodedReference(MoveTemp(Bytes));
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFalAiProvider_SharedPayload_Test,
+    "UnrealBanana.Providers.Fal.SharedPayload",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FFalAiProvider_SharedPayload_Test::RunTest(const FString&)
+{
+    using namespace NanoBanana::Tests;
+
+    FFakeHttpServer Server;
+    const TArray<uint8> ResultImage = { 0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 1, 2, 3, 4 };
+    // Sync fails softly, so the provider falls back to the queue with the same body.
+    Server.On(TEXT("POST"), TEXT("/sync/"), [](const FFakeHttpServer::FRequest&) { return FFakeHttpServer::FResponse::Json(TEXT("{\"detail\":\"busy\"}"), 503); });
+    Server.On(TEXT("POST"), TEXT("/queue/"), [](const FFakeHttpServer::FRequest&) { return FFakeHttpServer::FResponse::Json(TEXT("{\"request_id\":\"r1\"}")); });
+    Server.On(TEXT("GET"), TEXT("/queue/fal-ai/nano-banana/requests/r1/status"), [](const FFakeHttpServer::FRequest&) { return FFakeHttpServer::FResponse::Json(TEXT("{\"status\":\"COMPLETED\"}")); });
+    Server.On(TEXT("GET"), TEXT("/queue/fal-ai/nano-banana/requests/r1"), [&Server](const FFakeHttpServer::FRequest&)
+    {
+        return FFakeHttpServer::FResponse::Json(FString::Printf(TEXT("{\"images\":[{\"url\":\"%s/files/0.png\"}]}"), *Server.GetBaseUrl()));
+    });
+    Server.On(TEXT("GET"), TEXT("/files/"), [ResultImage](const FFakeHttpServer::FRequest&) { return FFakeHttpServer::FResponse::Bytes(ResultImage, TEXT("image/png")); });
+    if (!TestTrue(TEXT("stand-in server listening"), Server.Start())) return false;
+    FScopedFalConfig Config(Server.GetBaseUrl());
+
+    FNanoBananaRequest Request;
+    Request.Vendor = ENanoBananaVendor::Fal;
+    Request.Model = ENanoBananaModel::NanoBanana;
+    Request.Prompt = TEXT("a banana");
+    const TArray<NanoBanana::Image::FEncodedReferenceRef> References = { MakeLargeReference(3 * 1024 * 1024) };
+    const int64 BodySize = FFalAiProvider::BuildRequestBody(Request, References).Num();
+
+    TSharedRef<FProviderRun, ESPMode::ThreadSafe> Run = MakeShared<FProviderRun, ESPMode::ThreadSafe>();
+    TSharedRef<std::atomic<int32>, ESPMode::ThreadSafe> RequestBuiltCalls = MakeShared<std::atomic<int32>, ESPMode::ThreadSafe>(0);
+    FProviderCallbacks Callbacks = Run->MakeCallbacks();
+    Callbacks.OnRequestBuilt = [RequestBuiltCalls](const NanoBanana::FSharedBytes&) { ++*RequestBuiltCalls; };
+
+    TSharedRef<FFalAiProvider, ESPMode::ThreadSafe> Provider = MakeShared<FFalAiProvider, ESPMode::ThreadSafe>();
+    int64 NumAllocations = 0;
+    int64 NumLarge = 0;
+    bool bCounted = false;
+    {
+        // Anything at least half the body is a whole-body copy; nothing else in a request is that big.
+        FScopedAllocationCounter Counter((SIZE_T)(BodySize / 2));
+        bCounted = Counter.IsActive();
+
+        Provider->Submit(Request, References, Callbacks);
+        PumpUntil([&Run]() { return Run->IsDone(); }, 20.0);
+        NumAllocations = Counter.GetNumAllocations();
+        NumLarge = Counter.GetNumLargeAllocations();
+    }
+
+    const FProviderRun::FResult Result = Run->GetResult();
+    TestTrue(FString::Printf(TEXT("completed without error (%s)"), *Result.Error), Result.bDone && Result.Error.IsEmpty());
+    TestTrue(TEXT("result image downloaded"), Result.Images.Num() == 1 && Result.Images[0] == ResultImage);
+    TestEqual(TEXT("OnRequestBuilt fired once"), RequestBuiltCalls->load(), 1);
+
+    const TArray<FFakeHttpServer::FRequest> Seen = Server.GetRequests();
+    int32 BodySends = 0;
+    for (const FFakeHttpServer::FRequest& Sent : Seen)
+    {
+        if (Sent.Method != TEXT("POST")) continue;
+        ++BodySends;
+        TestEqual(FString::Printf(TEXT("%s received the whole body"), *Sent.Path), Sent.BodyBytes, BodySize);
+    }
+    TestEqual(TEXT("sync attempt and queue fallback both sent the body"), BodySends, 2);
+
+    if (!bCounted)
+    {
+        AddWarning(TEXT("Allocator does not route through GMalloc in this build; allocation counts skipped."));
+        return true;
+    }
+    // The body is built once into its final buffer; sending it twice and handing it to
+    // OnRequestBuilt only bumps reference counts.
+    TestEqual(TEXT("body-sized allocations per request"), NumLarge, (int64)1);
+    AddInfo(FString::Printf(TEXT("body %.1f MB; %lld body-sized allocation(s), %lld allocations in total (all threads) for one request"),
+        BodySize / (1024.0 * 1024.0), NumLarge, NumAllocations));
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
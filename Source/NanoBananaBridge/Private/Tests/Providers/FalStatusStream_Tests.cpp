@@ -0,0 +1,157 @@
+// FAL queue status streaming against the loopback stand-in: the result is fetched as soon as
+// the stream reports COMPLETED (not when it closes, and without status polls), a stream that
+// drops early hands over to polling, and the status field is read straight from UTF-8.
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#include "NanoBananaSettings.h"
+#include "Providers/Fal/FalAiProvider.h"
+#include "Tests/FakeHttpServer.h"
+#include "Tests/TestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    using NanoBanana::Tests::FFakeHttpServer;
+    using FRunResult = NanoBanana::Tests::FProviderRun::FResult;
+
+    const TCHAR* StatusPath = TEXT("/queue/fal-ai/nano-banana/requests/r1/status");
+
+    /** Queue-only FAL against the stand-in, with status streaming on. */
+    struct FScopedFalStreamConfig
+    {
+        FFalVendorConfig Saved;
+        FScopedFalStreamConfig(const FString& BaseUrl)
+        {
+            FFalVendorConfig& Fal = GetMutableDefault<UNanoBananaSettings>()->Fal;
+            Saved = Fal;
+            Fal.ApiKey = TEXT("stand-in-key");
+            Fal.bAlwaysUseQueue = true;
+            Fal.bStreamQueueStatus = true;
+            Fal.QueueBaseUrlOverride = BaseUrl / TEXT("queue");
+        }
+        ~FScopedFalStreamConfig()
+        {
+            GetMutableDefault<UNanoBananaSettings>()->Fal = Saved;
+        }
+    };
+
+    /** Submit, result and download routes shared by both tests; status routes are added per test. */
+    static void AddQueueRoutes(FFakeHttpServer& Server, const TArray<uint8>& ResultImage)
+    {
+        Server.On(TEXT("POST"), TEXT("/queue/"), [](const FFakeHttpServer::FRequest&) { return FFakeHttpServer::FResponse::Json(TEXT("{\"request_id\":\"r1\"}")); });
+        Server.On(TEXT("GET"), TEXT("/files/"), [ResultImage](const FFakeHttpServer::FRequest&) { return FFakeHttpServer::FResponse::Bytes(ResultImage, TEXT("image/png")); });
+    }
+
+    static void AddResultRoute(FFakeHttpServer& Server)
+    {
+        Server.On(TEXT("GET"), TEXT("/queue/fal-ai/nano-banana/requests/r1"), [&Server](const FFakeHttpServer::FRequest&)
+        {
+            return FFakeHttpServer::FResponse::Json(FString::Printf(TEXT("{\"images\":[{\"url\":\"%s/files/0.png\"}]}"), *Server.GetBaseUrl()));
+        });
+    }
+
+    static FRunResult RunFalRequest(double TimeoutSeconds)
+    {
+        FNanoBananaRequest Request;
+        Request.Vendor = ENanoBananaVendor::Fal;
+        Request.Model = ENanoBananaModel::NanoBanana;
+        Request.Prompt = TEXT("a banana");
+
+        TSharedRef<FFalAiProvider, ESPMode::ThreadSafe> Provider = MakeShared<FFalAiProvider, ESPMode::ThreadSafe>();
+        return NanoBanana::Tests::RunProvider(*Provider, Request, TimeoutSeconds);
+    }
+
+    static int32 CountExactPath(const FFakeHttpServer& Server, const FString& Path)
+    {
+        int32 Count = 0;
+        for (const FFakeHttpServer::FRequest& Seen : Server.GetRequests())
+        {
+            if (Seen.Method == TEXT("GET") && Seen.Path == Path) ++Count;
+        }
+        return Count;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFalAiProvider_ParseQueueStatus_Test,
+    "UnrealBanana.Providers.Fal.ParseQueueStatus",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FFalAiProvider_ParseQueueStatus_Test::RunTest(const FString&)
+{
+    auto Parse = [](const ANSICHAR* Json)
+    {
+        return FFalAiProvider::ParseQueueStatus(TConstArrayView<uint8>((const uint8*)Json, FCStringAnsi::Strlen(Json)));
+    };
+    TestTrue(TEXT("queued"), Parse("{\"status\":\"IN_QUEUE\",\"queue_position\":3}") == EFalQueueStatus::InQueue);
+    TestTrue(TEXT("running, spaced"), Parse("{ \"request_id\": \"r1\", \"status\" : \"IN_PROGRESS\", \"logs\": [] }") == EFalQueueStatus::InProgress);
+    TestTrue(TEXT("completed"), Parse("{\"status\":\"COMPLETED\",\"response_url\":\"https://x/r1\"}") == EFalQueueStatus::Completed);
+    TestTrue(TEXT("lower case"), Parse("{\"status\":\"completed\"}") == EFalQueueStatus::Completed);
+    TestTrue(TEXT("failed"), Parse("{\"status\":\"ERROR\"}") == EFalQueueStatus::Failed);
+    TestTrue(TEXT("no status"), Parse("{\"detail\":\"not found\"}") == EFalQueueStatus::Unknown);
+    TestTrue(TEXT("unterminated"), Parse("{\"status\":\"COMPL") == EFalQueueStatus::Unknown);
+    TestTrue(TEXT("status as a value is skipped"), Parse("{\"kind\":\"status\",\"status\":\"IN_QUEUE\"}") == EFalQueueStatus::InQueue);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFalAiProvider_StatusStream_Test,
+    "UnrealBanana.Providers.Fal.StatusStream",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FFalAiProvider_StatusStream_Test::RunTest(const FString&)
+{
+    const TArray<uint8> ResultImage = { 0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 5, 6, 7, 8 };
+    FFakeHttpServer Server;
+    AddQueueRoutes(Server, ResultImage);
+    // COMPLETED arrives at ~0.4 s but the stream stays open for another 5 s: the client must
+    // act on the event, not on the connection closing.
+    Server.On(TEXT("GET"), FString(StatusPath) + TEXT("/stream"), [](const FFakeHttpServer::FRequest&)
+    {
+        return FFakeHttpServer::FResponse::EventStream({
+            { 0.0, TEXT("{\"status\":\"IN_QUEUE\",\"queue_position\":0}") },
+            { 0.2, TEXT("{\"status\":\"IN_PROGRESS\",\"logs\":[]}") },
+            { 0.2, TEXT("{\"status\":\"COMPLETED\",\"logs\":[]}") },
+            { 5.0, TEXT("{\"status\":\"COMPLETED\"}") },
+        });
+    });
+    Server.On(TEXT("GET"), StatusPath, [](const FFakeHttpServer::FRequest&) { return FFakeHttpServer::FResponse::Json(TEXT("{\"status\":\"COMPLETED\"}")); });
+    AddResultRoute(Server);
+    if (!TestTrue(TEXT("stand-in server listening"), Server.Start())) return false;
+    FScopedFalStreamConfig Config(Server.GetBaseUrl());
+
+    const FRunResult Result = RunFalRequest(20.0);
+    TestTrue(FString::Printf(TEXT("completed without error (%s)"), *Result.Error), Result.bDone && Result.Error.IsEmpty());
+    TestTrue(TEXT("result image downloaded"), Result.Images.Num() == 1 && Result.Images[0] == ResultImage);
+    TestTrue(FString::Printf(TEXT("result fetched on the COMPLETED event (%.2f s)"), Result.Seconds), Result.Seconds < 3.0);
+    TestEqual(TEXT("one status stream"), CountExactPath(Server, FString(StatusPath) + TEXT("/stream")), 1);
+    TestEqual(TEXT("no status polls"), CountExactPath(Server, StatusPath), 0);
+    AddInfo(FString::Printf(TEXT("streamed job finished in %.2f s"), Result.Seconds));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFalAiProvider_StatusStreamFallback_Test,
+    "UnrealBanana.Providers.Fal.StatusStreamFallback",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FFalAiProvider_StatusStreamFallback_Test::RunTest(const FString&)
+{
+    const TArray<uint8> ResultImage = { 0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 9, 9 };
+    FFakeHttpServer Server;
+    AddQueueRoutes(Server, ResultImage);
+    // The stream drops after one non-terminal event; polling has to finish the job.
+    Server.On(TEXT("GET"), FString(StatusPath) + TEXT("/stream"), [](const FFakeHttpServer::FRequest&)
+    {
+        return FFakeHttpServer::FResponse::EventStream({ { 0.0, TEXT("{\"status\":\"IN_PROGRESS\"}") } });
+    });
+    Server.On(TEXT("GET"), StatusPath, [](const FFakeHttpServer::FRequest&) { return FFakeHttpServer::FResponse::Json(TEXT("{\"status\":\"COMPLETED\"}")); });
+    AddResultRoute(Server);
+    if (!TestTrue(TEXT("stand-in server listening"), Server.Start())) return false;
+    FScopedFalStreamConfig Config(Server.GetBaseUrl());
+
+    const FRunResult Result = RunFalRequest(20.0);
+    TestTrue(FString::Printf(TEXT("completed without error (%s)"), *Result.Error), Result.bDone && Result.Error.IsEmpty());
+    TestTrue(TEXT("result image downloaded"), Result.Images.Num() == 1 && Result.Images[0] == ResultImage);
+    TestEqual(TEXT("one status stream"), CountExactPath(Server, FString(StatusPath) + TEXT("/stream")), 1);
+    TestTrue(TEXT("polling took over"), CountExactPath(Server, StatusPath) >= 1);
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,140 @@
+// End-to-end test for Gemini streamGenerateContent: a local SSE stand-in paces one image per
+// chunk, and the provider must hand over the first image before the last one is even sent.
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/ScopeLock.h"
+#include "HttpModule.h"
+#include "HttpManager.h"
+
+#include "NanoBananaSettings.h"
+#include "Http/Base64Codec.h"
+#include "Providers/Google/GoogleGeminiProvider.h"
+#include "Tests/SseStandInServer.h"
+#include "Tests/TestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    /** Points the Google vendor at the stand-in for the duration of a test. */
+    struct FScopedGoogleConfig
+    {
+        FGoogleVendorConfig Saved;
+        FScopedGoogleConfig(const FString& BaseUrl, bool bStream)
+        {
+            FGoogleVendorConfig& Google = GetMutableDefault<UNanoBananaSettings>()->Google;
+            Saved = Google;
+            Google.ApiKey = TEXT("stand-in-key");
+            Google.BaseUrlOverride = BaseUrl;
+            Google.bStreamResponses = bStream;
+        }
+        ~FScopedGoogleConfig()
+        {
+            GetMutableDefault<UNanoBananaSettings>()->Google = Saved;
+        }
+    };
+
+    static TArray<uint8> MakeImageBytes(int32 Num, int32 Seed)
+    {
+        FRandomStream Rng(Seed);
+        TArray<uint8> Bytes;
+        Bytes.SetNumUninitialized(Num);
+        for (uint8& B : Bytes) B = (uint8)Rng.RandHelper(256);
+        return Bytes;
+    }
+
+    /** One streamGenerateContent chunk carrying a single inline image for candidate Index. */
+    static FString MakeImageChunk(const TArray<uint8>& Bytes, int32 Index)
+    {
+        return FString::Printf(TEXT("{\"candidates\":[{\"index\":%d,\"content\":{\"role\":\"model\",\"parts\":[{\"inlineData\":{\"mimeType\":\"image/png\",\"data\":\"%s\"}}]}}]}"),
+            Index, *NanoBanana::Base64::Encode(Bytes));
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGoogleGeminiProvider_Streaming_Test,
+    "UnrealBanana.Providers.Google.Streaming",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FGoogleGeminiProvider_Streaming_Test::RunTest(const FString&)
+{
+    using NanoBanana::Tests::FSseStandInServer;
+    using NanoBanana::Tests::FProviderRun;
+
+    constexpr int32 NumImages = 3;
+    constexpr double ChunkGapSeconds = 0.4;
+    TArray<TArray<uint8>> Expected;
+    TArray<FSseStandInServer::FScriptedEvent> Script;
+    Script.Add({ 0.05, TEXT("{\"candidates\":[{\"content\":{\"role\":\"model\",\"parts\":[{\"text\":\"Here you go.\"}]}}]}") });
+    for (int32 i = 0; i < NumImages; ++i)
+    {
+        Expected.Add(MakeImageBytes(512 * 1024, 100 + i));
+        Script.Add({ ChunkGapSeconds, MakeImageChunk(Expected.Last(), i) });
+    }
+    Script.Add({ 0.05, TEXT("{\"candidates\":[{\"finishReason\":\"STOP\"}],\"usageMetadata\":{\"totalTokenCount\":5160}}") });
+
+    FSseStandInServer Server(MoveTemp(Script));
+    if (!TestTrue(TEXT("stand-in server listening"), Server.Start())) return false;
+    FScopedGoogleConfig Config(Server.GetBaseUrl(), true);
+
+    // Shared with the callbacks, which run on worker threads and may outlive a timed-out wait.
+    struct FReady
+    {
+        FCriticalSection Lock;
+        TArray<int32> Order;
+        TArray<double> Times;
+        TArray<TArray<uint8>> Bytes;
+    };
+    TSharedRef<FReady, ESPMode::ThreadSafe> Ready = MakeShared<FReady, ESPMode::ThreadSafe>();
+    TSharedRef<FProviderRun, ESPMode::ThreadSafe> Run = MakeShared<FProviderRun, ESPMode::ThreadSafe>();
+    FProviderCallbacks Callbacks = Run->MakeCallbacks();
+    Callbacks.OnImageReady = [Ready](int32 Index, const TArray<uint8>& Bytes)
+    {
+        FScopeLock Guard(&Ready->Lock);
+        Ready->Order.Add(Index);
+        Ready->Times.Add(FPlatformTime::Seconds());
+        Ready->Bytes.Add(Bytes);
+    };
+
+    FNanoBananaRequest Request;
+    Request.Vendor = ENanoBananaVendor::Google;
+    Request.Prompt = TEXT("three bananas");
+    Request.NumImages = NumImages;
+
+    TSharedRef<FGoogleGeminiProvider, ESPMode::ThreadSafe> Provider = MakeShared<FGoogleGeminiProvider, ESPMode::ThreadSafe>();
+    Provider->Submit(Request, {}, Callbacks);
+
+    // Automation tests block the game thread, so pump the HTTP manager by hand.
+    const double Deadline = FPlatformTime::Seconds() + 20.0;
+    while (FPlatformTime::Seconds() < Deadline)
+    {
+        if (Run->IsDone()) break;
+        FHttpModule::Get().GetHttpManager().Tick(0.01f);
+        FPlatformProcess::Sleep(0.01f);
+    }
+    Server.WaitForCompletion(5.0);
+
+    const FProviderRun::FResult Result = Run->GetResult();
+    FScopeLock Guard(&Ready->Lock);
+    const TArray<int32>& ReadyOrder = Ready->Order;
+    const TArray<double>& ReadyTimes = Ready->Times;
+    TestTrue(FString::Printf(TEXT("completed without error (%s)"), *Result.Error), Result.bDone && Result.Error.IsEmpty());
+    TestTrue(TEXT("SSE endpoint requested"), Server.GetRequestLine().Contains(TEXT(":streamGenerateContent?alt=sse&key=")));
+    TestEqual(TEXT("one OnImageReady per image"), ReadyOrder.Num(), NumImages);
+    TestTrue(TEXT("OnImageReady in candidate order"), ReadyOrder == TArray<int32>({ 0, 1, 2 }));
+    TestTrue(TEXT("streamed bytes are the images"), Ready->Bytes == Expected);
+    TestTrue(TEXT("OnSuccess carries every image"), Result.Images == Expected);
+
+    const TArray<double> SendTimes = Server.GetEventSendTimes();
+    if (ReadyTimes.Num() > 0 && SendTimes.Num() >= NumImages + 1)
+    {
+        const double LastImageSent = SendTimes[NumImages];
+        TestTrue(TEXT("first image delivered before the last one was sent"), ReadyTimes[0] < LastImageSent);
+        AddInfo(FString::Printf(TEXT("first image after %.0f ms, last image sent at %.0f ms (relative to first chunk)"),
+            (ReadyTimes[0] - SendTimes[0]) * 1000.0, (LastImageSent - SendTimes[0]) * 1000.0));
+    }
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -4,9 +4,11 @@
 #include "Misc/AutomationTest.h"
 
 #include "NanoBananaTypes.h"
+#include "Http/Base64Image.h"
 #include "Providers/Google/GoogleGeminiProvider.h"
 #include "Providers/Fal/FalAiProvider.h"
 #include "Providers/Replicate/ReplicateProvider.h"
+#include "Providers/PayloadCapabilities.h"
 
 #if WITH_DEV_AUTOMATION_TESTS
 
@@ -25,18 +27,66 @@ namespace
         return R;
     }
 
-    static TArray<TArray<uint8>> MakeFakePngs(int32 N)
+    static TArray<NanoBanana::Image::FEncodedReferenceRef> MakeFakePngs(int32 N)
     {
-        TArray<TArray<uint8>> Out;
+        TArray<NanoBanana::Image::FEncodedReferenceRef> Out;
         for (int32 i = 0; i < N; ++i)
         {
             // Minimal "PNG" magic header + filler so SniffImageMimeType returns image/png.
             TArray<uint8> Bytes = {0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A,
                                     0x00, 0x00, 0x00, (uint8)(0x10 + i)};
-            Out.Add(MoveTemp(Bytes));
+            Out.Add(NanoBanana::Image::MakeEncodedReference(MoveTemp(Bytes)));
         }
         return Out;
     }
+
+    /** N distinct PNG-tagged references of Size bytes each, so payload size is dominated by images. */
+    static TArray<NanoBanana::Image::FEncodedReferenceRef> MakeSizedPngs(int32 N, int32 Size)
+    {
+        TArray<NanoBanana::Image::FEncodedReferenceRef> Out;
+        for (int32 i = 0; i < N; ++i)
+        {
+            TArray<uint8> Bytes;
+            Bytes.SetNumUninitialized(Size);
+            for (int32 b = 0; b < Size; ++b)
+            {
+                Bytes[b] = (uint8)((b * 7 + i * 131 + (b >> 8)) & 0xFF);
+            }
+            const uint8 Magic[] = {0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A};
+            FMemory::Memcpy(Bytes.GetData(), Magic, sizeof(Magic));
+            Out.Add(NanoBanana::Image::MakeEncodedReference(MoveTemp(Bytes)));
+        }
+        return Out;
+    }
+
+    static int32 CountOccurrences(const TArray<uint8>& Body, FAnsiStringView Needle)
+    {
+        int32 Count = 0;
+        for (int64 i = 0; i + Needle.Len() <= Body.Num(); ++i)
+        {
+            if (FMemory::Memcmp(Body.GetData() + i, Needle.GetData(), Needle.Len()) == 0)
+            {
+                ++Count;
+                i += Needle.Len() - 1;
+            }
+        }
+        return Count;
+    }
+
+    /** Each reference's base64 appears exactly once and the body is not much bigger than one copy of them. */
+    static void CheckEachImageSentOnce(FAutomationTestBase& Test, const TCHAR* What, const TArray<uint8>& Body,
+        const TArray<NanoBanana::Image::FEncodedReferenceRef>& Refs)
+    {
+        int64 PayloadBytes = 0;
+        for (int32 i = 0; i < Refs.Num(); ++i)
+        {
+            const FAnsiStringView B64 = Refs[i]->GetBase64();
+            PayloadBytes += Refs[i]->GetDataUri().Len();
+            Test.TestEqual(FString::Printf(TEXT("%s: image %d sent once"), What, i), CountOccurrences(Body, B64), 1);
+        }
+        Test.TestTrue(FString::Printf(TEXT("%s: body %d bytes <= one copy of images (%lld) + 1 KB"), What, Body.Num(), PayloadBytes),
+            Body.Num() <= PayloadBytes + 1024);
+    }
 }
 
 // ============================================================
@@ -76,6 +126,9 @@ bool FGoogleGeminiProvider_BuildEndpointUrl_Test::RunTest(const FString&)
     const FString UrlOverride = FGoogleGeminiProvider::BuildEndpointUrl(TEXT("https://my-proxy.example.com/gemini/"), TEXT("m"), TEXT(""));
     TestTrue(TEXT("override + trailing slash trimmed"), UrlOverride.StartsWith(TEXT("https://my-proxy.example.com/gemini/models/m:generateContent")));
     TestFalse(TEXT("no key -> no query"), UrlOverride.Contains(TEXT("?key=")));
+
+    const FString StreamUrl = FGoogleGeminiProvider::BuildEndpointUrl(FString(), TEXT("m"), TEXT("KEY123"), true);
+    TestTrue(TEXT("streaming endpoint + alt=sse"), StreamUrl.EndsWith(TEXT("/models/m:streamGenerateContent?alt=sse&key=KEY123")));
     return true;
 }
 
@@ -85,7 +138,7 @@ IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGoogleGeminiProvider_BuildRequestJson_Test,
 bool FGoogleGeminiProvider_BuildRequestJson_Test::RunTest(const FString&)
 {
     const FNanoBananaRequest R = MakeBaseRequest();
-    const TArray<TArray<uint8>> Refs = MakeFakePngs(2);
+    const TArray<NanoBanana::Image::FEncodedReferenceRef> Refs = MakeFakePngs(2);
     const FString Json = FGoogleGeminiProvider::BuildRequestJson(R, Refs);
 
     TestTrue(TEXT("contains contents"), Json.Contains(TEXT("\"contents\"")));
@@ -143,7 +196,7 @@ IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFalAiProvider_BuildRequestJson_Test,
 bool FFalAiProvider_BuildRequestJson_Test::RunTest(const FString&)
 {
     const FNanoBananaRequest R = MakeBaseRequest();
-    const TArray<TArray<uint8>> Refs = MakeFakePngs(1);
+    const TArray<NanoBanana::Image::FEncodedReferenceRef> Refs = MakeFakePngs(1);
     const FString Json = FFalAiProvider::BuildRequestJson(R, Refs);
 
     TestTrue(TEXT("prompt"),         Json.Contains(TEXT("\"prompt\"")));
@@ -188,7 +241,7 @@ IMPLEMENT_SIMPLE_AUTOMATION_TEST(FReplicateProvider_BuildRequestJson_Test,
 bool FReplicateProvider_BuildRequestJson_Test::RunTest(const FString&)
 {
     const FNanoBananaRequest R = MakeBaseRequest();
-    const TArray<TArray<uint8>> Refs = MakeFakePngs(1);
+    const TArray<NanoBanana::Image::FEncodedReferenceRef> Refs = MakeFakePngs(1);
     const FString Json = FReplicateProvider::BuildRequestJson(R, Refs);
 
     TestTrue(TEXT("model field"),    Json.Contains(TEXT("\"model\"")) && Json.Contains(TEXT("google/nano-banana")));
@@ -203,4 +256,64 @@ bool FReplicateProvider_BuildRequestJson_Test::RunTest(const FString&)
     return true;
 }
 
+// ============================================================
+// Payload capabilities: every reference exactly once
+// ============================================================
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPayloadCapabilities_Lookup_Test,
+    "UnrealBanana.Providers.PayloadCapabilities.Lookup",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FPayloadCapabilities_Lookup_Test::RunTest(const FString&)
+{
+    const FPayloadCapabilities& Gemini = FPayloadCapabilityTable::Find(ENanoBananaVendor::Google, TEXT("gemini-3-pro-image-preview"));
+    TestEqual(TEXT("gemini inline key"), FString(Gemini.InlineDataKey), FString(TEXT("inlineData")));
+    TestEqual(TEXT("gemini mime key"), FString(Gemini.MimeTypeKey), FString(TEXT("mimeType")));
+
+    const FPayloadCapabilities& FalNano = FPayloadCapabilityTable::Find(ENanoBananaVendor::Fal, TEXT("fal-ai/nano-banana-pro"));
+    TestEqual(TEXT("fal nano-banana field"), FString(FalNano.ImageField), FString(TEXT("image_urls")));
+    TestTrue(TEXT("fal nano-banana list"), FalNano.bImageFieldIsList);
+
+    const FPayloadCapabilities& FalKontext = FPayloadCapabilityTable::Find(ENanoBananaVendor::Fal, TEXT("fal-ai/flux-pro/kontext"));
+    TestEqual(TEXT("fal kontext field"), FString(FalKontext.ImageField), FString(TEXT("image_url")));
+    TestEqual(TEXT("single-image model sends one"), FalKontext.ClampReferenceCount(3), 1);
+
+    const FPayloadCapabilities& Rep = FPayloadCapabilityTable::Find(ENanoBananaVendor::Replicate, TEXT("google/nano-banana"));
+    TestEqual(TEXT("replicate field"), FString(Rep.ImageField), FString(TEXT("image_input")));
+
+    const FPayloadCapabilities& RepCustom = FPayloadCapabilityTable::Find(ENanoBananaVendor::Replicate, TEXT("someone/custom-model"));
+    TestEqual(TEXT("replicate default"), FString(RepCustom.ImageField), FString(TEXT("image_input")));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FProviders_PayloadSize_Test,
+    "UnrealBanana.Providers.PayloadSize",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FProviders_PayloadSize_Test::RunTest(const FString&)
+{
+    const FNanoBananaRequest R = MakeBaseRequest();
+    const TArray<NanoBanana::Image::FEncodedReferenceRef> Refs = MakeSizedPngs(3, 24 * 1024);
+
+    const TArray<uint8> GeminiBody = FGoogleGeminiProvider::BuildRequestBody(R, Refs);
+    CheckEachImageSentOnce(*this, TEXT("gemini"), GeminiBody, Refs);
+    TestEqual(TEXT("gemini: no snake_case duplicate"), CountOccurrences(GeminiBody, "\"inline_data\""), 0);
+
+    const TArray<uint8> FalBody = FFalAiProvider::BuildRequestBody(R, Refs);
+    CheckEachImageSentOnce(*this, TEXT("fal"), FalBody, Refs);
+    TestEqual(TEXT("fal: no image_url alias"), CountOccurrences(FalBody, "\"image_url\""), 0);
+
+    const TArray<uint8> RepBody = FReplicateProvider::BuildRequestBody(R, Refs);
+    CheckEachImageSentOnce(*this, TEXT("replicate"), RepBody, Refs);
+    TestEqual(TEXT("replicate: no image alias"), CountOccurrences(RepBody, "\"image\""), 0);
+
+    // Single-image model: only the first reference goes out.
+    FNanoBananaRequest Kontext = R;
+    Kontext.Model = ENanoBananaModel::Custom;
+    Kontext.CustomModelId = TEXT("fal-ai/flux-pro/kontext");
+    const TArray<uint8> KontextBody = FFalAiProvider::BuildRequestBody(Kontext, Refs);
+    TestEqual(TEXT("kontext: first image once"), CountOccurrences(KontextBody, Refs[0]->GetBase64()), 1);
+    TestEqual(TEXT("kontext: second image dropped"), CountOccurrences(KontextBody, Refs[1]->GetBase64()), 0);
+    TestEqual(TEXT("kontext: single image_url"), CountOccurrences(KontextBody, "\"image_url\":\"data:"), 1);
+    return true;
+}
+
 #endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,311 @@
+// Replicate webhook completion against the loopback stand-in: the prediction is created with a
+// webhook pointing at the in-process listener, the test plays Replicate and posts the finished
+// prediction there, and the job completes from that callback without waiting on status polls.
+// Plus the callback signature check, and polling as usual when there is no public URL.
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "HttpModule.h"
+#include "Interfaces/IHttpRequest.h"
+
+#include "NanoBananaSettings.h"
+#include "Providers/Replicate/ReplicateProvider.h"
+#include "Http/Base64Codec.h"
+#include "Http/WebhookReceiver.h"
+#include "Http/WebhookSignature.h"
+#include "Tests/FakeHttpServer.h"
+#include "Tests/TestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    using NanoBanana::Tests::FFakeHttpServer;
+    using NanoBanana::Tests::FProviderRun;
+    using NanoBanana::Tests::PumpGameThread;
+
+    /** Port for the webhook listener; kept away from the default so a running editor session is not disturbed. */
+    constexpr int32 TestWebhookPort = 18089;
+
+    /** Signing secret the test plays Replicate with ("whsec_" + base64 of the key). */
+    constexpr const TCHAR* TestSigningSecret = TEXT("whsec_MfKQ9r8GKYqrTwjUPD8ILPZIo2LaLaSw");
+
+    /** Replicate against the stand-in, async mode with the webhook on; no public URL means no webhook. */
+    struct FScopedReplicateWebhookConfig
+    {
+        FReplicateVendorConfig Saved;
+        FScopedReplicateWebhookConfig(const FString& BaseUrl, bool bWithPublicUrl)
+        {
+            FReplicateVendorConfig& Replicate = GetMutableDefault<UNanoBananaSettings>()->Replicate;
+            Saved = Replicate;
+            Replicate.ApiKey = TEXT("stand-in-key");
+            Replicate.BaseUrlOverride = BaseUrl / TEXT("v1");
+            Replicate.bPreferSyncWait = false;
+            Replicate.bUseWebhook = true;
+            Replicate.WebhookListenPort = TestWebhookPort;
+            // The test reaches the listener over loopback, standing in for a tunnel.
+            Replicate.WebhookPublicUrl = bWithPublicUrl ? FString::Printf(TEXT("http://127.0.0.1:%d"), TestWebhookPort) : FString();
+            Replicate.WebhookSigningSecret = TestSigningSecret;
+        }
+        ~FScopedReplicateWebhookConfig()
+        {
+            GetMutableDefault<UNanoBananaSettings>()->Replicate = Saved;
+        }
+    };
+
+    /** Adds the Standard Webhooks headers Replicate sends, signed with Secret. */
+    static void SignCallback(IHttpRequest& Post, const FString& Body, const FString& Secret)
+    {
+        const FString Id = TEXT("msg_test");
+        const FString Timestamp = LexToString(FDateTime::UtcNow().ToUnixTimestamp());
+        TArray<uint8> Key;
+        NanoBanana::Base64::Decode(FStringView(Secret).RightChop(6), Key);
+        const FTCHARToUTF8 Signed(*FString::Printf(TEXT("%s.%s.%s"), *Id, *Timestamp, *Body));
+        uint8 Digest[32];
+        NanoBanana::Http::HmacSha256(Key, TConstArrayView<uint8>((const uint8*)Signed.Get(), Signed.Length()), Digest);
+        Post.SetHeader(TEXT("webhook-id"), Id);
+        Post.SetHeader(TEXT("webhook-timestamp"), Timestamp);
+        Post.SetHeader(TEXT("webhook-signature"), TEXT("v1,") + NanoBanana::Base64::Encode(Digest));
+    }
+
+    /** Posts Body to Url and records the listener's status in OutStatus (-1 if the request failed). */
+    static void PostCallback(const FString& Url, const FString& Body, const FString& Secret, TSharedRef<int32, ESPMode::ThreadSafe> OutStatus)
+    {
+        TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Post = FHttpModule::Get().CreateRequest();
+        Post->SetURL(Url);
+        Post->SetVerb(TEXT("POST"));
+        Post->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
+        Post->SetContentAsString(Body);
+        SignCallback(*Post, Body, Secret);
+        Post->OnProcessRequestComplete().BindLambda([OutStatus](FHttpRequestPtr, FHttpResponsePtr Resp, bool bOk)
+        {
+            *OutStatus = (bOk && Resp.IsValid()) ? Resp->GetResponseCode() : -1;
+        });
+        Post->ProcessRequest();
+    }
+
+    /** The webhook URL the provider put in the create-prediction body, once the stand-in has seen it. */
+    static FString FindWebhookUrl(const FFakeHttpServer& Server, bool& bOutHasFilter)
+    {
+        for (const FFakeHttpServer::FRequest& Seen : Server.GetRequests())
+        {
+            if (Seen.Method != TEXT("POST") || Seen.Path != TEXT("/v1/predictions")) continue;
+            const FUTF8ToTCHAR Text((const UTF8CHAR*)Seen.Body.GetData(), Seen.Body.Num());
+            TSharedPtr<FJsonObject> Json;
+            if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(FString(Text.Length(), Text.Get())), Json) || !Json.IsValid()) return FString();
+
+            const TArray<TSharedPtr<FJsonValue>>* Filter = nullptr;
+            bOutHasFilter = Json->TryGetArrayField(TEXT("webhook_events_filter"), Filter) && Filter
+                && Filter->Num() == 1 && (*Filter)[0]->AsString() == TEXT("completed");
+            FString Url;
+            Json->TryGetStringField(TEXT("webhook"), Url);
+            return Url;
+        }
+        return FString();
+    }
+
+    /** Whether the stand-in has seen the create-prediction request yet. */
+    static bool HasCreated(const FFakeHttpServer& Server)
+    {
+        return Server.CountRequests(TEXT("POST"), TEXT("/v1/predictions")) > 0;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWebhookSignature_Test,
+    "UnrealBanana.Http.WebhookSignature",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FWebhookSignature_Test::RunTest(const FString&)
+{
+    using namespace NanoBanana::Http;
+    auto ToHex = [](const uint8 (&Digest)[32]) { return BytesToHex(Digest, 32).ToLower(); };
+    auto Utf8 = [](const ANSICHAR* Text) { return TArray<uint8>((const uint8*)Text, FCStringAnsi::Strlen(Text)); };
+
+    uint8 Digest[32];
+    Sha256(Utf8("abc"), Digest);
+    TestEqual(TEXT("SHA-256 of abc"), ToHex(Digest), FString(TEXT("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad")));
+    TArray<uint8> Long;
+    Long.Init('a', 1000);
+    Sha256(Long, Digest);
+    TestEqual(TEXT("SHA-256 over several blocks"), ToHex(Digest), FString(TEXT("41edece42d63e8d9bf515a9ba6932e1c20cbc9f5a5d134645adb5db1b9737ea3")));
+    HmacSha256(Utf8("key"), Utf8("The quick brown fox jumps over the lazy dog"), Digest);
+    TestEqual(TEXT("HMAC-SHA256"), ToHex(Digest), FString(TEXT("f7bc83f430538424b13298e6aa6fb143ef4d59a14946175997479dbc2d1a3cd8")));
+
+    // The Standard Webhooks reference example.
+    FWebhookSignatureHeaders Headers;
+    Headers.Id = TEXT("msg_p5jXN8AQM9LWM0D4loKWxJek");
+    Headers.Timestamp = TEXT("1614265330");
+    Headers.Signature = TEXT("v1,g0hM9SsE+OTPJTGt/tmIKtSyZlE3uFJELVlNIOLJ1OE=");
+    const TArray<uint8> Body = Utf8("{\"test\": 2432232314}");
+    const int64 Now = 1614265330;
+    FString Reason;
+    TestTrue(TEXT("reference signature verifies"), VerifyWebhookSignature(TestSigningSecret, Headers, Body, Now, Reason));
+
+    FWebhookSignatureHeaders Rotated = Headers;
+    Rotated.Signature = TEXT("v1,AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA= ") + Headers.Signature;
+    TestTrue(TEXT("any listed signature may match"), VerifyWebhookSignature(TestSigningSecret, Rotated, Body, Now, Reason));
+
+    TestFalse(TEXT("tampered body"), VerifyWebhookSignature(TestSigningSecret, Headers, Utf8("{\"test\": 2432232315}"), Now, Reason));
+    TestFalse(TEXT("other secret"), VerifyWebhookSignature(TEXT("whsec_AAAAAAAAAAAAAAAAAAAAAAAA"), Headers, Body, Now, Reason));
+    TestFalse(TEXT("stale timestamp"), VerifyWebhookSignature(TestSigningSecret, Headers, Body, Now + WebhookTimestampToleranceSeconds + 1, Reason));
+    FWebhookSignatureHeaders Unsigned = Headers;
+    Unsigned.Signature.Reset();
+    TestFalse(TEXT("unsigned"), VerifyWebhookSignature(TestSigningSecret, Unsigned, Body, Now, Reason));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FReplicateProvider_WebhookBody_Test,
+    "UnrealBanana.Providers.Replicate.WebhookBody",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FReplicateProvider_WebhookBody_Test::RunTest(const FString&)
+{
+    FNanoBananaRequest Request;
+    Request.Vendor = ENanoBananaVendor::Replicate;
+    Request.Model = ENanoBananaModel::NanoBanana;
+    Request.Prompt = TEXT("a banana");
+
+    TSharedPtr<FJsonObject> Json;
+    FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(FReplicateProvider::BuildRequestJson(Request, {}, TEXT("http://127.0.0.1:8089/nanobanana/webhook?job=abc"))), Json);
+    if (!TestTrue(TEXT("body parses"), Json.IsValid())) return false;
+    TestEqual(TEXT("webhook url"), Json->GetStringField(TEXT("webhook")), FString(TEXT("http://127.0.0.1:8089/nanobanana/webhook?job=abc")));
+    const TArray<TSharedPtr<FJsonValue>>* Filter = nullptr;
+    TestTrue(TEXT("completed events only"), Json->TryGetArrayField(TEXT("webhook_events_filter"), Filter) && Filter && Filter->Num() == 1 && (*Filter)[0]->AsString() == TEXT("completed"));
+
+    TSharedPtr<FJsonObject> Plain;
+    FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(FReplicateProvider::BuildRequestJson(Request, {})), Plain);
+    TestTrue(TEXT("no webhook fields without a url"), Plain.IsValid() && !Plain->HasField(TEXT("webhook")) && !Plain->HasField(TEXT("webhook_events_filter")));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FReplicateProvider_WebhookCompletion_Test,
+    "UnrealBanana.Providers.Replicate.WebhookCompletion",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FReplicateProvider_WebhookCompletion_Test::RunTest(const FString&)
+{
+    const TArray<uint8> ResultImage = { 0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 4, 2 };
+    FFakeHttpServer Server;
+    Server.On(TEXT("POST"), TEXT("/v1/predictions"), [&Server](const FFakeHttpServer::FRequest&)
+    {
+        return FFakeHttpServer::FResponse::Json(FString::Printf(
+            TEXT("{\"id\":\"p1\",\"status\":\"starting\",\"urls\":{\"get\":\"%s/v1/predictions/p1\"}}"), *Server.GetBaseUrl()), 201);
+    });
+    Server.On(TEXT("GET"), TEXT("/v1/predictions/p1"), [](const FFakeHttpServer::FRequest&) { return FFakeHttpServer::FResponse::Json(TEXT("{\"id\":\"p1\",\"status\":\"processing\"}")); });
+    Server.On(TEXT("GET"), TEXT("/files/"), [ResultImage](const FFakeHttpServer::FRequest&) { return FFakeHttpServer::FResponse::Bytes(ResultImage, TEXT("image/png")); });
+    if (!TestTrue(TEXT("stand-in server listening"), Server.Start())) return false;
+    FScopedReplicateWebhookConfig Config(Server.GetBaseUrl(), /*bWithPublicUrl*/ true);
+
+    TSharedRef<FProviderRun, ESPMode::ThreadSafe> Run = MakeShared<FProviderRun, ESPMode::ThreadSafe>();
+    FNanoBananaRequest Request;
+    Request.Vendor = ENanoBananaVendor::Replicate;
+    Request.Model = ENanoBananaModel::NanoBanana;
+    Request.Prompt = TEXT("a banana");
+
+    TSharedRef<FReplicateProvider, ESPMode::ThreadSafe> Provider = MakeShared<FReplicateProvider, ESPMode::ThreadSafe>();
+    const double Start = FPlatformTime::Seconds();
+    Provider->Submit(Request, {}, Run->MakeCallbacks());
+
+    FString WebhookUrl;
+    bool bHasFilter = false;
+    // Shared with the callback POSTs' completions, which may outlive this function on timeout.
+    TSharedRef<int32, ESPMode::ThreadSafe> ForgedStatus = MakeShared<int32, ESPMode::ThreadSafe>(0);
+    TSharedRef<int32, ESPMode::ThreadSafe> WebhookStatus = MakeShared<int32, ESPMode::ThreadSafe>(0);
+    double CreatedAt = 0.0;
+    bool bCallbackSent = false;
+    while (FPlatformTime::Seconds() < Start + 15.0)
+    {
+        if (Run->IsDone()) break;
+        const FString Finished = FString::Printf(TEXT("{\"id\":\"p1\",\"status\":\"succeeded\",\"output\":[\"%s/files/0.png\"]}"), *Server.GetBaseUrl());
+        if (WebhookUrl.IsEmpty())
+        {
+            WebhookUrl = FindWebhookUrl(Server, bHasFilter);
+            CreatedAt = FPlatformTime::Seconds();
+            // Someone who learned the URL but not the secret: refused, and the job stays pending.
+            if (!WebhookUrl.IsEmpty()) PostCallback(WebhookUrl, Finished, TEXT("whsec_AAAAAAAAAAAAAAAAAAAAAAAA"), ForgedStatus);
+        }
+        // Play Replicate: report completion a moment after the prediction was created.
+        else if (!bCallbackSent && *ForgedStatus != 0 && FPlatformTime::Seconds() > CreatedAt + 0.3)
+        {
+            bCallbackSent = true;
+            PostCallback(WebhookUrl, Finished, TestSigningSecret, WebhookStatus);
+        }
+        PumpGameThread();
+    }
+    const double Seconds = FPlatformTime::Seconds() - Start;
+    // Let the signed callback's own completion arrive before checking its status.
+    Provider->Cancel();
+    for (int32 i = 0; i < 100 && *WebhookStatus == 0; ++i)
+    {
+        PumpGameThread();
+    }
+
+    const FProviderRun::FResult Result = Run->GetResult();
+    TestTrue(TEXT("webhook registered in the request body"), WebhookUrl.StartsWith(FString::Printf(TEXT("http://127.0.0.1:%d%s?job="), TestWebhookPort, NanoBanana::Http::FWebhookReceiver::RoutePath)));
+    TestTrue(TEXT("only completed events requested"), bHasFilter);
+    TestEqual(TEXT("listener refused the forged callback"), *ForgedStatus, 401);
+    TestEqual(TEXT("listener accepted the signed callback"), *WebhookStatus, 200);
+    TestTrue(FString::Printf(TEXT("completed without error (%s)"), *Result.Error), Result.bDone && Result.Error.IsEmpty());
+    TestTrue(TEXT("result image downloaded"), Result.Images.Num() == 1 && Result.Images[0] == ResultImage);
+    TestTrue(FString::Printf(TEXT("finished from the callback (%.2f s)"), Seconds), Seconds < FReplicateProvider::WebhookSafetyPollSeconds);
+    TestEqual(TEXT("no status polls before the safety-net delay"), Server.CountRequests(TEXT("GET"), TEXT("/v1/predictions/p1")), 0);
+    TestEqual(TEXT("token consumed"), NanoBanana::Http::FWebhookReceiver::Get().GetStats().Pending, 0);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FReplicateProvider_WebhookWithoutPublicUrl_Test,
+    "UnrealBanana.Providers.Replicate.WebhookWithoutPublicUrl",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FReplicateProvider_WebhookWithoutPublicUrl_Test::RunTest(const FString&)
+{
+    const TArray<uint8> ResultImage = { 0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 2, 4 };
+    FFakeHttpServer Server;
+    Server.On(TEXT("POST"), TEXT("/v1/predictions"), [&Server](const FFakeHttpServer::FRequest&)
+    {
+        return FFakeHttpServer::FResponse::Json(FString::Printf(
+            TEXT("{\"id\":\"p2\",\"status\":\"starting\",\"urls\":{\"get\":\"%s/v1/predictions/p2\"}}"), *Server.GetBaseUrl()), 201);
+    });
+    Server.On(TEXT("GET"), TEXT("/v1/predictions/p2"), [&Server](const FFakeHttpServer::FRequest&)
+    {
+        return FFakeHttpServer::FResponse::Json(FString::Printf(TEXT("{\"id\":\"p2\",\"status\":\"succeeded\",\"output\":[\"%s/files/0.png\"]}"), *Server.GetBaseUrl()));
+    });
+    Server.On(TEXT("GET"), TEXT("/files/"), [ResultImage](const FFakeHttpServer::FRequest&) { return FFakeHttpServer::FResponse::Bytes(ResultImage, TEXT("image/png")); });
+    if (!TestTrue(TEXT("stand-in server listening"), Server.Start())) return false;
+    FScopedReplicateWebhookConfig Config(Server.GetBaseUrl(), /*bWithPublicUrl*/ false);
+
+    TSharedRef<FProviderRun, ESPMode::ThreadSafe> Run = MakeShared<FProviderRun, ESPMode::ThreadSafe>();
+    FNanoBananaRequest Request;
+    Request.Vendor = ENanoBananaVendor::Replicate;
+    Request.Model = ENanoBananaModel::NanoBanana;
+    Request.Prompt = TEXT("a banana");
+
+    const int64 RegisteredBefore = NanoBanana::Http::FWebhookReceiver::Get().GetStats().Registered;
+    TSharedRef<FReplicateProvider, ESPMode::ThreadSafe> Provider = MakeShared<FReplicateProvider, ESPMode::ThreadSafe>();
+    const double Start = FPlatformTime::Seconds();
+    Provider->Submit(Request, {}, Run->MakeCallbacks());
+    bool bHasFilter = false;
+    FString WebhookUrl;
+    bool bCreated = false;
+    while (FPlatformTime::Seconds() < Start + 15.0)
+    {
+        if (Run->IsDone()) break;
+        if (!bCreated && HasCreated(Server))
+        {
+            bCreated = true;
+            WebhookUrl = FindWebhookUrl(Server, bHasFilter);
+        }
+        PumpGameThread();
+    }
+    const double Seconds = FPlatformTime::Seconds() - Start;
+    Provider->Cancel();
+
+    const FProviderRun::FResult Result = Run->GetResult();
+    TestTrue(TEXT("no webhook Replicate could not reach"), bCreated && WebhookUrl.IsEmpty());
+    TestEqual(TEXT("nothing registered with the listener"), NanoBanana::Http::FWebhookReceiver::Get().GetStats().Registered, RegisteredBefore);
+    TestTrue(FString::Printf(TEXT("completed without error (%s)"), *Result.Error), Result.bDone && Result.Error.IsEmpty());
+    TestTrue(TEXT("result image downloaded"), Result.Images.Num() == 1 && Result.Images[0] == ResultImage);
+    TestTrue(FString::Printf(TEXT("polled on the normal schedule (%.2f s)"), Seconds), Seconds < FReplicateProvider::WebhookSafetyPollSeconds);
+    return true;
+}
+
+#endif
@@ -0,0 +1,112 @@
+// Tests for the content-addressed encoded-reference cache (FReferenceCache) and snapshot keys.
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#include "Http/Base64Image.h"
+#include "Http/ReferenceCache.h"
+#include "Http/ReferencePreparer.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    static NanoBanana::Image::FEncodedReferenceRef MakeFakeReference(int32 NumBytes, uint8 Fill)
+    {
+        TArray<uint8> Bytes;
+        Bytes.Init(Fill, NumBytes);
+        const uint8 Magic[] = {0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A};
+        FMemory::Memcpy(Bytes.GetData(), Magic, sizeof(Magic));
+        return NanoBanana::Image::MakeEncodedReference(MoveTemp(Bytes));
+    }
+
+    static NanoBanana::Image::FReferenceSnapshot MakeSnapshot(int32 W, int32 H, FColor Fill)
+    {
+        NanoBanana::Image::FReferenceSnapshot Snap;
+        Snap.Size = FIntPoint(W, H);
+        Snap.Pixels.Init(Fill, W * H);
+        return Snap;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FReferenceCache_HitMiss_Test,
+    "UnrealBanana.ReferenceCache.HitMiss",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FReferenceCache_HitMiss_Test::RunTest(const FString&)
+{
+    using namespace NanoBanana::Image;
+    FReferenceCache Cache(16 * 1024 * 1024);
+
+    const FEncodedReferenceRef Ref = MakeFakeReference(1024, 0x11);
+    TestFalse(TEXT("empty cache misses"), Cache.Find(1).IsValid());
+    Cache.Add(1, Ref);
+
+    TSharedPtr<const FEncodedReference, ESPMode::ThreadSafe> Hit = Cache.Find(1);
+    TestTrue(TEXT("hit after add"), Hit.IsValid());
+    TestTrue(TEXT("hit shares the same buffer"), Hit.Get() == &Ref.Get());
+    TestTrue(TEXT("data URI carries base64 prefix"), Hit->GetDataUri().StartsWith("data:image/png;base64,"));
+
+    const FReferenceCacheStats Stats = Cache.GetStats();
+    TestEqual(TEXT("hits"), Stats.Hits, (int64)1);
+    TestEqual(TEXT("misses"), Stats.Misses, (int64)1);
+    TestEqual(TEXT("entries"), Stats.NumEntries, 1);
+    TestEqual(TEXT("bytes served"), Stats.BytesServed, (int64)1024);
+    TestTrue(TEXT("resident bytes include data URI"), Stats.ResidentBytes >= 1024 + 1024 * 4 / 3);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FReferenceCache_LruEviction_Test,
+    "UnrealBanana.ReferenceCache.LruEviction",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FReferenceCache_LruEviction_Test::RunTest(const FString&)
+{
+    using namespace NanoBanana::Image;
+
+    const FEncodedReferenceRef A = MakeFakeReference(64 * 1024, 0xA0);
+    const FEncodedReferenceRef B = MakeFakeReference(64 * 1024, 0xB0);
+    const FEncodedReferenceRef C = MakeFakeReference(64 * 1024, 0xC0);
+    const int64 PerEntry = (int64)A->GetAllocatedSize();
+
+    // Room for two entries, not three.
+    FReferenceCache Cache(PerEntry * 2 + PerEntry / 2);
+    Cache.Add(1, A);
+    Cache.Add(2, B);
+    Cache.Find(1);          // touch A so B becomes least recent
+    Cache.Add(3, C);        // evicts B
+
+    TestTrue(TEXT("A kept (recently used)"), Cache.Find(1).IsValid());
+    TestFalse(TEXT("B evicted"), Cache.Find(2).IsValid());
+    TestTrue(TEXT("C kept"), Cache.Find(3).IsValid());
+    TestEqual(TEXT("one eviction"), Cache.GetStats().Evictions, (int64)1);
+    TestTrue(TEXT("stays under budget"), Cache.GetStats().ResidentBytes <= PerEntry * 2 + PerEntry / 2);
+
+    Cache.SetBudgetBytes(0);
+    TestEqual(TEXT("zero budget empties the cache"), Cache.GetStats().NumEntries, 0);
+    Cache.Add(4, A);
+    TestFalse(TEXT("zero budget disables caching"), Cache.Find(4).IsValid());
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FReferenceCache_SnapshotKey_Test,
+    "UnrealBanana.ReferenceCache.SnapshotKey",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FReferenceCache_SnapshotKey_Test::RunTest(const FString&)
+{
+    using namespace NanoBanana::Image;
+
+    uint64 K1 = 0, K2 = 0, K3 = 0, K4 = 0;
+    TestTrue(TEXT("pixel key"), ComputeSnapshotKey(MakeSnapshot(8, 8, FColor::Red), K1));
+    TestTrue(TEXT("same pixels"), ComputeSnapshotKey(MakeSnapshot(8, 8, FColor::Red), K2));
+    TestTrue(TEXT("different pixels"), ComputeSnapshotKey(MakeSnapshot(8, 8, FColor::Blue), K3));
+    TestTrue(TEXT("same pixels, different shape"), ComputeSnapshotKey(MakeSnapshot(4, 16, FColor::Red), K4));
+    TestEqual(TEXT("identical content -> identical key"), K1, K2);
+    TestNotEqual(TEXT("pixel change -> new key"), K1, K3);
+    TestNotEqual(TEXT("shape change -> new key"), K1, K4);
+
+    FReferenceSnapshot Missing;
+    Missing.FilePath = TEXT("/this/file/does/not/exist.png");
+    uint64 KMissing = 0;
+    TestFalse(TEXT("unstat-able file has no key"), ComputeSnapshotKey(Missing, KMissing));
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,189 @@
+// In-flight request coalescing: the request fingerprint, and identical GenerateImage actions
+// against a stand-in Gemini endpoint sharing one vendor call (unseeded ones only on opt-in).
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+#include "HAL/PlatformProcess.h"
+#include "Engine/World.h"
+#include "Engine/TextureRenderTarget2D.h"
+
+#include "NanoBananaSettings.h"
+#include "NanoBananaBridgeAsyncAction.h"
+#include "RequestCoalescer.h"
+#include "RequestFingerprint.h"
+#include "Http/ReferencePreparer.h"
+#include "Http/Base64Codec.h"
+#include "Tests/FakeHttpServer.h"
+#include "Tests/TestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    using namespace NanoBanana::Tests;
+
+    /** A Size x Size render target cleared to Color, standing in for a painted mask. */
+    static UTextureRenderTarget2D* MakeMask(const FLinearColor& Color, int32 Size = 8)
+    {
+        UTextureRenderTarget2D* Mask = NewObject<UTextureRenderTarget2D>();
+        Mask->ClearColor = Color;
+        Mask->InitAutoFormat(Size, Size);
+        Mask->UpdateResourceImmediate(/*bClearRenderTarget*/ true);
+        return Mask;
+    }
+
+    /** Runs a mask-only request through FReferencePreparer and returns the mask key it reports. */
+    static uint64 PrepareMaskKey(UTextureRenderTarget2D* Mask, bool bHashMask)
+    {
+        FNanoBananaRequest Request;
+        Request.OptionalMask = Mask;
+        TSharedRef<TOptional<uint64>> Key = MakeShared<TOptional<uint64>>();
+        TSharedRef<NanoBanana::Image::FReferencePreparer, ESPMode::ThreadSafe> Prep = NanoBanana::Image::FReferencePreparer::Start(Request, bHashMask,
+            [Key](TArray<NanoBanana::Image::FEncodedReferenceRef>, uint64 MaskKey) { *Key = MaskKey; });
+        PumpUntil([Key]() { return Key->IsSet(); });
+        return Key->Get(0);
+    }
+
+    /** Points Google at the stand-in and turns coalescing on, for unseeded requests too if asked. */
+    struct FScopedCoalescingConfig
+    {
+        FScopedGoogleStandIn StandIn;
+        TGuardValue<bool> Coalesce;
+        TGuardValue<bool> CoalesceUnseeded;
+        FScopedCoalescingConfig(const FString& BaseUrl, bool bUnseeded)
+            : StandIn(BaseUrl, FPaths::AutomationTransientDir() / TEXT("NanoBananaCoalescing"))
+            , Coalesce(GetMutableDefault<UNanoBananaSettings>()->bCoalesceIdenticalRequests, true)
+            , CoalesceUnseeded(GetMutableDefault<UNanoBananaSettings>()->bCoalesceUnseededRequests, bUnseeded)
+        {
+        }
+    };
+
+    static FNanoBananaRequest MakeRequest(int32 Seed)
+    {
+        FNanoBananaRequest Request;
+        Request.Vendor = ENanoBananaVendor::Google;
+        Request.Model = ENanoBananaModel::NanoBanana2;
+        Request.Prompt = TEXT("identical portrait");
+        Request.Seed = Seed;
+        // Every run must reach the stand-in, including reruns of this test.
+        Request.CachePolicy = ENanoBananaCachePolicy::Bypass;
+        return Request;
+    }
+
+    /** Runs Count identical actions side by side; returns how many completed, with their first image bytes. */
+    static int32 RunIdentical(const FNanoBananaRequest& Request, int32 Count, TArray<TArray<uint8>>& OutBytes)
+    {
+        TArray<TSharedRef<FActionRun>> Runs;
+        for (int32 i = 0; i < Count; ++i)
+        {
+            Runs.Add(StartAction(UNanoBananaBridgeAsyncAction::GenerateImage(GWorld, Request, /*bAlsoSaveComposite*/ false)));
+        }
+        WaitForActions(Runs);
+        int32 NumSucceeded = 0;
+        OutBytes.Reset();
+        for (const TSharedRef<FActionRun>& Run : Runs)
+        {
+            OutBytes.Add(Run->FirstImage());
+            if (OutBytes.Last().Num() > 0) ++NumSucceeded;
+        }
+        return NumSucceeded;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRequestCoalescing_Fingerprint_Test,
+    "UnrealBanana.Coalescing.Fingerprint",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FRequestCoalescing_Fingerprint_Test::RunTest(const FString&)
+{
+    using namespace NanoBanana;
+    const FNanoBananaRequest Base = MakeRequest(7);
+    const TArray<Image::FEncodedReferenceRef> NoRefs;
+    const uint64 BaseKey = ComputeRequestFingerprint(Base, NoRefs);
+    TestEqual(TEXT("stable"), ComputeRequestFingerprint(MakeRequest(7), NoRefs), BaseKey);
+
+    FNanoBananaRequest Bulk = Base;
+    Bulk.Priority = ENanoBananaJobPriority::Bulk;
+    TestEqual(TEXT("priority only orders the queue"), ComputeRequestFingerprint(Bulk, NoRefs), BaseKey);
+    Bulk.CachePolicy = ENanoBananaCachePolicy::Refresh;
+    TestEqual(TEXT("cache policy is not part of the request"), ComputeRequestFingerprint(Bulk, NoRefs), BaseKey);
+
+    FNanoBananaRequest Other = Base;
+    Other.Prompt += TEXT(".");
+    TestNotEqual(TEXT("prompt"), ComputeRequestFingerprint(Other, NoRefs), BaseKey);
+    Other = Base;
+    Other.Seed = 8;
+    TestNotEqual(TEXT("seed"), ComputeRequestFingerprint(Other, NoRefs), BaseKey);
+    Other = Base;
+    Other.Resolution = ENanoBananaResolution::Res2K;
+    TestNotEqual(TEXT("resolution"), ComputeRequestFingerprint(Other, NoRefs), BaseKey);
+    Other = Base;
+    Other.Prompt = TEXT("identical");
+    Other.NegativePrompt = TEXT(" portrait");
+    TestNotEqual(TEXT("fields don't run together"), ComputeRequestFingerprint(Other, NoRefs), BaseKey);
+
+    const Image::FEncodedReferenceRef A = Image::MakeEncodedReference(TArray<uint8>({ 1, 2, 3 }));
+    const Image::FEncodedReferenceRef B = Image::MakeEncodedReference(TArray<uint8>({ 4, 5, 6 }));
+    const Image::FEncodedReferenceRef ACopy = Image::MakeEncodedReference(TArray<uint8>({ 1, 2, 3 }));
+    const uint64 AB = ComputeRequestFingerprint(Base, { A, B });
+    TestNotEqual(TEXT("references count"), AB, BaseKey);
+    TestEqual(TEXT("references compare by content"), ComputeRequestFingerprint(Base, { ACopy, B }), AB);
+    TestNotEqual(TEXT("reference order matters"), ComputeRequestFingerprint(Base, { B, A }), AB);
+
+    // The preparer hashes the mask by its pixels, next to the references.
+    const uint64 White = PrepareMaskKey(MakeMask(FLinearColor::White), /*bHashMask*/ true);
+    TestNotEqual(TEXT("mask is hashed"), White, (uint64)0);
+    TestNotEqual(TEXT("mask counts"), ComputeRequestFingerprint(Base, NoRefs, White), BaseKey);
+    TestEqual(TEXT("masks with the same pixels match"), PrepareMaskKey(MakeMask(FLinearColor::White), true), White);
+    UTextureRenderTarget2D* Repainted = MakeMask(FLinearColor::White);
+    Repainted->ClearColor = FLinearColor::Black;
+    Repainted->UpdateResourceImmediate(/*bClearRenderTarget*/ true);
+    TestNotEqual(TEXT("repainting the mask changes the key"), PrepareMaskKey(Repainted, true), White);
+    TestEqual(TEXT("no readback when nothing needs the fingerprint"), PrepareMaskKey(Repainted, /*bHashMask*/ false), (uint64)0);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRequestCoalescing_EndToEnd_Test,
+    "UnrealBanana.Coalescing.EndToEnd",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FRequestCoalescing_EndToEnd_Test::RunTest(const FString&)
+{
+    const TArray<uint8> Png = MakeSolidPng(90);
+    const FString Body = FString::Printf(TEXT("{\"candidates\":[{\"content\":{\"role\":\"model\",\"parts\":[{\"inlineData\":{\"mimeType\":\"image/png\",\"data\":\"%s\"}}]}}]}"),
+        *NanoBanana::Base64::Encode(Png));
+
+    FFakeHttpServer Server;
+    Server.On(TEXT("POST"), TEXT("/models/"), [Body](const FFakeHttpServer::FRequest&)
+    {
+        // Long enough that every action is started while the first is still in flight.
+        FPlatformProcess::Sleep(0.3f);
+        return FFakeHttpServer::FResponse::Json(Body);
+    });
+    if (!TestTrue(TEXT("stand-in server listening"), Server.Start())) return false;
+
+    {
+        FScopedCoalescingConfig Config(Server.GetBaseUrl(), /*bUnseeded*/ false);
+        const int64 JoinedBefore = NanoBanana::FRequestCoalescer::Get().GetStats().NumJoined;
+
+        TArray<TArray<uint8>> Bytes;
+        TestEqual(TEXT("every seeded action completes"), RunIdentical(MakeRequest(7), 3, Bytes), 3);
+        TestEqual(TEXT("one vendor call for three identical requests"), Server.CountRequests(TEXT("POST"), TEXT("/models/")), 1);
+        TestEqual(TEXT("two joined the first"), NanoBanana::FRequestCoalescer::Get().GetStats().NumJoined - JoinedBefore, (int64)2);
+        for (const TArray<uint8>& B : Bytes)
+        {
+            TestTrue(TEXT("each receives the shared image"), B == Png);
+        }
+
+        TestEqual(TEXT("every unseeded action completes"), RunIdentical(MakeRequest(0), 2, Bytes), 2);
+        TestEqual(TEXT("unseeded requests run separately by default"), Server.CountRequests(TEXT("POST"), TEXT("/models/")), 3);
+    }
+    {
+        FScopedCoalescingConfig Config(Server.GetBaseUrl(), /*bUnseeded*/ true);
+        TArray<TArray<uint8>> Bytes;
+        TestEqual(TEXT("every opted-in unseeded action completes"), RunIdentical(MakeRequest(0), 2, Bytes), 2);
+        TestEqual(TEXT("opted-in unseeded requests coalesce"), Server.CountRequests(TEXT("POST"), TEXT("/models/")), 4);
+    }
+    TestEqual(TEXT("nothing left in flight"), NanoBanana::FRequestCoalescer::Get().GetStats().NumInFlight, 0);
+    return true;
+}
+
+#endif
@@ -0,0 +1,194 @@
+// Persistent result cache: entries, hit-rate stats, eviction by age and size, and rebuilding the
+// index from disk; then a seeded GenerateImage served from the cache without a vendor call.
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Guid.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+
+#include "NanoBananaSettings.h"
+#include "ResultCache.h"
+#include "Http/Base64Codec.h"
+#include "Tests/FakeHttpServer.h"
+#include "Tests/TestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    static FString MakeScratchDir(const TCHAR* Name)
+    {
+        const FString Dir = FPaths::AutomationTransientDir() / Name;
+        IFileManager::Get().DeleteDirectory(*Dir, /*RequireExists*/ false, /*Tree*/ true);
+        return Dir;
+    }
+
+    static TArray<FNanoBananaImageResult> MakeResults(int32 Count, int32 NumBytes, uint8 Fill)
+    {
+        TArray<FNanoBananaImageResult> Results;
+        Results.SetNum(Count);
+        for (FNanoBananaImageResult& R : Results)
+        {
+            R.PngBytes.Init(Fill, NumBytes);
+        }
+        return Results;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FResultCache_Entries_Test,
+    "UnrealBanana.ResultCache.Entries",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FResultCache_Entries_Test::RunTest(const FString&)
+{
+    using NanoBanana::FResultCache;
+    const FString Dir = MakeScratchDir(TEXT("NanoBananaResultCacheEntries"));
+    {
+        FResultCache Cache(Dir);
+        Cache.SetLimits(1024 * 1024, FTimespan::Zero());
+        TestFalse(TEXT("empty cache misses"), Cache.Probe(1));
+
+        Cache.Store(1, MakeResults(2, 100, 7), TEXT(".png"));
+        TestTrue(TEXT("stored entry is found"), Cache.Probe(1));
+        TArray<TArray<uint8>> Images;
+        TArray<FString> Paths;
+        TestTrue(TEXT("entry loads"), Cache.Load(1, Images, Paths));
+        TestEqual(TEXT("every image comes back"), Images.Num(), 2);
+        TestTrue(TEXT("bytes survive"), Images.Num() == 2 && Images[1] == MakeResults(1, 100, 7)[0].PngBytes);
+        TestTrue(TEXT("paths point into the cache"), Paths.Num() == 2 && Paths[0].StartsWith(Cache.GetRootDir()) && Paths[0].EndsWith(TEXT(".png")));
+
+        const FNanoBananaResultCacheStats Stats = Cache.GetStats();
+        TestEqual(TEXT("one entry"), Stats.NumEntries, 1);
+        TestEqual(TEXT("size"), Stats.SizeBytes, (int64)200);
+        TestEqual(TEXT("hits"), Stats.Hits, (int64)1);
+        TestEqual(TEXT("misses"), Stats.Misses, (int64)1);
+        TestEqual(TEXT("hit rate"), Stats.HitRate, 0.5f);
+
+        // An interrupted store (no manifest) next to the real entry.
+        IFileManager::Get().MakeDirectory(*(Dir / TEXT("00000000000000ff")), /*Tree*/ true);
+        FFileHelper::SaveArrayToFile(MakeResults(1, 10, 1)[0].PngBytes, *(Dir / TEXT("00000000000000ff") / TEXT("Result_00.png")));
+    }
+    {
+        FResultCache Reopened(Dir);
+        Reopened.SetLimits(1024 * 1024, FTimespan::Zero());
+        Reopened.WaitForScan();
+        TestTrue(TEXT("entries persist across sessions"), Reopened.Probe(1));
+        TestFalse(TEXT("an entry without a manifest is discarded"), Reopened.Probe(0xff));
+        TestFalse(TEXT("and its files are reclaimed"), IFileManager::Get().DirectoryExists(*(Dir / TEXT("00000000000000ff"))));
+
+        // Files deleted behind the cache's back turn a probe hit into a load miss.
+        IFileManager::Get().Delete(*(Dir / TEXT("0000000000000001") / TEXT("Result_01.png")));
+        TArray<TArray<uint8>> Images;
+        TArray<FString> Paths;
+        TestFalse(TEXT("incomplete entry does not load"), Reopened.Load(1, Images, Paths));
+        TestFalse(TEXT("and is dropped"), Reopened.Probe(1));
+
+        Reopened.Store(2, MakeResults(1, 10, 2), TEXT(".png"));
+        Reopened.Empty();
+        TestEqual(TEXT("emptied"), Reopened.GetStats().NumEntries, 0);
+        TestFalse(TEXT("emptied entries are gone"), Reopened.Probe(2));
+    }
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FResultCache_Eviction_Test,
+    "UnrealBanana.ResultCache.Eviction",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FResultCache_Eviction_Test::RunTest(const FString&)
+{
+    using NanoBanana::FResultCache;
+    FResultCache Cache(MakeScratchDir(TEXT("NanoBananaResultCacheEviction")));
+    Cache.SetLimits(250, FTimespan::Zero());
+
+    Cache.Store(1, MakeResults(1, 100, 1), TEXT(".png"));
+    FPlatformProcess::Sleep(0.02f);
+    Cache.Store(2, MakeResults(1, 100, 2), TEXT(".png"));
+    FPlatformProcess::Sleep(0.02f);
+    // Using 1 makes 2 the least recently used.
+    TArray<TArray<uint8>> Images;
+    TArray<FString> Paths;
+    TestTrue(TEXT("first entry loads"), Cache.Load(1, Images, Paths));
+    FPlatformProcess::Sleep(0.02f);
+    Cache.Store(3, MakeResults(1, 100, 3), TEXT(".png"));
+
+    TestTrue(TEXT("recently used entry kept"), Cache.Probe(1));
+    TestFalse(TEXT("least recently used entry evicted"), Cache.Probe(2));
+    TestTrue(TEXT("new entry kept"), Cache.Probe(3));
+    TestEqual(TEXT("within budget"), Cache.GetStats().SizeBytes, (int64)200);
+    TestEqual(TEXT("one eviction"), Cache.GetStats().Evictions, (int64)1);
+
+    Cache.Store(4, MakeResults(1, 400, 4), TEXT(".png"));
+    TestTrue(TEXT("an entry larger than the budget is still kept"), Cache.Probe(4));
+    TestEqual(TEXT("everything else made room"), Cache.GetStats().NumEntries, 1);
+
+    Cache.SetLimits(1024 * 1024, FTimespan::FromMilliseconds(50));
+    FPlatformProcess::Sleep(0.1f);
+    TestFalse(TEXT("expired entry misses"), Cache.Probe(4));
+    Cache.Store(5, MakeResults(1, 10, 5), TEXT(".png"));
+    TestEqual(TEXT("expired entry evicted on the next store"), Cache.GetStats().NumEntries, 1);
+    Cache.Empty();
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FResultCache_EndToEnd_Test,
+    "UnrealBanana.ResultCache.EndToEnd",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FResultCache_EndToEnd_Test::RunTest(const FString&)
+{
+    using namespace NanoBanana::Tests;
+    const TArray<uint8> Png = MakeSolidPng(120);
+    const FString Body = FString::Printf(TEXT("{\"candidates\":[{\"content\":{\"role\":\"model\",\"parts\":[{\"inlineData\":{\"mimeType\":\"image/png\",\"data\":\"%s\"}}]}}]}"),
+        *NanoBanana::Base64::Encode(Png));
+
+    FFakeHttpServer Server;
+    Server.On(TEXT("POST"), TEXT("/models/"), [Body](const FFakeHttpServer::FRequest&)
+    {
+        FPlatformProcess::Sleep(0.2f);
+        return FFakeHttpServer::FResponse::Json(Body);
+    });
+    if (!TestTrue(TEXT("stand-in server listening"), Server.Start())) return false;
+
+    FScopedGoogleStandIn StandIn(Server.GetBaseUrl(), FPaths::AutomationTransientDir() / TEXT("NanoBananaResultCache"));
+    int32& MaxMegabytes = GetMutableDefault<UNanoBananaSettings>()->ResultCacheMaxMegabytes;
+    TGuardValue<int32> CacheOn(MaxMegabytes, FMath::Max(MaxMegabytes, 64));
+    FNanoBananaRequest Request;
+    Request.Vendor = ENanoBananaVendor::Google;
+    Request.Model = ENanoBananaModel::NanoBanana2;
+    // Unique per run, so entries left by earlier runs never answer.
+    Request.Prompt = FString::Printf(TEXT("cached portrait %s"), *FGuid::NewGuid().ToString());
+    Request.Seed = 11;
+
+    const int64 HitsBefore = NanoBanana::FResultCache::Get().GetStats().Hits;
+    TestTrue(TEXT("first run generates"), RunGenerateImage(Request)->FirstImage() == Png);
+    TestEqual(TEXT("first run calls the vendor"), Server.CountRequests(TEXT("POST"), TEXT("/models/")), 1);
+
+    const TSharedRef<FActionRun> Hit = RunGenerateImage(Request);
+    TestTrue(TEXT("second run returns the same image"), Hit->FirstImage() == Png);
+    TestEqual(TEXT("second run is served from the cache"), Server.CountRequests(TEXT("POST"), TEXT("/models/")), 1);
+    TestEqual(TEXT("hit counted"), NanoBanana::FResultCache::Get().GetStats().Hits - HitsBefore, (int64)1);
+    AddInfo(FString::Printf(TEXT("cache hit completed in %.1f ms"), Hit->Seconds * 1000.0));
+
+    Request.CachePolicy = ENanoBananaCachePolicy::Refresh;
+    TestTrue(TEXT("refresh completes"), RunGenerateImage(Request)->FirstImage() == Png);
+    TestEqual(TEXT("refresh calls the vendor"), Server.CountRequests(TEXT("POST"), TEXT("/models/")), 2);
+
+    // Refresh rewrote the entry's directory; the hit's file must not have lived there.
+    const FString HitPath = Hit->Results.Num() > 0 ? Hit->Results[0].SavedPath : FString();
+    TestTrue(FString::Printf(TEXT("hit saved under OutputDirectory (%s)"), *HitPath),
+        HitPath.StartsWith(FPaths::ConvertRelativePathToFull(GetDefault<UNanoBananaSettings>()->OutputDirectory)));
+    TestTrue(TEXT("hit file outlives the cache entry"), IFileManager::Get().FileExists(*HitPath));
+
+    Request.CachePolicy = ENanoBananaCachePolicy::Bypass;
+    TestTrue(TEXT("bypass completes"), RunGenerateImage(Request)->FirstImage() == Png);
+    TestEqual(TEXT("bypass calls the vendor"), Server.CountRequests(TEXT("POST"), TEXT("/models/")), 3);
+
+    Request.CachePolicy = ENanoBananaCachePolicy::Use;
+    Request.Seed = 0;
+    RunGenerateImage(Request);
+    RunGenerateImage(Request);
+    TestEqual(TEXT("unseeded results are not cached by default"), Server.CountRequests(TEXT("POST"), TEXT("/models/")), 5);
+    return true;
+}
+
+#endif
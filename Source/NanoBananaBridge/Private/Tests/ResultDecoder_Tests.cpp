@@ -0,0 +1,128 @@
+// Frame-time regression test for result handling: a canned 4-image Gemini response, served by a
+// stand-in and run through GenerateImage, must be parsed and decoded on workers, leaving only
+// texture creation on the game thread.
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "Modules/ModuleManager.h"
+#include "ImageUtils.h"
+#include "Engine/Texture2D.h"
+#include "Engine/World.h"
+
+#include "NanoBananaBridgeAsyncAction.h"
+#include "Http/Base64Codec.h"
+#include "Http/JsonResponseScanner.h"
+#include "Tests/FakeHttpServer.h"
+#include "Tests/TestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    static TArray<uint8> MakeResultPng(IImageWrapperModule& ImageWrapper, int32 Size, int32 Seed)
+    {
+        FRandomStream Rng(Seed);
+        TArray<FColor> Pixels;
+        Pixels.SetNumUninitialized(Size * Size);
+        for (int32 i = 0; i < Pixels.Num(); ++i)
+        {
+            const int32 X = i % Size, Y = i / Size;
+            Pixels[i] = FColor((uint8)(X + Rng.RandHelper(16)), (uint8)(Y + Rng.RandHelper(16)), (uint8)Rng.RandHelper(64), 255);
+        }
+        TSharedPtr<IImageWrapper> Wrapper = ImageWrapper.CreateImageWrapper(EImageFormat::PNG);
+        Wrapper->SetRaw(Pixels.GetData(), (int64)Pixels.Num() * sizeof(FColor), Size, Size, ERGBFormat::BGRA, 8);
+        return Wrapper->GetCompressed(0);
+    }
+
+    /** Same shape as a generateContent reply with candidateCount = NumImages. */
+    static FString MakeCannedGeminiResponse(const TArray<uint8>& Png, int32 NumImages)
+    {
+        const FString B64 = NanoBanana::Base64::Encode(Png);
+        FString Parts;
+        for (int32 i = 0; i < NumImages; ++i)
+        {
+            Parts += FString::Printf(TEXT("%s{\"inlineData\":{\"mimeType\":\"image/png\",\"data\":\"%s\"}}"), i ? TEXT(",") : TEXT(""), *B64);
+        }
+        return FString::Printf(TEXT("{\"candidates\":[{\"content\":{\"role\":\"model\",\"parts\":[{\"text\":\"ok\"},%s]}}]}"), *Parts);
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FResultDecoder_FrameTime_Test,
+    "UnrealBanana.Http.ResultDecoder.FrameTime",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FResultDecoder_FrameTime_Test::RunTest(const FString&)
+{
+    using namespace NanoBanana::Tests;
+    IImageWrapperModule& ImageWrapper = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+
+    constexpr int32 NumImages = 4;
+    constexpr int32 ImageSize = 2048;
+    const FString Response = MakeCannedGeminiResponse(MakeResultPng(ImageWrapper, ImageSize, 3), NumImages);
+
+    // Old path: everything on the game thread.
+    double LegacyMs = 0.0;
+    {
+        const double T0 = FPlatformTime::Seconds();
+        TArray<TArray<uint8>> Images;
+        NanoBanana::Json::CollectInlineImagesFromResponseBody(Response, Images);
+        for (const TArray<uint8>& Bytes : Images)
+        {
+            FImageUtils::ImportBufferAsTexture2D(Bytes);
+        }
+        LegacyMs = (FPlatformTime::Seconds() - T0) * 1000.0;
+        TestEqual(TEXT("legacy path found every image"), Images.Num(), NumImages);
+    }
+
+    // New path: the same response through the Google provider and the action's completion
+    // path, against a local stand-in. Every pumped frame is a game-thread slice.
+    FFakeHttpServer Server;
+    Server.On(TEXT("POST"), TEXT("/models/"), [Response](const FFakeHttpServer::FRequest&)
+    {
+        return FFakeHttpServer::FResponse::Json(Response);
+    });
+    if (!TestTrue(TEXT("stand-in server listening"), Server.Start())) return false;
+
+    const FString OutputDirectory = FPaths::AutomationTransientDir() / TEXT("NanoBananaFrameTime");
+    IFileManager::Get().DeleteDirectory(*OutputDirectory, /*RequireExists*/ false, /*Tree*/ true);
+    FScopedGoogleStandIn StandIn(Server.GetBaseUrl(), OutputDirectory);
+
+    FNanoBananaRequest Request;
+    Request.Vendor = ENanoBananaVendor::Google;
+    Request.Model = ENanoBananaModel::NanoBanana2;
+    Request.Prompt = TEXT("four variations");
+    Request.NumImages = NumImages;
+    Request.CachePolicy = ENanoBananaCachePolicy::Bypass;
+
+    const TSharedRef<FActionRun> Run = StartAction(UNanoBananaBridgeAsyncAction::GenerateImage(GWorld, Request, /*bAlsoSaveComposite*/ false));
+    double WorstSliceMs = 0.0;
+    int32 Frames = 0;
+    const double Deadline = FPlatformTime::Seconds() + 60.0;
+    while (!Run->bDone && FPlatformTime::Seconds() < Deadline)
+    {
+        WorstSliceMs = FMath::Max(WorstSliceMs, PumpGameThread() * 1000.0);
+        ++Frames;
+    }
+    if (UNanoBananaBridgeAsyncAction* Action = Run->Action.Get()) Action->RemoveFromRoot();
+
+    if (!TestTrue(TEXT("action completed"), Run->bDone && Run->Error.IsEmpty())) return false;
+    int32 NumTextures = 0;
+    for (const FNanoBananaImageResult& Result : Run->Results)
+    {
+        const UTexture2D* Texture = Result.Texture.Get();
+        NumTextures += (Texture && Texture->GetSizeX() == ImageSize && Texture->GetSizeY() == ImageSize) ? 1 : 0;
+    }
+    TestEqual(TEXT("every image decoded into a texture"), NumTextures, NumImages);
+    // The old path stalled one frame for LegacyMs; now no frame may come close to that.
+    TestTrue(TEXT("longest game-thread slice is well under the all-on-game-thread path"), WorstSliceMs * 2.0 < LegacyMs);
+
+    AddInfo(FString::Printf(TEXT("%d x %dpx response (%d KB): legacy game-thread %.1f ms; longest slice through the action %.1f ms over %d frames (texture creation %.1f ms)"),
+        NumImages, ImageSize, Response.Len() / 1024, LegacyMs, WorstSliceMs, Frames, Run->Timings.TextureMs));
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
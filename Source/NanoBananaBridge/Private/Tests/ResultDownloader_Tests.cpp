@@ -0,0 +1,84 @@
+// Tests for the download sink: chunked bodies land in one buffer and one file, and a stream
+// that never commits leaves nothing behind.
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+#include "Misc/FileHelper.h"
+#include "HAL/FileManager.h"
+
+#include "Http/ResultDownloader.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    static TArray<uint8> MakeBody(int32 Num)
+    {
+        TArray<uint8> Bytes;
+        Bytes.SetNumUninitialized(Num);
+        for (int32 i = 0; i < Num; ++i) Bytes[i] = (uint8)((i * 31) ^ (i >> 8));
+        return Bytes;
+    }
+
+    /** Feeds Body in ChunkSize pieces, the way the HTTP thread does. */
+    static void FeedInChunks(NanoBanana::Http::FDownloadStream& Stream, TArray<uint8>& Body, int32 ChunkSize)
+    {
+        for (int32 Offset = 0; Offset < Body.Num(); Offset += ChunkSize)
+        {
+            Stream.Serialize(Body.GetData() + Offset, FMath::Min(ChunkSize, Body.Num() - Offset));
+        }
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FResultDownloader_Stream_Test,
+    "UnrealBanana.Http.ResultDownloader.Stream",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FResultDownloader_Stream_Test::RunTest(const FString&)
+{
+    using NanoBanana::Http::FDownloadStream;
+
+    const FString Dir = FPaths::ConvertRelativePathToFull(FPaths::AutomationTransientDir() / TEXT("NanoBananaDownloads"));
+    IFileManager::Get().MakeDirectory(*Dir, true);
+    TArray<uint8> Body = MakeBody(3 * 1024 * 1024 + 17);
+
+    // Committed: the file is the buffer, and the partial file is gone.
+    {
+        const FString Dest = Dir / TEXT("Committed.png");
+        FDownloadStream Stream(Dest);
+        FeedInChunks(Stream, Body, 64 * 1024 + 3);
+        TestTrue(TEXT("partial file exists while downloading"), IFileManager::Get().FileExists(*(Dest + TEXT(".part"))));
+        TestTrue(TEXT("commit succeeds"), Stream.Commit());
+        TestEqual(TEXT("saved path reported"), Stream.GetSavedPath(), Dest);
+        TestTrue(TEXT("buffer holds the body"), Stream.GetBytes() == Body);
+
+        TArray<uint8> OnDisk;
+        TestTrue(TEXT("file readable"), FFileHelper::LoadFileToArray(OnDisk, *Dest));
+        TestTrue(TEXT("file holds the body"), OnDisk == Body);
+        TestFalse(TEXT("no partial file left"), IFileManager::Get().FileExists(*(Dest + TEXT(".part"))));
+    }
+
+    // Abandoned (failed or canceled request): nothing is left on disk.
+    {
+        const FString Dest = Dir / TEXT("Abandoned.png");
+        {
+            FDownloadStream Stream(Dest);
+            FeedInChunks(Stream, Body, 8 * 1024);
+        }
+        TestFalse(TEXT("abandoned partial file removed"), IFileManager::Get().FileExists(*(Dest + TEXT(".part"))));
+        TestFalse(TEXT("abandoned destination not created"), IFileManager::Get().FileExists(*Dest));
+    }
+
+    // Memory only: no destination, nothing to commit.
+    {
+        FDownloadStream Stream(FString{});
+        FeedInChunks(Stream, Body, 1024 * 1024);
+        TestFalse(TEXT("memory-only commit reports no file"), Stream.Commit());
+        TestTrue(TEXT("memory-only saved path empty"), Stream.GetSavedPath().IsEmpty());
+        TestTrue(TEXT("memory-only buffer holds the body"), Stream.GetBytes() == Body);
+    }
+
+    IFileManager::Get().DeleteDirectory(*Dir, false, true);
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
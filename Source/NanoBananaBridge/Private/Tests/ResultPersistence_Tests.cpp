@@ -0,0 +1,90 @@
+// Result persistence after the vendor answers: several images and a composite are saved and
+// decoded by parallel worker stages, and the action reports how long each stage took.
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "Engine/World.h"
+
+#include "NanoBananaSettings.h"
+#include "NanoBananaBridgeAsyncAction.h"
+#include "Http/Base64Codec.h"
+#include "Tests/FakeHttpServer.h"
+#include "Tests/TestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FResultPersistence_Stages_Test,
+    "UnrealBanana.ResultPersistence.Stages",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FResultPersistence_Stages_Test::RunTest(const FString&)
+{
+    using namespace NanoBanana::Tests;
+    TArray<TArray<uint8>> Pngs;
+    FString Parts;
+    for (int32 i = 0; i < 3; ++i)
+    {
+        Pngs.Add(MakeSolidPng((uint8)(40 + 60 * i), 64));
+        Parts += FString::Printf(TEXT("%s{\"inlineData\":{\"mimeType\":\"image/png\",\"data\":\"%s\"}}"),
+            i > 0 ? TEXT(",") : TEXT(""), *NanoBanana::Base64::Encode(Pngs.Last()));
+    }
+    const FString Body = FString::Printf(TEXT("{\"candidates\":[{\"content\":{\"role\":\"model\",\"parts\":[%s]}}]}"), *Parts);
+
+    FFakeHttpServer Server;
+    Server.On(TEXT("POST"), TEXT("/models/"), [Body](const FFakeHttpServer::FRequest&)
+    {
+        return FFakeHttpServer::FResponse::Json(Body);
+    });
+    if (!TestTrue(TEXT("stand-in server listening"), Server.Start())) return false;
+
+    const FString OutputDirectory = FPaths::AutomationTransientDir() / TEXT("NanoBananaPersistence");
+    IFileManager::Get().DeleteDirectory(*OutputDirectory, /*RequireExists*/ false, /*Tree*/ true);
+    FScopedGoogleStandIn StandIn(Server.GetBaseUrl(), OutputDirectory);
+
+    // An input on disk, as a viewport capture would leave it, so the composite stage runs.
+    const FString InputPath = OutputDirectory / TEXT("Input.png");
+    FFileHelper::SaveArrayToFile(MakeSolidPng(255, 64), *InputPath);
+
+    FNanoBananaRequest Request;
+    Request.Vendor = ENanoBananaVendor::Google;
+    Request.Model = ENanoBananaModel::NanoBanana2;
+    Request.Prompt = TEXT("three variations");
+    Request.NumImages = 3;
+    Request.CachePolicy = ENanoBananaCachePolicy::Bypass;
+
+    UNanoBananaBridgeAsyncAction* Action = UNanoBananaBridgeAsyncAction::GenerateImage(GWorld, Request, /*bAlsoSaveComposite*/ true);
+    Action->InputSavePath = InputPath;
+    const TSharedRef<FActionRun> Run = StartAction(Action);
+    WaitForActions({ Run });
+    const TArray<FNanoBananaImageResult>& Results = Run->Results;
+
+    if (!TestEqual(TEXT("every image completes"), Results.Num(), 3)) return false;
+    TSet<FString> Paths;
+    for (int32 i = 0; i < Results.Num(); ++i)
+    {
+        TArray<uint8> OnDisk;
+        TestTrue(TEXT("saved"), FFileHelper::LoadFileToArray(OnDisk, *Results[i].SavedPath));
+        TestTrue(TEXT("saved in order"), OnDisk == Pngs[i]);
+        TestNotNull(TEXT("texture"), Results[i].Texture.Get());
+        Paths.Add(Results[i].SavedPath);
+    }
+    TestEqual(TEXT("distinct files"), Paths.Num(), 3);
+
+    TArray<FString> Composites;
+    IFileManager::Get().FindFiles(Composites, *(OutputDirectory / TEXT("*_Composite.png")), /*Files*/ true, /*Directories*/ false);
+    TestEqual(TEXT("composite written"), Composites.Num(), 1);
+
+    const FNanoBananaResultTimings& T = Run->Timings;
+    TestTrue(TEXT("timings are set before OnCompleted"), T.TotalMs > 0.0f);
+    TestTrue(TEXT("response measured"), T.ResponseMs > 0.0f && T.ResponseMs <= T.TotalMs);
+    TestTrue(TEXT("save measured"), T.SaveMs > 0.0f);
+    TestTrue(TEXT("decode measured"), T.DecodeMs > 0.0f);
+    TestTrue(TEXT("composite measured"), T.CompositeMs > 0.0f);
+    TestTrue(TEXT("stages fit in the total"), T.ResponseMs + T.PersistMs + T.TextureMs <= T.TotalMs + 1.0f);
+    AddInfo(FString::Printf(TEXT("response %.1f ms, persist %.1f ms (save %.1f, decode %.1f, composite %.1f), textures %.1f ms, total %.1f ms"),
+        T.ResponseMs, T.PersistMs, T.SaveMs, T.DecodeMs, T.CompositeMs, T.TextureMs, T.TotalMs));
+    return true;
+}
+
+#endif
@@ -0,0 +1,174 @@
+#include "SseStandInServer.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HAL/RunnableThread.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/ScopeLock.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "IPAddress.h"
+
+namespace NanoBanana::Tests
+{
+    FSseStandInServer::FSseStandInServer(TArray<FScriptedEvent> InEvents)
+        : Events(MoveTemp(InEvents))
+    {
+    }
+
+    FSseStandInServer::~FSseStandInServer()
+    {
+        Stop();
+        if (Thread)
+        {
+            Thread->WaitForCompletion();
+            delete Thread;
+        }
+        if (Listener)
+        {
+            Listener->Close();
+            ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Listener);
+        }
+    }
+
+    bool FSseStandInServer::Start()
+    {
+        ISocketSubsystem* Sockets = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+        if (!Sockets) return false;
+
+        Listener = Sockets->CreateSocket(NAME_Stream, TEXT("NanoBanana SSE stand-in"), false);
+        if (!Listener) return false;
+
+        TSharedRef<FInternetAddr> Addr = Sockets->CreateInternetAddr();
+        Addr->SetLoopbackAddress();
+        Addr->SetPort(0);
+        if (!Listener->Bind(*Addr) || !Listener->Listen(1)) return false;
+        Listener->GetAddress(*Addr);
+        Port = Addr->GetPort();
+
+        Thread = FRunnableThread::Create(this, TEXT("NanoBananaSseStandIn"));
+        return Thread != nullptr;
+    }
+
+    FString FSseStandInServer::GetBaseUrl() const
+    {
+        return FString::Printf(TEXT("http://127.0.0.1:%d"), Port);
+    }
+
+    void FSseStandInServer::WaitForCompletion(double TimeoutSeconds)
+    {
+        const double Deadline = FPlatformTime::Seconds() + TimeoutSeconds;
+        while (!bDone && FPlatformTime::Seconds() < Deadline)
+        {
+            FPlatformProcess::Sleep(0.005f);
+        }
+    }
+
+    FString FSseStandInServer::GetRequestLine() const
+    {
+        FScopeLock Guard(&Lock);
+        return RequestLine;
+    }
+
+    TArray<double> FSseStandInServer::GetEventSendTimes() const
+    {
+        FScopeLock Guard(&Lock);
+        return SendTimes;
+    }
+
+    bool FSseStandInServer::SendAll(FSocket& Socket, const FString& Text)
+    {
+        const FTCHARToUTF8 Utf8(*Text, Text.Len());
+        const uint8* Data = (const uint8*)Utf8.Get();
+        int32 Remaining = Utf8.Length();
+        while (Remaining > 0 && !bStopping)
+        {
+            int32 Sent = 0;
+            if (!Socket.Send(Data, Remaining, Sent)) return false;
+            Data += Sent;
+            Remaining -= Sent;
+        }
+        return Remaining == 0;
+    }
+
+    uint32 FSseStandInServer::Run()
+    {
+        ISocketSubsystem* Sockets = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+
+        bool bPending = false;
+        const double AcceptDeadline = FPlatformTime::Seconds() + 15.0;
+        while (!bStopping && !bPending && FPlatformTime::Seconds() < AcceptDeadline)
+        {
+            Listener->WaitForPendingConnection(bPending, FTimespan::FromMilliseconds(50));
+        }
+        FSocket* Conn = bPending ? Listener->Accept(TEXT("NanoBanana SSE stand-in connection")) : nullptr;
+        if (!Conn)
+        {
+            bDone = true;
+            return 1;
+        }
+
+        // Read headers, answer Expect: 100-continue, then drain the body by Content-Length.
+        TArray<uint8> Received;
+        int32 HeaderEnd = INDEX_NONE;
+        int64 ContentLength = 0;
+        bool bSentContinue = false;
+        uint8 Buffer[16 * 1024];
+        while (!bStopping)
+        {
+            if (HeaderEnd != INDEX_NONE && Received.Num() - HeaderEnd >= ContentLength) break;
+            if (!Conn->Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromSeconds(5.0))) break;
+            int32 Read = 0;
+            if (!Conn->Recv(Buffer, sizeof(Buffer), Read) || Read == 0) break;
+            Received.Append(Buffer, Read);
+
+            if (HeaderEnd == INDEX_NONE)
+            {
+                int32 Blank = INDEX_NONE;
+                for (int32 i = 0; i + 3 < Received.Num() && Blank == INDEX_NONE; ++i)
+                {
+                    if (FMemory::Memcmp(&Received[i], "\r\n\r\n", 4) == 0) Blank = i;
+                }
+                if (Blank == INDEX_NONE) continue;
+                HeaderEnd = Blank + 4;
+
+                const FString Headers(Blank, (const ANSICHAR*)Received.GetData());
+                TArray<FString> Lines;
+                Headers.ParseIntoArrayLines(Lines);
+                for (const FString& Line : Lines)
+                {
+                    FString Name, Value;
+                    if (!Line.Split(TEXT(":"), &Name, &Value)) continue;
+                    Value.TrimStartAndEndInline();
+                    if (Name.Equals(TEXT("Content-Length"), ESearchCase::IgnoreCase)) LexFromString(ContentLength, *Value);
+                    if (Name.Equals(TEXT("Expect"), ESearchCase::IgnoreCase) && !bSentContinue)
+                    {
+                        bSentContinue = SendAll(*Conn, TEXT("HTTP/1.1 100 Continue\r\n\r\n"));
+                    }
+                }
+                FScopeLock Guard(&Lock);
+                RequestLine = Lines.Num() > 0 ? Lines[0] : FString();
+            }
+        }
+
+        // No Content-Length: the body runs until the server closes, as SSE endpoints do.
+        SendAll(*Conn, TEXT("HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\nCache-Control: no-cache\r\nConnection: close\r\n\r\n"));
+        for (const FScriptedEvent& Event : Events)
+        {
+            if (bStopping) break;
+            FPlatformProcess::Sleep((float)Event.DelaySeconds);
+            if (!SendAll(*Conn, FString::Printf(TEXT("data: %s\r\n\r\n"), *Event.Payload))) break;
+            FScopeLock Guard(&Lock);
+            SendTimes.Add(FPlatformTime::Seconds());
+        }
+
+        Conn->Shutdown(ESocketShutdownMode::ReadWrite);
+        Conn->Close();
+        Sockets->DestroySocket(Conn);
+        bDone = true;
+        return 0;
+    }
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,68 @@
+// Loopback stand-in for a vendor SSE endpoint, used by automation tests. Accepts one HTTP
+// connection, records the request line, then writes scripted "data:" events with delays
+// so tests can observe what the client does before the stream ends.
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HAL/Runnable.h"
+#include "HAL/CriticalSection.h"
+
+#include <atomic>
+
+class FSocket;
+class FRunnableThread;
+
+namespace NanoBanana::Tests
+{
+    class FSseStandInServer : public FRunnable
+    {
+    public:
+        struct FScriptedEvent
+        {
+            /** Pause before this event is written. */
+            double DelaySeconds = 0.0;
+            /** Event payload (one JSON chunk); written as "data: <Payload>\r\n\r\n". */
+            FString Payload;
+        };
+
+        explicit FSseStandInServer(TArray<FScriptedEvent> InEvents);
+        virtual ~FSseStandInServer() override;
+
+        /** Binds 127.0.0.1 on an ephemeral port and starts serving. */
+        bool Start();
+
+        /** Base URL to point a provider at, e.g. http://127.0.0.1:54321 */
+        FString GetBaseUrl() const;
+
+        /** Waits for the connection to close. */
+        void WaitForCompletion(double TimeoutSeconds);
+
+        /** "POST /path?query HTTP/1.1", once a request has been read. */
+        FString GetRequestLine() const;
+
+        /** FPlatformTime::Seconds() at which each event finished sending. */
+        TArray<double> GetEventSendTimes() const;
+
+        virtual uint32 Run() override;
+        virtual void Stop() override { bStopping = true; }
+
+    private:
+        bool SendAll(FSocket& Socket, const FString& Text);
+
+        TArray<FScriptedEvent> Events;
+        FSocket* Listener = nullptr;
+        FRunnableThread* Thread = nullptr;
+        int32 Port = 0;
+        std::atomic<bool> bStopping { false };
+        std::atomic<bool> bDone { false };
+
+        mutable FCriticalSection Lock;
+        FString RequestLine;
+        TArray<double> SendTimes;
+    };
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
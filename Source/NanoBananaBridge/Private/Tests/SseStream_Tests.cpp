@@ -0,0 +1,61 @@
+// Tests for the incremental SSE parser: line endings, multi-line data, comments, and that
+// the result does not depend on where the network splits the stream.
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#include "Http/SseStream.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    /** Feeds Text in ChunkSize pieces and renders every event as "[event|data]". */
+    static FString ParseInChunks(const FString& Text, int32 ChunkSize)
+    {
+        FString Out;
+        NanoBanana::Http::FSseParser Parser([&Out](FAnsiStringView Event, TConstArrayView<uint8> Data)
+        {
+            const FUTF8ToTCHAR Wide((const UTF8CHAR*)Data.GetData(), Data.Num());
+            Out += FString::Printf(TEXT("[%s|%s]"), *FString(Event), *FString(Wide.Length(), Wide.Get()));
+        });
+
+        const FTCHARToUTF8 Utf8(*Text, Text.Len());
+        for (int32 Offset = 0; Offset < Utf8.Length(); Offset += ChunkSize)
+        {
+            Parser.Feed(TConstArrayView<uint8>((const uint8*)Utf8.Get() + Offset, FMath::Min(ChunkSize, Utf8.Length() - Offset)));
+        }
+        Parser.Finish();
+        return Out;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSseStream_Parser_Test,
+    "UnrealBanana.Http.SseStream.Parser",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FSseStream_Parser_Test::RunTest(const FString&)
+{
+    struct FCase { const TCHAR* Name; const TCHAR* Input; const TCHAR* Expected; };
+    const FCase Cases[] =
+    {
+        { TEXT("CRLF (Gemini)"),           TEXT("data: {\"a\":1}\r\n\r\ndata: {\"b\":2}\r\n\r\n"),      TEXT("[|{\"a\":1}][|{\"b\":2}]") },
+        { TEXT("LF, no space after colon"), TEXT("data:x\n\n"),                                            TEXT("[|x]") },
+        { TEXT("bare CR"),                 TEXT("data: a\rdata: b\r\r"),                                  TEXT("[|a\nb]") },
+        { TEXT("comments, id, retry"),     TEXT(": ping\n\nevent: status\ndata: ok\nid: 4\nretry: 10\n\n"), TEXT("[status|ok]") },
+        { TEXT("event without data"),      TEXT("event: x\n\ndata: y\n\n"),                               TEXT("[|y]") },
+        { TEXT("only one space stripped"), TEXT("data:  two\n\n"),                                        TEXT("[| two]") },
+        { TEXT("unterminated last event"), TEXT("data: one\ndata: two\n\ndata: tail"),                    TEXT("[|one\ntwo][|tail]") },
+        { TEXT("non-ASCII payload"),       TEXT("data: café 日本\r\n\r\n"),                  TEXT("[|café 日本]") },
+    };
+
+    for (const FCase& Case : Cases)
+    {
+        // Every chunking, from byte-at-a-time up to the whole stream at once.
+        for (const int32 ChunkSize : { 1, 2, 3, 7, 4096 })
+        {
+            TestEqual(FString::Printf(TEXT("%s (chunks of %d)"), Case.Name, ChunkSize), ParseInChunks(Case.Input, ChunkSize), FString(Case.Expected));
+        }
+    }
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,159 @@
+#include "TestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HttpModule.h"
+#include "HttpManager.h"
+#include "Containers/Ticker.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Engine/World.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "Modules/ModuleManager.h"
+
+#include "NanoBananaBridgeAsyncAction.h"
+
+namespace NanoBanana::Tests
+{
+    double PumpGameThread()
+    {
+        const double Start = FPlatformTime::Seconds();
+        FHttpModule::Get().GetHttpManager().Tick(0.01f);
+        FTSTicker::GetCoreTicker().Tick(0.01f);
+        FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+        const double Seconds = FPlatformTime::Seconds() - Start;
+        FPlatformProcess::Sleep(0.01f);
+        return Seconds;
+    }
+
+    bool PumpUntil(TFunctionRef<bool()> Done, double TimeoutSeconds)
+    {
+        const double Deadline = FPlatformTime::Seconds() + TimeoutSeconds;
+        while (!Done() && FPlatformTime::Seconds() < Deadline)
+        {
+            PumpGameThread();
+        }
+        return Done();
+    }
+
+    TArray<uint8> MakeSolidPng(uint8 Shade, int32 Size)
+    {
+        IImageWrapperModule& ImageWrapper = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+        TArray<FColor> Pixels;
+        Pixels.Init(FColor(Shade, Shade, Shade, 255), Size * Size);
+        TSharedPtr<IImageWrapper> Wrapper = ImageWrapper.CreateImageWrapper(EImageFormat::PNG);
+        Wrapper->SetRaw(Pixels.GetData(), (int64)Pixels.Num() * sizeof(FColor), Size, Size, ERGBFormat::BGRA, 8);
+        return Wrapper->GetCompressed(0);
+    }
+
+    FScopedGoogleStandIn::FScopedGoogleStandIn(const FString& BaseUrl, const FString& OutputDirectory)
+    {
+        UNanoBananaSettings* S = GetMutableDefault<UNanoBananaSettings>();
+        SavedGoogle = S->Google;
+        SavedOutputDirectory = S->OutputDirectory;
+        S->Google.ApiKey = TEXT("stand-in-key");
+        S->Google.BaseUrlOverride = BaseUrl;
+        S->Google.bStreamResponses = false;
+        S->OutputDirectory = OutputDirectory;
+    }
+
+    FScopedGoogleStandIn::~FScopedGoogleStandIn()
+    {
+        UNanoBananaSettings* S = GetMutableDefault<UNanoBananaSettings>();
+        S->Google = SavedGoogle;
+        S->OutputDirectory = SavedOutputDirectory;
+    }
+
+    FProviderCallbacks FProviderRun::MakeCallbacks(FProviderCallbacks Base)
+    {
+        TSharedRef<FProviderRun, ESPMode::ThreadSafe> Self = AsShared();
+        FProviderCallbacks Callbacks = MoveTemp(Base);
+        Callbacks.OnSuccess = [Self](TArray<TArray<uint8>> Images, TArray<FString>, const FSharedText&)
+        {
+            FScopeLock Guard(&Self->Lock);
+            Self->Result.Images = MoveTemp(Images);
+            Self->Result.bDone = true;
+        };
+        Callbacks.OnFailure = [Self](const FString& Error)
+        {
+            FScopeLock Guard(&Self->Lock);
+            Self->Result.Error = Error;
+            Self->Result.bDone = true;
+        };
+        return Callbacks;
+    }
+
+    FProviderRun::FResult RunProvider(IImageGenProvider& Provider, const FNanoBananaRequest& Request, double TimeoutSeconds, int32 SettleFrames,
+        FProviderCallbacks Extra)
+    {
+        TSharedRef<FProviderRun, ESPMode::ThreadSafe> Run = MakeShared<FProviderRun, ESPMode::ThreadSafe>();
+        const double Start = FPlatformTime::Seconds();
+        Provider.Submit(Request, {}, Run->MakeCallbacks(MoveTemp(Extra)));
+        PumpUntil([&Run]() { return Run->IsDone(); }, TimeoutSeconds);
+        const double Seconds = FPlatformTime::Seconds() - Start;
+        for (int32 i = 0; i < SettleFrames; ++i)
+        {
+            PumpGameThread();
+        }
+        Provider.Cancel();
+        PumpGameThread();
+
+        FProviderRun::FResult Result = Run->GetResult();
+        Result.Seconds = Seconds;
+        return Result;
+    }
+
+    TSharedRef<FActionRun> StartAction(UNanoBananaBridgeAsyncAction* Action)
+    {
+        TSharedRef<FActionRun> Run = MakeShared<FActionRun>();
+        Run->Action = Action;
+        Action->AddToRoot();
+        const double Start = FPlatformTime::Seconds();
+        Action->OnCompletedNative.AddLambda([Run, Start](const TArray<FNanoBananaImageResult>& Results)
+        {
+            Run->Results = Results;
+            if (UNanoBananaBridgeAsyncAction* Finished = Run->Action.Get())
+            {
+                Run->Timings = Finished->GetTimings();
+            }
+            Run->Seconds = FPlatformTime::Seconds() - Start;
+            Run->bDone = true;
+        });
+        Action->OnFailedNative.AddLambda([Run, Start](const FString& Error)
+        {
+            Run->Error = Error;
+            Run->Seconds = FPlatformTime::Seconds() - Start;
+            Run->bDone = true;
+        });
+        static_cast<UBlueprintAsyncActionBase*>(Action)->Activate();
+        return Run;
+    }
+
+    bool WaitForActions(TConstArrayView<TSharedRef<FActionRun>> Runs, double TimeoutSeconds)
+    {
+        const bool bAllDone = PumpUntil([Runs]()
+        {
+            for (const TSharedRef<FActionRun>& Run : Runs)
+            {
+                if (!Run->bDone) return false;
+            }
+            return true;
+        }, TimeoutSeconds);
+        for (const TSharedRef<FActionRun>& Run : Runs)
+        {
+            if (UNanoBananaBridgeAsyncAction* Action = Run->Action.Get()) Action->RemoveFromRoot();
+        }
+        return bAllDone;
+    }
+
+    TSharedRef<FActionRun> RunGenerateImage(const FNanoBananaRequest& Request, double TimeoutSeconds)
+    {
+        TSharedRef<FActionRun> Run = StartAction(UNanoBananaBridgeAsyncAction::GenerateImage(GWorld, Request, /*bAlsoSaveComposite*/ false));
+        WaitForActions({ Run }, TimeoutSeconds);
+        return Run;
+    }
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,113 @@
+// Scaffolding shared by the automation tests: pumping the blocked game thread, solid-colour
+// PNGs, pointing Google at a stand-in, and running providers or async actions to completion.
+// Callback state lives in shared objects, so a callback that fires after a timed-out wait
+// writes into memory that is still alive.
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/ScopeLock.h"
+#include "HAL/CriticalSection.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+#include "NanoBananaTypes.h"
+#include "NanoBananaSettings.h"
+#include "Providers/IImageGenProvider.h"
+
+class UNanoBananaBridgeAsyncAction;
+
+namespace NanoBanana::Tests
+{
+    /**
+     * Automation tests block the game thread, so pump HTTP, tickers and game-thread tasks by hand.
+     * Returns how long that work took in seconds, not counting the sleep that stands in for the rest of the frame.
+     */
+    double PumpGameThread();
+
+    /** Pumps until Done() returns true or TimeoutSeconds pass; returns Done(). */
+    bool PumpUntil(TFunctionRef<bool()> Done, double TimeoutSeconds = 10.0);
+
+    /** An opaque grey Size x Size square, PNG-encoded. */
+    TArray<uint8> MakeSolidPng(uint8 Shade, int32 Size = 8);
+
+    /** Points Google at the stand-in (non-streaming) and results at OutputDirectory until destroyed. */
+    struct FScopedGoogleStandIn
+    {
+        FGoogleVendorConfig SavedGoogle;
+        FString SavedOutputDirectory;
+        FScopedGoogleStandIn(const FString& BaseUrl, const FString& OutputDirectory);
+        ~FScopedGoogleStandIn();
+    };
+
+    /** Records what a provider reports. Its callbacks may fire on any thread, so reads go through the lock. */
+    class FProviderRun : public TSharedFromThis<FProviderRun, ESPMode::ThreadSafe>
+    {
+    public:
+        struct FResult
+        {
+            TArray<TArray<uint8>> Images;
+            FString Error;
+            bool bDone = false;
+            /** Submit to OnSuccess/OnFailure; set by RunProvider. */
+            double Seconds = 0.0;
+        };
+
+        /** Base with OnSuccess and OnFailure set, each holding a reference to this run. */
+        FProviderCallbacks MakeCallbacks(FProviderCallbacks Base = FProviderCallbacks());
+
+        bool IsDone() const
+        {
+            FScopeLock Guard(&Lock);
+            return Result.bDone;
+        }
+
+        FResult GetResult() const
+        {
+            FScopeLock Guard(&Lock);
+            return Result;
+        }
+
+    private:
+        mutable FCriticalSection Lock;
+        FResult Result;
+    };
+
+    /**
+     * Submits Request and pumps until the provider reports or TimeoutSeconds pass. SettleFrames
+     * more frames then let follow-up work run (a loser's cancel request, say) before the provider
+     * is canceled. Extra supplies any callbacks besides OnSuccess and OnFailure.
+     */
+    FProviderRun::FResult RunProvider(IImageGenProvider& Provider, const FNanoBananaRequest& Request, double TimeoutSeconds, int32 SettleFrames = 1,
+        FProviderCallbacks Extra = FProviderCallbacks());
+
+    /** What one UNanoBananaBridgeAsyncAction delivered through its native delegates. */
+    struct FActionRun
+    {
+        TArray<FNanoBananaImageResult> Results;
+        FString Error;
+        /** GetTimings() as it stood when OnCompleted fired. */
+        FNanoBananaResultTimings Timings;
+        bool bDone = false;
+        /** Activate to OnCompleted/OnFailed. */
+        double Seconds = 0.0;
+        TWeakObjectPtr<UNanoBananaBridgeAsyncAction> Action;
+
+        /** The first result's bytes; empty if the action failed or is still running. */
+        TArray<uint8> FirstImage() const
+        {
+            return Results.Num() > 0 ? Results[0].PngBytes : TArray<uint8>();
+        }
+    };
+
+    /** Roots Action, records its delegates into a new run and activates it. */
+    TSharedRef<FActionRun> StartAction(UNanoBananaBridgeAsyncAction* Action);
+
+    /** Pumps until every run is done or TimeoutSeconds pass, then unroots their actions. */
+    bool WaitForActions(TConstArrayView<TSharedRef<FActionRun>> Runs, double TimeoutSeconds = 10.0);
+
+    /** GenerateImage(Request) without a composite, run to completion. */
+    TSharedRef<FActionRun> RunGenerateImage(const FNanoBananaRequest& Request, double TimeoutSeconds = 10.0);
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,130 @@
+// Tests for the reference upload profiles: MIME types through the data-URI builders, and a
+// bytes / encode-time report per profile on a capture-sized image.
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+#include "HAL/PlatformTime.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "Modules/ModuleManager.h"
+
+#include "Http/Base64Image.h"
+#include "Http/UploadEncoder.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    /** Smooth gradients plus per-pixel noise: compresses roughly like a rendered frame. */
+    static TArray<FColor> MakeCaptureLikePixels(int32 W, int32 H)
+    {
+        FRandomStream Rng(77);
+        TArray<FColor> Pixels;
+        Pixels.SetNumUninitialized(W * H);
+        for (int32 Y = 0; Y < H; ++Y)
+        {
+            for (int32 X = 0; X < W; ++X)
+            {
+                const int32 Noise = Rng.RandRange(-6, 6);
+                Pixels[Y * W + X] = FColor(
+                    (uint8)FMath::Clamp(X * 255 / W + Noise, 0, 255),
+                    (uint8)FMath::Clamp(Y * 255 / H + Noise, 0, 255),
+                    (uint8)FMath::Clamp(128 + (int32)(64.0f * FMath::Sin(X * 0.01f + Y * 0.02f)) + Noise, 0, 255),
+                    255);
+            }
+        }
+        return Pixels;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUploadEncoder_MimeType_Test,
+    "UnrealBanana.Http.UploadEncoder.MimeType",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FUploadEncoder_MimeType_Test::RunTest(const FString&)
+{
+    using namespace NanoBanana::Image;
+    IImageWrapperModule& ImageWrapper = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+    const TArray<FColor> Pixels = MakeCaptureLikePixels(64, 48);
+
+    FUploadProfile Png;
+    Png.Encoding = ENanoBananaUploadEncoding::PNGFast;
+    TArray<uint8> PngBytes = EncodeForUpload(ImageWrapper, Pixels, FIntPoint(64, 48), Png);
+    TestEqual(TEXT("PNG sniffed"), SniffImageMimeType(PngBytes), FString(TEXT("image/png")));
+    TestTrue(TEXT("PNG data URI"), PngBytesToDataUri(PngBytes).StartsWith(TEXT("data:image/png;base64,")));
+    TestTrue(TEXT("PNG encoded reference"), MakeEncodedReference(MoveTemp(PngBytes))->GetDataUri().StartsWith("data:image/png;base64,"));
+
+    FUploadProfile Jpeg;
+    Jpeg.Encoding = ENanoBananaUploadEncoding::JPEG;
+    Jpeg.Quality = 85;
+    TArray<uint8> JpegBytes = EncodeForUpload(ImageWrapper, Pixels, FIntPoint(64, 48), Jpeg);
+    TestEqual(TEXT("JPEG sniffed"), SniffImageMimeType(JpegBytes), FString(TEXT("image/jpeg")));
+    TestTrue(TEXT("JPEG data URI"), PngBytesToDataUri(JpegBytes).StartsWith(TEXT("data:image/jpeg;base64,")));
+    TestTrue(TEXT("explicit MIME wins"), PngBytesToDataUri(JpegBytes, TEXT("image/x-test")).StartsWith(TEXT("data:image/x-test;base64,")));
+
+    const FEncodedReferenceRef Ref = MakeEncodedReference(MoveTemp(JpegBytes));
+    TestEqual(TEXT("JPEG reference MIME"), Ref->MimeType, FString(TEXT("image/jpeg")));
+    TestTrue(TEXT("JPEG encoded reference"), Ref->GetDataUri().StartsWith("data:image/jpeg;base64,"));
+
+    // Round trip: the JPEG decodes back to the same dimensions.
+    TSharedPtr<IImageWrapper> Decoder = ImageWrapper.CreateImageWrapper(EImageFormat::JPEG);
+    TestTrue(TEXT("JPEG decodes"), Decoder.IsValid() && Decoder->SetCompressed(Ref->Bytes.GetData(), Ref->Bytes.Num())
+        && Decoder->GetWidth() == 64 && Decoder->GetHeight() == 48);
+
+    // A reference with transparency keeps its alpha instead of being flattened to JPEG.
+    TArray<FColor> CutOut = Pixels;
+    CutOut[0].A = 0;
+    TestEqual(TEXT("transparent pixels stay PNG"), SniffImageMimeType(EncodeForUpload(ImageWrapper, CutOut, FIntPoint(64, 48), Jpeg)), FString(TEXT("image/png")));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUploadEncoder_Benchmark_Test,
+    "UnrealBanana.Http.UploadEncoder.Benchmark",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FUploadEncoder_Benchmark_Test::RunTest(const FString&)
+{
+    using namespace NanoBanana::Image;
+    IImageWrapperModule& ImageWrapper = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+
+    // A 1080p viewport capture, the most common reference.
+    const FIntPoint Size(1920, 1080);
+    const TArray<FColor> Pixels = MakeCaptureLikePixels(Size.X, Size.Y);
+
+    // Previous behaviour for comparison: lossless PNG at maximum compression.
+    int64 BaselineBytes = 0;
+    {
+        TSharedPtr<IImageWrapper> Wrapper = ImageWrapper.CreateImageWrapper(EImageFormat::PNG);
+        const double T0 = FPlatformTime::Seconds();
+        Wrapper->SetRaw(Pixels.GetData(), (int64)Pixels.Num() * sizeof(FColor), Size.X, Size.Y, ERGBFormat::BGRA, 8);
+        BaselineBytes = Wrapper->GetCompressed(100).Num();
+        AddInfo(FString::Printf(TEXT("PNG (quality 100): %lld bytes, %.1f ms"), BaselineBytes, (FPlatformTime::Seconds() - T0) * 1000.0));
+    }
+
+    struct FCase { ENanoBananaUploadEncoding Encoding; int32 Quality; };
+    const FCase Cases[] = {
+        {ENanoBananaUploadEncoding::PNGFast, 0},
+        {ENanoBananaUploadEncoding::JPEG, 95},
+        {ENanoBananaUploadEncoding::JPEG, 90},
+        {ENanoBananaUploadEncoding::JPEG, 75},
+    };
+    for (const FCase& Case : Cases)
+    {
+        FUploadProfile Profile;
+        Profile.Encoding = Case.Encoding;
+        Profile.Quality = Case.Quality;
+
+        const double T0 = FPlatformTime::Seconds();
+        const TArray<uint8> Bytes = EncodeForUpload(ImageWrapper, Pixels, Size, Profile);
+        const double Ms = (FPlatformTime::Seconds() - T0) * 1000.0;
+
+        TestTrue(FString::Printf(TEXT("%s q%d encodes"), LexToString(Case.Encoding), Case.Quality), Bytes.Num() > 0);
+        if (Profile.IsLossy())
+        {
+            TestTrue(FString::Printf(TEXT("JPEG q%d smaller than lossless PNG"), Case.Quality), Bytes.Num() < BaselineBytes);
+        }
+        AddInfo(FString::Printf(TEXT("%s%s: %d bytes, %.1f ms"), LexToString(Case.Encoding),
+            Profile.IsLossy() ? *FString::Printf(TEXT(" (quality %d)"), Case.Quality) : TEXT(""), Bytes.Num(), Ms));
+    }
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
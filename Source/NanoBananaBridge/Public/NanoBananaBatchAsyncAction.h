@@ -0,0 +1,106 @@
+// Async action: many generation requests as one batch, with bounded per-vendor concurrency.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "NanoBananaTypes.h"
+#include "NanoBananaBridgeAsyncAction.h"
+#include "NanoBananaBatchAsyncAction.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FNanoBananaBatchItemProgress, int32, Index, float, Percent, const FString&, Stage);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FNanoBananaBatchItemFinished, int32, Index, const FNanoBananaBatchItemResult&, Result);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FNanoBananaBatchCompleted, const TArray<FNanoBananaBatchItemResult>&, Results, int32, NumSucceeded, int32, NumFailed);
+
+/**
+ * Runs each request of a batch through the same pipeline as GenerateImage. At most
+ * MaxConcurrency items per vendor are in flight at once; like every request they are admitted
+ * by UNanoBananaJobScheduler, which also caps each vendor across all callers.
+ * A failed item is reported and the rest carry on; OnCompleted fires once every item has
+ * finished, with results in input order.
+ */
+UCLASS()
+class NANOBANANABRIDGE_API UNanoBananaBatchAsyncAction : public UBlueprintAsyncActionBase
+{
+    GENERATED_BODY()
+public:
+    /** Overall progress: the mean of every item's progress, with "N/M done" as the stage. */
+    UPROPERTY(BlueprintAssignable)
+    FNanoBananaProgress OnProgress;
+
+    UPROPERTY(BlueprintAssignable)
+    FNanoBananaBatchItemProgress OnItemProgress;
+
+    /** Fires as each item succeeds or fails, in completion order. */
+    UPROPERTY(BlueprintAssignable)
+    FNanoBananaBatchItemFinished OnItemFinished;
+
+    UPROPERTY(BlueprintAssignable)
+    FNanoBananaBatchCompleted OnCompleted;
+
+    /**
+     * Generate images for every request in Requests.
+     * @param Requests       One entry per generation; each may target a different vendor.
+     * @param MaxConcurrency Most items of this batch in flight at once per vendor.
+     * @param Priority       Scheduling class for every item (overrides each request's own).
+     */
+    UFUNCTION(BlueprintCallable, meta=(BlueprintInternalUseOnly="true", WorldContext="WorldContextObject"), Category="Nano Banana")
+    static UNanoBananaBatchAsyncAction* BatchGenerateImages(UObject* WorldContextObject, const TArray<FNanoBananaRequest>& Requests, int32 MaxConcurrency = 4,
+        ENanoBananaJobPriority Priority = ENanoBananaJobPriority::Bulk);
+
+    /** Cancels every unfinished item (each fails with "Canceled"), then completes the batch. */
+    UFUNCTION(BlueprintCallable, Category="Nano Banana")
+    void Cancel();
+
+    /** True once OnCompleted has fired. */
+    bool IsFinished() const { return bFinished; }
+
+    /** Per-item outcomes in input order; unfinished items have neither Images nor Error yet. */
+    const TArray<FNanoBananaBatchItemResult>& GetResults() const { return Results; }
+
+protected:
+    virtual void Activate() override;
+    virtual void BeginDestroy() override;
+
+private:
+    enum class EItemState : uint8 { Pending, Running, Done };
+
+    struct FItem
+    {
+        EItemState State = EItemState::Pending;
+        float Percent = 0.0f;
+    };
+
+    UPROPERTY()
+    TObjectPtr<UObject> WorldContextObject;
+
+    TArray<FNanoBananaRequest> Requests;
+    int32 MaxConcurrency = 4;
+
+    /** Parallel to Requests. */
+    TArray<FItem> Items;
+    UPROPERTY()
+    TArray<FNanoBananaBatchItemResult> Results;
+    /** Running items' actions, by item index; cleared as each finishes. */
+    UPROPERTY()
+    TArray<TObjectPtr<UNanoBananaBridgeAsyncAction>> ItemActions;
+
+    /** Items of this batch started and not yet finished, per vendor. */
+    TMap<ENanoBananaVendor, int32> InFlightByVendor;
+    int32 NumDone = 0;
+    int32 NumSucceeded = 0;
+    /** Distinguishes this batch's result files from other batches started in the same second. */
+    uint32 BatchSerial = 0;
+    bool bPumping = false;
+    bool bCanceling = false;
+    bool bFinished = false;
+
+    /** Starts pending items while their vendor is under MaxConcurrency. */
+    void Pump();
+    void StartItem(int32 Index);
+    void HandleItemProgress(float Percent, const FString& Stage, int32 Index);
+    void HandleItemCompleted(const TArray<FNanoBananaImageResult>& Images, int32 Index);
+    void HandleItemFailed(const FString& Error, int32 Index);
+    void FinishItem(int32 Index, FNanoBananaBatchItemResult&& Result);
+    void BroadcastOverallProgress();
+    void FinishIfDone();
+};
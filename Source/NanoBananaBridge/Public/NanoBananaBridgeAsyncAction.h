@@ -9,10 +9,18 @@
 #include "NanoBananaBridgeAsyncAction.generated.h"
 
 class IImageGenProvider;
+namespace NanoBanana::Image { class FReferencePreparer; struct FEncodedReference; }
+namespace NanoBanana { class FProviderEventChannel; struct FProviderEvent; }
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FNanoBananaProgress, float, Percent, const FString&, Stage);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FNanoBananaCompleted, const TArray<FNanoBananaImageResult>&, Results, const FString&, CompositePath);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FNanoBananaFailed, const FString&, Error);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FNanoBananaImageReady, int32, Index, UTexture2D*, Texture);
+
+/** Native counterparts of the delegates above, for C++ owners such as UNanoBananaBatchAsyncAction. */
+DECLARE_MULTICAST_DELEGATE_TwoParams(FNanoBananaProgressNative, float /*Percent*/, const FString& /*Stage*/);
+DECLARE_MULTICAST_DELEGATE_OneParam(FNanoBananaCompletedNative, const TArray<FNanoBananaImageResult>& /*Results*/);
+DECLARE_MULTICAST_DELEGATE_OneParam(FNanoBananaFailedNative, const FString& /*Error*/);
 
 /**
  * Vendor-agnostic image generation async action. Supports Google Gemini, FAL.ai, and Replicate
@@ -32,6 +40,19 @@ public:
     UPROPERTY(BlueprintAssignable)
     FNanoBananaFailed OnFailed;
 
+    /**
+     * Fires once per image as soon as it has arrived, before OnCompleted, when the provider
+     * streams its response (Gemini with bStreamResponses). OnCompleted still carries every
+     * result, with the same textures.
+     */
+    UPROPERTY(BlueprintAssignable)
+    FNanoBananaImageReady OnImageReady;
+
+    /** Fire alongside OnProgress / OnCompleted / OnFailed. */
+    FNanoBananaProgressNative OnProgressNative;
+    FNanoBananaCompletedNative OnCompletedNative;
+    FNanoBananaFailedNative OnFailedNative;
+
     /**
      * Generate one or more images directly from an FNanoBananaRequest.
      * @param Request           Vendor + model + prompt + reference images, etc.
@@ -57,6 +78,13 @@ public:
     UFUNCTION(BlueprintCallable, Category="Nano Banana")
     void Cancel();
 
+    /**
+     * Per-stage timings of this request, filled in before OnCompleted fires. A request that joined
+     * an identical one in flight reports that one's stages, with its own TotalMs.
+     */
+    UFUNCTION(BlueprintPure, Category="Nano Banana")
+    FNanoBananaResultTimings GetTimings() const { return Timings; }
+
     // Overrides for save paths. Leave empty to auto-name under settings OutputDirectory.
     UPROPERTY()
     FString InputSavePath;
@@ -64,11 +92,18 @@ public:
     UPROPERTY()
     FString CompositeSavePath;
 
+    /** Appended to the timestamp in result file names, so requests finishing in the same second don't collide. */
+    UPROPERTY()
+    FString ResultSuffix;
+
 protected:
     virtual void Activate() override;
     virtual void BeginDestroy() override;
 
 private:
+    /** Starts its items with Activate() and listens through the native delegates. */
+    friend class UNanoBananaBatchAsyncAction;
+
     enum class EMode : uint8 { Direct, CaptureFirst };
 
     UPROPERTY()
@@ -80,13 +115,87 @@ private:
     bool bAlsoSaveComposite = true;
     bool bFinished = false;
 
+    /** FPlatformTime::Seconds() at Activate(). */
+    double ActivatedSeconds = 0.0;
+    FNanoBananaResultTimings Timings;
+
+    /** Waiting in UNanoBananaJobScheduler as SchedulerJobId. */
+    bool bQueuedInScheduler = false;
+    /** Started by the scheduler; its vendor slot is given back once the vendor has answered. */
+    bool bHoldsSchedulerSlot = false;
+    uint32 SchedulerJobId = 0;
+    /** The provider reported an HTTP 429 before its failure. */
+    bool bRateLimited = false;
+    int32 RateLimitRetries = 0;
+
+    /** Encoded once, before the request is looked up, queued or sent. */
+    TArray<TSharedRef<const NanoBanana::Image::FEncodedReference, ESPMode::ThreadSafe>> PreparedReferences;
+    /** Coalescing or a result cache applies, so the request is fingerprinted (and its mask read back). */
+    bool bNeedsFingerprint = false;
+    /** NanoBanana::ComputeRequestFingerprint of Request and PreparedReferences; 0 when not needed. */
+    uint64 Fingerprint = 0;
+    /** Results go into FResultCache once generated (CachePolicy Use or Refresh, and cacheable). */
+    bool bStoreInResultCache = false;
+    bool bServedFromCache = false;
+    /** Same for the DerivedDataCache tier (bShareResultsThroughDerivedDataCache). */
+    bool bStoreInSharedCache = false;
+    bool bServedFromSharedCache = false;
+
+    /** Registered with FRequestCoalescer under Fingerprint; identical requests join this one. */
+    bool bCoalescingLeader = false;
+    /** Identical requests waiting on this one's execution; they receive its progress and results. */
+    TArray<TWeakObjectPtr<UNanoBananaBridgeAsyncAction>> Followers;
+
+    /** Timestamp shared by every file this request writes; fixed when the provider starts. */
+    FString ResultStamp;
+
     TSharedPtr<IImageGenProvider, ESPMode::ThreadSafe> Provider;
+    TSharedPtr<NanoBanana::Image::FReferencePreparer, ESPMode::ThreadSafe> ReferencePrep;
+
+    /** Provider callbacks queue here and are delivered once per frame on the game thread. */
+    TSharedPtr<NanoBanana::FProviderEventChannel, ESPMode::ThreadSafe> Events;
 
+    /** Textures already handed out through OnImageReady, by result index. */
+    UPROPERTY()
+    TArray<TObjectPtr<UTexture2D>> StreamedTextures;
+
+    /**
+     * Encodes the references, then serves the request from the result cache, joins an
+     * identical one in flight, or queues it for its vendor.
+     */
     void RunProvider();
+    void HandleReferencesReady(TArray<TSharedRef<const NanoBanana::Image::FEncodedReference, ESPMode::ThreadSafe>> References, uint64 MaskKey);
+    /** Starts loading a cached result (true), or returns false on a miss or when the policy skips the cache. */
+    bool TryServeFromCache();
+    /** Asks the DerivedDataCache; generates (JoinOrQueue) on a miss. */
+    void LoadFromSharedCache();
+    void JoinOrQueue();
+    /** Queues the request with the job scheduler; StartProvider runs once it is admitted. */
+    void QueueForVendor();
+    void StartProvider();
+    void SubmitToProvider(const TArray<TSharedRef<const NanoBanana::Image::FEncodedReference, ESPMode::ThreadSafe>>& References);
     void HandleCaptured(const struct FViewportCaptureResult& Capture, const FString& SavedPath);
-    void HandleSuccess(TArray<TArray<uint8>> Images, const FString& RawResponse);
+    /** Game thread: dispatches one event drained from the provider channel. */
+    void HandleProviderEvent(NanoBanana::FProviderEvent& Event);
+    /** Game thread: hands saving and decoding to a worker, then finishes via CompleteWithResults.
+     *  RawResponse is the provider's shared body (NanoBanana::FSharedText); captured, not copied. */
+    void HandleSuccess(TArray<TArray<uint8>> Images, TArray<FString> SavedPaths, const TSharedRef<const FString, ESPMode::ThreadSafe>& RawResponse);
+    void HandleImageReady(int32 Index, const struct FImage& Image);
+    void CompleteWithResults(TArray<FNanoBananaImageResult> Results, const FString& CompositePath);
     void Fail(const FString& Error);
+    void BroadcastProgress(float Percent, const FString& Stage);
+    /** Game thread: a rate-limited failure with retries left; queue the request again. */
+    void RetryAfterRateLimit(const FString& Error);
+    void ReleaseSchedulerSlot();
+    void CloseEvents();
+    /** Joins an identical request already in flight (true), or registers this one for others to join. */
+    bool TryJoinInFlight();
+    /** Unregisters from FRequestCoalescer and hands back the followers still waiting. */
+    TArray<UNanoBananaBridgeAsyncAction*> StopLeading();
+    void ForEachFollower(TFunctionRef<void(UNanoBananaBridgeAsyncAction&)> Visit) const;
 
     FString MakeTimestampedPath(const FString& BaseDir, const FString& Suffix) const;
-    void DumpDebug(const FString& Suffix, const FString& Body) const;
+    static FString MakeResultPath(const FString& AbsBaseDir, const FString& Stamp, const FString& Ext, int32 Index, int32 Count);
+    FString MakeDebugPath(const FString& Suffix) const;
+    void DumpDebug(const FString& Suffix, const TArray<uint8>& Body) const;
 };
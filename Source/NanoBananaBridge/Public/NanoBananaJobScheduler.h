@@ -0,0 +1,146 @@
+// Engine-wide scheduler every generation request goes through before it reaches a vendor.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "Containers/Ticker.h"
+#include "NanoBananaTypes.h"
+#include "NanoBananaJobScheduler.generated.h"
+
+/** Live queue state for one vendor. */
+USTRUCT(BlueprintType)
+struct NANOBANANABRIDGE_API FNanoBananaVendorQueueStats
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    ENanoBananaVendor Vendor = ENanoBananaVendor::Google;
+
+    /** Requests holding a slot (sent, or being prepared to send). */
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    int32 Running = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    int32 QueuedInteractive = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    int32 QueuedBackground = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    int32 QueuedBulk = 0;
+
+    /** Token-bucket balance; meaningless when the vendor has no rate limit. */
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    float Tokens = 0.0f;
+
+    /** Seconds left of the vendor's last Retry-After; 0 when not held. */
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    float HeldForSeconds = 0.0f;
+
+    /** HTTP 429 answers seen from this vendor since startup. */
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    int32 RateLimitedCount = 0;
+
+    /** Requests started since startup. */
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    int64 Started = 0;
+
+    /** Mean time started requests spent waiting in the queue. */
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    float MeanWaitSeconds = 0.0f;
+};
+
+USTRUCT(BlueprintType)
+struct NANOBANANABRIDGE_API FNanoBananaJobSchedulerStats
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    int32 Running = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    int32 Queued = 0;
+
+    /** Only vendors that have seen a request. */
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    TArray<FNanoBananaVendorQueueStats> Vendors;
+};
+
+/**
+ * Admits generation requests to vendors. Each vendor has an in-flight cap
+ * (UNanoBananaSettings::MaxConcurrentRequestsPerVendor) and a token bucket (its RateLimit);
+ * waiting requests start highest priority first, oldest first within a priority. An HTTP 429
+ * holds the vendor until its Retry-After has passed.
+ *
+ * Game thread only. Enqueue() hands over a job's start function, called (possibly before
+ * Enqueue returns) once the vendor may take another request; the job gives its slot back with
+ * Release() when the vendor has answered, or when it is canceled.
+ */
+UCLASS()
+class NANOBANANABRIDGE_API UNanoBananaJobScheduler : public UEngineSubsystem
+{
+    GENERATED_BODY()
+public:
+    using FJobId = uint32;
+
+    /** Null before the engine is up and after it has shut down; callers then start directly. */
+    static UNanoBananaJobScheduler* Get();
+
+    FJobId Enqueue(ENanoBananaVendor Vendor, ENanoBananaJobPriority Priority, TFunction<void()> Start);
+
+    /** Drops a job that has not started. False if it already started (or never existed). */
+    bool Remove(FJobId Id);
+
+    /** A started job for Vendor is done with it; frees its slot and starts waiting jobs. */
+    void Release(ENanoBananaVendor Vendor);
+
+    /** Vendor answered HTTP 429: start nothing more for it until RetryAfterSeconds from now. */
+    void ReportRateLimited(ENanoBananaVendor Vendor, float RetryAfterSeconds);
+
+    /** Live queue depth, slots in use, token balance and back-off per vendor. */
+    UFUNCTION(BlueprintCallable, Category="Nano Banana")
+    FNanoBananaJobSchedulerStats GetStats() const;
+
+    virtual void Deinitialize() override;
+
+private:
+    static constexpr int32 NumPriorities = 3;
+
+    struct FJob
+    {
+        FJobId Id = 0;
+        double EnqueuedAt = 0.0;
+        TFunction<void()> Start;
+    };
+
+    struct FVendorState
+    {
+        /** Waiting jobs per priority, oldest first. */
+        TArray<FJob> Queued[NumPriorities];
+        int32 Running = 0;
+        /** Token bucket; starts full. */
+        double Tokens = -1.0;
+        double LastRefill = 0.0;
+        /** No starts before this time (Retry-After). */
+        double HeldUntil = 0.0;
+        int32 RateLimitedCount = 0;
+        int64 Started = 0;
+        double TotalWaitSeconds = 0.0;
+
+        int32 NumQueued() const;
+    };
+
+    /** Starts every job that its vendor's cap, bucket and back-off allow; arms a wake-up for the rest. */
+    void Dispatch();
+    /** Earliest time Vendor could start its next job, or 0 when it can right now. */
+    double NextStartTime(FVendorState& State, ENanoBananaVendor Vendor, double Now);
+    void ScheduleWake(double At);
+    bool HandleWake(float DeltaTime);
+
+    TMap<ENanoBananaVendor, FVendorState> Vendors;
+    FJobId NextId = 1;
+    bool bDispatching = false;
+
+    FTSTicker::FDelegateHandle WakeHandle;
+    double WakeAt = 0.0;
+};
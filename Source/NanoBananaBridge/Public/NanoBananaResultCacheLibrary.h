@@ -0,0 +1,63 @@
+// Blueprint access to the on-disk result cache (Saved/NanoBanana/Cache) and its DerivedDataCache tier.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "NanoBananaResultCacheLibrary.generated.h"
+
+/** Size and effectiveness of the result cache since startup. */
+USTRUCT(BlueprintType)
+struct NANOBANANABRIDGE_API FNanoBananaResultCacheStats
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    int32 NumEntries = 0;
+
+    /** Image bytes on disk. */
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    int64 SizeBytes = 0;
+
+    /** Requests served from the cache. */
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    int64 Hits = 0;
+
+    /** Cacheable requests that had to be generated. */
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    int64 Misses = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    int64 Stores = 0;
+
+    /** Entries dropped for age or to stay within the size budget. */
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    int64 Evictions = 0;
+
+    /** Hits / (Hits + Misses); 0 before the first lookup. */
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    float HitRate = 0.0f;
+
+    /** Local misses answered by the DerivedDataCache (bShareResultsThroughDerivedDataCache). */
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    int64 SharedHits = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    int64 SharedMisses = 0;
+
+    /** Results written to the DerivedDataCache. */
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    int64 SharedStores = 0;
+};
+
+UCLASS()
+class NANOBANANABRIDGE_API UNanoBananaResultCacheLibrary : public UBlueprintFunctionLibrary
+{
+    GENERATED_BODY()
+public:
+    UFUNCTION(BlueprintPure, Category="Nano Banana|Cache")
+    static FNanoBananaResultCacheStats GetResultCacheStats();
+
+    /** Deletes every locally cached result; the DerivedDataCache keeps its copies. In-flight requests are not affected. */
+    UFUNCTION(BlueprintCallable, Category="Nano Banana|Cache")
+    static void ClearResultCache();
+};
@@ -6,6 +6,21 @@
 #include "NanoBananaTypes.h"
 #include "NanoBananaSettings.generated.h"
 
+/** Token-bucket limit on how fast requests to one vendor are started. */
+USTRUCT(BlueprintType)
+struct NANOBANANABRIDGE_API FNanoBananaRateLimit
+{
+    GENERATED_BODY()
+
+    /** Sustained request starts per second. 0 = no limit (only the concurrency cap applies). */
+    UPROPERTY(EditAnywhere, Config, Category="Rate Limit", meta=(ClampMin="0", ClampMax="100"))
+    float RequestsPerSecond = 0.0f;
+
+    /** Starts allowed back to back after an idle period. */
+    UPROPERTY(EditAnywhere, Config, Category="Rate Limit", meta=(ClampMin="1", ClampMax="100"))
+    int32 Burst = 4;
+};
+
 USTRUCT(BlueprintType)
 struct NANOBANANABRIDGE_API FGoogleVendorConfig
 {
@@ -15,9 +30,20 @@ struct NANOBANANABRIDGE_API FGoogleVendorConfig
     UPROPERTY(EditAnywhere, Config, Category="Google")
     FString ApiKey;
 
+    /**
+     * Use :streamGenerateContent (server-sent events) so each image is handed over as soon as
+     * its chunk arrives, instead of after the whole multi-candidate response.
+     */
+    UPROPERTY(EditAnywhere, Config, Category="Google")
+    bool bStreamResponses = false;
+
     /** Override base URL. Default: https://generativelanguage.googleapis.com/v1beta */
     UPROPERTY(EditAnywhere, Config, Category="Google", AdvancedDisplay)
     FString BaseUrlOverride;
+
+    /** How fast new requests may start (UNanoBananaJobScheduler). */
+    UPROPERTY(EditAnywhere, Config, Category="Google", AdvancedDisplay)
+    FNanoBananaRateLimit RateLimit;
 };
 
 USTRUCT(BlueprintType)
@@ -33,6 +59,31 @@ struct NANOBANANABRIDGE_API FFalVendorConfig
     UPROPERTY(EditAnywhere, Config, Category="FAL")
     bool bAlwaysUseQueue = false;
 
+    /**
+     * Watch queued jobs through FAL's status event stream (one connection per job) and fetch
+     * the result as soon as it reports COMPLETED, instead of polling the status endpoint.
+     * Polling takes over if the stream is refused or drops.
+     */
+    UPROPERTY(EditAnywhere, Config, Category="FAL")
+    bool bStreamQueueStatus = false;
+
+    /**
+     * When the sync request is still unanswered after the usual sync latency (HedgePercentile
+     * of recent requests for the same model and resolution), also submit the job to the queue
+     * and take whichever finishes first. The loser is canceled. A job can be billed twice if
+     * FAL has already started both, so this is off by default.
+     */
+    UPROPERTY(EditAnywhere, Config, Category="FAL")
+    bool bHedgeSyncWithQueue = false;
+
+    /** Percentile of recent sync latencies after which the queue submission goes out. */
+    UPROPERTY(EditAnywhere, Config, Category="FAL", AdvancedDisplay, meta=(ClampMin="0.5", ClampMax="0.99", EditCondition="bHedgeSyncWithQueue"))
+    float HedgePercentile = 0.9f;
+
+    /** Hedge delay until enough sync latencies have been seen. */
+    UPROPERTY(EditAnywhere, Config, Category="FAL", AdvancedDisplay, meta=(ClampMin="0.5", EditCondition="bHedgeSyncWithQueue"))
+    float HedgeDelayWithoutHistorySeconds = 20.0f;
+
     /** Sync base URL. Default: https://fal.run */
     UPROPERTY(EditAnywhere, Config, Category="FAL", AdvancedDisplay)
     FString SyncBaseUrlOverride;
@@ -40,6 +91,10 @@ struct NANOBANANABRIDGE_API FFalVendorConfig
     /** Queue base URL. Default: https://queue.fal.run */
     UPROPERTY(EditAnywhere, Config, Category="FAL", AdvancedDisplay)
     FString QueueBaseUrlOverride;
+
+    /** How fast new requests may start (UNanoBananaJobScheduler). */
+    UPROPERTY(EditAnywhere, Config, Category="FAL", AdvancedDisplay)
+    FNanoBananaRateLimit RateLimit;
 };
 
 USTRUCT(BlueprintType)
@@ -66,6 +121,54 @@ struct NANOBANANABRIDGE_API FReplicateVendorConfig
     /** Base URL override. Default: https://api.replicate.com/v1 */
     UPROPERTY(EditAnywhere, Config, Category="Replicate", AdvancedDisplay)
     FString BaseUrlOverride;
+
+    /**
+     * Register an embedded HTTP listener as the prediction webhook, so a job completes as soon
+     * as Replicate calls back instead of on the next poll. Polling continues at a slow rate as
+     * a safety net.
+     */
+    UPROPERTY(EditAnywhere, Config, Category="Replicate")
+    bool bUseWebhook = false;
+
+    /** Local port of the webhook listener. */
+    UPROPERTY(EditAnywhere, Config, Category="Replicate", AdvancedDisplay, meta=(ClampMin="1", ClampMax="65535", EditCondition="bUseWebhook"))
+    int32 WebhookListenPort = 8089;
+
+    /**
+     * Public URL that forwards to the listener (e.g. a tunnel), without the path. Replicate
+     * has to be able to reach it. Empty = no webhook is registered and jobs poll as usual.
+     */
+    UPROPERTY(EditAnywhere, Config, Category="Replicate", AdvancedDisplay, meta=(EditCondition="bUseWebhook"))
+    FString WebhookPublicUrl;
+
+    /**
+     * The account's webhook signing secret ("whsec_..."; GET /v1/webhooks/default/secret).
+     * Callbacks without a valid signature are ignored. Falls back to env var
+     * REPLICATE_WEBHOOK_SECRET when blank; without either, jobs poll as usual.
+     */
+    UPROPERTY(EditAnywhere, Config, Category="Replicate", AdvancedDisplay, meta=(EditCondition="bUseWebhook"))
+    FString WebhookSigningSecret;
+
+    /** How fast new requests may start (UNanoBananaJobScheduler). */
+    UPROPERTY(EditAnywhere, Config, Category="Replicate", AdvancedDisplay)
+    FNanoBananaRateLimit RateLimit;
+};
+
+/** One step of the vendor failover chain. */
+USTRUCT(BlueprintType)
+struct NANOBANANABRIDGE_API FNanoBananaFailoverTarget
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, Config, Category="Failover")
+    ENanoBananaVendor Vendor = ENanoBananaVendor::Google;
+
+    UPROPERTY(EditAnywhere, Config, Category="Failover")
+    ENanoBananaModel Model = ENanoBananaModel::NanoBanana2;
+
+    /** Vendor-specific model id (used when Model == Custom). */
+    UPROPERTY(EditAnywhere, Config, Category="Failover", meta=(EditCondition="Model == ENanoBananaModel::Custom"))
+    FString CustomModelId;
 };
 
 UCLASS(Config=Game, DefaultConfig, meta=(DisplayName="Nano Banana / Gemini Images"))
@@ -109,6 +212,31 @@ public:
     UPROPERTY(EditAnywhere, Config, Category="Vendors", meta=(ShowOnlyInnerProperties))
     FReplicateVendorConfig Replicate;
 
+    // ---------------- Failover ----------------
+
+    /**
+     * Vendors/models to try, in order, when a request's own vendor fails. Targets without an
+     * API key are skipped. Empty = requests only ever use their own vendor.
+     */
+    UPROPERTY(EditAnywhere, Config, Category="Failover")
+    TArray<FNanoBananaFailoverTarget> FailoverChain;
+
+    /**
+     * Also start the next target when the current one is still running past
+     * FailoverHedgePercentile of its recent completion times, and keep whichever finishes
+     * first. The slower one is canceled, but may already have been billed.
+     */
+    UPROPERTY(EditAnywhere, Config, Category="Failover")
+    bool bHedgeAcrossVendors = false;
+
+    /** Percentile of recent completion times (per vendor, model and resolution) that triggers the hedge. */
+    UPROPERTY(EditAnywhere, Config, Category="Failover", AdvancedDisplay, meta=(ClampMin="0.5", ClampMax="0.99", EditCondition="bHedgeAcrossVendors"))
+    float FailoverHedgePercentile = 0.9f;
+
+    /** Hedge delay until enough completion times have been seen. */
+    UPROPERTY(EditAnywhere, Config, Category="Failover", AdvancedDisplay, meta=(ClampMin="1", EditCondition="bHedgeAcrossVendors"))
+    float FailoverHedgeDelayWithoutHistorySeconds = 60.0f;
+
     // ---------------- IO + behavior ----------------
 
     /** Output directory for saved images (absolute or project-relative). */
@@ -127,11 +255,122 @@ public:
     UPROPERTY(EditAnywhere, Config, Category="Behavior", meta=(ClampMin="10", ClampMax="1800"))
     int32 MaxPollSeconds = 240;
 
+    /**
+     * Times a request answered with HTTP 429 is queued again (after the vendor's Retry-After)
+     * before it fails. 0 = fail on the first 429.
+     */
+    UPROPERTY(EditAnywhere, Config, Category="Behavior", meta=(ClampMin="0", ClampMax="10"))
+    int32 MaxRateLimitRetries = 2;
+
+    // ---------------- Performance ----------------
+
+    /** Memory cap for the in-process cache of encoded reference images (PNG + base64). 0 disables it. */
+    UPROPERTY(EditAnywhere, Config, Category="Performance", meta=(ClampMin="0", ClampMax="4096", Units="MB"))
+    int32 ReferenceCacheMaxMegabytes = 256;
+
+    /**
+     * Downscale reference images so neither side exceeds the request's output resolution
+     * (e.g. 1024 px for 1K) before encoding and upload. Requests can override this via
+     * FNanoBananaRequest::ReferenceScaling. Has no effect when Resolution is Auto.
+     */
+    UPROPERTY(EditAnywhere, Config, Category="Performance")
+    bool bDownscaleReferencesToResolution = true;
+
+    /**
+     * Encoding used for reference images sent to vendors. JPEG is several times smaller and
+     * faster to encode than PNG, and the models do not need lossless input. PNG files on disk
+     * are transcoded too; JPEG files are sent as they are. References with any transparent
+     * pixels are sent as fast PNG regardless, since JPEG has no alpha channel.
+     */
+    UPROPERTY(EditAnywhere, Config, Category="Performance")
+    ENanoBananaUploadEncoding UploadEncoding = ENanoBananaUploadEncoding::JPEG;
+
+    UPROPERTY(EditAnywhere, Config, Category="Performance", meta=(ClampMin="1", ClampMax="100",
+        EditCondition="UploadEncoding==ENanoBananaUploadEncoding::JPEG"))
+    int32 UploadJpegQuality = 90;
+
+    /**
+     * Most generation requests in flight at once per vendor, across every action and batch.
+     * Further requests wait in UNanoBananaJobScheduler, highest priority first.
+     */
+    UPROPERTY(EditAnywhere, Config, Category="Performance", meta=(ClampMin="1", ClampMax="64"))
+    int32 MaxConcurrentRequestsPerVendor = 8;
+
+    /**
+     * Most status polls (FAL queue status, Replicate prediction GETs) in flight at once per
+     * vendor, across all jobs. Further polls wait in the shared poll scheduler until a
+     * request completes.
+     */
+    UPROPERTY(EditAnywhere, Config, Category="Performance", meta=(ClampMin="1", ClampMax="64"))
+    int32 MaxConcurrentPollsPerVendor = 8;
+
+    /**
+     * Random spread applied to each poll interval (0.2 = +/-20%) so jobs submitted together
+     * do not keep polling in lockstep.
+     */
+    UPROPERTY(EditAnywhere, Config, Category="Performance", meta=(ClampMin="0", ClampMax="0.5"))
+    float PollJitterFraction = 0.2f;
+
+    /**
+     * Learn how long each (vendor, model, resolution) takes and poll around the predicted
+     * completion time instead of the fixed 1 s -> 5 s backoff. Estimates are kept in
+     * Saved/NanoBanana/PollLatency.json; see NanoBanana.PollLatency.Stats for the savings.
+     */
+    UPROPERTY(EditAnywhere, Config, Category="Performance")
+    bool bAdaptivePollIntervals = true;
+
+    /**
+     * A request identical to one already in flight (every request field plus reference image
+     * content) waits for that one instead of generating again, and receives the same results.
+     */
+    UPROPERTY(EditAnywhere, Config, Category="Performance")
+    bool bCoalesceIdenticalRequests = true;
+
+    /**
+     * Also coalesce requests with Seed 0. Off by default: an unseeded request usually asks for
+     * a fresh random image, so two of them should not share one.
+     */
+    UPROPERTY(EditAnywhere, Config, Category="Performance", meta=(EditCondition="bCoalesceIdenticalRequests"))
+    bool bCoalesceUnseededRequests = false;
+
+    /**
+     * Disk budget for finished results kept under Saved/NanoBanana/Cache, keyed by request
+     * fingerprint. A repeated request (see FNanoBananaRequest::CachePolicy) is served from
+     * there without contacting its vendor. Least recently used entries go first. 0 disables it.
+     */
+    UPROPERTY(EditAnywhere, Config, Category="Performance", meta=(ClampMin="0", ClampMax="65536"))
+    int32 ResultCacheMaxMegabytes = 1024;
+
+    /** Cached results older than this many days are discarded. 0 = no age limit. */
+    UPROPERTY(EditAnywhere, Config, Category="Performance", meta=(ClampMin="0", ClampMax="3650"))
+    int32 ResultCacheMaxAgeDays = 30;
+
+    /**
+     * Also cache requests with Seed 0. Off by default: an unseeded request usually wants a
+     * fresh random image, not the one from last time.
+     */
+    UPROPERTY(EditAnywhere, Config, Category="Performance")
+    bool bCacheUnseededResults = false;
+
+    /**
+     * Also keep results in the DerivedDataCache (editor only), so with a shared DDC one person's
+     * generation is a cache hit for everyone on the team. Checked after the local result cache;
+     * a hit there is copied into it. Follows CachePolicy and bCacheUnseededResults.
+     */
+    UPROPERTY(EditAnywhere, Config, Category="Performance")
+    bool bShareResultsThroughDerivedDataCache = false;
+
     // ---------------- Helpers ----------------
 
     /** Returns the effective API key for the given vendor: configured value, or env-var fallback. */
     FString GetEffectiveApiKey(ENanoBananaVendor Vendor) const;
 
+    /** Replicate's webhook signing secret: configured value, or env-var fallback. */
+    FString GetEffectiveReplicateWebhookSecret() const;
+
+    /** The vendor's RateLimit; a default (unlimited) one for unknown vendors. */
+    const FNanoBananaRateLimit& GetRateLimit(ENanoBananaVendor Vendor) const;
+
     /** Convenience accessor matching UDeveloperSettings idiom. */
     static const UNanoBananaSettings& Get();
 };
@@ -54,6 +54,23 @@ enum class ENanoBananaResolution : uint8
     Res4K   UMETA(DisplayName="4K (4096)"),
 };
 
+/** Whether reference images are downscaled to the requested output resolution before upload. */
+UENUM(BlueprintType)
+enum class ENanoBananaReferenceScaling : uint8
+{
+    ProjectDefault  UMETA(DisplayName="Project Default"),
+    FitToResolution UMETA(DisplayName="Fit To Output Resolution"),
+    Original        UMETA(DisplayName="Original Size"),
+};
+
+/** How reference images are encoded for upload. Only affects what is sent, not saved outputs. */
+UENUM(BlueprintType)
+enum class ENanoBananaUploadEncoding : uint8
+{
+    PNGFast UMETA(DisplayName="PNG (fast, lossless)"),
+    JPEG    UMETA(DisplayName="JPEG"),
+};
+
 UENUM(BlueprintType)
 enum class ENanoBananaOutputFormat : uint8
 {
@@ -62,6 +79,30 @@ enum class ENanoBananaOutputFormat : uint8
     WebP    UMETA(DisplayName="WebP"),
 };
 
+/**
+ * Scheduling class of a request (see UNanoBananaJobScheduler). Waiting Interactive requests
+ * always start before Background ones, and Background before Bulk.
+ */
+UENUM(BlueprintType)
+enum class ENanoBananaJobPriority : uint8
+{
+    Interactive UMETA(DisplayName="Interactive"),
+    Background  UMETA(DisplayName="Background"),
+    Bulk        UMETA(DisplayName="Bulk"),
+};
+
+/** How a request uses the on-disk result cache (Saved/NanoBanana/Cache). */
+UENUM(BlueprintType)
+enum class ENanoBananaCachePolicy : uint8
+{
+    // Serve a cached result when there is one; otherwise generate and cache it.
+    Use     UMETA(DisplayName="Use"),
+    // Always generate, and replace the cached result.
+    Refresh UMETA(DisplayName="Refresh"),
+    // Neither read nor write the cache.
+    Bypass  UMETA(DisplayName="Bypass"),
+};
+
 /**
  * One reference image input. Populate ONE of: Texture, RenderTarget, FilePath.
  * Pre-encoded PngBytes is used internally by the bridge after conversion.
@@ -126,9 +167,21 @@ struct NANOBANANABRIDGE_API FNanoBananaRequest
     UPROPERTY(BlueprintReadWrite, Category="Nano Banana")
     TArray<FNanoBananaReferenceImage> ReferenceImages;
 
+    /** FitToResolution shrinks references so neither side exceeds Resolution's pixel size (aspect kept). */
+    UPROPERTY(BlueprintReadWrite, Category="Nano Banana")
+    ENanoBananaReferenceScaling ReferenceScaling = ENanoBananaReferenceScaling::ProjectDefault;
+
     /** Optional inpaint/edit mask (alpha = where to edit). */
     UPROPERTY(BlueprintReadWrite, Category="Nano Banana")
     TObjectPtr<UTextureRenderTarget2D> OptionalMask = nullptr;
+
+    /** Queue position against other requests to the same vendor. Batches run their items as Bulk. */
+    UPROPERTY(BlueprintReadWrite, Category="Nano Banana")
+    ENanoBananaJobPriority Priority = ENanoBananaJobPriority::Interactive;
+
+    /** Whether an identical earlier result may be served from disk instead of generating. */
+    UPROPERTY(BlueprintReadWrite, Category="Nano Banana")
+    ENanoBananaCachePolicy CachePolicy = ENanoBananaCachePolicy::Use;
 };
 
 /**
@@ -149,6 +202,66 @@ struct NANOBANANABRIDGE_API FNanoBananaImageResult
     FString SavedPath;
 };
 
+/**
+ * Where a finished request spent its time, in milliseconds. Per-image stages run in parallel
+ * on workers; their figures are summed across images, so they can exceed PersistMs.
+ */
+USTRUCT(BlueprintType)
+struct NANOBANANABRIDGE_API FNanoBananaResultTimings
+{
+    GENERATED_BODY()
+
+    /** Activation until the result bytes arrived: capture, encoding, queueing, the vendor or a cache. */
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    float ResponseMs = 0.0f;
+
+    /** Writing result files (and the debug response) not already written while downloading. */
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    float SaveMs = 0.0f;
+
+    /** Decoding result pixels that were not streamed earlier. */
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    float DecodeMs = 0.0f;
+
+    /** Reading the input, composing, encoding and writing the side-by-side composite. */
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    float CompositeMs = 0.0f;
+
+    /** Writing the result cache entry (and handing results to the DerivedDataCache). */
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    float CacheStoreMs = 0.0f;
+
+    /** Wall clock from the result bytes arriving until every worker stage had finished. */
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    float PersistMs = 0.0f;
+
+    /** Creating textures on the game thread. */
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    float TextureMs = 0.0f;
+
+    /** Activation until OnCompleted. */
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    float TotalMs = 0.0f;
+};
+
+/**
+ * Outcome of one request in a BatchGenerateImages batch. Exactly one of Images / Error is set.
+ */
+USTRUCT(BlueprintType)
+struct NANOBANANABRIDGE_API FNanoBananaBatchItemResult
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    bool bSucceeded = false;
+
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    TArray<FNanoBananaImageResult> Images;
+
+    UPROPERTY(BlueprintReadOnly, Category="Nano Banana")
+    FString Error;
+};
+
 /** Helpers used by providers and tests. */
 struct NANOBANANABRIDGE_API FNanoBananaTypeUtils
 {
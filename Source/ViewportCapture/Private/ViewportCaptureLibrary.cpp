@@ -126,5 +126,6 @@ void UViewportCaptureLibrary::CompressColorsToPNG(const TArray<FColor>& Colors,
     const int32 Height = Size.Y;
 
     ImageWrapper->SetRaw(Colors.GetData(), Colors.Num() * sizeof(FColor), Width, Height, ERGBFormat::BGRA, 8);
-    OutPNG = ImageWrapper->GetCompressed(100);
+    // Default zlib level: still lossless, but far cheaper than 100 (max compression) on the game thread.
+    OutPNG = ImageWrapper->GetCompressed((int32)EImageCompressionQuality::Default);
 }